@@ -0,0 +1,105 @@
+/*  -- $HeadURL: https://uv-software.net/MacCAN/PCANUSB/Utilities/bench/trunk/bench_batch.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Benchmark of the batch receive API (canbatch)
+ *
+ *  copyright :  (c) 2025 by UV Software, Berlin
+ *
+ *  author(s) :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  Frames per second and CPU time of CAN_Read through the wrapper (one
+ *  call per frame) and of CAN_ReadBatch with batches of 16 and 64, read
+ *  from the stub library (Linux):
+ *
+ *    LD_LIBRARY_PATH=../stub STUB_LEAN=1 ./bench_batch [<frames>]
+ *
+ *  With STUB_LEAN=1 a read of the stub only fills a message, so that the
+ *  cost of the wrapper is not hidden by the frame generator.
+ */
+#include "PCANBasic.h"
+#include "canbatch.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#define FRAMES  (100000000UL)
+#define BATCH_MAX  (64)
+
+static double now(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec * 1e-9);
+}
+
+static double cpu(void)
+{
+    struct rusage usage;
+
+    (void)getrusage(RUSAGE_SELF, &usage);
+    return (double)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+           ((double)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6);
+}
+
+static void run(unsigned long frames, DWORD batch)
+{
+    static TPCANMsg messages[BATCH_MAX];
+    static TPCANTimestamp timestamps[BATCH_MAX];
+    unsigned long count = 0UL, calls = 0UL;
+    double start = now(), used = cpu(), elapsed;
+    DWORD read;
+
+    while (count < frames) {
+        if (batch > 1U) {
+            (void)CAN_ReadBatch(PCAN_USBBUS1, messages, timestamps, batch, &read);
+            count += (unsigned long)read;
+        }
+        else if (CAN_Read(PCAN_USBBUS1, messages, timestamps) == PCAN_ERROR_OK)
+            count++;
+        calls++;
+    }
+    elapsed = now() - start;
+    used = cpu() - used;
+    if (batch > 1U)
+        printf("  batch of %-2u:          ", batch);
+    else
+        printf("  per-frame CAN_Read:   ");
+    printf("%4.0f Mframes/s, %.1f ns/frame, %.2f s CPU (%lu calls)\n",
+           (double)count / elapsed / 1e6, elapsed / (double)count * 1e9, used, calls);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long frames = (argc > 1) ? strtoul(argv[1], NULL, 0) : FRAMES;
+    TPCANStatus status;
+
+    if (frames == 0UL) {
+        fprintf(stderr, "Usage: %s [<frames>]\n", argv[0]);
+        return 1;
+    }
+    if ((status = CAN_Initialize(PCAN_USBBUS1, PCAN_BAUD_250K, 0, 0, 0)) != PCAN_ERROR_OK) {
+        fprintf(stderr, "+++ error: CAN_Initialize returned 0x%X\n", status);
+        return 1;
+    }
+    printf("%lu frames on one core:\n", frames);
+    run(frames, 1U);
+    run(frames, 16U);
+    run(frames, 64U);
+    (void)CAN_Uninitialize(PCAN_USBBUS1);
+    return 0;
+}
+
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,131 @@
+/*  -- $HeadURL: https://uv-software.net/MacCAN/PCANUSB/Utilities/bench/trunk/bench_encode.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Benchmark of the payload encoders (printmsg)
+ *
+ *  copyright :  (c) 2025 by UV Software, Berlin
+ *
+ *  author(s) :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  Time per frame to convert the payload into HEX data and ASCII column
+ *  (8 and 64 bytes):
+ *  - per-byte msg_print_data/msg_print_space/msg_print_ascii into a FILE
+ *    (the former output path of can_moni)
+ *  - msg_encode_data/msg_encode_ascii with each kernel of this CPU
+ *
+ *  The kernels are static, so the module is included here to select them.
+ *
+ *  Usage: bench_encode [<frames>]
+ */
+#include "printmsg.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define FRAMES  (2000000L)
+
+typedef void (*kernel_t)(char *text, const unsigned char *data, int len);
+
+static double now(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double)ts.tv_sec * 1e9) + (double)ts.tv_nsec;
+}
+
+static double per_byte(FILE *stream, unsigned char *data, int len, long frames)
+{
+    double start = now();
+    long n;
+    int row, col, idx;
+
+    for (n = 0; n < frames; n++) {
+        data[0] = (unsigned char)n;
+        for (row = 0; (row * 8) < len; row++) {
+            for (col = 0, idx = row * 8; col < 8; col++, idx++)
+                msg_print_data(stream, data[idx], (col + 1) == 8, MSG_MODE_HEX);
+            fprintf(stream, "  ");
+            for (col = 0, idx = row * 8; col < 8; col++, idx++)
+                msg_print_ascii(stream, data[idx], MSG_ASCII_ON);
+            if (((row + 1) * 8) < len)
+                msg_print_indent_fd(stream, "\n\t", MSG_MODE_HEX);
+        }
+        fprintf(stream, "\n");
+    }
+    return (now() - start) / (double)frames;
+}
+
+static double encoder(kernel_t hex, kernel_t ascii, unsigned char *data, int len, long frames)
+{
+    static char text[1024];
+    volatile size_t sum = 0;
+    double start;
+    long n;
+
+    if (!encoder_ready)
+        init_encoder();
+    encode_hex = hex;
+    encode_ascii = ascii;
+    start = now();
+    for (n = 0; n < frames; n++) {
+        data[0] = (unsigned char)n;
+        sum += (size_t)msg_encode_data(text, data, len, MSG_MODE_HEX);
+        sum += (size_t)msg_encode_ascii(&text[512], data, len);
+    }
+    (void)sum;
+    return (now() - start) / (double)frames;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned char data[64];
+    long frames = (argc > 1) ? strtol(argv[1], NULL, 0) : FRAMES;
+    FILE *stream;
+    int i;
+
+    if ((frames <= 0L) || !(stream = fopen("/dev/null", "w"))) {
+        fprintf(stderr, "Usage: %s [<frames>]\n", argv[0]);
+        return 1;
+    }
+    srand(1);
+    for (i = 0; i < 64; i++)
+        data[i] = (unsigned char)rand();
+
+    printf("HEX data + ASCII per frame (%ld frames):\n", frames);
+    printf("  per-byte msg_print_xyz:  8 bytes %6.0f ns,  64 bytes %6.0f ns\n",
+           per_byte(stream, data, 8, frames / 8L), per_byte(stream, data, 64, frames / 8L));
+    printf("  scalar tables:           8 bytes %6.0f ns,  64 bytes %6.0f ns\n",
+           encoder(encode_hex_scalar, encode_ascii_scalar, data, 8, frames),
+           encoder(encode_hex_scalar, encode_ascii_scalar, data, 64, frames));
+#if defined(MSG_ENCODE_X86)
+    printf("  SSE2:                    8 bytes %6.0f ns,  64 bytes %6.0f ns\n",
+           encoder(encode_hex_sse2, encode_ascii_sse2, data, 8, frames),
+           encoder(encode_hex_sse2, encode_ascii_sse2, data, 64, frames));
+    if (__builtin_cpu_supports("avx2"))
+        printf("  AVX2:                    8 bytes %6.0f ns,  64 bytes %6.0f ns\n",
+               encoder(encode_hex_avx2, encode_ascii_avx2, data, 8, frames),
+               encoder(encode_hex_avx2, encode_ascii_avx2, data, 64, frames));
+    else
+        printf("  AVX2:                    (not supported by this CPU)\n");
+#elif defined(MSG_ENCODE_NEON)
+    printf("  NEON:                    8 bytes %6.0f ns,  64 bytes %6.0f ns\n",
+           encoder(encode_hex_neon, encode_ascii_neon, data, 8, frames),
+           encoder(encode_hex_neon, encode_ascii_neon, data, 64, frames));
+#endif
+    (void)fclose(stream);
+    return 0;
+}
+
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,60 @@
+#!/bin/sh
+#
+#	Scaling of can_moni with 1, 2, 4 and 8 interfaces (stub library)
+#
+#	Each interface generates the same number of frames as fast as the
+#	stub can; the readers are pinned to the cores (--cpu=0-<n-1>, round
+#	robin if there are less cores).  The output goes to /dev/null, so it
+#	is the throughput of the readers and of the time-stamp merge.
+#
+#	All frames are merged, formatted and written by one output thread
+#	(the main thread), so it caps the throughput however many cores the
+#	readers have (with one interface there is nothing to merge).  Where /proc is available, the share of the output
+#	thread in the CPU time of can_moni is sampled during the run; frames
+#	per CPU second of the output thread is that cap ("output cap").
+#
+#	Usage: bench_scale.sh [<frames per interface>]
+#
+#	Copyright (c) 2025  Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+#
+CAN_MONI=${CAN_MONI:-../can_moni/can_moni}
+STUB_DIR=${STUB_DIR:-../stub}
+FRAMES=${1:-200000}
+CORES=$(getconf _NPROCESSORS_ONLN 2>/dev/null || echo 1)
+SAMPLE=/tmp/bench_scale.$$
+
+# CPU time [ticks] of the output thread (the main thread) and of the readers
+cpu_times() {
+	# note: the fields after the command name, which is in parentheses
+	awk -v main=/proc/$1/task/$1/stat '{ sub(/^.*\) /, "")
+		if (FILENAME == main) o += $12 + $13; else r += $12 + $13 }
+		END { printf("%d %d\n", o, r) }' /proc/$1/task/*/stat 2>/dev/null
+}
+
+echo "can_moni with n interfaces, $FRAMES frames each, $CORES core(s):"
+for n in 1 2 4 8; do
+	interfaces=""
+	i=1; while [ $i -le $n ]; do interfaces="$interfaces PCAN-USB$i"; i=$((i + 1)); done
+	last=$(( (n < CORES ? n : CORES) - 1 ))
+	echo "0 0" >$SAMPLE
+	start=$(date +%s.%N)
+	# note: the CPU time of can_moni is taken from `times' (user and system time of the children)
+	(LD_LIBRARY_PATH=$STUB_DIR STUB_FRAMES=$FRAMES $CAN_MONI $interfaces --cpu=0-$last >/dev/null 2>&1; times) |
+		awk 'NR == 2 { split($1, u, /[ms]/); split($2, s, /[ms]/); print u[1] * 60 + u[2] + s[1] * 60 + s[2] }' >$SAMPLE.cpu &
+	sleep 0.1
+	while pid=$(pgrep -n -x can_moni) && [ -n "$pid" ]; do
+		cpu_times $pid >$SAMPLE.new && [ -s $SAMPLE.new ] && mv $SAMPLE.new $SAMPLE
+		sleep 0.1
+	done
+	wait
+	end=$(date +%s.%N)
+	read output readers <$SAMPLE
+	read cpu <$SAMPLE.cpu
+	awk -v n=$n -v f=$FRAMES -v s=$start -v e=$end -v c=$cpu -v o=$output -v r=$readers 'BEGIN {
+		printf("  %d interface(s): %8d frames in %5.2f s, %6.0f kframes/s", n, n * f, e - s, n * f / (e - s) / 1000)
+		if ((c > 0) && (o > 0))
+			printf(", output thread %3.0f%% of %5.2f s cpu (output cap %5.0f kframes/s)",
+			       100 * o / (o + r), c, n * f / (c * o / (o + r)) / 1000)
+		printf("\n") }'
+done
+rm -f $SAMPLE $SAMPLE.new $SAMPLE.cpu
@@ -0,0 +1,164 @@
+/*  -- $HeadURL: https://uv-software.net/MacCAN/PCANUSB/Utilities/bench/trunk/bench_writeq.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Benchmark of the asynchronous write queue (writeq)
+ *
+ *  copyright :  (c) 2025 by UV Software, Berlin
+ *
+ *  author(s) :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  Latency of msg_buffer_message at 40k frames/s into a pipe whose reader
+ *  stalls 80ms per MB, written synchronously (write(2) when the buffer is
+ *  full), by io_uring and by the writer thread (cf. --io of can_moni).
+ *
+ *  Usage: bench_writeq [<frames>]
+ */
+#include "printmsg.h"
+#include "writeq.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/wait.h>
+
+#define FRAMES  (120000L)
+#define PACE_NSEC  (25000ULL)       /* 40k frames/s */
+#define STALL_NSEC  (80000000L)     /* reader stalls 80ms ... */
+#define STALL_BYTES  (1048576L)     /* ... per MB */
+
+static uint64_t now(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static int compare(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+
+    return (x < y) ? -1 : (x > y) ? 1 : 0;
+}
+
+static void slow_reader(int fd)
+{
+    static char buffer[16384];
+    struct timespec stall = { 0, STALL_NSEC };
+    long bytes = 0L;
+    ssize_t n;
+
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+        if ((bytes += (long)n) >= STALL_BYTES) {
+            (void)nanosleep(&stall, NULL);
+            bytes -= STALL_BYTES;
+        }
+    }
+    _exit(0);
+}
+
+static char *async_sink(void *context, char *data, size_t length)
+{
+    struct write_queue *wq = (struct write_queue*)context;
+
+    if (data == NULL)
+        return wrq_buffer(wq);
+    if (length == 0) {
+        wrq_release(wq, data);
+        return NULL;
+    }
+    if (!wrq_submit(wq, data, length))
+        return NULL;
+    return wrq_buffer(wq);
+}
+
+static int run(const char *name, int backend, uint64_t *latency, long frames)
+{
+    static unsigned char data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    struct write_queue queue;
+    struct msg_format format;
+    struct msg_buffer buffer;
+    struct msg_timestamp timestamp = { 0, 0 };
+    uint64_t start, begin, end;
+    FILE *stream;
+    pid_t child;
+    int fds[2], status;
+    long i;
+
+    if ((pipe(fds) < 0) || ((child = fork()) < 0))
+        return 0;
+    if (child == 0) {
+        (void)close(fds[1]);
+        slow_reader(fds[0]);
+    }
+    (void)close(fds[0]);
+    stream = fdopen(fds[1], "w");
+    msg_format_init(&format, MSG_TIME_ZERO, MSG_MODE_HEX, MSG_MODE_HEX, MSG_ASCII_ON, 0);
+    (void)msg_buffer_init(&buffer, stream, MSG_BUFFER_SIZE, MSG_FLUSH_FULL, 0UL);
+    if (backend >= 0) {
+        if (!wrq_init(&queue, backend, MSG_BUFFER_SIZE, WRQ_BUFFERS)) {
+            printf("  %-8s (not available)\n", name);
+            msg_buffer_exit(&buffer);
+            (void)fclose(stream);
+            (void)waitpid(child, &status, 0);
+            return 1;
+        }
+        (void)wrq_attach(&queue, fds[1]);
+        (void)msg_buffer_sink(&buffer, async_sink, (void*)&queue);
+    }
+    start = now();
+    for (i = 0; i < frames; i++) {
+        timestamp.tv_sec = (long)(i / 40000L);
+        timestamp.tv_usec = (long)((i % 40000L) * 25L);
+        begin = now();
+        (void)msg_buffer_message(&buffer, &format, (uint64_t)i, &timestamp, 0x123UL + (unsigned long)(i & 63L), 0, 8, data);
+        end = now();
+        latency[i] = end - begin;
+        while ((now() - begin) < PACE_NSEC)
+            ;
+    }
+    msg_buffer_exit(&buffer);
+    if (backend >= 0)
+        wrq_exit(&queue);
+    (void)fclose(stream);
+    (void)waitpid(child, &status, 0);
+    qsort(latency, (size_t)frames, sizeof(uint64_t), compare);
+    printf("  %-8s p99 %5.2f us  p99.9 %5.1f us  max %5.1f ms  (%.1f s)\n", name,
+           (double)latency[(frames * 99L) / 100L] / 1e3, (double)latency[(frames * 999L) / 1000L] / 1e3,
+           (double)latency[frames - 1L] / 1e6, (double)(now() - start) / 1e9);
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    long frames = (argc > 1) ? strtol(argv[1], NULL, 0) : FRAMES;
+    uint64_t *latency;
+
+    if ((frames < 1000L) || !(latency = malloc((size_t)frames * sizeof(uint64_t)))) {
+        fprintf(stderr, "Usage: %s [<frames>]\n", argv[0]);
+        return 1;
+    }
+    (void)signal(SIGPIPE, SIG_IGN);
+    printf("msg_buffer_message at 40k frames/s into a pipe, reader stalls 80ms per MB (%ld frames):\n", frames);
+    (void)run("sync", -1, latency, frames);
+    (void)run("io_uring", WRQ_URING, latency, frames);
+    (void)run("thread", WRQ_THREAD, latency, frames);
+    free(latency);
+    return 0;
+}
+
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
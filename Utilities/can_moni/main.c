@@ -118,8 +118,29 @@ static const char LICENSE[]     = "This program is free software; you can redist
 #include "PCANBasic.h"
 #endif
 #endif
+#include "canbatch.h"
 #include "bitrates.h"
 #include "printmsg.h"
+#include "canrec.h"
+#include "canpack.h"
+#include "ringbuf.h"
+#include "msgtable.h"
+#include "msgstats.h"
+#include "busload.h"
+#include "msghist.h"
+#include "msgchange.h"
+#include "msgrate.h"
+#include "idset.h"
+#include "idaccept.h"
+#include "msgfilter.h"
+#include "msgtrig.h"
+#include "msgmerge.h"
+#include "flightrec.h"
+#include "logfile.h"
+#include "segment.h"
+#include "writeq.h"
+#include "evloop.h"
+#include "affinity.h"
 #include "timer.h"
 
 #include <stdio.h>
@@ -133,6 +154,7 @@ static const char LICENSE[]     = "This program is free software; you can redist
 #include <signal.h>
 #include <errno.h>
 #include <time.h>
+#include <pthread.h>
 
 #include <sys/time.h>
 #include <sys/types.h>
@@ -147,7 +169,11 @@ static const char LICENSE[]     = "This program is free software; you can redist
 
 /*  -----------  defines  ---------------------------------------------------
  */
-#define MAX_ID        2048
+#define MAX_RATE      1000000UL
+#define PRE_TRIGGER   1000UL
+#define POST_TRIGGER  1000UL
+#define RECORDER_FILE "flight.rec"
+#define FRAME_BITS    47UL  /* shortest frame (CAN CC, no data) incl. IFS */
 
 #define TIME_ZERO    0
 #define TIME_ABS     1
@@ -159,24 +185,72 @@ static const char LICENSE[]     = "This program is free software; you can redist
 
 #define ASCII_OFF    0
 #define ASCII_ON     1
+
+#define OUTPUT_TEXT    0
+#define OUTPUT_BINARY  1
+#define OUTPUT_LOG     2
+#define OUTPUT_PACKED  3
+
+#define VIEW_LIST    0
+#define VIEW_TABLE   1
+#define VIEW_STATS   2
+
 #ifndef BLOCKING_READ
 #define RxTIMEOUT    0    /* return immediately */
 #else
 #define RxTIMEOUT    65535    /* blocking read */
 #endif
+#define RxBATCH      64       /* frames per read */
 #define CODE_11BIT   0x000
 #define MASK_11BIT   0x7FF
 #define CODE_29BIT   0x00000000
 #define MASK_29BIT   0x1FFFFFFF
 
+#define CACHE_LINE   64       /* bytes (per-channel state) */
+#define QUEUE_DEPTH  16384    /* frames */
+#define MERGE_DEPTH  16384    /* frames (reorder buffer) */
+#define REORDER_WINDOW  10    /* msec */
+#define STATS_INTERVAL  10    /* seconds */
+
+#define CHANGES_ONLY    1     /* suppress frames with an unchanged payload */
+#define CHANGES_COUNT   2     /* ... and show the number of suppressed frames */
+
+#define FRAME_EXCLUDED  0x80  /* excluded CAN-ID (only counted for the bus load) */
+
 
 /*  -----------  types  -----------------------------------------------------
  */
+/** CAN message in the receive queue (from the reader thread to the output)
+ */
+struct frame {
+    struct msg_timestamp timestamp;    /**< time-stamp */
+    uint32_t id;                       /**< CAN identifier */
+    uint8_t flags;                     /**< message flags (MSG_FLAG_xyz) */
+    uint8_t dlc;                       /**< data length code */
+    uint8_t len;                       /**< number of data bytes */
+    unsigned char data[64];            /**< data bytes */
+    uint8_t channel;                   /**< interface (index) */
+};
+
+/** reader thread of a CAN channel (cache-line aligned, the channels do not share a line)
+ */
+struct reader {
+    TPCANHandle channel;               /**< channel handle */
+    int index;                         /**< interface (index) */
+    int core;                          /**< pinned to core (or -1) */
+    struct ring_buffer *queue;         /**< receive queue */
+    TPCANStatus status;                /**< error code (if any) */
+    TPCANStatus (*read)(struct reader *self); /**< reads a batch of frames */
+    uint64_t frames;                   /**< number of frames received */
+    uint64_t passed;                   /**< number of frames passed by the software filter */
+} __attribute__((aligned(CACHE_LINE)));
 
 
 /*  -----------  prototypes  ------------------------------------------------
  */
 static void sigterm(int signo);
+static void sigusr1(int signo);
+static void sigusr2(int signo);
 static void usage(FILE *stream, const char *program);
 static void version(FILE *stream, const char *program);
 
@@ -184,20 +258,89 @@ static int list_bitrates(BYTE op_mode);
 static int list_interfaces(void);
 static int test_interfaces(void);
 
-static uint64_t receive(TPCANHandle channel, int mode_time, int mode_id, int mode_data, int mode_ascii);
-static uint64_t receive_fd(TPCANHandle channel, int mode_time, int mode_id, int mode_data, int mode_ascii);
+static uint64_t receive(int canfd, int mode_time, int mode_id, int mode_data, int mode_ascii);
+static int render(const char *filename, FILE *output, int mode_time, int mode_id, int mode_data, int mode_ascii, int follow);
+static void release_interfaces(int count);
+static void release_queues(int count);
+static int merge_frames(struct frame *frame, int *closed);
+static unsigned int merge_delay(void);
+static void *reader(void *arg);
+static void *reader_fd(void *arg);
+static void rx_loop(struct reader *self);
+static void rx_event(struct ev_loop *loop, void *context, uint64_t value);
+static void rx_stop(struct ev_loop *loop, void *context, uint64_t value);
+static void stop_readers(void);
+static void close_stopper(void);
+static TPCANStatus read_frames(struct reader *self);
+static TPCANStatus read_frames_fd(struct reader *self);
+static void next_segment(struct msg_buffer *output, struct rec_header *header, struct log_writer *writer);
+static uint64_t output_bytes(const struct msg_buffer *output);
+static char *async_sink(void *context, char *data, size_t length);
+static int export_histograms(void);
+static int print_message(struct msg_buffer *output, struct msg_format *format, uint64_t counter, struct frame *frame, uint64_t repeats);
+static int dump_begin(void *context, FILE *stream, const void *last);
+static int dump_frame(void *context, const void *item);
+static int dump_end(void *context);
 
-static int get_exclusion(const char *arg);
+static int get_exclusion(const char *arg, unsigned long *line);
+static int get_acceptance(struct id_cover *cover, unsigned long max_id);
+static int get_rate_limit(const char *arg, int policy);
+static int get_id_list(const char *arg, int (*range)(void *context, unsigned long first, unsigned long last), void *context);
+static int exclude_range(void *context, unsigned long first, unsigned long last);
+static int limit_range(void *context, unsigned long first, unsigned long last);
+static int core_range(void *context, unsigned long first, unsigned long last);
 
 
 /*  -----------  variables  ----------------------------------------------
  */
-static int can_id[MAX_ID];
-static int can_id_xtd = 1;
+static struct id_set exclusion;
+static int filtering = 0;
+static struct msg_filter expression;
+static int capture = 0;
+static struct msg_filter trigger;
+static struct msg_trigger trig;
+static int recording = 0;
+static struct flight_rec recorder;
+static struct msg_buffer dump_buffer;
+static struct rec_header dump_header;
+static uint64_t dump_window = 0;
+static uint64_t dump_since = 0;
+static uint64_t dump_written = 0;
+static int flush_policy = MSG_FLUSH_FULL;
+static unsigned long flush_value = 0UL;
+static int output_mode = OUTPUT_TEXT;
+static int log_format = 0;
+static int view_mode = VIEW_LIST;
+static unsigned long stats_interval = STATS_INTERVAL;
+static struct msg_stats stats;
+static int bus_load = 0;
+static unsigned long load_interval = LOAD_INTERVAL;
+static struct bus_load busload;
+static int histogram = 0;
+static const char *hist_file = NULL;
+static struct msg_hist hist;
+static int changes_only = 0;
+static struct msg_changes changes;
+static int rate_limit = 0;
+static struct msg_rate ratelimit;
+static FILE *output_stream = NULL;
+static size_t queue_depth = QUEUE_DEPTH;
+static int queue_policy = RING_BLOCK;
+static int merging = 0;
+static unsigned long reorder = REORDER_WINDOW;
+static struct msg_merge merge;
+static struct pack_writer packer;
+static struct seg_output segment;
+static int segmented = 0;
+static int io_mode = -1;
+static struct write_queue wqueue;
 static const unsigned char dlc_table[16] = {
     0,1,2,3,4,5,6,7,8,12,16,20,24,32,48,64
 };
 static volatile int running = 1;
+static int stopper[2] = { -1, -1 };  /* note: pipe to wake up the readers at the end */
+static volatile sig_atomic_t report = 0;
+static volatile sig_atomic_t dump = 0;
 
 /*  - - - - - -  from CAN API Defs - - - - - - - - - - - - - - - - - - - -
  */
@@ -216,6 +359,12 @@ static struct _can_board_t
   {PCAN_USBBUS7,                           "PCAN-USB7"},
   {PCAN_USBBUS8,                           "PCAN-USB8"},
 };
+static int boards[PCAN_BOARDS];        /* interfaces (index into the board list) */
+static int interfaces = 0;             /* number of interfaces */
+static struct ring_buffer queues[PCAN_BOARDS];
+static struct reader readers[PCAN_BOARDS];
+static int cores[PCAN_BOARDS];         /* cores of the reader threads */
+static int pinning = 0;                /* number of cores */
 
 /*  -----------  main  ---------------------------------------------------
  */
@@ -234,13 +383,38 @@ int main(int argc, char *argv[])
     DWORD std_mask = MASK_11BIT; int sm = 0;
     DWORD xtd_code = CODE_29BIT; int xc = 0;
     DWORD xtd_mask = MASK_29BIT; int xm = 0;
+    struct id_cover std_cover; int std_auto = 0;
+    struct id_cover xtd_cover; int xtd_auto = 0;
     BYTE  trace = PCAN_PARAMETER_OFF; int ts = 0;
     long  baudrate = PCAN_BAUD_250K; int bd = 0;
     int   mode_time = TIME_ZERO; int mt = 0;
     int   mode_id = MODE_HEX; int mi = 0;
     int   mode_data = MODE_HEX; int md = 0;
     int   mode_ascii = ASCII_ON; int ma = 0;
-    int   exclude = 0;
+    int   fl = 0; char suffix[8] = "";
+    int   om = 0;
+    int   qd = 0, qp = 0;
+    unsigned long window = 0UL; int ro = 0;
+    int   cp = 0;
+    int   vm = 0;
+    unsigned long interval = 0UL; int iv = 0;
+    unsigned long pre = PRE_TRIGGER; int pr = 0;
+    unsigned long post = POST_TRIGGER; int po = 0;
+    int   rearm = 0;
+    unsigned long rec_value = 0UL; char rec_unit[8] = ""; uint64_t rec_bytes = 0, rec_frames = 0; const char *rec_file = RECORDER_FILE; int rn = 0;
+    int   huge = 0;
+    unsigned long nominal = 0UL, data_phase = 0UL; int bl = 0; int hg = 0; int co = 0;
+    unsigned long depth = 0UL;
+    char *output_file = NULL; int of = 0;
+    unsigned long seg_size = 0UL; int sz = 0;
+    unsigned long seg_time = 0UL; int st = 0;
+    int   io = 0;
+    char *render_file = NULL; int rd = 0; int follow = 0;
+    int   fdes;
+    int   exclude = 0; unsigned long line = 0UL; int rc;
+    uint64_t dropped_newest = 0, dropped_oldest = 0, blocked = 0; int n;
+    uint64_t rx_frames = 0, rx_passed = 0;
+    size_t position = 0;
     int   show_version = 0;
     int   verbose = 0;
     int   num_boards = 0;
@@ -257,6 +431,33 @@ int main(int argc, char *argv[])
         {"data", required_argument, 0, 'd'},
         {"ascii", required_argument, 0, 'a'},
         {"exclude", required_argument, 0, 'x'},
+        {"filter", required_argument, 0, 'Z'},
+        {"flush", required_argument, 0, 'F'},
+        {"output", required_argument, 0, 'O'},
+        {"output-file", required_argument, 0, 'W'},
+        {"segment-size", required_argument, 0, 'S'},
+        {"segment-time", required_argument, 0, 'D'},
+        {"io", required_argument, 0, 'I'},
+        {"render", required_argument, 0, 'k'},
+        {"follow", no_argument, 0, 'w'},
+        {"view", required_argument, 0, 'V'},
+        {"interval", required_argument, 0, 'J'},
+        {"bus-load", optional_argument, 0, 'U'},
+        {"histogram", optional_argument, 0, 'G'},
+        {"changes-only", optional_argument, 0, 'C'},
+        {"trigger", required_argument, 0, 'A'},
+        {"pre-trigger", required_argument, 0, 'H'},
+        {"post-trigger", required_argument, 0, 'X'},
+        {"re-arm", no_argument, 0, 'e'},
+        {"recorder", required_argument, 0, 'r'},
+        {"recorder-file", required_argument, 0, 'f'},
+        {"huge-pages", no_argument, 0, 'g'},
+        {"rate-limit", required_argument, 0, 'K'},
+        {"decimate", required_argument, 0, 'N'},
+        {"queue", required_argument, 0, 'Q'},
+        {"overflow", required_argument, 0, 'P'},
+        {"reorder", required_argument, 0, 'j'},
+        {"cpu", required_argument, 0, 'c'},
         {"baudrate", required_argument, 0, 'b'},
         {"bitrate", required_argument, 0, 'B'},
         {"verbose", no_argument, 0, 'v'},
@@ -277,14 +478,14 @@ int main(int argc, char *argv[])
         {0, 0, 0, 0}
     };
 
-    /* exclude list (11-bit IDs only) */
-    for (i = 0; i < MAX_ID; i++) {
-        can_id[i] = 1;
-    }
+    /* exclude list (bitset of 11-bit IDs, intervals of 29-bit IDs) */
+    (void)idset_init(&exclusion);
     /* signal handler */
     if ((signal(SIGINT, sigterm) == SIG_ERR) ||
 #if !defined(_WIN32) && !defined(_WIN64)
        (signal(SIGHUP, sigterm) == SIG_ERR) ||
+       (signal(SIGUSR1, sigusr1) == SIG_ERR) ||
+       (signal(SIGUSR2, sigusr2) == SIG_ERR) ||
 #endif
        (signal(SIGTERM, sigterm) == SIG_ERR)) {
         perror("+++ error");
@@ -534,8 +735,365 @@ int main(int argc, char *argv[])
                 fprintf(stderr, "%s: duplicated option `--exclude' (%c)\n", basename(argv[0]), opt);
                 return 1;
             }
-            if (!get_exclusion(optarg)) {
-                fprintf(stderr, "%s: illegal argument for option `--exclude' (%c)\n", basename(argv[0]), opt);
+            if ((rc = get_exclusion(optarg, &line)) <= 0) {
+                if (rc < 0)
+                    fprintf(stderr, "%s: cannot read file `%s' (%s)\n", basename(argv[0]), strchr(optarg, '@') + 1, strerror(errno));
+                else if (line)
+                    fprintf(stderr, "%s: illegal CAN-ID in file `%s' (line %lu)\n", basename(argv[0]), strchr(optarg, '@') + 1, line);
+                else
+                    fprintf(stderr, "%s: illegal argument for option `--exclude' (%c)\n", basename(argv[0]), opt);
+                return 1;
+            }
+            break;
+        /* option '--filter=<expr>' */
+        case 'Z':
+            if (filtering++) {
+                fprintf(stderr, "%s: duplicated option `--filter'\n", basename(argv[0]));
+                return 1;
+            }
+            if (!flt_compile(&expression, optarg, &position)) {
+                fprintf(stderr, "%s: illegal argument for option `--filter' (at `%s')\n", basename(argv[0]), &optarg[position]);
+                return 1;
+            }
+            break;
+        /* option '--flush=<n>[B|K|F|MS]' */
+        case 'F':
+            if (fl++) {
+                fprintf(stderr, "%s: duplicated option `--flush'\n", basename(argv[0]));
+                return 1;
+            }
+            if ((sscanf(optarg, "%lu%7s", &flush_value, suffix) < 1) || (flush_value == 0UL)) {
+                fprintf(stderr, "%s: illegal argument for option `--flush'\n", basename(argv[0]));
+                return 1;
+            }
+            if (!strcasecmp(suffix, "") || !strcasecmp(suffix, "B"))
+                flush_policy = MSG_FLUSH_BYTES;
+            else if (!strcasecmp(suffix, "K") || !strcasecmp(suffix, "KB")) {
+                flush_policy = MSG_FLUSH_BYTES;
+                flush_value *= 1024UL;
+            }
+            else if (!strcasecmp(suffix, "F") || !strcasecmp(suffix, "FRAMES"))
+                flush_policy = MSG_FLUSH_FRAMES;
+            else if (!strcasecmp(suffix, "MS") || !strcasecmp(suffix, "MSEC"))
+                flush_policy = MSG_FLUSH_TIME;
+            else {
+                fprintf(stderr, "%s: illegal argument for option `--flush'\n", basename(argv[0]));
+                return 1;
+            }
+            break;
+        /* option '--output=(TEXT|BINARY|COMPRESSED|ASC|CANDUMP|TRC)' */
+        case 'O':
+            if (om++) {
+                fprintf(stderr, "%s: duplicated option `--output'\n", basename(argv[0]));
+                return 1;
+            }
+            if (!strcasecmp(optarg, "TEXT") || !strcasecmp(optarg, "TXT") || !strcasecmp(optarg, "t"))
+                output_mode = OUTPUT_TEXT;
+            else if (!strcasecmp(optarg, "BINARY") || !strcasecmp(optarg, "BIN") || !strcasecmp(optarg, "b"))
+                output_mode = OUTPUT_BINARY;
+            else if (!strcasecmp(optarg, "COMPRESSED") || !strcasecmp(optarg, "PACKED") || !strcasecmp(optarg, "c"))
+                output_mode = OUTPUT_PACKED;
+            else if (!strcasecmp(optarg, "ASC") || !strcasecmp(optarg, "VECTOR")) {
+                output_mode = OUTPUT_LOG;
+                log_format = LOG_FORMAT_ASC;
+            }
+            else if (!strcasecmp(optarg, "CANDUMP") || !strcasecmp(optarg, "LOG")) {
+                output_mode = OUTPUT_LOG;
+                log_format = LOG_FORMAT_CANDUMP;
+            }
+            else if (!strcasecmp(optarg, "TRC") || !strcasecmp(optarg, "PEAK")) {
+                output_mode = OUTPUT_LOG;
+                log_format = LOG_FORMAT_TRC;
+            }
+            else if (!strcasecmp(optarg, "JSONL") || !strcasecmp(optarg, "JSON") || !strcasecmp(optarg, "j")) {
+                output_mode = OUTPUT_LOG;
+                log_format = LOG_FORMAT_JSONL;
+            }
+            else {
+                fprintf(stderr, "%s: illegal argument for option `--output'\n", basename(argv[0]));
+                return 1;
+            }
+            break;
+        /* option '--output-file=<file>' */
+        case 'W':
+            if (of++) {
+                fprintf(stderr, "%s: duplicated option `--output-file'\n", basename(argv[0]));
+                return 1;
+            }
+            output_file = optarg;
+            break;
+        /* option '--render=<file>' */
+        case 'k':
+            if (rd++) {
+                fprintf(stderr, "%s: duplicated option `--render'\n", basename(argv[0]));
+                return 1;
+            }
+            render_file = optarg;
+            break;
+        /* option '--follow' */
+        case 'w':
+            if (follow++) {
+                fprintf(stderr, "%s: duplicated option `--follow'\n", basename(argv[0]));
+                return 1;
+            }
+            break;
+        /* option '--segment-size=<MB>' */
+        case 'S':
+            if (sz++) {
+                fprintf(stderr, "%s: duplicated option `--segment-size'\n", basename(argv[0]));
+                return 1;
+            }
+            if ((sscanf(optarg, "%lu", &seg_size) != 1) || (seg_size == 0UL) || (seg_size > 1048576UL)) {
+                fprintf(stderr, "%s: illegal argument for option `--segment-size'\n", basename(argv[0]));
+                return 1;
+            }
+            break;
+        /* option '--segment-time=<seconds>' */
+        case 'D':
+            if (st++) {
+                fprintf(stderr, "%s: duplicated option `--segment-time'\n", basename(argv[0]));
+                return 1;
+            }
+            if ((sscanf(optarg, "%lu", &seg_time) != 1) || (seg_time == 0UL)) {
+                fprintf(stderr, "%s: illegal argument for option `--segment-time'\n", basename(argv[0]));
+                return 1;
+            }
+            break;
+        /* option '--io=(SYNC|ASYNC|URING|THREAD)' */
+        case 'I':
+            if (io++) {
+                fprintf(stderr, "%s: duplicated option `--io'\n", basename(argv[0]));
+                return 1;
+            }
+            if (!strcasecmp(optarg, "SYNC") || !strcasecmp(optarg, "s"))
+                io_mode = -1;
+            else if (!strcasecmp(optarg, "ASYNC") || !strcasecmp(optarg, "a"))
+                io_mode = WRQ_AUTO;
+            else if (!strcasecmp(optarg, "URING") || !strcasecmp(optarg, "IO_URING") || !strcasecmp(optarg, "u"))
+                io_mode = WRQ_URING;
+            else if (!strcasecmp(optarg, "THREAD") || !strcasecmp(optarg, "t"))
+                io_mode = WRQ_THREAD;
+            else {
+                fprintf(stderr, "%s: illegal argument for option `--io'\n", basename(argv[0]));
+                return 1;
+            }
+            break;
+        /* option '--view=(LIST|TABLE|STATS)' */
+        case 'V':
+            if (vm++) {
+                fprintf(stderr, "%s: duplicated option `--view'\n", basename(argv[0]));
+                return 1;
+            }
+            if (!strcasecmp(optarg, "LIST") || !strcasecmp(optarg, "SCROLL") || !strcasecmp(optarg, "l"))
+                view_mode = VIEW_LIST;
+            else if (!strcasecmp(optarg, "TABLE") || !strcasecmp(optarg, "TOP") || !strcasecmp(optarg, "t"))
+                view_mode = VIEW_TABLE;
+            else if (!strcasecmp(optarg, "STATISTICS") || !strcasecmp(optarg, "STATS") || !strcasecmp(optarg, "s"))
+                view_mode = VIEW_STATS;
+            else {
+                fprintf(stderr, "%s: illegal argument for option `--view'\n", basename(argv[0]));
+                return 1;
+            }
+            break;
+        /* option '--interval=<seconds>' */
+        case 'J':
+            if (iv++) {
+                fprintf(stderr, "%s: duplicated option `--interval'\n", basename(argv[0]));
+                return 1;
+            }
+            if ((sscanf(optarg, "%lu", &interval) != 1) || (interval > 86400UL)) {
+                fprintf(stderr, "%s: illegal argument for option `--interval'\n", basename(argv[0]));
+                return 1;
+            }
+            stats_interval = interval;
+            break;
+        /* option '--bus-load[=<msec>]' */
+        case 'U':
+            if (bl++) {
+                fprintf(stderr, "%s: duplicated option `--bus-load'\n", basename(argv[0]));
+                return 1;
+            }
+            if ((optarg != NULL) &&
+                ((sscanf(optarg, "%lu", &load_interval) != 1) || (load_interval < 10UL) || (load_interval > 3600000UL))) {
+                fprintf(stderr, "%s: illegal argument for option `--bus-load'\n", basename(argv[0]));
+                return 1;
+            }
+            bus_load = 1;
+            break;
+        /* option '--histogram[=<file>]' */
+        case 'G':
+            if (hg++) {
+                fprintf(stderr, "%s: duplicated option `--histogram'\n", basename(argv[0]));
+                return 1;
+            }
+            if ((optarg != NULL) && (*optarg == '\0')) {
+                fprintf(stderr, "%s: illegal argument for option `--histogram'\n", basename(argv[0]));
+                return 1;
+            }
+            hist_file = optarg;
+            histogram = 1;
+            break;
+        /* option '--changes-only[=COUNT]' */
+        case 'C':
+            if (co++) {
+                fprintf(stderr, "%s: duplicated option `--changes-only'\n", basename(argv[0]));
+                return 1;
+            }
+            if (optarg == NULL)
+                changes_only = CHANGES_ONLY;
+            else if (!strcasecmp(optarg, "COUNT") || !strcasecmp(optarg, "c"))
+                changes_only = CHANGES_COUNT;
+            else {
+                fprintf(stderr, "%s: illegal argument for option `--changes-only'\n", basename(argv[0]));
+                return 1;
+            }
+            break;
+        /* option '--trigger=<expr>' */
+        case 'A':
+            if (capture++) {
+                fprintf(stderr, "%s: duplicated option `--trigger'\n", basename(argv[0]));
+                return 1;
+            }
+            if (!flt_compile(&trigger, optarg, &position)) {
+                fprintf(stderr, "%s: illegal argument for option `--trigger' (at `%s')\n", basename(argv[0]), &optarg[position]);
+                return 1;
+            }
+            break;
+        /* option '--pre-trigger=<n>' */
+        case 'H':
+            if (pr++) {
+                fprintf(stderr, "%s: duplicated option `--pre-trigger'\n", basename(argv[0]));
+                return 1;
+            }
+            if ((sscanf(optarg, "%lu", &pre) != 1) || (pre > TRIG_PRE_MAX)) {
+                fprintf(stderr, "%s: illegal argument for option `--pre-trigger'\n", basename(argv[0]));
+                return 1;
+            }
+            break;
+        /* option '--post-trigger=<n>' */
+        case 'X':
+            if (po++) {
+                fprintf(stderr, "%s: duplicated option `--post-trigger'\n", basename(argv[0]));
+                return 1;
+            }
+            if ((sscanf(optarg, "%lu", &post) != 1) || (post > TRIG_POST_MAX)) {
+                fprintf(stderr, "%s: illegal argument for option `--post-trigger'\n", basename(argv[0]));
+                return 1;
+            }
+            break;
+        /* option '--re-arm' */
+        case 'e':
+            if (rearm++) {
+                fprintf(stderr, "%s: duplicated option `--re-arm'\n", basename(argv[0]));
+                return 1;
+            }
+            break;
+        /* option '--recorder=<n>(S|MIN|H|MB|GB)' */
+        case 'r':
+            if (recording++) {
+                fprintf(stderr, "%s: duplicated option `--recorder'\n", basename(argv[0]));
+                return 1;
+            }
+            if ((sscanf(optarg, "%lu%7s", &rec_value, rec_unit) != 2) || (rec_value == 0UL)) {
+                fprintf(stderr, "%s: illegal argument for option `--recorder'\n", basename(argv[0]));
+                return 1;
+            }
+            if (!strcasecmp(rec_unit, "S") || !strcasecmp(rec_unit, "SEC"))
+                dump_window = (uint64_t)rec_value;
+            else if (!strcasecmp(rec_unit, "MIN"))
+                dump_window = (uint64_t)rec_value * 60ull;
+            else if (!strcasecmp(rec_unit, "H"))
+                dump_window = (uint64_t)rec_value * 3600ull;
+            else if ((!strcasecmp(rec_unit, "M") || !strcasecmp(rec_unit, "MB")) && (rec_value <= (UINT64_MAX / 1048576ull)))
+                rec_bytes = (uint64_t)rec_value * 1048576ull;
+            else if ((!strcasecmp(rec_unit, "G") || !strcasecmp(rec_unit, "GB")) && (rec_value <= (UINT64_MAX / 1073741824ull)))
+                rec_bytes = (uint64_t)rec_value * 1073741824ull;
+            else {
+                fprintf(stderr, "%s: illegal argument for option `--recorder'\n", basename(argv[0]));
+                return 1;
+            }
+            if (dump_window > 86400ull) {
+                fprintf(stderr, "%s: illegal argument for option `--recorder'\n", basename(argv[0]));
+                return 1;
+            }
+            break;
+        /* option '--recorder-file=<file>' */
+        case 'f':
+            if (rn++) {
+                fprintf(stderr, "%s: duplicated option `--recorder-file'\n", basename(argv[0]));
+                return 1;
+            }
+            rec_file = optarg;
+            break;
+        /* option '--huge-pages' */
+        case 'g':
+            if (huge++) {
+                fprintf(stderr, "%s: duplicated option `--huge-pages'\n", basename(argv[0]));
+                return 1;
+            }
+            break;
+        /* option '--rate-limit=<fps>[:<id-list>]' and '--decimate=<n>[:<id-list>]' (repeatable) */
+        case 'K':
+        case 'N':
+            if (!rate_limit && !rate_init(&ratelimit)) {
+                fprintf(stderr, "+++ error: rate limiting could not be allocated\n");
+                return 1;
+            }
+            rate_limit = 1;
+            if (!get_rate_limit(optarg, (opt == 'K') ? RATE_TOKEN_BUCKET : RATE_ONE_OF_N)) {
+                fprintf(stderr, "%s: illegal argument for option `--%s'\n", basename(argv[0]), (opt == 'K') ? "rate-limit" : "decimate");
+                return 1;
+            }
+            break;
+        /* option '--queue=<n>' */
+        case 'Q':
+            if (qd++) {
+                fprintf(stderr, "%s: duplicated option `--queue'\n", basename(argv[0]));
+                return 1;
+            }
+            if ((sscanf(optarg, "%lu", &depth) != 1) || (depth < RING_DEPTH_MIN) || (depth > RING_DEPTH_MAX)) {
+                fprintf(stderr, "%s: illegal argument for option `--queue'\n", basename(argv[0]));
+                return 1;
+            }
+            queue_depth = (size_t)depth;
+            break;
+        /* option '--overflow=(BLOCK|DROP-NEWEST|DROP-OLDEST)' */
+        case 'P':
+            if (qp++) {
+                fprintf(stderr, "%s: duplicated option `--overflow'\n", basename(argv[0]));
+                return 1;
+            }
+            if (!strcasecmp(optarg, "BLOCK") || !strcasecmp(optarg, "WAIT") || !strcasecmp(optarg, "b"))
+                queue_policy = RING_BLOCK;
+            else if (!strcasecmp(optarg, "DROP-NEWEST") || !strcasecmp(optarg, "NEWEST") || !strcasecmp(optarg, "n"))
+                queue_policy = RING_DROP_NEWEST;
+            else if (!strcasecmp(optarg, "DROP-OLDEST") || !strcasecmp(optarg, "OLDEST") || !strcasecmp(optarg, "o"))
+                queue_policy = RING_DROP_OLDEST;
+            else {
+                fprintf(stderr, "%s: illegal argument for option `--overflow'\n", basename(argv[0]));
+                return 1;
+            }
+            break;
+        /* option '--reorder=<msec>' */
+        case 'j':
+            if (ro++) {
+                fprintf(stderr, "%s: duplicated option `--reorder'\n", basename(argv[0]));
+                return 1;
+            }
+            if ((sscanf(optarg, "%lu", &window) != 1) || (window > 10000UL)) {
+                fprintf(stderr, "%s: illegal argument for option `--reorder'\n", basename(argv[0]));
+                return 1;
+            }
+            reorder = window;
+            break;
+        /* option '--cpu=<list>' */
+        case 'c':
+            if (cp++) {
+                fprintf(stderr, "%s: duplicated option `--cpu'\n", basename(argv[0]));
+                return 1;
+            }
+            if (!get_id_list(optarg, core_range, NULL)) {
+                fprintf(stderr, "%s: illegal argument for option `--cpu'\n", basename(argv[0]));
                 return 1;
             }
             break;
@@ -596,36 +1154,71 @@ int main(int argc, char *argv[])
             }
         }
     }
-    /* - check if one and only one <interface> is given */
-    if (optind + 1 != argc) {
-        if (optind == argc)
-            fprintf(stderr, "%s: no interface given\n", basename(argv[0]));
-        else
-            fprintf(stderr, "%s: too many arguments given\n", basename(argv[0]));
-        return 1;
-    }
-    /* - first search the <interface> by its name in the device list */
-    for (b = 0; b < PCAN_BOARDS; b++) {
-        if (strcasecmp(argv[optind], can_board[b].name) == 0) {
-            board = can_board[b].type;
-            break;
+    /* - render a capture file (BINARY or COMPRESSED) instead of receiving from an <interface> */
+    if (render_file != NULL) {
+        if (optind != argc) {
+            fprintf(stderr, "%s: option `--render' cannot be used with an <interface>\n", basename(argv[0]));
+            return 1;
         }
-    }
-    /* if not found, search the <interface> by its channel handle in the device list */
-    if (b >= PCAN_BOARDS) {
-        if (sscanf(argv[optind], "%li", &board) != 1) {
-            fprintf(stderr, "%s: illegal argument\n", basename(argv[0]));
+        if ((om && (output_mode != OUTPUT_TEXT)) || sz || st || (io_mode >= 0)) {
+            fprintf(stderr, "%s: option `--render' writes TEXT into stdout or the output file only\n", basename(argv[0]));
+            return 1;
+        }
+        if ((output_file != NULL) && ((output_stream = fopen(output_file, "w")) == NULL)) {
+            fprintf(stderr, "%s: cannot open output file `%s' (%s)\n", basename(argv[0]), output_file, strerror(errno));
             return 1;
         }
+        rc = render(render_file, (output_stream != NULL) ? output_stream : stdout, mode_time, mode_id, mode_data, mode_ascii, follow);
+        if (output_stream != NULL)
+            (void)fclose(output_stream);
+        return rc;
+    }
+    if (follow) {
+        fprintf(stderr, "%s: option `--follow' requires option `--render'\n", basename(argv[0]));
+        return 1;
+    }
+    /* - check if at least one <interface> is given (several ones are merged) */
+    if (optind == argc) {
+        fprintf(stderr, "%s: no interface given\n", basename(argv[0]));
+        return 1;
+    }
+    if ((argc - optind) > PCAN_BOARDS) {
+        fprintf(stderr, "%s: too many arguments given\n", basename(argv[0]));
+        return 1;
+    }
+    for (n = optind; n < argc; n++) {
+        /* - first search the <interface> by its name in the device list */
         for (b = 0; b < PCAN_BOARDS; b++) {
-            if (board == (long)can_board[b].type)
+            if (strcasecmp(argv[n], can_board[b].name) == 0) {
+                board = can_board[b].type;
                 break;
+            }
         }
+        /* if not found, search the <interface> by its channel handle in the device list */
         if (b >= PCAN_BOARDS) {
-            fprintf(stderr, "%s: illegal argument\n", basename(argv[0]));
-            return 1;
+            if (sscanf(argv[n], "%li", &board) != 1) {
+                fprintf(stderr, "%s: illegal argument\n", basename(argv[0]));
+                return 1;
+            }
+            for (b = 0; b < PCAN_BOARDS; b++) {
+                if (board == (long)can_board[b].type)
+                    break;
+            }
+            if (b >= PCAN_BOARDS) {
+                fprintf(stderr, "%s: illegal argument\n", basename(argv[0]));
+                return 1;
+            }
+        }
+        /* - check if the <interface> is given twice */
+        for (i = 0; i < interfaces; i++) {
+            if (boards[i] == b) {
+                fprintf(stderr, "%s: duplicated interface `%s'\n", basename(argv[0]), can_board[b].name);
+                return 1;
+            }
         }
+        boards[interfaces++] = b;
     }
+    merging = (interfaces > 1) ? 1 : 0;
     /* - check if a bit-rate string is given for CAN FD mode */
     if ((op_mode & PCAN_MESSAGE_FD) && (bitrate == NULL)) {
         fprintf(stderr, "%s: illegal combination of options `--mode' (m) and `--baudrate' (b)\n", basename(argv[0]));
@@ -636,6 +1229,103 @@ int main(int argc, char *argv[])
         fprintf(stderr, "%s: illegal combination of options `--mode' (m) and `--bitrate'\n", basename(argv[0]));
         return 1;
     }
+    /* - check if the table view or the statistics are combined with another output format */
+    if ((view_mode != VIEW_LIST) && (output_mode != OUTPUT_TEXT)) {
+        fprintf(stderr, "%s: illegal combination of options `--view' and `--output'\n", basename(argv[0]));
+        return 1;
+    }
+    /* - check if an interval is given without the statistics */
+    if (iv && (view_mode != VIEW_STATS)) {
+        fprintf(stderr, "%s: option `--interval' requires option `--view=STATS'\n", basename(argv[0]));
+        return 1;
+    }
+    /* - check if changes-only is requested in a table or statistics view */
+    if (changes_only && (view_mode != VIEW_LIST)) {
+        fprintf(stderr, "%s: option `--changes-only' requires option `--view=LIST'\n", basename(argv[0]));
+        return 1;
+    }
+    /* - check if a trigger capture is requested in a table or statistics view */
+    if (capture && (view_mode != VIEW_LIST)) {
+        fprintf(stderr, "%s: option `--trigger' requires option `--view=LIST'\n", basename(argv[0]));
+        return 1;
+    }
+    /* - check if the repeats are requested for a trigger capture (unknown for the pre-trigger frames) */
+    if (capture && (changes_only == CHANGES_COUNT)) {
+        fprintf(stderr, "%s: illegal combination of options `--trigger' and `--changes-only=COUNT'\n", basename(argv[0]));
+        return 1;
+    }
+    /* - check if the trigger windows are given without a trigger */
+    if ((pr || po || rearm) && !capture) {
+        fprintf(stderr, "%s: option `--%s' requires option `--trigger'\n", basename(argv[0]), pr ? "pre-trigger" : po ? "post-trigger" : "re-arm");
+        return 1;
+    }
+    /* - check if the flight recorder is requested in a table or statistics view, or with a trigger capture */
+    if (recording && ((view_mode != VIEW_LIST) || capture || (changes_only == CHANGES_COUNT))) {
+        fprintf(stderr, "%s: option `--recorder' requires option `--view=LIST' (and no trigger, no repeats)\n", basename(argv[0]));
+        return 1;
+    }
+    /* - check if the options of the flight recorder are given without it */
+    if ((rn || huge) && !recording) {
+        fprintf(stderr, "%s: option `--%s' requires option `--recorder'\n", basename(argv[0]), rn ? "recorder-file" : "huge-pages");
+        return 1;
+    }
+    /* - check if several interfaces are merged into binary records (w/o interface), a flight recorder or a bus load */
+    if (merging && (bus_load || recording || (output_mode == OUTPUT_BINARY) || (output_mode == OUTPUT_PACKED))) {
+        fprintf(stderr, "%s: option `--%s' requires one interface\n", basename(argv[0]),
+                bus_load ? "bus-load" : recording ? "recorder" : "output");
+        return 1;
+    }
+    /* - check if a reorder window is given for one interface */
+    if (ro && !merging) {
+        fprintf(stderr, "%s: option `--reorder' requires several interfaces\n", basename(argv[0]));
+        return 1;
+    }
+    /* - check if segments are requested without an output file */
+    if ((sz || st) && ((output_file == NULL) || (view_mode != VIEW_LIST))) {
+        fprintf(stderr, "%s: option `--segment-%s' requires option `--output-file' (and no table view)\n", basename(argv[0]), sz ? "size" : "time");
+        return 1;
+    }
+    /* - check if asynchronous writes are requested without an output file */
+    if ((io_mode >= 0) && ((output_file == NULL) || (view_mode != VIEW_LIST) || (output_mode == OUTPUT_PACKED))) {
+        fprintf(stderr, "%s: option `--io' requires option `--output-file' (and no table view, no compressed output)\n", basename(argv[0]));
+        return 1;
+    }
+    /* - derive the acceptance filter from the include set (w/o bus load, it needs all frames) */
+    if (!bus_load) {
+        if (!sc && !sm)
+            std_auto = get_acceptance(&std_cover, MASK_11BIT);
+        if (!xc && !xm)
+            xtd_auto = get_acceptance(&xtd_cover, MASK_29BIT);
+    }
+    /* - open the output stream for the CAN messages (text or binary records) */
+    output_stream = stdout;
+    if ((output_file != NULL) && (sz || st)) {
+        if (!seg_init(&segment, output_file, ((output_mode == OUTPUT_BINARY) || (output_mode == OUTPUT_PACKED)) ? "wb" : "w",
+                      (uint64_t)seg_size * 1048576ull, (uint64_t)seg_time)) {
+            fprintf(stderr, "%s: cannot open output file `%s' (%s)\n", basename(argv[0]), output_file, strerror(errno));
+            return 1;
+        }
+        output_stream = segment.stream;
+        segmented = 1;
+    }
+    else if (output_file != NULL) {
+        if ((output_stream = fopen(output_file, ((output_mode == OUTPUT_BINARY) || (output_mode == OUTPUT_PACKED)) ? "wb" : "w")) == NULL) {
+            fprintf(stderr, "%s: cannot open output file `%s' (%s)\n", basename(argv[0]), output_file, strerror(errno));
+            return 1;
+        }
+    }
+    else if (output_mode != OUTPUT_TEXT) {
+        if (((output_mode == OUTPUT_BINARY) || (output_mode == OUTPUT_PACKED)) && isatty(STDOUT_FILENO)) {
+            fprintf(stderr, "%s: binary output to a terminal (use `--output-file' or a redirection)\n", basename(argv[0]));
+            return 1;
+        }
+        /* note: the records resp. the log-file get the original stdout, everything else goes to stderr */
+        if (((fdes = dup(STDOUT_FILENO)) < 0) || (dup2(STDERR_FILENO, STDOUT_FILENO) < 0) ||
+            ((output_stream = fdopen(fdes, "wb")) == NULL)) {
+            perror("+++ error");
+            return errno;
+        }
+    }
     /* CAN Monitor for PCAN-USB Interfaces */
     fprintf(stdout, "%s\n%s\n\n%s\n\n", APPLICATION, COPYRIGHT, WARRANTY);
     /* - show operation mode and bit-rate settings */
@@ -667,125 +1357,284 @@ int main(int argc, char *argv[])
                     baudrate == PCAN_BAUD_10K  ?   "10" : "?", baudrate);
         }
     }
-    /* - initialization */
-    fprintf(stdout, "Hardware=%s...", can_board[b].name);
-    fflush (stdout);
-    channel = (TPCANHandle)can_board[b].type;
-    if ((status = CAN_SetValue(channel, PCAN_LISTEN_ONLY, (void*)&listenonly, sizeof(listenonly))) != PCAN_ERROR_OK) {
-        fprintf(stdout, "FAILED!\n");
-        fprintf(stderr, "+++ error: CAN_SetValue PCAN-USB%u (PCAN_LISTEN_ONLY=%u) returned 0x%X\n", (channel - 0x50), listenonly, status);
-        return (int)status;;
-    }
-    if (!(op_mode & PCAN_MESSAGE_FD)) {
-        if ((status = CAN_Initialize(channel, (TPCANBaudrate)baudrate, PCAN_USB, 0, 0)) != PCAN_ERROR_OK) {
+    /* - initialization (of each interface) */
+    for (n = 0; n < interfaces; n++) {
+        b = boards[n];
+        fprintf(stdout, "Hardware=%s...", can_board[b].name);
+        fflush (stdout);
+        channel = (TPCANHandle)can_board[b].type;
+        if ((status = CAN_SetValue(channel, PCAN_LISTEN_ONLY, (void*)&listenonly, sizeof(listenonly))) != PCAN_ERROR_OK) {
             fprintf(stdout, "FAILED!\n");
-            fprintf(stderr, "+++ error: CAN_Initialize PCAN-USB%u returned 0x%X\n", (channel - 0x50), status);
+            fprintf(stderr, "+++ error: CAN_SetValue PCAN-USB%u (PCAN_LISTEN_ONLY=%u) returned 0x%X\n", (channel - 0x50), listenonly, status);
+            release_interfaces(n);
             return (int)status;;
         }
-        fprintf(stdout, "OK!\nBaudrate=%lukbps...",
-            btr_calc_bit_rate_sja1000((unsigned short)baudrate) / 1000);
-    }
-    else {
-        if (!btr_string_to_bit_timing(bitrate, &freq, &slow, &fast)) {
-            fprintf(stdout, "FAILED!\n");
-            fprintf(stderr, "+++ error: CAN_InitializeFD PCAN-USB%u with wrong bit-rate\n", (channel - 0x50));
-            return (int)-1;
+        if (!(op_mode & PCAN_MESSAGE_FD)) {
+            if ((status = CAN_Initialize(channel, (TPCANBaudrate)baudrate, PCAN_USB, 0, 0)) != PCAN_ERROR_OK) {
+                fprintf(stdout, "FAILED!\n");
+                fprintf(stderr, "+++ error: CAN_Initialize PCAN-USB%u returned 0x%X\n", (channel - 0x50), status);
+                release_interfaces(n);
+                return (int)status;;
+            }
+            fprintf(stdout, "OK!\nBaudrate=%lukbps...",
+                btr_calc_bit_rate_sja1000((unsigned short)baudrate) / 1000);
+            nominal = btr_calc_bit_rate_sja1000((unsigned short)baudrate);
         }
-        if ((status = CAN_InitializeFD(channel, bitrate)) != PCAN_ERROR_OK) {
-            fprintf(stdout, "FAILED!\n");
-            fprintf(stderr, "+++ error: CAN_InitializeFD PCAN-USB%u returned 0x%X\n", (channel - 0x50), status);
-            return (int)status;;
+        else {
+            if (!btr_string_to_bit_timing(bitrate, &freq, &slow, &fast)) {
+                fprintf(stdout, "FAILED!\n");
+                fprintf(stderr, "+++ error: CAN_InitializeFD PCAN-USB%u with wrong bit-rate\n", (channel - 0x50));
+                release_interfaces(n);
+                return (int)-1;
+            }
+            if ((status = CAN_InitializeFD(channel, bitrate)) != PCAN_ERROR_OK) {
+                fprintf(stdout, "FAILED!\n");
+                fprintf(stderr, "+++ error: CAN_InitializeFD PCAN-USB%u returned 0x%X\n", (channel - 0x50), status);
+                release_interfaces(n);
+                return (int)status;;
+            }
+            fprintf(stdout, "OK!\nBit-rate=%lukbps",
+                btr_calc_bit_rate_nominal(&slow, freq) / 1000);
+            if ((op_mode & PCAN_MESSAGE_BRS))
+                fprintf(stdout, ":%lukbps",
+                    btr_calc_bit_rate_data(&fast, freq) / 1000);
+            nominal = btr_calc_bit_rate_nominal(&slow, freq);
+            if ((op_mode & PCAN_MESSAGE_BRS))
+                data_phase = btr_calc_bit_rate_data(&fast, freq);
+            fprintf(stdout, "...");
         }
-        fprintf(stdout, "OK!\nBit-rate=%lukbps",
-            btr_calc_bit_rate_nominal(&slow, freq) / 1000);
-        if ((op_mode & PCAN_MESSAGE_BRS))
-            fprintf(stdout, ":%lukbps",
-                btr_calc_bit_rate_data(&fast, freq) / 1000);
-        fprintf(stdout, "...");
-    }
-    if ((status = CAN_SetValue(channel, PCAN_ALLOW_STATUS_FRAMES, (void*)&allow_sts, sizeof(allow_sts))) != PCAN_ERROR_OK) {
-        fprintf(stdout, "FAILED!\n");
-        fprintf(stderr, "+++ error: CAN_SetValue PCAN-USB%u (PCAN_ALLOW_STATUS_FRAMES=%u) returned 0x%X\n", (channel - 0x50), allow_sts, status);
-        (void)CAN_Uninitialize(channel);
-        return (int)status;;
-    }
-    if ((status = CAN_SetValue(channel, PCAN_ALLOW_RTR_FRAMES, (void*)&allow_rtr, sizeof(allow_rtr))) != PCAN_ERROR_OK) {
-        fprintf(stdout, "FAILED!\n");
-        fprintf(stderr, "+++ error: CAN_SetValue PCAN-USB%u (PCAN_ALLOW_RTR_FRAMES=%u) returned 0x%X\n", (channel - 0x50), allow_rtr, status);
-        (void)CAN_Uninitialize(channel);
-        return (int)status;;
-    }
-    if ((std_code != CODE_11BIT) || (std_mask != MASK_11BIT)) {
-        filter = ((UINT64)std_code << 32) | (UINT64)std_mask;
-        if ((status = CAN_SetValue(channel, PCAN_ACCEPTANCE_FILTER_11BIT, (void*)&filter, sizeof(filter))) != PCAN_ERROR_OK) {
+        if ((status = CAN_SetValue(channel, PCAN_ALLOW_STATUS_FRAMES, (void*)&allow_sts, sizeof(allow_sts))) != PCAN_ERROR_OK) {
             fprintf(stdout, "FAILED!\n");
-            fprintf(stderr, "+++ error: CAN_SetValue PCAN-USB%u (PCAN_ACCEPTANCE_FILTER_11BIT=%"PRIX64") returned 0x%X\n", (channel - 0x50), filter, status);
-            (void)CAN_Uninitialize(channel);
+            fprintf(stderr, "+++ error: CAN_SetValue PCAN-USB%u (PCAN_ALLOW_STATUS_FRAMES=%u) returned 0x%X\n", (channel - 0x50), allow_sts, status);
+            release_interfaces(n + 1);
             return (int)status;;
         }
-    }
-    if ((xtd_code != CODE_29BIT) || (xtd_mask != MASK_29BIT)) {
-        filter = ((UINT64)xtd_code << 32) | (UINT64)xtd_mask;
-        if ((status = CAN_SetValue(channel, PCAN_ACCEPTANCE_FILTER_29BIT, (void*)&filter, sizeof(filter))) != PCAN_ERROR_OK) {
+        if ((status = CAN_SetValue(channel, PCAN_ALLOW_RTR_FRAMES, (void*)&allow_rtr, sizeof(allow_rtr))) != PCAN_ERROR_OK) {
             fprintf(stdout, "FAILED!\n");
-            fprintf(stderr, "+++ error: CAN_SetValue PCAN-USB%u (PCAN_ACCEPTANCE_FILTER_29BIT=%"PRIX64") returned 0x%X\n", (channel - 0x50), filter, status);
-            (void)CAN_Uninitialize(channel);
+            fprintf(stderr, "+++ error: CAN_SetValue PCAN-USB%u (PCAN_ALLOW_RTR_FRAMES=%u) returned 0x%X\n", (channel - 0x50), allow_rtr, status);
+            release_interfaces(n + 1);
             return (int)status;;
         }
-    }
-    if (trace != PCAN_PARAMETER_OFF) {
-        if (getcwd((char*)buffer, 256) == NULL) {
-            fprintf(stdout, "FAILED!\n");
-            perror("+++ error");
-            (void)CAN_Uninitialize(channel);
-            return (int)status;;
+        if ((std_code != CODE_11BIT) || (std_mask != MASK_11BIT)) {
+            filter = ((UINT64)std_code << 32) | (UINT64)std_mask;
+            if ((status = CAN_SetValue(channel, PCAN_ACCEPTANCE_FILTER_11BIT, (void*)&filter, sizeof(filter))) != PCAN_ERROR_OK) {
+                fprintf(stdout, "FAILED!\n");
+                fprintf(stderr, "+++ error: CAN_SetValue PCAN-USB%u (PCAN_ACCEPTANCE_FILTER_11BIT=%"PRIX64") returned 0x%X\n", (channel - 0x50), filter, status);
+                release_interfaces(n + 1);
+                return (int)status;;
+            }
         }
-        if ((status = CAN_SetValue(channel, PCAN_TRACE_LOCATION, (void*)buffer, 256U)) != PCAN_ERROR_OK) {
-            fprintf(stdout, "FAILED!\n");
-            fprintf(stderr, "+++ error: CAN_SetValue PCAN-USB%u (PCAN_TRACE_LOCATION=%s) returned 0x%X\n", (channel - 0x50), (char*)buffer, status);
-            (void)CAN_Uninitialize(channel);
-            return (int)status;;
+        if ((xtd_code != CODE_29BIT) || (xtd_mask != MASK_29BIT)) {
+            filter = ((UINT64)xtd_code << 32) | (UINT64)xtd_mask;
+            if ((status = CAN_SetValue(channel, PCAN_ACCEPTANCE_FILTER_29BIT, (void*)&filter, sizeof(filter))) != PCAN_ERROR_OK) {
+                fprintf(stdout, "FAILED!\n");
+                fprintf(stderr, "+++ error: CAN_SetValue PCAN-USB%u (PCAN_ACCEPTANCE_FILTER_29BIT=%"PRIX64") returned 0x%X\n", (channel - 0x50), filter, status);
+                release_interfaces(n + 1);
+                return (int)status;;
+            }
         }
-        buffer[0] = TRACE_FILE_SINGLE | TRACE_FILE_DATE | TRACE_FILE_TIME | TRACE_FILE_OVERWRITE;
-        if ((status = CAN_SetValue(channel, PCAN_TRACE_CONFIGURE, (void*)&buffer[0], sizeof(BYTE))) != PCAN_ERROR_OK) {
+        if ((std_auto || xtd_auto) &&
+            ((status = idset_acceptance(channel, std_auto ? &std_cover : NULL, xtd_auto ? &xtd_cover : NULL)) != PCAN_ERROR_OK)) {
             fprintf(stdout, "FAILED!\n");
-            fprintf(stderr, "+++ error: CAN_SetValue PCAN-USB%u (PCAN_TRACE_CONFIGURE=%X) returned 0x%X\n", (channel - 0x50), buffer[0], status);
-            (void)CAN_Uninitialize(channel);
+            fprintf(stderr, "+++ error: acceptance filter of PCAN-USB%u returned 0x%X\n", (channel - 0x50), status);
+            release_interfaces(n + 1);
             return (int)status;;
         }
-        if ((status = CAN_SetValue(channel, PCAN_TRACE_STATUS, (void*)&trace, sizeof(trace))) != PCAN_ERROR_OK) {
-            fprintf(stdout, "FAILED!\n");
-            fprintf(stderr, "+++ error: CAN_SetValue PCAN-USB%u (PCAN_TRACE_STATUS=%X) returned 0x%u\n", (channel - 0x50), trace, status);
-            (void)CAN_Uninitialize(channel);
-            return (int)status;;
+        if (trace != PCAN_PARAMETER_OFF) {
+            if (getcwd((char*)buffer, 256) == NULL) {
+                fprintf(stdout, "FAILED!\n");
+                perror("+++ error");
+                release_interfaces(n + 1);
+                return (int)status;;
+            }
+            if ((status = CAN_SetValue(channel, PCAN_TRACE_LOCATION, (void*)buffer, 256U)) != PCAN_ERROR_OK) {
+                fprintf(stdout, "FAILED!\n");
+                fprintf(stderr, "+++ error: CAN_SetValue PCAN-USB%u (PCAN_TRACE_LOCATION=%s) returned 0x%X\n", (channel - 0x50), (char*)buffer, status);
+                release_interfaces(n + 1);
+                return (int)status;;
+            }
+            buffer[0] = TRACE_FILE_SINGLE | TRACE_FILE_DATE | TRACE_FILE_TIME | TRACE_FILE_OVERWRITE;
+            if ((status = CAN_SetValue(channel, PCAN_TRACE_CONFIGURE, (void*)&buffer[0], sizeof(BYTE))) != PCAN_ERROR_OK) {
+                fprintf(stdout, "FAILED!\n");
+                fprintf(stderr, "+++ error: CAN_SetValue PCAN-USB%u (PCAN_TRACE_CONFIGURE=%X) returned 0x%X\n", (channel - 0x50), buffer[0], status);
+                release_interfaces(n + 1);
+                return (int)status;;
+            }
+            if ((status = CAN_SetValue(channel, PCAN_TRACE_STATUS, (void*)&trace, sizeof(trace))) != PCAN_ERROR_OK) {
+                fprintf(stdout, "FAILED!\n");
+                fprintf(stderr, "+++ error: CAN_SetValue PCAN-USB%u (PCAN_TRACE_STATUS=%X) returned 0x%u\n", (channel - 0x50), trace, status);
+                release_interfaces(n + 1);
+                return (int)status;;
+            }
+        }
+        fprintf(stdout, "OK!\n");
+    }
+    if (std_auto)
+        idset_print_acceptance(stdout, &std_cover, MASK_11BIT);
+    if (xtd_auto)
+        idset_print_acceptance(stdout, &xtd_cover, MASK_29BIT);
+    /* - bus load (from the bit-rate settings) */
+    if (bus_load && !load_init(&busload, nominal, data_phase, load_interval)) {
+        fprintf(stderr, "+++ error: bus load could not be computed (bit-rate unknown)\n");
+        release_interfaces(interfaces);
+        return 1;
+    }
+    /* - histograms of inter-arrival times (preallocated) */
+    if (histogram && !hist_init(&hist)) {
+        fprintf(stderr, "+++ error: histograms could not be allocated\n");
+        release_interfaces(interfaces);
+        return 1;
+    }
+    /* - ring of the frames before the trigger (preallocated) */
+    if (capture && !trig_init(&trig, sizeof(struct frame), (size_t)pre, (uint64_t)post, rearm)) {
+        fprintf(stderr, "+++ error: trigger capture could not be allocated\n");
+        release_interfaces(interfaces);
+        return 1;
+    }
+    /* - ring of the last n seconds resp. bytes (preallocated, dumped in the background) */
+    if (recording) {
+        struct fr_writer writer = { dump_begin, dump_frame, dump_end, NULL };
+
+        /* note: sized for the highest frame rate when given as time */
+        if (dump_window && (nominal < FRAME_BITS)) {
+            fprintf(stderr, "+++ error: flight recorder could not be sized (bit-rate unknown)\n");
+            release_interfaces(interfaces);
+            return 1;
+        }
+        rec_frames = dump_window ? (dump_window * (uint64_t)(nominal / FRAME_BITS)) : (rec_bytes / sizeof(struct frame));
+        /* note: the ring is mapped and touched at start-up, so it is limited by the physical memory */
+        if (rec_frames > (uint64_t)fr_max_depth(sizeof(struct frame))) {
+            fprintf(stderr, "+++ error: flight recorder of %" PRIu64 " frame(s) (%.1f MB) exceeds the limit of %.1f MB (1/%i of the RAM)\n",
+                    rec_frames, ((double)rec_frames * (double)sizeof(struct frame)) / 1048576.,
+                    ((double)fr_max_depth(sizeof(struct frame)) * (double)sizeof(struct frame)) / 1048576., FR_MEMORY_SHARE);
+            release_interfaces(interfaces);
+            return 1;
+        }
+        depth = (unsigned long)rec_frames;
+        rec_header_init(&dump_header, (op_mode & PCAN_MESSAGE_FD) ? 1 : 0);
+        /* note: the stream of the dump buffer is set per dump */
+        if ((depth == 0UL) || !msg_buffer_init(&dump_buffer, stdout, MSG_BUFFER_SIZE, MSG_FLUSH_FULL, 0UL) ||
+            !fr_init(&recorder, sizeof(struct frame), (size_t)depth, huge, rec_file, &writer)) {
+            fprintf(stderr, "+++ error: flight recorder could not be allocated\n");
+            release_interfaces(interfaces);
+            return 1;
         }
+        dump_window *= 1000000ull;
+        fprintf(stdout, "Flight recorder: %lu frame(s), %.1f MB (%s), dumped into `%s' on SIGUSR2\n", depth,
+                (double)recorder.length / 1048576., (recorder.pages == FR_PAGES_HUGE) ? "huge pages" :
+                (recorder.pages == FR_PAGES_THP) ? "transparent huge pages" : "normal pages", rec_file);
+    }
+    /* - last payload per CAN-ID (changes only) */
+    if (changes_only && !chg_init(&changes)) {
+        fprintf(stderr, "+++ error: payload table could not be allocated\n");
+        release_interfaces(interfaces);
+        return 1;
     }
-    fprintf(stdout, "OK!\n");
     /* - reception loop */
     fprintf(stderr, "\nPress ^C to abort.\n\n");
-    if (!(op_mode & PCAN_MESSAGE_FD))
-        (void)receive(channel, mode_time, mode_id, mode_data, mode_ascii);
-    else
-        (void)receive_fd(channel, mode_time, mode_id, mode_data, mode_ascii);
-    /* - teardown */
-    if (CAN_GetValue(channel, PCAN_HARDWARE_NAME, buffer, 256) == PCAN_ERROR_OK) {
-        fprintf(stdout, "Hardware: %s", buffer);
-        if (CAN_GetValue(channel, PCAN_DEVICE_ID, (void*)&device_id, sizeof(DWORD)) == PCAN_ERROR_OK)
-            fprintf(stdout, " (DeviceId=0x%02"PRIx32")", device_id);
-        fprintf(stdout, "\n");
+    (void)receive((op_mode & PCAN_MESSAGE_FD) ? 1 : 0, mode_time, mode_id, mode_data, mode_ascii);
+    if (io_mode >= 0)
+        wrq_exit(&wqueue);
+    if (segmented)
+        seg_exit(&segment);
+    else if (output_stream != stdout)
+        (void)fclose(output_stream);
+    for (n = 0; n < interfaces; n++) {
+        dropped_newest += queues[n].dropped_newest;
+        dropped_oldest += queues[n].dropped_oldest;
+        blocked += queues[n].blocked;
     }
-    if (CAN_GetValue(channel, PCAN_CHANNEL_VERSION, buffer, 256) == PCAN_ERROR_OK) {
-        fprintf(stdout, "Firmware: %s\n", buffer);
+    if (dropped_newest || dropped_oldest || (verbose && blocked)) {
+        fprintf(stdout, "Receive queue: %" PRIu64 " newest frame(s) dropped, %" PRIu64 " oldest frame(s) dropped, reader blocked %" PRIu64 " time(s)\n",
+                dropped_newest, dropped_oldest, blocked);
     }
-    if (CAN_GetValue(channel, PCAN_API_VERSION, buffer, 256) == PCAN_ERROR_OK) {
-        fprintf(stdout, "Software: API Version %s\n", buffer);
+    if (merging) {
+        fprintf(stdout, "Merge: %" PRIu64 " frame(s) of %i interfaces, %" PRIu64 " out of order, %" PRIu64 " before the reorder window of %lums (buffer full)\n",
+                merge.merged, interfaces, merge.late, merge.forced, reorder);
     }
-    if ((status = CAN_Uninitialize(channel)) != PCAN_ERROR_OK) {
-        fprintf(stderr, "+++ error: CAN_Uninitialize PCAN-USB%u returned 0x%X\n", (channel - 0x50), status);
-        return (int)status;;
+    for (n = 0; n < interfaces; n++) {
+        rx_frames += readers[n].frames;
+        rx_passed += readers[n].passed;
+        if (verbose && (merging || pinning)) {
+            fprintf(stdout, "Reader thread: %s, %" PRIu64 " frame(s) received", can_board[boards[n]].name, readers[n].frames);
+            if (readers[n].core >= 0)
+                fprintf(stdout, " (core %i)", readers[n].core);
+            fprintf(stdout, "\n");
+        }
     }
-    fprintf(stdout, "%s\n", COPYRIGHT);
-    return 0;
+    if (segmented && verbose) {
+        fprintf(stdout, "Output file: %" PRIu64 " segment(s)\n", segment.segments);
+    }
+    if (bus_load) {
+        (void)load_report(&busload, stdout);
+    }
+    if (histogram) {
+        (void)hist_report(&hist, stdout, mode_id);
+        if (hist_file && !export_histograms())
+            fprintf(stderr, "+++ error: histograms could not be written to `%s'\n", hist_file);
+        hist_exit(&hist);
+    }
+    if (rate_limit) {
+        (void)rate_report(&ratelimit, stdout);
+        rate_exit(&ratelimit);
+    }
+    if (changes_only) {
+        fprintf(stdout, "Changes only: %" PRIu64 " of %" PRIu64 " frame(s) suppressed\n", changes.suppressed, changes.frames);
+        chg_exit(&changes);
+    }
+    if (capture) {
+        fprintf(stdout, "Trigger capture: %" PRIu64 " trigger(s), %" PRIu64 " of %" PRIu64 " frame(s) written\n", trig.triggers, trig.written, trig.frames);
+        trig_exit(&trig);
+    }
+    if (recording) {
+        fr_exit(&recorder);
+        fprintf(stdout, "Flight recorder: %" PRIu64 " frame(s) recorded, %" PRIu64 " dump(s) with %" PRIu64 " frame(s) written, %" PRIu64 " frame(s) lost\n",
+                recorder.recorded, recorder.dumps, dump_written, recorder.lost);
+        if (recorder.errors || recorder.rejected)
+            fprintf(stdout, "Flight recorder: %" PRIu64 " dump(s) failed, %" PRIu64 " request(s) while busy\n", recorder.errors, recorder.rejected);
+        msg_buffer_exit(&dump_buffer);
+    }
+    if (std_auto || xtd_auto) {
+        fprintf(stdout, "Software filter: %" PRIu64 " of %" PRIu64 " frame(s) rejected (passed by the acceptance filter)\n", rx_frames - rx_passed, rx_frames);
+    }
+    if ((io_mode >= 0) && (wqueue.errors || verbose)) {
+        fprintf(stdout, "Write queue: %" PRIu64 " buffer(s) written by %s%s%s, %" PRIu64 " stall(s), %" PRIu64 " error(s)\n",
+                wqueue.writes, (wqueue.backend == WRQ_URING) ? "io_uring" : "writer thread",
+                wqueue.fixed ? " (registered buffers)" : "", wqueue.sqpoll ? " (SQPOLL)" : "",
+                wqueue.stalls, wqueue.errors);
+    }
+    if ((output_mode == OUTPUT_PACKED) && verbose) {
+        fprintf(stdout, "Compression: %" PRIu64 " frame(s) in %" PRIu64 " byte(s) (%.1f byte(s) per frame)\n",
+                packer.frames, packer.bytes, packer.frames ? (double)packer.bytes / (double)packer.frames : 0.0);
+    }
+    /* - teardown */
+    idset_exit(&exclusion);
+    for (n = 0; n < interfaces; n++) {
+        channel = (TPCANHandle)can_board[boards[n]].type;
+        if (CAN_GetValue(channel, PCAN_HARDWARE_NAME, buffer, 256) == PCAN_ERROR_OK) {
+            fprintf(stdout, "Hardware: %s", buffer);
+            if (CAN_GetValue(channel, PCAN_DEVICE_ID, (void*)&device_id, sizeof(DWORD)) == PCAN_ERROR_OK)
+                fprintf(stdout, " (DeviceId=0x%02"PRIx32")", device_id);
+            fprintf(stdout, "\n");
+        }
+        if (CAN_GetValue(channel, PCAN_CHANNEL_VERSION, buffer, 256) == PCAN_ERROR_OK) {
+            fprintf(stdout, "Firmware: %s\n", buffer);
+        }
+    }
+    if (CAN_GetValue(channel, PCAN_API_VERSION, buffer, 256) == PCAN_ERROR_OK) {
+        fprintf(stdout, "Software: API Version %s\n", buffer);
+    }
+    for (n = 0, rc = 0; n < interfaces; n++) {
+        channel = (TPCANHandle)can_board[boards[n]].type;
+        if ((status = CAN_Uninitialize(channel)) != PCAN_ERROR_OK) {
+            fprintf(stderr, "+++ error: CAN_Uninitialize PCAN-USB%u returned 0x%X\n", (channel - 0x50), status);
+            rc = (int)status;
+        }
+    }
+    if (rc != 0)
+        return rc;
+    fprintf(stdout, "%s\n", COPYRIGHT);
+    return 0;
 }
 
 /*  -----------  local functions  ----------------------------------------
@@ -868,261 +1717,881 @@ static int list_bitrates(BYTE op_mode)
     }
 }
 
-static uint64_t receive(TPCANHandle channel, int mode_time, int mode_id, int mode_data, int mode_ascii)
+static uint64_t receive(int canfd, int mode_time, int mode_id, int mode_data, int mode_ascii)
 {
-    TPCANStatus status;
-    TPCANMsg message;
-    TPCANTimestamp timestamp;
+    struct frame frame;
+    pthread_t threads[PCAN_BOARDS];
+    sigset_t sigset, oldset;
 
     uint64_t frames = 0;
-    uint64_t msec;
-    struct msg_timestamp ts;
-    unsigned char len, row, col, end, idx;
+    uint64_t repeats = 0;
+    struct msg_format format;
+    struct msg_buffer output;
+    struct rec_header header;
+    struct msg_table table;
+    struct log_writer writer;
+    time_t due = 0;
+    size_t pending = 1;
+    unsigned int delay;
+    int closed, popped, match, rc, n;
+    int bus = 0;
 
-#ifdef BLOCKING_READ
-    int fdes = -1;
-
-    if ((status = CAN_GetValue(channel, PCAN_RECEIVE_EVENT, &fdes, sizeof(int))) != PCAN_ERROR_OK) {
-        fprintf(stderr, "+++ error: CAN_GetValue PCAN_RECEIVE_EVENT returned 0x%X\n", status);
+    for (n = 0; n < interfaces; n++) {
+        if (!ring_init(&queues[n], queue_depth, sizeof(struct frame), queue_policy)) {
+            fprintf(stderr, "+++ error: receive queue could not be allocated\n");
+            release_queues(n);
+            return 0;
+        }
+    }
+    /* several interfaces: the receive queues are merged by the time-stamps of the frames */
+    /* note: the readers wake up the output thread by the first queue (one wait for all) */
+    if (merging && (!ring_group(queues, interfaces) || !mrg_init(&merge, interfaces, sizeof(struct frame), MERGE_DEPTH, (uint64_t)reorder * 1000ull))) {
+        fprintf(stderr, "+++ error: reorder buffer could not be allocated\n");
+        release_queues(interfaces);
         return 0;
     }
-    fd_set rdfs;
-    FD_ZERO(&rdfs);
-    FD_SET(fdes, &rdfs);
-#endif
-    while (running) {
-        if ((status = CAN_Read(channel, &message, &timestamp)) == PCAN_ERROR_OK) {
-            if (!(message.MSGTYPE & PCAN_MESSAGE_STATUS)) {
-                if (((message.ID < MAX_ID) && can_id[message.ID]) || ((message.ID >= MAX_ID) && can_id_xtd)) {
-                    fprintf(stdout, "%-7" PRIu64 " ", frames++);
-                    /* --- CAN 2. 0 time-stamp --- */
-                    msec = ((unsigned long long)timestamp.millis_overflow << 32) + (unsigned long long)timestamp.millis;
-                    ts.tv_sec = (long)(msec / 1000ull);
-                    ts.tv_usec = (((long)(msec % 1000ull)) * 1000L) + (long)timestamp.micros;
-                    /* --- output time-stamp --- */
-                    msg_print_time(stdout, (struct msg_timestamp*)&ts, mode_time);
-                    msg_print_id(stdout, message.ID, (message.MSGTYPE & PCAN_MESSAGE_RTR), (message.MSGTYPE & PCAN_MESSAGE_EXTENDED),
-                                         message.LEN, mode_id);
-                    if (!(message.MSGTYPE & PCAN_MESSAGE_RTR)) {
-                        len = message.LEN;
-                        if (mode_ascii) {
-                            row = 0;
-                            while ((row * 8) < len) {
-                                end = len - (row * 8);
-                                if (end >= 8)
-                                    end = 8;
-                                // data and space
-                                for (col = 0, idx = (row *8); col < end; col++, idx++)
-                                    msg_print_data(stdout, message.DATA[idx], ((col + 1) == 8), mode_data);
-                                for (; col < 8; col++)
-                                    msg_print_space(stdout, ((col + 1) == 8), mode_data);
-                                // ascii characters
-                                fprintf(stdout, "  ");
-                                for (col = 0, idx = (row *8); col < end; col++, idx++)
-                                    msg_print_ascii(stdout, message.DATA[idx], mode_ascii);
-                                row += 1;
-                                if ((row * 8) < len)
-                                    msg_print_indent(stdout, "\n\t", mode_id);
-                            }
-                        }
-                        else {
-                            for (idx = 0; idx < len; idx++)
-                                msg_print_data(stdout, message.DATA[idx], ((idx + 1) == len), mode_data);
-                        }
-                    }
-                    else {
-//                        switch (mode_data) {
-//                            case MODE_DEC: fprintf(stdout, "dlc=%d", message.DLC); break;
-//                            case MODE_OCT: fprintf(stdout, "dlc=\\%03o", message.DLC); break;
-//                            case MODE_HEX: fprintf(stdout, "dlc=%02X", message.DLC); break;
-//                        }
-                        fprintf(stdout, "Remote Transmit Request");
+    msg_format_init(&format, mode_time, mode_id, mode_data, mode_ascii, canfd);
+    if (!msg_buffer_init(&output, output_stream, MSG_BUFFER_SIZE, flush_policy, flush_value)) {
+        fprintf(stderr, "+++ error: output buffer could not be allocated\n");
+        release_queues(interfaces);
+        return 0;
+    }
+    if ((io_mode >= 0) && (!wrq_init(&wqueue, io_mode, MSG_BUFFER_SIZE, WRQ_BUFFERS) ||
+                           !wrq_attach(&wqueue, fileno(output_stream)) ||
+                           !msg_buffer_sink(&output, async_sink, (void*)&wqueue))) {
+        fprintf(stderr, "+++ error: asynchronous writes could not be started (%s)\n",
+                (io_mode == WRQ_URING) ? "io_uring not available" : strerror(errno));
+        msg_buffer_exit(&output);
+        release_queues(interfaces);
+        return 0;
+    }
+    if (output_mode == OUTPUT_BINARY) {
+        rec_header_init(&header, canfd);
+        (void)rec_write_header(&output, &header);
+    }
+    if ((output_mode == OUTPUT_PACKED) && !pack_writer_init(&packer, output_stream, canfd)) {
+        fprintf(stderr, "+++ error: compressed capture could not be started\n");
+        msg_buffer_exit(&output);
+        release_queues(interfaces);
+        return 0;
+    }
+    if (output_mode == OUTPUT_LOG) {
+        (void)log_writer_init(&writer, log_format, canfd, can_board[boards[0]].name, 1);
+        (void)log_write_header(&writer, &output);
+    }
+    if ((view_mode == VIEW_TABLE) && !tbl_init(&table, output_stream, mode_id, mode_data, canfd, TBL_REFRESH)) {
+        fprintf(stderr, "+++ error: message table could not be allocated\n");
+        msg_buffer_exit(&output);
+        release_queues(interfaces);
+        return 0;
+    }
+    if (view_mode == VIEW_STATS) {
+        if (!stats_init(&stats)) {
+            fprintf(stderr, "+++ error: statistics could not be allocated\n");
+            msg_buffer_exit(&output);
+            release_queues(interfaces);
+            return 0;
+        }
+        due = stats_interval ? time(NULL) + (time_t)stats_interval : 0;
+    }
+    /* reader threads: CAN_Read resp. CAN_ReadFD into the receive queue of each interface */
+    /* note: signals are handled by this thread (it wakes up the readers by the stop pipe) */
+    if (pipe(stopper) != 0) {
+        fprintf(stderr, "+++ error: stop pipe could not be created (%s)\n", strerror(errno));
+        msg_buffer_exit(&output);
+        release_queues(interfaces);
+        return 0;
+    }
+    sigfillset(&sigset);
+    pthread_sigmask(SIG_BLOCK, &sigset, &oldset);
+    for (n = 0, rc = 0; n < interfaces; n++) {
+        readers[n].channel = (TPCANHandle)can_board[boards[n]].type;
+        readers[n].index = n;
+        readers[n].core = pinning ? cores[n % pinning] : -1;
+        readers[n].queue = &queues[n];
+        readers[n].status = PCAN_ERROR_OK;
+        if ((rc = pthread_create(&threads[n], NULL, canfd ? reader_fd : reader, (void*)&readers[n])) != 0) {
+            fprintf(stderr, "+++ error: reader thread could not be started (%s)\n", strerror(rc));
+            break;
+        }
+        /* note: each reader on its own core, so a burst on one bus does not delay the others */
+        if ((readers[n].core >= 0) && ((rc = aff_pin(threads[n], readers[n].core)) != 0)) {
+            fprintf(stderr, "+++ error: reader thread could not be pinned to core %i (%s)\n", readers[n].core, strerror(rc));
+            n++;
+            break;
+        }
+    }
+    pthread_sigmask(SIG_SETMASK, &oldset, NULL);
+    if (rc != 0) {
+        stop_readers();
+        while (n-- > 0)
+            pthread_join(threads[n], NULL);
+        close_stopper();
+        msg_buffer_exit(&output);
+        release_queues(interfaces);
+        return 0;
+    }
+    /* output loop: format and write the frames from the receive queue */
+    for (;;) {
+        closed = !merging ? ring_closed(&queues[0]) : 0;
+        if (segmented && seg_due(&segment, output_bytes(&output)))
+            next_segment(&output, &header, &writer);
+        if ((popped = !merging ? ring_pop(&queues[0], &frame) : merge_frames(&frame, &closed)) != 0) {
+            if (bus_load) {
+                /* --- bus load of all frames (incl. excluded CAN-IDs) --- */
+                if (load_update(&busload, ((uint64_t)frame.timestamp.tv_sec * 1000000ull) + (uint64_t)frame.timestamp.tv_usec,
+                                frame.id, frame.flags, frame.dlc, frame.len, frame.data) && (view_mode == VIEW_LIST))
+                    (void)load_print(&busload, stderr);
+                if (frame.flags & FRAME_EXCLUDED)
+                    continue;
+            }
+            if (histogram) {
+                /* --- inter-arrival times per CAN-ID and of the bus --- */
+                hist_update(&hist, ((uint64_t)frame.timestamp.tv_sec * 1000000ull) + (uint64_t)frame.timestamp.tv_usec,
+                            frame.id, frame.flags);
+            }
+            if (rate_limit && !rate_check(&ratelimit, ((uint64_t)frame.timestamp.tv_sec * 1000000ull) + (uint64_t)frame.timestamp.tv_usec,
+                                          frame.id, frame.flags)) {
+                /* --- decimated by the rule of the CAN-ID (only counted) --- */
+                continue;
+            }
+            if (changes_only && !chg_check(&changes, frame.id, frame.flags, frame.dlc, frame.len, frame.data, &repeats)) {
+                /* --- unchanged payload: suppressed (only counted) --- */
+                continue;
+            }
+            if (recording) {
+                /* --- flight recorder: the frame is only kept in the ring (dumped on SIGUSR2) --- */
+                fr_record(&recorder, &frame);
+                continue;
+            }
+            if (capture) {
+                /* --- trigger capture: only the frames around a trigger are written --- */
+                match = (trig.state == TRIG_ARMED) && flt_match(&trigger, frame.id, frame.flags, frame.dlc, frame.len, frame.data);
+                if ((pending = trig_update(&trig, &frame, match)) == 0)
+                    continue;
+            }
+            do {
+                if (capture)
+                    memcpy(&frame, trig_next(&trig), sizeof(struct frame));
+                if (view_mode == VIEW_TABLE) {
+                    /* --- update the row of the CAN-ID (redraw at 10Hz) --- */
+                    (void)tbl_update(&table, &frame.timestamp, frame.id, frame.flags, frame.dlc, frame.len, frame.data);
+                    (void)tbl_refresh(&table, 0);
+                    frames++;
+                }
+                else if (view_mode == VIEW_STATS) {
+                    /* --- count the message per CAN-ID (summary on demand) --- */
+                    (void)stats_update(&stats,
+                                       ((uint64_t)frame.timestamp.tv_sec * 1000000ull) + (uint64_t)frame.timestamp.tv_usec,
+                                       frame.id, frame.flags, frame.dlc);
+                    frames++;
+                }
+                else if (output_mode == OUTPUT_LOG) {
+                    /* --- output message (ASC, candump, TRC or JSON Lines) --- */
+                    if (merging && (frame.channel != bus)) {
+                        bus = frame.channel;
+                        (void)log_writer_bus(&writer, can_board[boards[bus]].name, bus + 1);
                     }
-                    fprintf(stdout, "\n");
+                    (void)log_write_message(&writer, &output, &frame.timestamp, frame.id, frame.flags, frame.dlc, frame.len, frame.data);
+                    frames++;
                 }
-            }
+                else if (output_mode == OUTPUT_PACKED) {
+                    /* --- output message (delta encoded, one write per block) --- */
+                    (void)pack_write_message(&packer,
+                                             ((uint64_t)frame.timestamp.tv_sec * 1000000ull) + (uint64_t)frame.timestamp.tv_usec,
+                                             frame.id, frame.flags, frame.dlc, frame.len, frame.data);
+                    frames++;
+                }
+                else if (output_mode == OUTPUT_BINARY) {
+                    /* --- output message (one record per frame) --- */
+                    (void)rec_write_message(&output, &header,
+                                            ((uint64_t)frame.timestamp.tv_sec * 1000000ull) + (uint64_t)frame.timestamp.tv_usec,
+                                            frame.id, frame.flags, frame.dlc, frame.len, frame.data);
+                    frames++;
+                }
+                else if (((changes_only == CHANGES_COUNT) && repeats) || merging) {
+                    /* --- output message (with the interface and/or the number of suppressed repeats) --- */
+                    (void)print_message(&output, &format, frames++, &frame, (changes_only == CHANGES_COUNT) ? repeats : 0);
+                }
+                else {
+                    /* --- output message (one line per frame) --- */
+                    (void)msg_buffer_message(&output, &format, frames++, &frame.timestamp, frame.id, frame.flags, frame.len, frame.data);
+                }
+            } while (capture && --pending);
+            if (capture && (trig.state == TRIG_DONE))
+                stop_readers();   /* note: single shot */
         }
-        else if (status == PCAN_ERROR_QRCVEMPTY)
-#ifdef BLOCKING_READ
-            select(fdes+1, &rdfs, NULL, NULL, NULL);
-#else
-            timer_delay(1);
-#endif
+        else if (!closed) {
+            /* receive queue is empty: write out pending frames */
+            (void)msg_buffer_flush(&output);
+            if (output_mode == OUTPUT_PACKED)
+                (void)pack_flush(&packer, 0);
+            if (view_mode == VIEW_TABLE)
+                (void)tbl_refresh(&table, 0);
+            if (bus_load && load_poll(&busload) && (view_mode == VIEW_LIST))
+                (void)load_print(&busload, stderr);
+            if (!merging)
+                ring_wait(&queues[0], 100U);
+            else if ((delay = merge_delay()) != 0U)
+                ring_wait_group(queues, interfaces, delay);
+        }
+        else
+            break;
+        /* statistics: every n seconds (clock read every 1024 frames or when idle) and on SIGUSR1 */
+        if ((view_mode == VIEW_STATS) && (report || (due && (!popped || !(frames & 0x3FFu)) && (time(NULL) >= due)))) {
+            (void)stats_report(&stats, output_stream, mode_id);
+            if (bus_load)
+                (void)load_print(&busload, output_stream);
+            due = stats_interval ? time(NULL) + (time_t)stats_interval : 0;
+            if (!histogram)
+                report = 0;
+        }
+        /* flight recorder: dump on SIGUSR2 (written by a background thread) */
+        if (recording && dump) {
+            if (!fr_dump(&recorder))
+                fprintf(stderr, "+++ error: flight recorder is still dumping (request ignored)\n");
+            dump = 0;
+        }
+        /* histograms: on SIGUSR1 (and the CSV file rewritten) */
+        if (histogram && report) {
+            (void)hist_report(&hist, (view_mode == VIEW_STATS) ? output_stream : stderr, mode_id);
+            if (hist_file && !export_histograms())
+                fprintf(stderr, "+++ error: histograms could not be written to `%s'\n", hist_file);
+            report = 0;
+        }
+    }
+    for (n = 0; n < interfaces; n++)
+        pthread_join(threads[n], NULL);
+    close_stopper();
+    if (view_mode == VIEW_TABLE)
+        tbl_exit(&table);
+    if (view_mode == VIEW_STATS) {
+        (void)stats_report(&stats, output_stream, mode_id);
+        if (bus_load)
+            (void)load_print(&busload, output_stream);
+        stats_exit(&stats);
     }
+    if (output_mode == OUTPUT_LOG)
+        (void)log_write_footer(&writer, &output);
+    if (output_mode == OUTPUT_PACKED)
+        pack_writer_exit(&packer);
+    msg_buffer_exit(&output);
+    release_queues(interfaces);
     fprintf(stdout, "\n");
     return frames;
 }
 
-static uint64_t receive_fd(TPCANHandle channel, int mode_time, int mode_id, int mode_data, int mode_ascii)
+static int render(const char *filename, FILE *output, int mode_time, int mode_id, int mode_data, int mode_ascii, int follow)
 {
-    TPCANStatus status;
-    TPCANMsgFD message;
-    TPCANTimestampFD timestamp;
+    char magic[8];
+    size_t length;
+    FILE *input;
+    int rc = 0;
 
-    uint64_t frames = 0;
-//    uint64_t msec;
-    struct msg_timestamp ts;
-    unsigned char len, row, col, end, idx;
+    if ((input = fopen(filename, "rb")) == NULL) {
+        fprintf(stderr, "+++ error: cannot open capture file `%s' (%s)\n", filename, strerror(errno));
+        return 1;
+    }
+    /* the file header tells the format (and the CAN mode) */
+    length = fread(magic, 1, sizeof(magic), input);
+    rewind(input);
+    if ((length == sizeof(magic)) && !memcmp(magic, REC_MAGIC, sizeof(magic)) && !follow)
+        (void)rec_render(input, output, mode_time, mode_id, mode_data, mode_ascii);
+    else if (((length == sizeof(magic)) && !memcmp(magic, PACK_MAGIC, sizeof(magic))) || ((length < sizeof(magic)) && follow)) {
+        /* note: a followed file may still lack its header, and ^C ends the follow mode */
+        if (follow) {
+            (void)signal(SIGINT, SIG_DFL);
+            (void)signal(SIGHUP, SIG_DFL);
+            (void)signal(SIGTERM, SIG_DFL);
+        }
+        (void)pack_render(input, output, mode_time, mode_id, mode_data, mode_ascii, follow);
+    }
+    else {
+        fprintf(stderr, "+++ error: `%s' is not a %scapture file\n", filename, follow ? "COMPRESSED " : "");
+        rc = 1;
+    }
+    if (ferror(input) || ferror(output)) {
+        fprintf(stderr, "+++ error: cannot render capture file `%s' (%s)\n", filename, strerror(errno));
+        rc = 1;
+    }
+    (void)fclose(input);
+    return rc;
+}
+
+static void release_interfaces(int count)
+{
+    int n;
+
+    for (n = 0; n < count; n++)
+        (void)CAN_Uninitialize((TPCANHandle)can_board[boards[n]].type);
+}
+
+static void release_queues(int count)
+{
+    int n;
+
+    for (n = 0; n < count; n++)
+        ring_exit(&queues[n]);
+    if (merging)
+        mrg_exit(&merge);
+}
+
+static int merge_frames(struct frame *frame, int *closed)
+{
+    struct frame item;
+    struct timespec now;
+    uint64_t usec;
+    int open = 0, done, n, i;
+
+    /* note: the arrival time of the frames (monotonic), once per round */
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    usec = ((uint64_t)now.tv_sec * 1000000ull) + ((uint64_t)now.tv_nsec / 1000ull);
+    /* take up to a batch of frames of each receive queue into the reorder buffer */
+    for (n = 0; n < interfaces; n++) {
+        if (merge.closed[n])
+            continue;
+        done = ring_closed(&queues[n]);
+        for (i = 0; (i < RxBATCH) && (merge.avail > 0); i++) {
+            if (!ring_pop(&queues[n], &item)) {
+                if (done)
+                    mrg_close(&merge, n);
+                break;
+            }
+            (void)mrg_push(&merge, n, &item, ((uint64_t)item.timestamp.tv_sec * 1000000ull) + (uint64_t)item.timestamp.tv_usec, usec);
+        }
+        open += !merge.closed[n] ? 1 : 0;
+    }
+    /* hand out the oldest frame, if no interface can deliver an older one */
+    *closed = !open;
+    return mrg_pop(&merge, frame, usec);
+}
+
+static unsigned int merge_delay(void)
+{
+    struct timespec now;
+    uint64_t usec, due;
+
+    /* note: sleep until a frame arrives, or until the reorder window of the oldest frame ends */
+    if ((due = mrg_due(&merge)) == 0)
+        return 100U;
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    usec = ((uint64_t)now.tv_sec * 1000000ull) + ((uint64_t)now.tv_nsec / 1000ull);
+    if (due <= usec)
+        return 0U;
+    due = (due - usec + 999ull) / 1000ull;
+    return (due < 100ull) ? (unsigned int)due : 100U;
+}
+
+static void next_segment(struct msg_buffer *output, struct rec_header *header, struct log_writer *writer)
+{
+    FILE *stream;
+
+    /* the next segment has been opened in the background (or is opened now) */
+    if ((stream = seg_open(&segment)) == NULL)
+        return;
+    /* finish the current segment (each segment is a complete file) */
+    if (output_mode == OUTPUT_LOG)
+        (void)log_write_footer(writer, output);
+    (void)msg_buffer_flush(output);
+    if (output_mode == OUTPUT_PACKED)
+        (void)pack_writer_switch(&packer, stream);
+    if (io_mode >= 0)
+        (void)wrq_attach(&wqueue, fileno(stream));
+    seg_switch(&segment, output_bytes(output));
+    output->stream = output_stream = stream;
+    /* start the next segment with the header of the output format */
+    if (output_mode == OUTPUT_BINARY)
+        (void)rec_write_header(output, header);
+    if (output_mode == OUTPUT_LOG) {
+        writer->counter = 0;
+        (void)log_write_header(writer, output);
+    }
+}
+
+static uint64_t output_bytes(const struct msg_buffer *output)
+{
+    /* note: the compressed capture is written by its own */
+    if (output_mode == OUTPUT_PACKED)
+        return packer.bytes;
+    return output->written + (uint64_t)output->used;
+}
+
+static char *async_sink(void *context, char *data, size_t length)
+{
+    struct write_queue *wq = (struct write_queue*)context;
+
+    /* the first buffer, a filled buffer, or the last buffer (taken back) */
+    if (data == NULL)
+        return wrq_buffer(wq);
+    if (length == 0) {
+        wrq_release(wq, data);
+        return NULL;
+    }
+    if (!wrq_submit(wq, data, length))
+        return NULL;
+    return wrq_buffer(wq);
+}
+
+static int print_message(struct msg_buffer *output, struct msg_format *format, uint64_t counter, struct frame *frame, uint64_t repeats)
+{
+    char *line, text[MSG_LINE_MAX];
+    size_t n = 0, m;
+
+    /* note: the line is formatted in place (one interface) resp. after the interface
+     *       (several interfaces), and the count of repeats replaces its newline */
+    if ((line = msg_buffer_reserve(output, MSG_LINE_MAX)) == NULL)
+        return 0;
+    if (!merging) {
+        if ((n = msg_format_message(line, MSG_LINE_MAX, format, counter, &frame->timestamp,
+                                    frame->id, frame->flags, frame->len, frame->data)) == 0)
+            return 0;
+    }
+    else {
+        if ((m = msg_format_message(text, MSG_LINE_MAX, format, counter, &frame->timestamp,
+                                    frame->id, frame->flags, frame->len, frame->data)) == 0)
+            return 0;
+        n = (size_t)snprintf(line, MSG_LINE_MAX, "%-11s", can_board[boards[frame->channel]].name);
+        if (m > (MSG_LINE_MAX - 1 - n))
+            m = MSG_LINE_MAX - 1 - n;
+        memcpy(&line[n], text, m);
+        n += m;
+    }
+    if (repeats) {
+        n -= 1;
+        n += (size_t)snprintf(&line[n], MSG_LINE_MAX - n, "  (%" PRIu64 " repeat%s)\n",
+                              repeats, (repeats != 1) ? "s" : "");
+    }
+    return msg_buffer_commit(output, (n < MSG_LINE_MAX) ? n : MSG_LINE_MAX - 1);
+}
+
+static int dump_begin(void *context, FILE *stream, const void *last)
+{
+    const struct frame *frame = (const struct frame*)last;
+    uint64_t newest;
+
+    /* note: a snapshot sized by time is cut to the time window before the newest frame */
+    dump_since = 0;
+    if (frame && dump_window) {
+        newest = ((uint64_t)frame->timestamp.tv_sec * 1000000ull) + (uint64_t)frame->timestamp.tv_usec;
+        dump_since = (newest > dump_window) ? newest - dump_window : 0;
+    }
+    dump_buffer.stream = stream;
+    dump_buffer.used = 0;
+    (void)context;
+    return rec_write_header(&dump_buffer, &dump_header);
+}
+
+static int dump_frame(void *context, const void *item)
+{
+    const struct frame *frame = (const struct frame*)item;
+    uint64_t timestamp = ((uint64_t)frame->timestamp.tv_sec * 1000000ull) + (uint64_t)frame->timestamp.tv_usec;
+
+    (void)context;
+    if (timestamp < dump_since)
+        return 1;
+    dump_written++;
+    return rec_write_message(&dump_buffer, &dump_header, timestamp, frame->id, frame->flags, frame->dlc, frame->len, frame->data);
+}
+
+static int dump_end(void *context)
+{
+    (void)context;
+    return msg_buffer_flush(&dump_buffer);
+}
+
+static int export_histograms(void)
+{
+    FILE *fp;
+    int rc;
+
+    /* note: the file is rewritten on each report */
+    if ((fp = fopen(hist_file, "w")) == NULL)
+        return 0;
+    rc = hist_export(&hist, fp);
+    if (fclose(fp) != 0)
+        rc = 0;
+    return rc;
+}
 
+static void *reader(void *arg)
+{
+    struct reader *self = (struct reader*)arg;
+
+    self->read = read_frames;
+    rx_loop(self);
+    ring_close(self->queue);
+    return NULL;
+}
+
+static void *reader_fd(void *arg)
+{
+    struct reader *self = (struct reader*)arg;
+
+    self->read = read_frames_fd;
+    rx_loop(self);
+    ring_close(self->queue);
+    return NULL;
+}
+
+static void rx_loop(struct reader *self)
+{
 #ifdef BLOCKING_READ
+    struct ev_loop loop;
+    TPCANStatus status;
     int fdes = -1;
 
-    if ((status = CAN_GetValue(channel, PCAN_RECEIVE_EVENT, &fdes, sizeof(int))) != PCAN_ERROR_OK) {
+    if ((status = CAN_GetValue(self->channel, PCAN_RECEIVE_EVENT, &fdes, sizeof(int))) != PCAN_ERROR_OK) {
         fprintf(stderr, "+++ error: CAN_GetValue PCAN_RECEIVE_EVENT returned 0x%X\n", status);
-        return 0;
+        self->status = status;
+        return;
     }
-    fd_set rdfs;
-    FD_ZERO(&rdfs);
-    FD_SET(fdes, &rdfs);
-#endif
+    /* receive event (edge-triggered) and the stop pipe (written at the end of the program) */
+    if (!ev_init(&loop) || (ev_add_fd(&loop, fdes, rx_event, (void*)self) < 0) ||
+        (ev_add_fd(&loop, stopper[0], rx_stop, NULL) < 0)) {
+        fprintf(stderr, "+++ error: event loop could not be started (%s)\n", strerror(errno));
+        self->status = PCAN_ERROR_UNKNOWN;
+        ev_exit(&loop);
+        return;
+    }
+    /* note: frames received before the loop has been started are read now */
+    rx_event(&loop, (void*)self, 0);
+    (void)ev_run(&loop);
+    ev_exit(&loop);
+#else
     while (running) {
-        if ((status = CAN_ReadFD(channel, &message, &timestamp)) == PCAN_ERROR_OK) {
-            if (!(message.MSGTYPE & PCAN_MESSAGE_STATUS)) {
-                if (((message.ID < MAX_ID) && can_id[message.ID]) || ((message.ID >= MAX_ID) && can_id_xtd)) {
-                    fprintf(stdout, "%-7" PRIu64 " ", frames++);
-                    /* --- CAN FD time-stamp --- */
-                    ts.tv_sec = (long)(timestamp / 1000000ull);
-                    ts.tv_usec = (long)(timestamp % 1000000ull);
-                    /* --- output time-stamp --- */
-                    msg_print_time(stdout, (struct msg_timestamp*)&ts, mode_time);
-                    msg_print_id_fd(stdout, message.ID, (message.MSGTYPE & PCAN_MESSAGE_RTR), (message.MSGTYPE & PCAN_MESSAGE_EXTENDED),
-                                                        (message.MSGTYPE & PCAN_MESSAGE_FD), (message.MSGTYPE & PCAN_MESSAGE_BRS),
-                                                        (message.MSGTYPE & PCAN_MESSAGE_ESI), dlc_table[message.DLC & 0xF], mode_id);
-                    if (!(message.MSGTYPE & PCAN_MESSAGE_RTR)) {
-                        len = dlc_table[message.DLC & 0xF];
-                        if (mode_ascii) {
-                            row = 0;
-                            while ((row * 8) < len) {
-                                end = len - (row * 8);
-                                if (end >= 8)
-                                    end = 8;
-                                // data and space
-                                for (col = 0, idx = (row *8); col < end; col++, idx++)
-                                    msg_print_data(stdout, message.DATA[idx], ((col + 1) == 8), mode_data);
-                                for (; col < 8; col++)
-                                    msg_print_space(stdout, ((col + 1) == 8), mode_data);
-                                // ascii characters
-                                fprintf(stdout, "  ");
-                                for (col = 0, idx = (row *8); col < end; col++, idx++)
-                                    msg_print_ascii(stdout, message.DATA[idx], mode_ascii);
-                                row += 1;
-                                if ((row * 8) < len)
-                                    msg_print_indent_fd(stdout, "\n\t", mode_id);
-                            }
-                        }
-                        else {
-                            for (idx = 0; idx < len; idx++)
-                                msg_print_data(stdout, message.DATA[idx], ((idx + 1) == len), mode_data);
-                        }
-                    }
-                    else {
-//                        switch (mode_data) {
-//                            case MODE_DEC: fprintf(stdout, "dlc=%d", message.DLC); break;
-//                            case MODE_OCT: fprintf(stdout, "dlc=\\%03o", message.DLC); break;
-//                            case MODE_HEX: fprintf(stdout, "dlc=%02X", message.DLC); break;
-//                        }
-                        fprintf(stdout, "Remote Transmit Request");
-                    }
-                    fprintf(stdout, "\n");
+        if (self->read(self) == PCAN_ERROR_QRCVEMPTY)
+            timer_delay(1);
+    }
+#endif
+}
+
+static void rx_event(struct ev_loop *loop, void *context, uint64_t value)
+{
+    struct reader *self = (struct reader*)context;
+
+    /* note: the receive event is edge-triggered, so the queue is read until it is empty */
+    while (running && (self->read(self) != PCAN_ERROR_QRCVEMPTY));
+    if (!running)
+        ev_stop(loop);
+    (void)value;
+}
+
+static void rx_stop(struct ev_loop *loop, void *context, uint64_t value)
+{
+    /* note: the stop pipe is never read, so it wakes up the loop of each reader */
+    ev_stop(loop);
+    (void)context;
+    (void)value;
+}
+
+static void stop_readers(void)
+{
+    char byte = 0;
+
+    /* note: only a flag and a write (async-signal-safe, called by the signal handler) */
+    if (running) {
+        running = 0;
+        if (stopper[1] >= 0)
+            (void)write(stopper[1], &byte, 1);
+    }
+}
+
+static void close_stopper(void)
+{
+    int fd = stopper[1];
+
+    /* note: the signal handler must not write to a closed (or reused) descriptor */
+    stopper[1] = -1;
+    if (fd >= 0)
+        (void)close(fd);
+    if (stopper[0] >= 0)
+        (void)close(stopper[0]);
+    stopper[0] = -1;
+}
+
+static TPCANStatus read_frames(struct reader *self)
+{
+    TPCANStatus status;
+    TPCANMsg messages[RxBATCH], *message;
+    TPCANTimestamp timestamps[RxBATCH], *timestamp;
+    DWORD count, i;
+    struct frame frame;
+    uint64_t msec, received = 0, passed = 0;
+    int allowed;
+
+    /* note: the receive queue is drained in batches (one library call per batch) */
+    /* note: the filter reads the data in chunks of 16 bytes, so all 64 bytes are defined */
+    memset(&frame, 0, sizeof(struct frame));
+    frame.channel = (uint8_t)self->index;
+    status = CAN_ReadBatch(self->channel, messages, timestamps, RxBATCH, &count);
+    for (i = 0; i < count; i++) {
+        message = &messages[i];
+        timestamp = &timestamps[i];
+        if (!(message->MSGTYPE & PCAN_MESSAGE_STATUS)) {
+            allowed = !idset_contains(&exclusion, message->ID);
+            received++;
+            /* note: excluded frames are handed over for the bus load */
+            if (allowed || bus_load) {
+                /* --- CAN 2. 0 time-stamp --- */
+                msec = ((unsigned long long)timestamp->millis_overflow << 32) + (unsigned long long)timestamp->millis;
+                frame.timestamp.tv_sec = (long)(msec / 1000ull);
+                frame.timestamp.tv_usec = (((long)(msec % 1000ull)) * 1000L) + (long)timestamp->micros;
+                frame.id = (uint32_t)message->ID;
+                frame.flags = ((message->MSGTYPE & PCAN_MESSAGE_EXTENDED) ? MSG_FLAG_XTD : 0) |
+                              ((message->MSGTYPE & PCAN_MESSAGE_RTR) ? MSG_FLAG_RTR : 0);
+                frame.dlc = message->LEN;
+                frame.len = (message->LEN < 8) ? message->LEN : 8;
+                memcpy(frame.data, message->DATA, 8);
+                /* --- filter expression (before any formatting) --- */
+                if (allowed && filtering)
+                    allowed = flt_match(&expression, frame.id, frame.flags, frame.dlc, frame.len, frame.data);
+                /* --- hand over to the output thread --- */
+                if (allowed || bus_load) {
+                    frame.flags |= !allowed ? FRAME_EXCLUDED : 0;
+                    (void)ring_push(self->queue, &frame);
                 }
+                passed += allowed ? 1u : 0u;
             }
         }
-        else if (status == PCAN_ERROR_QRCVEMPTY)
-#ifdef BLOCKING_READ
-            select(fdes+1, &rdfs, NULL, NULL, NULL);
-#else
-            timer_delay(1);
-#endif
     }
-    fprintf(stdout, "\n");
-    return frames;
+    /* note: the counters are updated once per batch (cache line of the reader) */
+    self->frames += received;
+    self->passed += passed;
+    return status;
 }
 
-static int get_exclusion(const char *arg)
+static TPCANStatus read_frames_fd(struct reader *self)
 {
-    char *val, *end;
-    int i, inv = 0;
-    long id, last = -1;
+    TPCANStatus status;
+    TPCANMsgFD messages[RxBATCH], *message;
+    TPCANTimestampFD timestamps[RxBATCH], timestamp;
+    DWORD count, i;
+    struct frame frame;
+    uint64_t received = 0, passed = 0;
+    int allowed;
+
+    /* note: the receive queue is drained in batches (one library call per batch) */
+    /* note: the filter reads the data in chunks of 16 bytes, so all 64 bytes are defined */
+    memset(&frame, 0, sizeof(struct frame));
+    frame.channel = (uint8_t)self->index;
+    status = CAN_ReadFDBatch(self->channel, messages, timestamps, RxBATCH, &count);
+    for (i = 0; i < count; i++) {
+        message = &messages[i];
+        timestamp = timestamps[i];
+        if (!(message->MSGTYPE & PCAN_MESSAGE_STATUS)) {
+            allowed = !idset_contains(&exclusion, message->ID);
+            received++;
+            /* note: excluded frames are handed over for the bus load */
+            if (allowed || bus_load) {
+                /* --- CAN FD time-stamp --- */
+                frame.timestamp.tv_sec = (long)(timestamp / 1000000ull);
+                frame.timestamp.tv_usec = (long)(timestamp % 1000000ull);
+                frame.id = (uint32_t)message->ID;
+                frame.flags = ((message->MSGTYPE & PCAN_MESSAGE_EXTENDED) ? MSG_FLAG_XTD : 0) |
+                              ((message->MSGTYPE & PCAN_MESSAGE_RTR) ? MSG_FLAG_RTR : 0) |
+                              ((message->MSGTYPE & PCAN_MESSAGE_FD) ? MSG_FLAG_FDF : 0) |
+                              ((message->MSGTYPE & PCAN_MESSAGE_BRS) ? MSG_FLAG_BRS : 0) |
+                              ((message->MSGTYPE & PCAN_MESSAGE_ESI) ? MSG_FLAG_ESI : 0);
+                frame.dlc = message->DLC;
+                frame.len = dlc_table[message->DLC & 0xF];
+                memcpy(frame.data, message->DATA, frame.len);
+                /* --- filter expression (before any formatting) --- */
+                if (allowed && filtering)
+                    allowed = flt_match(&expression, frame.id, frame.flags, frame.dlc, frame.len, frame.data);
+                /* --- hand over to the output thread --- */
+                if (allowed || bus_load) {
+                    frame.flags |= !allowed ? FRAME_EXCLUDED : 0;
+                    (void)ring_push(self->queue, &frame);
+                }
+                passed += allowed ? 1u : 0u;
+            }
+        }
+    }
+    /* note: the counters are updated once per batch (cache line of the reader) */
+    self->frames += received;
+    self->passed += passed;
+    return status;
+}
+
+static int get_exclusion(const char *arg, unsigned long *line)
+{
+    int inv = 0;
 
     if (!arg)
         return 0;
 
-    val = (char *)arg;
-    if (*val == '~') {
+    if (*arg == '~') {
         inv = 1;
-        val++;
+        arg++;
     }
+    if (*arg == '@') {
+        /* note: the CAN-IDs from a file (line = 0: file not readable) */
+        if (!idset_load(&exclusion, arg + 1, line))
+            return (*line == 0) ? -1 : 0;
+    }
+    else if (!get_id_list(arg, exclude_range, NULL))
+        return 0;
+    if (idset_build(&exclusion) < 0)
+        return 0;
+    if (inv)
+        idset_invert(&exclusion);
+    return 1;
+}
+
+static int get_acceptance(struct id_cover *cover, unsigned long max_id)
+{
+    struct id_set include;
+    struct id_cover other;
+    int rc, range;
+
+    /* the include set is the complement of the exclusion ... */
+    idset_invert(&exclusion);
+    rc = idset_cover(&exclusion, max_id, cover);
+    idset_invert(&exclusion);
+    if (!rc)
+        return 0;
+    /* ... or the CAN-IDs of the filter expression, whichever is smaller */
+    if (filtering && idset_init(&include)) {
+        if (flt_id_set(&expression, &include) && (idset_build(&include) >= 0) &&
+            idset_cover(&include, max_id, &other) && (idset_cover_ids(&other, &range) < idset_cover_ids(cover, &range)))
+            memcpy(cover, &other, sizeof(struct id_cover));
+        idset_exit(&include);
+    }
+    return (idset_cover_ids(cover, &range) <= max_id) ? 1 : 0;
+}
+
+static int get_rate_limit(const char *arg, int policy)
+{
+    unsigned long value;
+    char *end;
+    int rule;
+
+    if (!arg || (*arg < '0') || (*arg > '9'))
+        return 0;
+    errno = 0;
+    value = strtoul(arg, &end, 0);
+    if ((errno != 0) || (value < 1UL) || (value > MAX_RATE))
+        return 0;
+    if ((rule = rate_rule(&ratelimit, policy, value)) < 0)
+        return 0;
+    /* w/o an <id-list> the rule applies to all CAN-IDs */
+    if (*end == '\0')
+        return rate_range(&ratelimit, rule, 0UL, (unsigned long)MASK_29BIT);
+    if (*end != ':')
+        return 0;
+    return get_id_list(++end, limit_range, (void*)&rule);
+}
+
+static int get_id_list(const char *arg, int (*range)(void *context, unsigned long first, unsigned long last), void *context)
+{
+    char *val, *end;
+    long id, first;
+
+    /* <id-list> = <id>[-<id>]{,<id>[-<id>]} (11-bit and 29-bit IDs) */
+    val = (char *)arg;
     for (;;) {
         errno = 0;
-        id = strtol(val, &end, 0);
-
-        if (errno == ERANGE && (id == LONG_MAX || id == LONG_MIN))
-            return 0;
-        if (errno != 0 && id == 0)
+        first = id = strtol(val, &end, 0);
+        if ((errno != 0) || (val == end) || (id < 0) || (id > MASK_29BIT))
             return 0;
-        if (val == end)
+        if (*end == '-') {
+            val = ++end;
+            errno = 0;
+            id = strtol(val, &end, 0);
+            if ((errno != 0) || (val == end) || (id < 0) || (id > MASK_29BIT))
+                return 0;
+        }
+        if (!range(context, (unsigned long)((first < id) ? first : id), (unsigned long)((first < id) ? id : first)))
             return 0;
-
-        if (id < MAX_ID)
-            can_id[id] = 0;
-
-        if (*end == '\0') {
-            if (last != -1) {
-                while (last != id) {
-                    if (last < id)
-                        last++;
-                    else
-                        last--;
-                    can_id[last] = 0;
-                }
-                /*last = -1; <<< dead store */
-            }
+        if (*end == '\0')
             break;
-        }
-        if (*end == ',') {
-            if (last != -1) {
-                while (last != id) {
-                    if (last < id)
-                        last++;
-                    else
-                        last--;
-                    can_id[last] = 0;
-                }
-                last = -1;
-            }
-        }
-        else if (*end == '-')
-            last = id;
-        else
+        if (*end != ',')
             return 0;
-
         val = ++end;
     }
-    if (inv) {
-        for (i = 0; i < MAX_ID; i++)
-            can_id[i] = !can_id[i];
+    return 1;
+}
+
+static int exclude_range(void *context, unsigned long first, unsigned long last)
+{
+    (void)context;
+    return idset_add(&exclusion, first, last);
+}
+
+static int limit_range(void *context, unsigned long first, unsigned long last)
+{
+    return rate_range(&ratelimit, *(int*)context, first, last);
+}
+
+static int core_range(void *context, unsigned long first, unsigned long last)
+{
+    (void)context;
+    if (last >= (unsigned long)aff_cores())
+        return 0;
+    for (; first <= last; first++) {
+        if (pinning >= PCAN_BOARDS)
+            return 0;
+        cores[pinning++] = (int)first;
     }
-    can_id_xtd = !inv;
     return 1;
 }
 
 static void sigterm(int signo)
 {
     //fprintf(stderr, "%s: got signal %d\n", __FILE__, signo);
-    running = 0;
+    stop_readers();
+    (void)signo;
+}
+
+static void sigusr1(int signo)
+{
+    report = 1;
+    (void)signo;
+}
+
+static void sigusr2(int signo)
+{
+    dump = 1;
     (void)signo;
 }
 
 static void usage(FILE *stream, const char *program)
 {
     fprintf(stdout, "%s\n%s\n\n%s\n\n", APPLICATION, COPYRIGHT, WARRANTY);
-    fprintf(stream, "Usage: %s <interface> [<option>...]\n", program);
+    fprintf(stream, "Usage: %s <interface>... [<option>...]\n", program);
     fprintf(stream, "Options:\n");
     fprintf(stream, " -t, --time=(ZERO|ABS|REL)     absolute or relative time (default=0)\n");
     fprintf(stream, " -i  --id=(HEX|DEC|OCT)        display mode of CAN-IDs (default=HEX)\n");
     fprintf(stream, " -d, --data=(HEX|DEC|OCT)      display mode of data bytes (default=HEX)\n");
     fprintf(stream, " -a, --ascii=(ON|OFF)          display data bytes in ASCII (default=ON) \n");
-    fprintf(stream, " -x, --exclude=[~]<id-list>    exclude CAN-IDs: <id-list>=<id>[-<id>]{,<id>[-<id>]}\n");
+    fprintf(stream, " -x, --exclude=[~]<id-list>    exclude CAN-IDs: <id-list>=<id>[-<id>]{,<id>[-<id>]} or @<file>\n");
+    fprintf(stream, "     --filter=<expr>           show only frames matching <expr>, e.g. \"ID IN 0x100-0x1FF && DATA[0] == 0x55\"\n");
+    fprintf(stream, "     --flush=<n>[B|K|F|MS]     flush output after n bytes, KB, frames or msec\n");
+    fprintf(stream, "     --output=<format>         output format: TEXT, BINARY, COMPRESSED, ASC, CANDUMP, TRC or JSONL (default=TEXT)\n");
+    fprintf(stream, "     --output-file=<file>      write the CAN messages into a file (default=stdout)\n");
+    fprintf(stream, "     --segment-size=<MB>       start a new output file every <MB> megabytes (with --output-file)\n");
+    fprintf(stream, "     --segment-time=<seconds>  start a new output file every <seconds> seconds (with --output-file)\n");
+    fprintf(stream, "     --io=<mode>               write the output file: SYNC, ASYNC, URING or THREAD (default=SYNC)\n");
+    fprintf(stream, "     --render=<file>           print a BINARY or COMPRESSED capture file as TEXT and exit (w/o <interface>)\n");
+    fprintf(stream, "     --follow                  keep on rendering a COMPRESSED file while it is written (with --render)\n");
+    fprintf(stream, "     --view=(LIST|TABLE|STATS) scrolling list, one row per CAN-ID or statistics (default=LIST)\n");
+    fprintf(stream, "     --interval=<seconds>      print the statistics every <seconds> seconds (default=%u, 0=on exit)\n", STATS_INTERVAL);
+    fprintf(stream, "     --bus-load[=<msec>]       show the bus load every <msec> milliseconds (default=%u)\n", LOAD_INTERVAL);
+    fprintf(stream, "     --histogram[=<file>]      inter-arrival times per CAN-ID (p50..p99.9, max), optionally as CSV\n");
+    fprintf(stream, "     --changes-only[=COUNT]    show only frames whose DLC or data changed (COUNT: with suppressed repeats)\n");
+    fprintf(stream, "     --trigger=<expr>          write only the frames around a frame matching <expr> (see --filter)\n");
+    fprintf(stream, "     --pre-trigger=<n>         number of frames before the trigger (default=%lu)\n", PRE_TRIGGER);
+    fprintf(stream, "     --post-trigger=<n>        number of frames after the trigger (default=%lu)\n", POST_TRIGGER);
+    fprintf(stream, "     --re-arm                  wait for the next trigger after a capture (default=single shot)\n");
+    fprintf(stream, "     --recorder=<n><unit>      keep the last <n> S, MIN, H, MB or GB of frames in RAM (flight recorder)\n");
+    fprintf(stream, "     --recorder-file=<file>    dump the recorded frames on SIGUSR2 into <file>-<time> (default=%s)\n", RECORDER_FILE);
+    fprintf(stream, "     --huge-pages              keep the recorded frames in huge pages (if available)\n");
+    fprintf(stream, "     --rate-limit=<n>[:<ids>]  at most <n> frames per second per CAN-ID in <ids>=<id-list> (repeatable)\n");
+    fprintf(stream, "     --decimate=<n>[:<ids>]    keep one of <n> frames per CAN-ID in <ids>=<id-list> (repeatable)\n");
+    fprintf(stream, "     --queue=<n>               depth of the receive queue (default=%u frames)\n", QUEUE_DEPTH);
+    fprintf(stream, "     --overflow=<policy>       when the queue is full: BLOCK, DROP-NEWEST or DROP-OLDEST (default=BLOCK)\n");
+    fprintf(stream, "     --reorder=<msec>          reorder window when merging several interfaces (default=%u)\n", REORDER_WINDOW);
+    fprintf(stream, "     --cpu=<list>              pin the reader threads to cores: <list>=<core>[-<core>]{,<core>[-<core>]} (one per interface)\n");
     fprintf(stream, "     --code=<id>               acceptance code for 11-bit IDs (default=0x%03X)\n", CODE_11BIT);
     fprintf(stream, "     --mask=<id>               acceptance mask for 11-bit IDs (default=0x%03X)\n", MASK_11BIT);
     fprintf(stream, "     --xtd-code=<id>           acceptance code for 29-bit IDs (default=0x%08X)\n", CODE_29BIT);
@@ -118,8 +118,14 @@ static const char LICENSE[]     = "This program is free software; you can redist
 #include "PCANBasic.h"
 #endif
 #endif
+#include "canbatch.h"
 #include "bitrates.h"
 #include "timer.h"
+#include "printmsg.h"
+#include "msgfilter.h"
+#include "idset.h"
+#include "idaccept.h"
+#include "evloop.h"
 
 #include <stdio.h>
 #include <stdint.h>
@@ -151,6 +157,8 @@ static const char LICENSE[]     = "This program is free software; you can redist
 #define TxFRAMES  (2)
 #define TxRANDOM  (3)
 
+#define RxBATCH   (64)  /* frames per read */
+
 #define CODE_11BIT   0x000
 #define MASK_11BIT   0x7FF
 #define CODE_29BIT   0x00000000
@@ -181,11 +189,20 @@ static uint64_t tx_frames_fd(TPCANHandle channel, BYTE mode, uint32_t can_id, ui
 static uint64_t tx_test_fd(TPCANHandle channel, BYTE mode, uint32_t can_id, uint8_t dlc, uint32_t delay, time_t duration, uint64_t offset);
 static uint64_t rx_test_fd(TPCANHandle channel, int check, uint64_t offset, int stop_on_error);
 
+static int rx_filter(const TPCANMsg *message);
+static int rx_filter_fd(const TPCANMsgFD *message);
+static int get_acceptance(struct id_cover *cover, unsigned long max_id);
+
 
 /*  -----------  variables  ----------------------------------------------
  */
 static char *prompt[4] = {"-\b", "/\b", "|\b", "\\\b"};
 static volatile int running = 1;
+static int filtering = 0;
+static struct msg_filter expression;
+static const unsigned char dlc_table[16] = {
+    0,1,2,3,4,5,6,7,8,12,16,20,24,32,48,64
+};
 
 /*  - - - - - -  from CAN API Defs - - - - - - - - - - - - - - - - - - - -
  */
@@ -224,6 +241,8 @@ int main(int argc, char *argv[])
     DWORD std_mask = MASK_11BIT; int sm = 0;
     DWORD xtd_code = CODE_29BIT; int xc = 0;
     DWORD xtd_mask = MASK_29BIT; int xm = 0;
+    struct id_cover std_cover; int std_auto = 0;
+    struct id_cover xtd_cover; int xtd_auto = 0;
     BYTE  trace = PCAN_PARAMETER_OFF; int ts = 0;
     long  baudrate = PCAN_BAUD_250K; int bd = 0;
     long  delay = 0; int t = 0;
@@ -231,6 +250,7 @@ int main(int argc, char *argv[])
     long  can_id = 0x100; int c = 0;
     long  number = 0; int n = 0;
     int   stop_on_error = 0;
+    size_t position = 0;
     int   show_version = 0;
     int   verbose = 0;
     int   num_boards = 0;
@@ -256,6 +276,7 @@ int main(int argc, char *argv[])
         {"receive", no_argument, 0, 'r'},
         {"number", required_argument, 0, 'n'},
         {"stop", no_argument, 0, 's'},
+        {"filter", required_argument, 0, 'Z'},
         {"transmit", required_argument, 0, 't'},
         {"frames", required_argument, 0, 'f'},
         {"random", required_argument, 0, 'F'},
@@ -467,6 +488,16 @@ int main(int argc, char *argv[])
             }
             stop_on_error = 1;
             break;
+        case 'Z':  /* option '--filter=<expr>' */
+            if (filtering++) {
+                fprintf(stderr, "%s: duplicated option `--filter'\n", basename(argv[0]));
+                return 1;
+            }
+            if (!flt_compile(&expression, optarg, &position)) {
+                fprintf(stderr, "%s: illegal argument for option `--filter' (at `%s')\n", basename(argv[0]), &optarg[position]);
+                return 1;
+            }
+            break;
         case 't':  /* option '--transmit=<duration>' (-t) in [s] */
             if (m++) {
                 fprintf(stderr, "%s: duplicated option `--transmit' (%c)\n", basename(argv[0]), opt);
@@ -702,6 +733,13 @@ int main(int argc, char *argv[])
         fprintf(stderr, "%s: illegal option `--listen-only' for transmitter test\n", basename(argv[0]));
         return 1;
     }
+    /* - derive the acceptance filter from the filter expression (receiver test) */
+    if ((mode == RxMODE) && filtering) {
+        if (!sc && !sm)
+            std_auto = get_acceptance(&std_cover, MASK_11BIT);
+        if (!xc && !xm)
+            xtd_auto = get_acceptance(&xtd_cover, MASK_29BIT);
+    }
     /* CAN Tester for PCAN-USB interfaces */
     fprintf(stdout, "%s\n%s\n\n%s\n\n", APPLICATION, COPYRIGHT, WARRANTY);
     /* - show operation mode and bit-rate settings */
@@ -799,6 +837,13 @@ int main(int argc, char *argv[])
             return (int)status;;
         }
     }
+    if ((std_auto || xtd_auto) &&
+        ((status = idset_acceptance(channel, std_auto ? &std_cover : NULL, xtd_auto ? &xtd_cover : NULL)) != PCAN_ERROR_OK)) {
+        fprintf(stdout, "FAILED!\n");
+        fprintf(stderr, "+++ error: acceptance filter of PCAN-USB%u returned 0x%X\n", (channel - 0x50), status);
+        (void)CAN_Uninitialize(channel);
+        return (int)status;;
+    }
     if (trace != PCAN_PARAMETER_OFF) {
         if (getcwd((char*)buffer, 256) == NULL) {
             fprintf(stdout, "FAILED!\n");
@@ -827,6 +872,10 @@ int main(int argc, char *argv[])
         }
     }
     fprintf(stdout, "OK!\n");
+    if (std_auto)
+        idset_print_acceptance(stdout, &std_cover, MASK_11BIT);
+    if (xtd_auto)
+        idset_print_acceptance(stdout, &xtd_cover, MASK_29BIT);
     /* - do your job well: */
     switch (mode) {
     case TxMODE:    /* transmitter test (duration) */
@@ -1183,58 +1232,73 @@ static uint64_t rx_test(TPCANHandle channel, int check, uint64_t number, int sto
     time_t start = time(NULL);
 
     TPCANStatus status;
-    TPCANMsg message;
-    TPCANTimestamp timestamp;
+    TPCANMsg messages[RxBATCH], *message;
+    TPCANTimestamp timestamps[RxBATCH];
+    DWORD count, i;
 
     uint64_t frames = 0;
     uint64_t errors = 0;
     uint64_t calls = 0;
+    uint64_t filtered = 0;
     uint64_t data;
 
 #ifdef BLOCKING_READ
+    struct ev_loop loop;
     int fdes = -1;
 
     if ((status = CAN_GetValue(channel, PCAN_RECEIVE_EVENT, &fdes, sizeof(int))) != PCAN_ERROR_OK) {
         fprintf(stderr, "+++ error: CAN_GetValue PCAN_RECEIVE_EVENT returned 0x%X\n", status);
         return 0;;
     }
-    fd_set rdfs;
-    FD_ZERO(&rdfs);
-    FD_SET(fdes, &rdfs);
+    /* note: the wait is interrupted by a signal (EINTR), the signal handler stops the test */
+    if (!ev_init(&loop) || (ev_add_fd(&loop, fdes, NULL, NULL) < 0)) {
+        fprintf(stderr, "+++ error: event loop could not be started (%s)\n", strerror(errno));
+        ev_exit(&loop);
+        return 0;
+    }
 #endif
     fprintf(stderr, "\nPress ^C to abort.\n");
     fprintf(stdout, "\nReceiving message(s)...");
     fflush (stdout);
     for (;;) {
-        if ((status = CAN_Read(channel, &message, &timestamp)) == PCAN_ERROR_OK) {
-            if (!(message.MSGTYPE & PCAN_MESSAGE_STATUS)) {
+        status = CAN_ReadBatch(channel, messages, timestamps, RxBATCH, &count);
+        for (i = 0; i < count; i++) {
+            message = &messages[i];
+            if (!(message->MSGTYPE & PCAN_MESSAGE_STATUS) && filtering && !rx_filter(message))
+                filtered++;
+            else if (!(message->MSGTYPE & PCAN_MESSAGE_STATUS)) {
                if (check) {
                     data = 0;
-                    if (message.LEN > 0)
-                        data |= (uint64_t)message.DATA[0] << 0;
-                    if (message.LEN > 1)
-                        data |= (uint64_t)message.DATA[1] << 8;
-                    if (message.LEN > 2)
-                        data |= (uint64_t)message.DATA[2] << 16;
-                    if (message.LEN > 3)
-                        data |= (uint64_t)message.DATA[3] << 24;
-                    if (message.LEN > 4)
-                        data |= (uint64_t)message.DATA[4] << 32;
-                    if (message.LEN > 5)
-                        data |= (uint64_t)message.DATA[5] << 40;
-                    if (message.LEN > 6)
-                        data |= (uint64_t)message.DATA[6] << 48;
-                    if (message.LEN > 7)
-                        data |= (uint64_t)message.DATA[7] << 56;
+                    if (message->LEN > 0)
+                        data |= (uint64_t)message->DATA[0] << 0;
+                    if (message->LEN > 1)
+                        data |= (uint64_t)message->DATA[1] << 8;
+                    if (message->LEN > 2)
+                        data |= (uint64_t)message->DATA[2] << 16;
+                    if (message->LEN > 3)
+                        data |= (uint64_t)message->DATA[3] << 24;
+                    if (message->LEN > 4)
+                        data |= (uint64_t)message->DATA[4] << 32;
+                    if (message->LEN > 5)
+                        data |= (uint64_t)message->DATA[5] << 40;
+                    if (message->LEN > 6)
+                        data |= (uint64_t)message->DATA[6] << 48;
+                    if (message->LEN > 7)
+                        data |= (uint64_t)message->DATA[7] << 56;
                     if (data != number) {
                         fprintf(stderr, "\b");
                         fprintf(stdout, "FAILED!\n\n");
                         fprintf(stderr, "+++ error: data inconsistent - %"PRIu64" received / %"PRIu64" expected\n", data, number);
                         if (stop_on_error) {
                             fprintf(stdout, "Message(s)=%"PRIu64"\n", frames);
+                            if (filtering)
+                                fprintf(stdout, "Filtered=%"PRIu64"\n", filtered);
                             fprintf(stdout, "Error(s)=%"PRIu64"\n", errors);
                             fprintf(stdout, "Call(s)=%"PRIu64"\n", calls);
                             fprintf(stdout, "Time=%lisec\n\n", time(NULL) - start);
+#ifdef BLOCKING_READ
+                            ev_exit(&loop);
+#endif
                             return frames+1;
                         }
                         else {
@@ -1249,11 +1313,11 @@ static uint64_t rx_test(TPCANHandle channel, int check, uint64_t number, int sto
             else
                 errors++;
         }
-        else if (status != PCAN_ERROR_QRCVEMPTY)
+        if ((status != PCAN_ERROR_OK) && (status != PCAN_ERROR_QRCVEMPTY))
             errors++;
-        else
+        else if (status == PCAN_ERROR_QRCVEMPTY)
 #ifdef BLOCKING_READ
-            select(fdes+1, &rdfs, NULL, NULL, NULL);
+            (void)ev_poll(&loop, -1);
 #else
             timer_delay(1);
 #endif
@@ -1262,12 +1326,20 @@ static uint64_t rx_test(TPCANHandle channel, int check, uint64_t number, int sto
             fprintf(stderr, "\b");
             fprintf(stdout, "OK!\n\n");
             fprintf(stdout, "Message(s)=%"PRIu64"\n", frames);
+            if (filtering)
+                fprintf(stdout, "Filtered=%"PRIu64"\n", filtered);
             fprintf(stdout, "Error(s)=%"PRIu64"\n", errors);
             fprintf(stdout, "Call(s)=%"PRIu64"\n", calls);
             fprintf(stdout, "Time=%lisec\n\n", time(NULL) - start);
+#ifdef BLOCKING_READ
+            ev_exit(&loop);
+#endif
             return frames;
         }
     }
+#ifdef BLOCKING_READ
+    ev_exit(&loop);
+#endif
     return frames;
 }
 
@@ -1499,58 +1571,73 @@ static uint64_t rx_test_fd(TPCANHandle channel, int check, uint64_t number, int
     time_t start = time(NULL);
 
     TPCANStatus status;
-    TPCANMsgFD message;
-    TPCANTimestampFD timestamp;
+    TPCANMsgFD messages[RxBATCH], *message;
+    TPCANTimestampFD timestamps[RxBATCH];
+    DWORD count, i;
 
     uint64_t frames = 0;
     uint64_t errors = 0;
     uint64_t calls = 0;
+    uint64_t filtered = 0;
     uint64_t data;
 
 #ifdef BLOCKING_READ
+    struct ev_loop loop;
     int fdes = -1;
 
     if ((status = CAN_GetValue(channel, PCAN_RECEIVE_EVENT, &fdes, sizeof(int))) != PCAN_ERROR_OK) {
         fprintf(stderr, "+++ error: CAN_GetValue PCAN_RECEIVE_EVENT returned 0x%X\n", status);
         return 0;;
     }
-    fd_set rdfs;
-    FD_ZERO(&rdfs);
-    FD_SET(fdes, &rdfs);
+    /* note: the wait is interrupted by a signal (EINTR), the signal handler stops the test */
+    if (!ev_init(&loop) || (ev_add_fd(&loop, fdes, NULL, NULL) < 0)) {
+        fprintf(stderr, "+++ error: event loop could not be started (%s)\n", strerror(errno));
+        ev_exit(&loop);
+        return 0;
+    }
 #endif
     fprintf(stderr, "\nPress ^C to abort.\n");
     fprintf(stdout, "\nReceiving message(s)...");
     fflush (stdout);
     for (;;) {
-        if ((status = CAN_ReadFD(channel, &message, &timestamp)) == PCAN_ERROR_OK) {
-            if (!(message.MSGTYPE & PCAN_MESSAGE_STATUS)) {
+        status = CAN_ReadFDBatch(channel, messages, timestamps, RxBATCH, &count);
+        for (i = 0; i < count; i++) {
+            message = &messages[i];
+            if (!(message->MSGTYPE & PCAN_MESSAGE_STATUS) && filtering && !rx_filter_fd(message))
+                filtered++;
+            else if (!(message->MSGTYPE & PCAN_MESSAGE_STATUS)) {
                if (check) {
                     data = 0;
-                    if (message.DLC > 0)
-                        data |= (uint64_t)message.DATA[0] << 0;
-                    if (message.DLC > 1)
-                        data |= (uint64_t)message.DATA[1] << 8;
-                    if (message.DLC > 2)
-                        data |= (uint64_t)message.DATA[2] << 16;
-                    if (message.DLC > 3)
-                        data |= (uint64_t)message.DATA[3] << 24;
-                    if (message.DLC > 4)
-                        data |= (uint64_t)message.DATA[4] << 32;
-                    if (message.DLC > 5)
-                        data |= (uint64_t)message.DATA[5] << 40;
-                    if (message.DLC > 6)
-                        data |= (uint64_t)message.DATA[6] << 48;
-                    if (message.DLC > 7)
-                        data |= (uint64_t)message.DATA[7] << 56;
+                    if (message->DLC > 0)
+                        data |= (uint64_t)message->DATA[0] << 0;
+                    if (message->DLC > 1)
+                        data |= (uint64_t)message->DATA[1] << 8;
+                    if (message->DLC > 2)
+                        data |= (uint64_t)message->DATA[2] << 16;
+                    if (message->DLC > 3)
+                        data |= (uint64_t)message->DATA[3] << 24;
+                    if (message->DLC > 4)
+                        data |= (uint64_t)message->DATA[4] << 32;
+                    if (message->DLC > 5)
+                        data |= (uint64_t)message->DATA[5] << 40;
+                    if (message->DLC > 6)
+                        data |= (uint64_t)message->DATA[6] << 48;
+                    if (message->DLC > 7)
+                        data |= (uint64_t)message->DATA[7] << 56;
                     if (data != number) {
                         fprintf(stderr, "\b");
                         fprintf(stdout, "FAILED!\n\n");
                         fprintf(stderr, "+++ error: data inconsistent - %"PRIu64" received / %"PRIu64" expected\n", data, number);
                         if (stop_on_error) {
                             fprintf(stdout, "Message(s)=%"PRIu64"\n", frames);
+                            if (filtering)
+                                fprintf(stdout, "Filtered=%"PRIu64"\n", filtered);
                             fprintf(stdout, "Error(s)=%"PRIu64"\n", errors);
                             fprintf(stdout, "Call(s)=%"PRIu64"\n", calls);
                             fprintf(stdout, "Time=%lisec\n\n", time(NULL) - start);
+#ifdef BLOCKING_READ
+                            ev_exit(&loop);
+#endif
                             return frames+1;
                         }
                         else {
@@ -1565,11 +1652,11 @@ static uint64_t rx_test_fd(TPCANHandle channel, int check, uint64_t number, int
             else
                 errors++;
         }
-        else if (status != PCAN_ERROR_QRCVEMPTY)
+        if ((status != PCAN_ERROR_OK) && (status != PCAN_ERROR_QRCVEMPTY))
             errors++;
-        else
+        else if (status == PCAN_ERROR_QRCVEMPTY)
 #ifdef BLOCKING_READ
-            select(fdes+1, &rdfs, NULL, NULL, NULL);
+            (void)ev_poll(&loop, -1);
 #else
             timer_delay(1);
 #endif
@@ -1578,15 +1665,61 @@ static uint64_t rx_test_fd(TPCANHandle channel, int check, uint64_t number, int
             fprintf(stderr, "\b");
             fprintf(stdout, "OK!\n\n");
             fprintf(stdout, "Message(s)=%"PRIu64"\n", frames);
+            if (filtering)
+                fprintf(stdout, "Filtered=%"PRIu64"\n", filtered);
             fprintf(stdout, "Error(s)=%"PRIu64"\n", errors);
             fprintf(stdout, "Call(s)=%"PRIu64"\n", calls);
             fprintf(stdout, "Time=%lisec\n\n", time(NULL) - start);
+#ifdef BLOCKING_READ
+            ev_exit(&loop);
+#endif
             return frames;
         }
     }
+#ifdef BLOCKING_READ
+    ev_exit(&loop);
+#endif
     return frames;
 }
 
+static int rx_filter(const TPCANMsg *message)
+{
+    unsigned char data[64];
+    int flags = ((message->MSGTYPE & PCAN_MESSAGE_EXTENDED) ? MSG_FLAG_XTD : 0) |
+                ((message->MSGTYPE & PCAN_MESSAGE_RTR) ? MSG_FLAG_RTR : 0);
+
+    /* note: the filter reads 16 bytes at a time */
+    memcpy(data, message->DATA, 8);
+    memset(&data[8], 0, 64 - 8);
+    return flt_match(&expression, message->ID, flags, message->LEN, (message->LEN < 8) ? message->LEN : 8, data);
+}
+
+static int rx_filter_fd(const TPCANMsgFD *message)
+{
+    int flags = ((message->MSGTYPE & PCAN_MESSAGE_EXTENDED) ? MSG_FLAG_XTD : 0) |
+                ((message->MSGTYPE & PCAN_MESSAGE_RTR) ? MSG_FLAG_RTR : 0) |
+                ((message->MSGTYPE & PCAN_MESSAGE_FD) ? MSG_FLAG_FDF : 0) |
+                ((message->MSGTYPE & PCAN_MESSAGE_BRS) ? MSG_FLAG_BRS : 0) |
+                ((message->MSGTYPE & PCAN_MESSAGE_ESI) ? MSG_FLAG_ESI : 0);
+
+    return flt_match(&expression, message->ID, flags, message->DLC, dlc_table[message->DLC & 0xF], message->DATA);
+}
+
+static int get_acceptance(struct id_cover *cover, unsigned long max_id)
+{
+    struct id_set include;
+    int rc = 0, range;
+
+    /* the CAN-IDs that can pass the filter expression */
+    if (!idset_init(&include))
+        return 0;
+    if (flt_id_set(&expression, &include) && (idset_build(&include) >= 0) &&
+        idset_cover(&include, max_id, cover))
+        rc = (idset_cover_ids(cover, &range) <= max_id) ? 1 : 0;
+    idset_exit(&include);
+    return rc;
+}
+
 static void sigterm(int signo)
 {
     //fprintf(stderr, "%s: got signal %d\n", __FILE__, signo);
@@ -1602,6 +1735,7 @@ static void usage(FILE *stream, const char *program)
     fprintf(stream, " -r, --receive                 count received messages until ^C is pressed\n");
     fprintf(stream, " -n, --number=<number>         check up-counting numbers starting with <number>\n");
     fprintf(stream, " -s, --stop                    stop on error (with option --number)\n");
+    fprintf(stream, "     --filter=<expr>           count only frames matching <expr>, e.g. \"ID IN 0x100-0x1FF && DATA[0] == 0x55\"\n");
     fprintf(stream, " -m, --mode=(CCF|FDF[+BRS])    CAN operation mode: CAN CC or CAN FD\n");
     fprintf(stream, "     --listen-only             monitor mode (listen-only mode)\n");
     fprintf(stream, "     --no-status-frames        suppress reception of status frames\n");
@@ -79,6 +79,7 @@
 #include "PCANBasic.h"
 #define CAN_LIBRARY  "libpcanbasic.so"
 #endif
+#include "canbatch.h"
 #include <stdio.h>
 #include <dlfcn.h>
 #include <errno.h>
@@ -302,3 +303,41 @@ TPCANStatus CAN_LookUpChannel(LPSTR Parameters, TPCANHandle* FoundChannel) {
     else
         return PCAN_ERROR_UNKNOWN;
 }
+
+TPCANStatus CAN_ReadBatch(TPCANHandle Channel, TPCANMsg* MessageBuffer, TPCANTimestamp* TimestampBuffer, DWORD Count, DWORD* Read) {
+    TPCANStatus Status = PCAN_ERROR_OK;
+    DWORD n = 0;
+
+    if (Read)
+        *Read = 0;
+    if (LoadLibrary() != 0)
+        return PCAN_ERROR_NODRIVER;
+    if (!fpCAN_Read)
+        return PCAN_ERROR_UNKNOWN;
+    if (!MessageBuffer || !Read)
+        return PCAN_ERROR_ILLPARAMVAL;
+    // note: the library is checked once per batch, not once per frame
+    while ((n < Count) && ((Status = fpCAN_Read(Channel, &MessageBuffer[n], TimestampBuffer ? &TimestampBuffer[n] : NULL)) == PCAN_ERROR_OK))
+        n++;
+    *Read = n;
+    return Status;
+}
+
+TPCANStatus CAN_ReadFDBatch(TPCANHandle Channel, TPCANMsgFD* MessageBuffer, TPCANTimestampFD* TimestampBuffer, DWORD Count, DWORD* Read) {
+    TPCANStatus Status = PCAN_ERROR_OK;
+    DWORD n = 0;
+
+    if (Read)
+        *Read = 0;
+    if (LoadLibrary() != 0)
+        return PCAN_ERROR_NODRIVER;
+    if (!fpCAN_ReadFD)
+        return PCAN_ERROR_UNKNOWN;
+    if (!MessageBuffer || !Read)
+        return PCAN_ERROR_ILLPARAMVAL;
+    // note: the library is checked once per batch, not once per frame
+    while ((n < Count) && ((Status = fpCAN_ReadFD(Channel, &MessageBuffer[n], TimestampBuffer ? &TimestampBuffer[n] : NULL)) == PCAN_ERROR_OK))
+        n++;
+    *Read = n;
+    return Status;
+}
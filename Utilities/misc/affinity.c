@@ -0,0 +1,116 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/affinity.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Thread Affinity (Pinning of Threads to Cores)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  (see header file)
+ *
+ *  includes  :  affinity.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ */
+/** @file        affinity.c
+ *
+ *  @brief       Thread Affinity (Pinning of Threads to Cores)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @addtogroup  affinity
+ *  @{
+ */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE  /* pthread_setaffinity_np */
+#endif
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "affinity.h"
+
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#if defined(__linux__)
+#include <sched.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <mach/thread_policy.h>
+#else
+#error Platform not supported
+#endif
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int aff_cores(void)
+{
+    long cores = sysconf(_SC_NPROCESSORS_CONF);
+
+    return (cores > 0) ? (int)cores : 1;
+}
+
+int aff_pin(pthread_t thread, int core)
+{
+#if defined(__linux__)
+    cpu_set_t cpuset;
+
+    if ((core < 0) || (core >= CPU_SETSIZE))
+        return EINVAL;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core, &cpuset);
+    return pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpuset);
+#elif defined(__APPLE__)
+    thread_affinity_policy_data_t policy;
+
+    if (core < 0)
+        return EINVAL;
+    /* note: tag 0 means no affinity, so the tag is the number of the core plus one */
+    policy.affinity_tag = (integer_t)core + 1;
+    if (thread_policy_set(pthread_mach_thread_np(thread), THREAD_AFFINITY_POLICY,
+                          (thread_policy_t)&policy, THREAD_AFFINITY_POLICY_COUNT) != KERN_SUCCESS)
+        return ENOTSUP;
+    return 0;
+#endif
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
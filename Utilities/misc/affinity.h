@@ -0,0 +1,88 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/affinity.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Thread Affinity (Pinning of Threads to Cores)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  int aff_cores(void);
+ *               int aff_pin(pthread_t thread, int core);
+ *
+ *  includes  :  <pthread.h>
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  A thread is pinned to one core, so that it is not migrated between
+ *  the cores and does not compete with the threads of other cores (e.g.
+ *  one reader thread per CAN channel):
+ *  - on Linux the CPU affinity mask of the thread is set to the core
+ *    (pthread_setaffinity_np);
+ *  - on macOS there is no pinning; the core is given as affinity tag of
+ *    the thread (THREAD_AFFINITY_POLICY), so that threads with different
+ *    tags are scheduled onto different cores if possible.  The policy is
+ *    not supported on Apple silicon (the tag is ignored then).
+ */
+/** @file        affinity.h
+ *
+ *  @brief       Thread Affinity (Pinning of Threads to Cores)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    affinity Thread Affinity (Pinning of Threads to Cores)
+ *  @{
+ */
+#ifndef AFFINITY_H_INCLUDED
+#define AFFINITY_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include <pthread.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       returns the number of cores (configured).
+ *
+ *  @returns     number of cores (at least 1)
+ */
+int aff_cores(void);
+
+/** @brief       pins a thread to a core.
+ *
+ *  @param[in]   thread  the thread (e.g. from pthread_create)
+ *  @param[in]   core    number of the core (0..aff_cores()-1)
+ *
+ *  @returns     zero on success, or an error number otherwise
+ */
+int aff_pin(pthread_t thread, int core);
+
+
+#endif /* AFFINITY_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,397 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/busload.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Bus Load of a CAN Network (Frame Lengths with Bit Stuffing)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Microsoft Visual C/C++ Compiler
+ *               Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  (see header file)
+ *
+ *  includes  :  busload.h, printmsg.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ */
+/** @file        busload.c
+ *
+ *  @brief       Bus Load of a CAN Network (Frame Lengths with Bit Stuffing)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @addtogroup  bus_load
+ *  @{
+ */
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "busload.h"
+#include "printmsg.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sys/time.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define CRC15_POLY      (0x4599u)   /* CAN CC: x^15+x^14+x^10+x^8+x^7+x^4+x^3+1 */
+#define TRAILER_BITS    (13)        /* CRC delimiter, ACK slot and delimiter, EOF, intermission */
+#define FD_CRC17_FIELD  (4+17+6)    /* stuff count, CRC-17 and fixed stuff bits */
+#define FD_CRC21_FIELD  (4+21+7)    /* stuff count, CRC-21 and fixed stuff bits */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+/* bit stuffing: level of the last bit and number of equal bits (1..4) */
+struct stuffing {
+    unsigned last;
+    unsigned run;
+    unsigned long bits;             /* transmitted bits (incl. stuff bits) */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static void make_tables(void);
+static uint64_t make_entry(unsigned value, int count);
+static void put_bits(struct stuffing *stuff, uint64_t value, int count);
+static void put_bytes(struct stuffing *stuff, const unsigned char *data, int len);
+static unsigned crc15(uint64_t header, int count, const unsigned char *data, int len);
+static int advance(struct bus_load *load, uint64_t number);
+static uint64_t get_time_usec(void);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+static uint64_t stuff_table[256];       /* byte -> 8 x (stuff bits << 3 | state) by state (level << 2 | run-1) */
+static uint64_t stuff_tail[256];        /* 1..7 bits (1 << count | value) -> dto. */
+static uint16_t crc15_table[256];       /* CRC-15 of a byte */
+static int tables_ready = 0;
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int load_init(struct bus_load *load, unsigned long nominal, unsigned long data, unsigned long interval)
+{
+    if (!load || !nominal || !interval)
+        return 0;
+    memset(load, 0, sizeof(struct bus_load));
+    load->bit_rate = nominal;
+    load->data_rate = data;
+    load->interval = (uint64_t)interval * 1000ull;
+    if (!tables_ready)
+        make_tables();
+    return 1;
+}
+
+unsigned long load_frame_bits(unsigned long id, int flags, int dlc, int len, const unsigned char *data, unsigned long *data_bits)
+{
+    struct stuffing stuff;
+    unsigned long nominal;
+    uint64_t header;
+    int count, last;
+
+    if (!tables_ready)
+        make_tables();
+    if (len < 0)
+        len = 0;
+    /* note: the bus is idle (recessive) before SOF, so SOF starts a new sequence */
+    stuff.last = 1u;
+    stuff.run = 1u;
+    stuff.bits = 0ul;
+    if (!(flags & MSG_FLAG_FDF)) {
+        /* CAN CC: SOF to CRC with dynamic stuffing (the CRC is stuffed as well) */
+        if (len > 8)
+            len = 8;
+        if (flags & MSG_FLAG_RTR)
+            len = 0;
+        if (!(flags & MSG_FLAG_XTD)) {
+            header = ((uint64_t)(id & 0x7FFul) << 7) |                          /* SOF, ID, */
+                     ((flags & MSG_FLAG_RTR) ? 0x40u : 0x0u) |                  /* RTR, IDE, r0, */
+                     ((uint64_t)dlc & 0xFu);                                    /* DLC */
+            count = 19;
+        }
+        else {
+            header = ((uint64_t)((id >> 18) & 0x7FFul) << 27) | (0x3ull << 25) | /* SOF, ID-A, SRR, IDE, */
+                     ((uint64_t)(id & 0x3FFFFul) << 7) |                        /* ID-B, */
+                     ((flags & MSG_FLAG_RTR) ? 0x40u : 0x0u) |                  /* RTR, r1, r0, */
+                     ((uint64_t)dlc & 0xFu);                                    /* DLC */
+            count = 39;
+        }
+        put_bits(&stuff, header, count);
+        put_bytes(&stuff, data, len);
+        put_bits(&stuff, (uint64_t)crc15(header, count, data, len), 15);
+        if (data_bits)
+            *data_bits = 0ul;
+        return stuff.bits + TRAILER_BITS;
+    }
+    /* CAN FD: SOF to BRS in the nominal phase */
+    if (len > 64)
+        len = 64;
+    if (!(flags & MSG_FLAG_XTD))
+        put_bits(&stuff, ((uint64_t)(id & 0x7FFul) << 5) | 0x4u |               /* SOF, ID, RRS, IDE, FDF, res, */
+                         ((flags & MSG_FLAG_BRS) ? 0x1u : 0x0u), 17);           /* BRS */
+    else
+        put_bits(&stuff, ((uint64_t)((id >> 18) & 0x7FFul) << 24) | (0x3ull << 22) |  /* SOF, ID-A, SRR, IDE, */
+                         ((uint64_t)(id & 0x3FFFFul) << 4) | 0x4u |             /* ID-B, RRS, FDF, res, */
+                         ((flags & MSG_FLAG_BRS) ? 0x1u : 0x0u), 36);           /* BRS */
+    nominal = stuff.bits;
+    /* ESI to CRC field in the data phase (with bit-rate switching) */
+    stuff.bits = 0ul;
+    put_bits(&stuff, (((flags & MSG_FLAG_ESI) ? 1u : 0u) << 4) | ((uint64_t)dlc & 0xFu), 5);
+    put_bytes(&stuff, data, len);
+    /* note: a stuff bit after the last bit of the data field is replaced by
+     *       the first fixed stuff bit of the CRC field */
+    last = len ? (data[len - 1] & 0x01) : (dlc & 0x01);
+    if (stuff.last != (unsigned)last)
+        stuff.bits--;
+    stuff.bits += (len > 16) ? FD_CRC21_FIELD : FD_CRC17_FIELD;
+    if (flags & MSG_FLAG_BRS) {
+        if (data_bits)
+            *data_bits = stuff.bits;
+        return nominal + TRAILER_BITS;
+    }
+    if (data_bits)
+        *data_bits = 0ul;
+    return nominal + stuff.bits + TRAILER_BITS;
+}
+
+int load_update(struct bus_load *load, uint64_t timestamp, unsigned long id, int flags, int dlc, int len, const unsigned char *data)
+{
+    unsigned long nominal, fast = 0ul;
+    int completed = 0;
+
+    if (!load || !load->interval)
+        return 0;
+    if (!load->started) {
+        load->start = timestamp;
+        load->offset = get_time_usec() - timestamp;
+        load->started = 1;
+    }
+    /* note: a frame is counted into the interval of its time-stamp */
+    if (timestamp >= load->start)
+        completed = advance(load, (timestamp - load->start) / load->interval);
+    nominal = load_frame_bits(id, flags, dlc, len, data, &fast);
+    load->current.frames++;
+    load->current.nominal += (uint64_t)nominal;
+    load->current.data += (uint64_t)fast;
+    load->frames++;
+    return completed;
+}
+
+int load_poll(struct bus_load *load)
+{
+    uint64_t now;
+
+    if (!load || !load->started)
+        return 0;
+    now = get_time_usec() - load->offset;
+    if (now < load->start)
+        return 0;
+    return advance(load, (now - load->start) / load->interval);
+}
+
+int load_print(const struct bus_load *load, FILE *stream)
+{
+    if (!load || !stream)
+        return 0;
+    if (load->data_rate)
+        fprintf(stream, "Bus load: %5.1f%% (nominal %.1f%%, data %.1f%%), %" PRIu64 " frame(s), peak %.1f%%\n",
+                load->last.load, load->last.load_nominal, load->last.load_data, load->last.frames, load->peak.load);
+    else
+        fprintf(stream, "Bus load: %5.1f%%, %" PRIu64 " frame(s), peak %.1f%%\n",
+                load->last.load, load->last.frames, load->peak.load);
+    return ferror(stream) ? 0 : 1;
+}
+
+int load_report(const struct bus_load *load, FILE *stream)
+{
+    double average;
+
+    if (!load || !stream)
+        return 0;
+    average = load->intervals ? (load->busy * 100.0) / ((double)load->intervals * (double)load->interval) : 0.0;
+    fprintf(stream, "Bus load: %.1f%% average over %" PRIu64 " interval(s) of %" PRIu64 "ms, peak %.1f%%",
+            average, load->intervals, (uint64_t)(load->interval / 1000u), load->peak.load);
+    if (load->peak.frames) {
+        fprintf(stream, " at %.3fs", (double)(load->peak_number * load->interval) / 1000000.0);
+        if (load->data_rate)
+            fprintf(stream, " (nominal %.1f%%, data %.1f%%)", load->peak.load_nominal, load->peak.load_data);
+    }
+    fprintf(stream, "\n");
+    return ferror(stream) ? 0 : 1;
+}
+
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static void make_tables(void)
+{
+    unsigned crc;
+    int byte, bit, count;
+
+    for (byte = 0; byte < 256; byte++)
+        stuff_table[byte] = make_entry((unsigned)byte, 8);
+    for (count = 1; count < 8; count++) {
+        for (byte = 0; byte < (1 << count); byte++)
+            stuff_tail[(1 << count) | byte] = make_entry((unsigned)byte, count);
+    }
+    for (byte = 0; byte < 256; byte++) {
+        crc = (unsigned)byte << 7;
+        for (bit = 0; bit < 8; bit++)
+            crc = (crc & 0x4000u) ? ((crc << 1) ^ CRC15_POLY) : (crc << 1);
+        crc15_table[byte] = (uint16_t)(crc & 0x7FFFu);
+    }
+    tables_ready = 1;
+}
+
+static uint64_t make_entry(unsigned value, int count)
+{
+    unsigned state, level, run, bit, stuffed;
+    uint64_t entry = 0ull;
+    int i;
+
+    for (state = 0; state < 8; state++) {
+        level = state >> 2;
+        run = (state & 3u) + 1u;
+        stuffed = 0u;
+        for (i = count - 1; i >= 0; i--) {
+            bit = (value >> i) & 1u;
+            if (bit == level)
+                run++;
+            else {
+                level = bit;
+                run = 1u;
+            }
+            if (run == 5u) {
+                /* stuff bit of the opposite level (starts a new sequence) */
+                level ^= 1u;
+                run = 1u;
+                stuffed++;
+            }
+        }
+        entry |= (uint64_t)((stuffed << 3) | (level << 2) | (run - 1u)) << (state * 5u);
+    }
+    return entry;
+}
+
+static void put_bits(struct stuffing *stuff, uint64_t value, int count)
+{
+    unsigned state = (stuff->last << 2) | (stuff->run - 1u);
+    unsigned entry;
+
+    /* note: whole bytes and the remaining bits by the tables */
+    while (count >= 8) {
+        count -= 8;
+        entry = (unsigned)(stuff_table[(value >> count) & 0xFFu] >> (state * 5u)) & 0x1Fu;
+        stuff->bits += 8u + (entry >> 3);
+        state = entry & 7u;
+    }
+    if (count > 0) {
+        entry = (unsigned)(stuff_tail[(1u << count) | (unsigned)(value & ((1u << count) - 1u))] >> (state * 5u)) & 0x1Fu;
+        stuff->bits += (unsigned)count + (entry >> 3);
+        state = entry & 7u;
+    }
+    stuff->last = state >> 2;
+    stuff->run = (state & 3u) + 1u;
+}
+
+static void put_bytes(struct stuffing *stuff, const unsigned char *data, int len)
+{
+    unsigned state = (stuff->last << 2) | (stuff->run - 1u);
+    unsigned entry;
+    int i;
+
+    for (i = 0; i < len; i++) {
+        /* note: the table entry does not depend on the state, only the shift */
+        entry = (unsigned)(stuff_table[data[i]] >> (state * 5u)) & 0x1Fu;
+        stuff->bits += 8u + (entry >> 3);
+        state = entry & 7u;
+    }
+    stuff->last = state >> 2;
+    stuff->run = (state & 3u) + 1u;
+}
+
+static unsigned crc15(uint64_t header, int count, const unsigned char *data, int len)
+{
+    unsigned crc = 0u;
+    int i;
+
+    /* note: leading zeros do not change the CRC (the register starts with 0),
+     *       so the header is padded to whole bytes and the data is aligned */
+    for (i = ((count + 7) / 8) - 1; i >= 0; i--)
+        crc = ((crc << 8) ^ crc15_table[((crc >> 7) ^ (unsigned)(header >> (i * 8))) & 0xFFu]) & 0x7FFFu;
+    for (i = 0; i < len; i++)
+        crc = ((crc << 8) ^ crc15_table[((crc >> 7) ^ data[i]) & 0xFFu]) & 0x7FFFu;
+    return crc;
+}
+
+static int advance(struct bus_load *load, uint64_t number)
+{
+    struct load_interval *current = &load->current;
+    double seconds = (double)load->interval / 1000000.0;
+    double nominal, data;
+
+    if (number <= load->number)
+        return 0;
+    /* complete the current interval */
+    nominal = (double)current->nominal / (double)load->bit_rate;
+    data = (double)current->data / (double)(load->data_rate ? load->data_rate : load->bit_rate);
+    current->load_nominal = (nominal * 100.0) / seconds;
+    current->load_data = (data * 100.0) / seconds;
+    current->load = current->load_nominal + current->load_data;
+    load->busy += (nominal + data) * 1000000.0;
+    if (current->load > load->peak.load) {
+        load->peak = *current;
+        load->peak_number = load->number;
+    }
+    load->last = *current;
+    load->intervals++;
+    memset(current, 0, sizeof(struct load_interval));
+    /* note: intervals without frames in between have no load */
+    if ((number - load->number) > 1) {
+        memset(&load->last, 0, sizeof(struct load_interval));
+        load->intervals += number - load->number - 1;
+    }
+    load->number = number;
+    return 1;
+}
+
+static uint64_t get_time_usec(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return ((uint64_t)tv.tv_sec * 1000000ull) + (uint64_t)tv.tv_usec;
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
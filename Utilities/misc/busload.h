@@ -0,0 +1,175 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/busload.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Bus Load of a CAN Network (Frame Lengths with Bit Stuffing)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Microsoft Visual C/C++ Compiler
+ *               Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  int load_init(struct bus_load *load, unsigned long nominal, unsigned long data, unsigned long interval);
+ *               unsigned long load_frame_bits(unsigned long id, int flags, int dlc, int len, const unsigned char *data, unsigned long *data_bits);
+ *               int load_update(struct bus_load *load, uint64_t timestamp, unsigned long id, int flags, int dlc, int len, const unsigned char *data);
+ *               int load_poll(struct bus_load *load);
+ *               int load_print(const struct bus_load *load, FILE *stream);
+ *               int load_report(const struct bus_load *load, FILE *stream);
+ *
+ *  includes  :  (none)
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  The bus load is the time the received frames occupy the bus, in per
+ *  cent of an interval.  The on-wire length of a frame is computed from
+ *  its format (11-bit or 29-bit ID, remote frame, CAN FD with or without
+ *  bit-rate switching) and its content: the stuff bits depend on the
+ *  identifier, the DLC, the data bytes and (for CAN CC) the CRC, so they
+ *  are counted exactly, with a table per byte for the data field.  CAN FD
+ *  frames have a stuff count and fixed stuff bits in the CRC field.  The
+ *  end of frame and the intermission (3 bits) are counted as well.
+ *
+ *  With bit-rate switching the bits from the ESI bit to the end of the
+ *  CRC field are transmitted with the data bit-rate, the other ones with
+ *  the nominal bit-rate; the time of both phases is reported separately.
+ *
+ *  The intervals are taken from the time-stamps of the frames.  On an
+ *  idle bus they are closed by the wall clock (see load_poll).
+ */
+/** @file        busload.h
+ *
+ *  @brief       Bus Load of a CAN Network (Frame Lengths with Bit Stuffing)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    bus_load Bus Load of a CAN Network (Frame Lengths with Bit Stuffing)
+ *  @{
+ */
+#ifndef BUSLOAD_H_INCLUDED
+#define BUSLOAD_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define LOAD_INTERVAL   (1000)      /**< default interval [msec] */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+/** bus load of one interval
+ */
+struct load_interval {
+    uint64_t frames;                /**< number of frames */
+    uint64_t nominal;               /**< bits in the nominal phase */
+    uint64_t data;                  /**< bits in the data phase */
+    double load;                    /**< bus load [%] */
+    double load_nominal;            /**< nominal phase [%] */
+    double load_data;               /**< data phase [%] */
+};
+
+/** bus load of a CAN network
+ */
+struct bus_load {
+    unsigned long bit_rate;         /**< nominal bit-rate [bit/s] */
+    unsigned long data_rate;        /**< data phase bit-rate [bit/s] */
+    uint64_t interval;              /**< length of an interval [usec] */
+    uint64_t start;                 /**< begin of the first interval [usec] */
+    uint64_t number;                /**< number of the current interval */
+    uint64_t offset;                /**< wall clock - time-stamp [usec] */
+    int started;                    /**< first frame received */
+    struct load_interval current;   /**< current interval (counting) */
+    struct load_interval last;      /**< last completed interval */
+    struct load_interval peak;      /**< interval with the highest load */
+    uint64_t peak_number;           /**< number of the peak interval */
+    uint64_t intervals;             /**< number of completed intervals */
+    uint64_t frames;                /**< number of frames (total) */
+    double busy;                    /**< time occupied by frames [usec] (total) */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       initializes the bus load.
+ *
+ *  @param[out]  load      pointer to the bus load
+ *  @param[in]   nominal   nominal bit-rate [bit/s]
+ *  @param[in]   data      data phase bit-rate [bit/s] (or 0 w/o bit-rate switching)
+ *  @param[in]   interval  length of an interval [msec]
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int load_init(struct bus_load *load, unsigned long nominal, unsigned long data, unsigned long interval);
+
+/** @brief       computes the on-wire length of a frame (including stuff bits,
+ *               end of frame and intermission).
+ *
+ *  @param[in]   id         CAN identifier
+ *  @param[in]   flags      message flags (MSG_FLAG_xyz)
+ *  @param[in]   dlc        data length code
+ *  @param[in]   len        number of data bytes (0..8 or 0..64)
+ *  @param[in]   data       data bytes
+ *  @param[out]  data_bits  bits in the data phase (with bit-rate switching), or NULL
+ *
+ *  @returns     bits in the nominal phase (all bits w/o bit-rate switching)
+ */
+unsigned long load_frame_bits(unsigned long id, int flags, int dlc, int len, const unsigned char *data, unsigned long *data_bits);
+
+/** @brief       counts a CAN message into the interval of its time-stamp.
+ *
+ *  @param[in]   load       pointer to the bus load
+ *  @param[in]   timestamp  time-stamp of the CAN message [usec]
+ *  @param[in]   id         CAN identifier
+ *  @param[in]   flags      message flags (MSG_FLAG_xyz)
+ *  @param[in]   dlc        data length code
+ *  @param[in]   len        number of data bytes
+ *  @param[in]   data       data bytes
+ *
+ *  @returns     non-zero value when an interval has been completed
+ */
+int load_update(struct bus_load *load, uint64_t timestamp, unsigned long id, int flags, int dlc, int len, const unsigned char *data);
+
+/** @brief       completes the intervals that are over by the wall clock (to
+ *               be called when the bus is idle).
+ *
+ *  @returns     non-zero value when an interval has been completed
+ */
+int load_poll(struct bus_load *load);
+
+/** @brief       writes the bus load of the last completed interval (one line).
+ *
+ *  @returns     non-zero value on success, or zero on a write error
+ */
+int load_print(const struct bus_load *load, FILE *stream);
+
+/** @brief       writes a summary: average and peak bus load.
+ *
+ *  @returns     non-zero value on success, or zero on a write error
+ */
+int load_report(const struct bus_load *load, FILE *stream);
+
+
+#endif /* BUSLOAD_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,114 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/canbatch.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Batch Reception of CAN Messages (PCAN-Basic Wrapper)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  TPCANStatus CAN_ReadBatch(TPCANHandle Channel, TPCANMsg* MessageBuffer, TPCANTimestamp* TimestampBuffer, DWORD Count, DWORD* Read);
+ *               TPCANStatus CAN_ReadFDBatch(TPCANHandle Channel, TPCANMsgFD* MessageBuffer, TPCANTimestampFD* TimestampBuffer, DWORD Count, DWORD* Read);
+ *
+ *  includes  :  PCBUSB.h resp. PCANBasic.h (or pcan_api.h)
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  The batch functions read up to n messages with one call: the wrapper
+ *  (PCBUSB.c) checks the library once and then calls CAN_Read resp.
+ *  CAN_ReadFD of the library directly, until the array is full or the
+ *  receive queue is empty.  The messages and time-stamps are stored in
+ *  caller arrays, in the order of reception.
+ *
+ *  The result is PCAN_ERROR_OK when the array is full, PCAN_ERROR_QRCVEMPTY
+ *  when the receive queue ran empty, or the error of the first failed read;
+ *  in any case the number of messages read before is returned in 'Read'.
+ *
+ *  In the standalone build (w/o the wrapper), the batch functions are a
+ *  loop over CAN_Read resp. CAN_ReadFD.
+ */
+/** @file        canbatch.h
+ *
+ *  @brief       Batch Reception of CAN Messages (PCAN-Basic Wrapper)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    can_batch Batch Reception of CAN Messages (PCAN-Basic Wrapper)
+ *  @{
+ */
+#ifndef CANBATCH_H_INCLUDED
+#define CANBATCH_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#if (OPTION_PCBUSB_STANDALONE != 0)
+#include "pcan_api.h"
+#else
+#if defined(__APPLE__)
+#include "PCBUSB.h"
+#else
+#include "PCANBasic.h"
+#endif
+#endif
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+#if (OPTION_PCBUSB_STANDALONE == 0)
+
+/** @brief       reads up to n CAN messages from the receive queue of a channel.
+ *
+ *  @param[in]   Channel          channel handle
+ *  @param[out]  MessageBuffer    array of (at least) Count messages
+ *  @param[out]  TimestampBuffer  array of (at least) Count time-stamps (or NULL)
+ *  @param[in]   Count            max. number of messages to be read
+ *  @param[out]  Read             number of messages read
+ *
+ *  @returns     PCAN_ERROR_OK if Count messages have been read,
+ *               PCAN_ERROR_QRCVEMPTY if the receive queue ran empty,
+ *               or the error code of the first failed read
+ */
+TPCANStatus CAN_ReadBatch(TPCANHandle Channel, TPCANMsg* MessageBuffer, TPCANTimestamp* TimestampBuffer, DWORD Count, DWORD* Read);
+
+/** @brief       reads up to n CAN FD messages from the receive queue of a
+ *               channel (see CAN_ReadBatch).
+ */
+TPCANStatus CAN_ReadFDBatch(TPCANHandle Channel, TPCANMsgFD* MessageBuffer, TPCANTimestampFD* TimestampBuffer, DWORD Count, DWORD* Read);
+
+#else
+
+static inline TPCANStatus CAN_ReadBatch(TPCANHandle Channel, TPCANMsg* MessageBuffer, TPCANTimestamp* TimestampBuffer, DWORD Count, DWORD* Read) {
+    TPCANStatus Status = PCAN_ERROR_OK;
+
+    for (*Read = 0; (*Read < Count) && ((Status = CAN_Read(Channel, &MessageBuffer[*Read], TimestampBuffer ? &TimestampBuffer[*Read] : NULL)) == PCAN_ERROR_OK); (*Read)++);
+    return Status;
+}
+
+static inline TPCANStatus CAN_ReadFDBatch(TPCANHandle Channel, TPCANMsgFD* MessageBuffer, TPCANTimestampFD* TimestampBuffer, DWORD Count, DWORD* Read) {
+    TPCANStatus Status = PCAN_ERROR_OK;
+
+    for (*Read = 0; (*Read < Count) && ((Status = CAN_ReadFD(Channel, &MessageBuffer[*Read], TimestampBuffer ? &TimestampBuffer[*Read] : NULL)) == PCAN_ERROR_OK); (*Read)++);
+    return Status;
+}
+
+#endif
+
+#endif /* CANBATCH_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
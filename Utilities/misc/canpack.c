@@ -0,0 +1,758 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/canpack.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Compressed Capture of CAN Messages (Delta Encoding, LZ)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Microsoft Visual C/C++ Compiler
+ *               Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  (see header file)
+ *
+ *  includes  :  canpack.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ */
+/** @file        canpack.c
+ *
+ *  @brief       Compressed Capture of CAN Messages (Delta Encoding, LZ)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @addtogroup  can_pack
+ *  @{
+ */
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "canpack.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <time.h>
+#include <sys/time.h>
+#else
+#include <windows.h>
+#endif
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define PACK_IDS_MAX    ((PACK_IDS / 4) * 3)  /* load factor of the table of CAN-IDs */
+#define TABLE_HASH_SHIFT (32 - 12)          /* 2^12 = PACK_IDS */
+
+#define LZ_MIN_MATCH    (4)
+#define LZ_MAX_OFFSET   (65535)
+#define LZ_HASH_BITS    (12)
+#define LZ_HASH_SIZE    (1U << LZ_HASH_BITS)
+#define LZ_NO_POSITION  (0xFFFFFFFFU)
+
+#define FOLLOW_DELAY    (100)       /* 100ms [msec] */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static int table_init(struct pack_table *table);
+static void table_reset(struct pack_table *table);
+static struct pack_entry *table_lookup(struct pack_table *table, uint32_t key, int *fresh);
+static uint64_t table_predict(const struct pack_entry *entry, int fresh, uint64_t last);
+static int write_header(struct pack_writer *writer);
+static int write_block(struct pack_writer *writer);
+static int read_bytes(struct pack_reader *reader, size_t length);
+static int read_block(struct pack_reader *reader);
+static int decode_frame(struct pack_reader *reader, struct rec_message *message);
+
+static size_t lz_compress(const unsigned char *src, size_t length, unsigned char *dst, size_t capacity, uint32_t *hash);
+static long lz_decompress(const unsigned char *src, size_t length, unsigned char *dst, size_t capacity);
+static unsigned char *lz_sequence(unsigned char *op, const unsigned char *literals, size_t count, size_t offset, size_t match);
+
+static size_t put_varint(unsigned char *ptr, uint64_t value);
+static int get_varint(const unsigned char *ptr, size_t length, size_t *pos, uint64_t *value);
+static void put_le16(unsigned char *ptr, uint16_t value);
+static void put_le32(unsigned char *ptr, uint32_t value);
+static void put_le64(unsigned char *ptr, uint64_t value);
+static uint16_t get_le16(const unsigned char *ptr);
+static uint32_t get_le32(const unsigned char *ptr);
+static uint64_t get_le64(const unsigned char *ptr);
+static uint64_t get_time_usec(void);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int pack_writer_init(struct pack_writer *writer, FILE *stream, int canfd)
+{
+    if (!writer || !stream)
+        return 0;
+    memset(writer, 0, sizeof(struct pack_writer));
+    writer->stream = stream;
+    writer->canfd = canfd ? 1 : 0;
+    if (!table_init(&writer->table))
+        return 0;
+    writer->raw = (unsigned char*)malloc(PACK_BLOCK_SIZE);
+    writer->packed = (unsigned char*)malloc(PACK_BLOCK_HEADER + PACK_BLOCK_SIZE);
+    writer->hash = (uint32_t*)malloc(LZ_HASH_SIZE * sizeof(uint32_t));
+    if (!writer->raw || !writer->packed || !writer->hash) {
+        pack_writer_exit(writer);
+        return 0;
+    }
+    if (!write_header(writer)) {
+        pack_writer_exit(writer);
+        return 0;
+    }
+    return 1;
+}
+
+int pack_write_message(struct pack_writer *writer,
+                       uint64_t timestamp, unsigned long id, int flags, int dlc, int len, const unsigned char *data)
+{
+    struct pack_entry *entry;
+    unsigned char *out, *mask;
+    unsigned char delta;
+    uint32_t key;
+    int64_t diff;
+    int max = (writer && writer->canfd) ? 64 : 8;
+    int fresh, changed, i;
+    size_t n;
+    int rc = 1;
+
+    if (!writer || !writer->raw || (len < 0))
+        return 0;
+    if (len > max)
+        len = max;
+    /* close the block when it is full or its time span is over */
+    if ((writer->used > 0) &&
+        (((writer->used + PACK_FRAME_MAX) > PACK_BLOCK_SIZE) || (writer->table.used >= PACK_IDS_MAX) ||
+         ((timestamp - writer->first) >= PACK_BLOCK_TIME)))
+        rc = write_block(writer);
+    if (writer->used == 0) {
+        writer->first = writer->last = timestamp;
+        writer->deadline = get_time_usec() + PACK_BLOCK_TIME;
+    }
+    key = ((uint32_t)id << 1) | ((flags & MSG_FLAG_XTD) ? 1U : 0U);
+    entry = table_lookup(&writer->table, key, &fresh);
+    /* tag, CAN-ID (key or number) and time-stamp deviation (zig-zag) */
+    out = &writer->raw[writer->used];
+    out[0] = fresh ? PACK_TAG_NEW : 0x00;
+    n = 1;
+    n += put_varint(&out[n], fresh ? (uint64_t)key : (uint64_t)entry->number);
+    diff = (int64_t)(timestamp - table_predict(entry, fresh, writer->last));
+    n += put_varint(&out[n], ((uint64_t)diff << 1) ^ (uint64_t)(diff >> 63));
+    /* flags, DLC and length (only when they changed) */
+    if (fresh || (entry->flags != (uint8_t)flags) || (entry->dlc != (uint8_t)dlc) || (entry->len != (uint8_t)len)) {
+        out[0] |= PACK_TAG_SHAPE;
+        out[n++] = (unsigned char)flags;
+        out[n++] = (unsigned char)dlc;
+        out[n++] = (unsigned char)len;
+    }
+    /* data bytes: mask of the changed bytes and their XOR delta */
+    mask = &out[n];
+    memset(mask, 0, (size_t)((len + 7) / 8));
+    n += (size_t)((len + 7) / 8);
+    for (i = 0, changed = 0; i < len; i++) {
+        if ((delta = data[i] ^ entry->data[i]) != 0x00) {
+            mask[i >> 3] |= (unsigned char)(1U << (i & 7));
+            out[n++] = delta;
+            changed++;
+        }
+    }
+    if (!changed) {
+        out[0] |= PACK_TAG_SAME;
+        n -= (size_t)((len + 7) / 8);
+    }
+    /* remember the frame of the CAN-ID */
+    if (entry->len > (uint8_t)len)
+        memset(&entry->data[len], 0x00, (size_t)(entry->len - len));
+    if (len > 0)
+        memcpy(entry->data, data, (size_t)len);
+    entry->flags = (uint8_t)flags;
+    entry->dlc = (uint8_t)dlc;
+    entry->len = (uint8_t)len;
+    entry->cycle = fresh ? 0U : (timestamp - entry->time);
+    entry->time = timestamp;
+    writer->used += n;
+    writer->last = timestamp;
+    writer->count++;
+    writer->frames++;
+    return rc;
+}
+
+int pack_flush(struct pack_writer *writer, int force)
+{
+    if (!writer || !writer->raw)
+        return 0;
+    if ((writer->used > 0) && (force || (get_time_usec() >= writer->deadline)))
+        return write_block(writer);
+    return 1;
+}
+
+int pack_writer_switch(struct pack_writer *writer, FILE *stream)
+{
+    int rc;
+
+    if (!writer || !writer->raw || !stream)
+        return 0;
+    rc = write_block(writer);
+    writer->stream = stream;
+    return write_header(writer) ? rc : 0;
+}
+
+void pack_writer_exit(struct pack_writer *writer)
+{
+    if (!writer)
+        return;
+    if (writer->raw && writer->packed && writer->hash && writer->stream)
+        (void)write_block(writer);
+    free(writer->table.entries);
+    free(writer->table.numbers);
+    free(writer->raw);
+    free(writer->packed);
+    free(writer->hash);
+    writer->table.entries = NULL;
+    writer->table.numbers = NULL;
+    writer->raw = NULL;
+    writer->packed = NULL;
+    writer->hash = NULL;
+}
+
+int pack_reader_init(struct pack_reader *reader, FILE *stream)
+{
+    if (!reader || !stream)
+        return 0;
+    memset(reader, 0, sizeof(struct pack_reader));
+    reader->stream = stream;
+    if (!table_init(&reader->table))
+        return 0;
+    reader->raw = (unsigned char*)malloc(PACK_BLOCK_SIZE);
+    reader->packed = (unsigned char*)malloc(PACK_BLOCK_HEADER + PACK_BLOCK_SIZE);
+    if (!reader->raw || !reader->packed) {
+        pack_reader_exit(reader);
+        return 0;
+    }
+    return 1;
+}
+
+int pack_read_message(struct pack_reader *reader, struct rec_message *message)
+{
+    int rc;
+
+    if (!reader || !reader->raw || !message)
+        return -1;
+    /* file header (once) */
+    if (!reader->header) {
+        if (!read_bytes(reader, PACK_HEADER_SIZE))
+            return 0;
+        if ((memcmp(&reader->packed[0], PACK_MAGIC, 8) != 0) || (get_le16(&reader->packed[8]) != PACK_VERSION) ||
+            ((reader->packed[12] != PACK_MODE_CC) && (reader->packed[12] != PACK_MODE_FD)))
+            return -1;
+        reader->canfd = (reader->packed[12] == PACK_MODE_FD) ? 1 : 0;
+        reader->header = 1;
+        reader->have = 0;
+    }
+    /* next block (when the current one is done) */
+    while (reader->count == 0) {
+        if ((rc = read_block(reader)) <= 0)
+            return rc;
+    }
+    if (!decode_frame(reader, message))
+        return -1;
+    reader->count--;
+    return 1;
+}
+
+void pack_reader_exit(struct pack_reader *reader)
+{
+    if (!reader)
+        return;
+    free(reader->table.entries);
+    free(reader->table.numbers);
+    free(reader->raw);
+    free(reader->packed);
+    reader->table.entries = NULL;
+    reader->table.numbers = NULL;
+    reader->raw = NULL;
+    reader->packed = NULL;
+}
+
+uint64_t pack_render(FILE *input, FILE *output, int mode_time, int mode_id, int mode_data, int mode_ascii, int follow)
+{
+    struct pack_reader reader;
+    struct rec_message message;
+    struct msg_timestamp ts;
+    struct msg_format format;
+    struct msg_buffer buffer;
+    uint64_t frames = 0;
+    int rc;
+#ifndef _WIN32
+    struct timespec delay = { 0, FOLLOW_DELAY * 1000000L };
+#endif
+
+    if (!pack_reader_init(&reader, input))
+        return 0;
+    /* note: the mode is known after the file header has been read */
+    while ((rc = pack_read_message(&reader, &message)) == 0) {
+        if (!follow) {
+            pack_reader_exit(&reader);
+            return 0;
+        }
+#ifndef _WIN32
+        (void)nanosleep(&delay, NULL);
+#else
+        Sleep(FOLLOW_DELAY);
+#endif
+    }
+    msg_format_init(&format, mode_time, mode_id, mode_data, mode_ascii, reader.canfd);
+    if ((rc < 0) || !msg_buffer_init(&buffer, output, MSG_BUFFER_SIZE, MSG_FLUSH_FULL, 0UL)) {
+        pack_reader_exit(&reader);
+        return 0;
+    }
+    while (rc >= 0) {
+        if (rc > 0) {
+            ts.tv_sec = (long)(message.timestamp / 1000000ull);
+            ts.tv_usec = (long)(message.timestamp % 1000000ull);
+            if (!msg_buffer_message(&buffer, &format, frames++, &ts, message.id, message.flags, message.len, message.data))
+                break;
+        }
+        else if (follow) {
+            /* end of the file: wait for the next block */
+            (void)msg_buffer_flush(&buffer);
+#ifndef _WIN32
+            (void)nanosleep(&delay, NULL);
+#else
+            Sleep(FOLLOW_DELAY);
+#endif
+        }
+        else
+            break;
+        rc = pack_read_message(&reader, &message);
+    }
+    msg_buffer_exit(&buffer);
+    pack_reader_exit(&reader);
+    return frames;
+}
+
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static int table_init(struct pack_table *table)
+{
+    /* note: an entry is free if it is not from the current block */
+    table->entries = (struct pack_entry*)calloc(PACK_IDS, sizeof(struct pack_entry));
+    table->numbers = (uint32_t*)calloc(PACK_IDS, sizeof(uint32_t));
+    table->block = 1;
+    table->used = 0;
+    return (table->entries && table->numbers) ? 1 : 0;
+}
+
+static void table_reset(struct pack_table *table)
+{
+    table->block++;
+    table->used = 0;
+}
+
+static struct pack_entry *table_lookup(struct pack_table *table, uint32_t key, int *fresh)
+{
+    uint32_t index = (key * 2654435761U) >> TABLE_HASH_SHIFT;
+    struct pack_entry *entry;
+
+    for (;;) {
+        entry = &table->entries[index & (PACK_IDS - 1)];
+        if (entry->block != table->block) {
+            /* new CAN-ID in this block (zero data) */
+            entry->key = key;
+            entry->block = table->block;
+            entry->number = (uint32_t)table->used;
+            table->numbers[table->used] = index & (PACK_IDS - 1);
+            entry->flags = entry->dlc = entry->len = 0;
+            memset(entry->data, 0x00, sizeof(entry->data));
+            table->used++;
+            *fresh = 1;
+            return entry;
+        }
+        if (entry->key == key) {
+            *fresh = 0;
+            return entry;
+        }
+        index++;
+    }
+}
+
+static uint64_t table_predict(const struct pack_entry *entry, int fresh, uint64_t last)
+{
+    /* note: a cyclic message is expected one cycle time after its last frame */
+    return fresh ? last : (entry->time + entry->cycle);
+}
+
+static int write_header(struct pack_writer *writer)
+{
+    unsigned char header[PACK_HEADER_SIZE];
+
+    memset(header, 0, sizeof(header));
+    memcpy(&header[0], PACK_MAGIC, 8);
+    put_le16(&header[8], PACK_VERSION);
+    header[12] = writer->canfd ? PACK_MODE_FD : PACK_MODE_CC;
+    if ((fwrite(header, 1, PACK_HEADER_SIZE, writer->stream) != PACK_HEADER_SIZE) || (fflush(writer->stream) != 0))
+        return 0;
+    writer->bytes += PACK_HEADER_SIZE;
+    return 1;
+}
+
+static int write_block(struct pack_writer *writer)
+{
+    unsigned char *block = writer->packed;
+    size_t packed, length;
+
+    if (writer->used == 0)
+        return 1;
+    /* compress the encoded frames (or store them, if that does not pay) */
+    packed = lz_compress(writer->raw, writer->used, &block[PACK_BLOCK_HEADER], writer->used - 1, writer->hash);
+    if (packed == 0)
+        memcpy(&block[PACK_BLOCK_HEADER], writer->raw, writer->used);
+    length = PACK_BLOCK_HEADER + (packed ? packed : writer->used);
+    put_le32(&block[0], (uint32_t)writer->used);
+    put_le32(&block[4], (uint32_t)packed);
+    put_le32(&block[8], writer->count);
+    put_le32(&block[12], 0U);
+    put_le64(&block[16], writer->first);
+    writer->used = 0;
+    writer->count = 0;
+    table_reset(&writer->table);
+    /* one write per block */
+    if (fwrite(block, 1, length, writer->stream) != length)
+        return 0;
+    writer->bytes += (uint64_t)length;
+    return (fflush(writer->stream) == 0) ? 1 : 0;
+}
+
+static int read_bytes(struct pack_reader *reader, size_t length)
+{
+    size_t n;
+
+    /* note: bytes read so far are kept (the writer may still be busy) */
+    while (reader->have < length) {
+        n = fread(&reader->packed[reader->have], 1, length - reader->have, reader->stream);
+        if (n == 0) {
+            clearerr(reader->stream);
+            return 0;
+        }
+        reader->have += n;
+    }
+    return 1;
+}
+
+static int read_block(struct pack_reader *reader)
+{
+    uint32_t size, packed;
+
+    if (!read_bytes(reader, PACK_BLOCK_HEADER))
+        return 0;
+    size = get_le32(&reader->packed[0]);
+    packed = get_le32(&reader->packed[4]);
+    if ((size == 0) || (size > PACK_BLOCK_SIZE) || (packed >= size))
+        return -1;
+    if (!read_bytes(reader, PACK_BLOCK_HEADER + (size_t)(packed ? packed : size)))
+        return 0;
+    if (packed) {
+        if (lz_decompress(&reader->packed[PACK_BLOCK_HEADER], (size_t)packed, reader->raw, PACK_BLOCK_SIZE) != (long)size)
+            return -1;
+    }
+    else
+        memcpy(reader->raw, &reader->packed[PACK_BLOCK_HEADER], (size_t)size);
+    reader->size = (size_t)size;
+    reader->pos = 0;
+    reader->count = get_le32(&reader->packed[8]);
+    reader->last = get_le64(&reader->packed[16]);
+    reader->have = 0;
+    table_reset(&reader->table);
+    return 1;
+}
+
+static int decode_frame(struct pack_reader *reader, struct rec_message *message)
+{
+    const unsigned char *raw = reader->raw;
+    const unsigned char *mask;
+    struct pack_entry *entry;
+    uint64_t diff, key, stamp;
+    size_t pos = reader->pos;
+    int max = reader->canfd ? 64 : 8;
+    int tag, fresh, len, i;
+
+    if (pos >= reader->size)
+        return 0;
+    tag = (int)raw[pos++];
+    if (!get_varint(raw, reader->size, &pos, &key) || !get_varint(raw, reader->size, &pos, &diff))
+        return 0;
+    if (tag & PACK_TAG_NEW) {
+        if ((key > 0xFFFFFFFFULL) || (reader->table.used >= PACK_IDS_MAX))
+            return 0;
+        entry = table_lookup(&reader->table, (uint32_t)key, &fresh);
+        if (!fresh || !(tag & PACK_TAG_SHAPE))
+            return 0;
+    }
+    else {
+        if (key >= (uint64_t)reader->table.used)
+            return 0;
+        entry = &reader->table.entries[reader->table.numbers[key]];
+        key = (uint64_t)entry->key;
+        fresh = 0;
+    }
+    stamp = table_predict(entry, fresh, reader->last) + (uint64_t)((int64_t)(diff >> 1) ^ -(int64_t)(diff & 1));
+    if (tag & PACK_TAG_SHAPE) {
+        if ((pos + 3) > reader->size)
+            return 0;
+        entry->flags = raw[pos++];
+        entry->dlc = raw[pos++];
+        len = (int)raw[pos++];
+        if (len > max)
+            return 0;
+        if (entry->len > (uint8_t)len)
+            memset(&entry->data[len], 0x00, (size_t)(entry->len - len));
+        entry->len = (uint8_t)len;
+    }
+    len = (int)entry->len;
+    if (!(tag & PACK_TAG_SAME)) {
+        mask = &raw[pos];
+        if ((pos += (size_t)((len + 7) / 8)) > reader->size)
+            return 0;
+        for (i = 0; i < len; i++) {
+            if (mask[i >> 3] & (1U << (i & 7))) {
+                if (pos >= reader->size)
+                    return 0;
+                entry->data[i] ^= raw[pos++];
+            }
+        }
+    }
+    entry->cycle = fresh ? 0U : (stamp - entry->time);
+    entry->time = stamp;
+    reader->last = stamp;
+    reader->pos = pos;
+    message->timestamp = stamp;
+    message->id = (unsigned long)(key >> 1);
+    message->flags = (int)entry->flags;
+    message->dlc = (int)entry->dlc;
+    message->len = len;
+    memcpy(message->data, entry->data, (size_t)len);
+    return 1;
+}
+
+static size_t lz_compress(const unsigned char *src, size_t length, unsigned char *dst, size_t capacity, uint32_t *hash)
+{
+    unsigned char *op = dst;
+    size_t ip = 0, anchor = 0, ref, match;
+    uint32_t sequence, candidate;
+    uint32_t index;
+
+    memset(hash, 0xFF, LZ_HASH_SIZE * sizeof(uint32_t));
+    while ((ip + LZ_MIN_MATCH) <= length) {
+        memcpy(&sequence, &src[ip], 4);
+        index = (sequence * 2654435761U) >> (32 - LZ_HASH_BITS);
+        ref = (size_t)hash[index];
+        hash[index] = (uint32_t)ip;
+        if ((ref == (size_t)LZ_NO_POSITION) || ((ip - ref) > LZ_MAX_OFFSET) ||
+            (memcpy(&candidate, &src[ref], 4), candidate != sequence)) {
+            /* note: skip faster over data that does not compress */
+            ip += 1 + ((ip - anchor) >> 6);
+            continue;
+        }
+        for (match = LZ_MIN_MATCH; ((ip + match) < length) && (src[ref + match] == src[ip + match]); match++);
+        /* worst case: token, 2 extra bytes per 255 literals, offset and length bytes */
+        if ((size_t)(op - dst) + (ip - anchor) + ((ip - anchor) / 255) + (match / 255) + 8 > capacity)
+            return 0;
+        op = lz_sequence(op, &src[anchor], ip - anchor, ip - ref, match);
+        ip += match;
+        anchor = ip;
+    }
+    /* last sequence: literals only */
+    if ((size_t)(op - dst) + (length - anchor) + ((length - anchor) / 255) + 2 > capacity)
+        return 0;
+    op = lz_sequence(op, &src[anchor], length - anchor, 0, 0);
+    return (size_t)(op - dst);
+}
+
+static unsigned char *lz_sequence(unsigned char *op, const unsigned char *literals, size_t count, size_t offset, size_t match)
+{
+    unsigned char *token = op++;
+    size_t n;
+
+    /* token: number of literals (high nibble) and match length - 4 (low nibble) */
+    *token = (unsigned char)(((count < 15) ? count : 15) << 4);
+    if (count >= 15) {
+        for (n = count - 15; n >= 255; n -= 255)
+            *op++ = 255;
+        *op++ = (unsigned char)n;
+    }
+    memcpy(op, literals, count);
+    op += count;
+    if (match == 0)
+        return op;
+    *op++ = (unsigned char)(offset);
+    *op++ = (unsigned char)(offset >> 8);
+    match -= LZ_MIN_MATCH;
+    *token |= (unsigned char)((match < 15) ? match : 15);
+    if (match >= 15) {
+        for (n = match - 15; n >= 255; n -= 255)
+            *op++ = 255;
+        *op++ = (unsigned char)n;
+    }
+    return op;
+}
+
+static long lz_decompress(const unsigned char *src, size_t length, unsigned char *dst, size_t capacity)
+{
+    size_t ip = 0, op = 0, count, offset;
+    unsigned char token, byte;
+
+    while (ip < length) {
+        token = src[ip++];
+        /* literals */
+        count = (size_t)(token >> 4);
+        if (count == 15) {
+            do {
+                if (ip >= length)
+                    return -1;
+                byte = src[ip++];
+                count += (size_t)byte;
+            } while (byte == 255);
+        }
+        if (((ip + count) > length) || ((op + count) > capacity))
+            return -1;
+        memcpy(&dst[op], &src[ip], count);
+        ip += count;
+        op += count;
+        if (ip >= length)
+            break;
+        /* match (may overlap the output) */
+        if ((ip + 2) > length)
+            return -1;
+        offset = (size_t)src[ip] | ((size_t)src[ip + 1] << 8);
+        ip += 2;
+        if ((offset == 0) || (offset > op))
+            return -1;
+        count = (size_t)(token & 0x0F);
+        if (count == 15) {
+            do {
+                if (ip >= length)
+                    return -1;
+                byte = src[ip++];
+                count += (size_t)byte;
+            } while (byte == 255);
+        }
+        count += LZ_MIN_MATCH;
+        if ((op + count) > capacity)
+            return -1;
+        for (; count > 0; count--, op++)
+            dst[op] = dst[op - offset];
+    }
+    return (long)op;
+}
+
+static size_t put_varint(unsigned char *ptr, uint64_t value)
+{
+    size_t n = 0;
+
+    while (value >= 0x80) {
+        ptr[n++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    ptr[n++] = (unsigned char)value;
+    return n;
+}
+
+static int get_varint(const unsigned char *ptr, size_t length, size_t *pos, uint64_t *value)
+{
+    unsigned int shift = 0;
+    unsigned char byte;
+
+    *value = 0;
+    do {
+        if ((*pos >= length) || (shift > 63))
+            return 0;
+        byte = ptr[(*pos)++];
+        *value |= (uint64_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return 1;
+}
+
+static void put_le16(unsigned char *ptr, uint16_t value)
+{
+    ptr[0] = (unsigned char)(value);
+    ptr[1] = (unsigned char)(value >> 8);
+}
+
+static void put_le32(unsigned char *ptr, uint32_t value)
+{
+    ptr[0] = (unsigned char)(value);
+    ptr[1] = (unsigned char)(value >> 8);
+    ptr[2] = (unsigned char)(value >> 16);
+    ptr[3] = (unsigned char)(value >> 24);
+}
+
+static void put_le64(unsigned char *ptr, uint64_t value)
+{
+    put_le32(&ptr[0], (uint32_t)value);
+    put_le32(&ptr[4], (uint32_t)(value >> 32));
+}
+
+static uint16_t get_le16(const unsigned char *ptr)
+{
+    return (uint16_t)ptr[0] | ((uint16_t)ptr[1] << 8);
+}
+
+static uint32_t get_le32(const unsigned char *ptr)
+{
+    return (uint32_t)ptr[0] | ((uint32_t)ptr[1] << 8) | ((uint32_t)ptr[2] << 16) | ((uint32_t)ptr[3] << 24);
+}
+
+static uint64_t get_le64(const unsigned char *ptr)
+{
+    return (uint64_t)get_le32(&ptr[0]) | ((uint64_t)get_le32(&ptr[4]) << 32);
+}
+
+static uint64_t get_time_usec(void)
+{
+#ifndef _WIN32
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return ((uint64_t)tv.tv_sec * 1000000ull) + (uint64_t)tv.tv_usec;
+#else
+    return (uint64_t)GetTickCount64() * 1000ull;
+#endif
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,273 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/canpack.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Compressed Capture of CAN Messages (Delta Encoding, LZ)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Microsoft Visual C/C++ Compiler
+ *               Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  int pack_writer_init(struct pack_writer *writer, FILE *stream, int canfd);
+ *               int pack_write_message(struct pack_writer *writer, uint64_t timestamp, unsigned long id, int flags, int dlc, int len, const unsigned char *data);
+ *               int pack_flush(struct pack_writer *writer, int force);
+ *               int pack_writer_switch(struct pack_writer *writer, FILE *stream);
+ *               void pack_writer_exit(struct pack_writer *writer);
+ *               int pack_reader_init(struct pack_reader *reader, FILE *stream);
+ *               int pack_read_message(struct pack_reader *reader, struct rec_message *message);
+ *               void pack_reader_exit(struct pack_reader *reader);
+ *               uint64_t pack_render(FILE *input, FILE *output, int mode_time, int mode_id, int mode_data, int mode_ascii, int follow);
+ *
+ *  includes  :  canrec.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  A compressed capture file consists of a header followed by blocks of
+ *  CAN messages.  All fields are stored in little-endian byte order.
+ *
+ *  Header (16 bytes):
+ *    0  magic[8]     "CANPAK\r\n"
+ *    8  version      uint16_t (PACK_VERSION)
+ *   10  reserved     uint16_t (zero)
+ *   12  mode         uint8_t  (0 = CAN CC, 1 = CAN FD)
+ *   13  reserved[3]  (zero)
+ *
+ *  Block (24 bytes + payload):
+ *    0  size         uint32_t (size of the encoded frames)
+ *    4  packed       uint32_t (size of the payload, or 0 if not compressed)
+ *    8  frames       uint32_t (number of frames in the block)
+ *   12  reserved     uint32_t (zero)
+ *   16  timestamp    uint64_t (time-stamp of the first frame [usec])
+ *   24  payload      (encoded frames, LZ compressed if packed is non-zero)
+ *
+ *  Encoded frame (in a block):
+ *    tag          uint8_t  (PACK_TAG_xyz)
+ *    key          varint   (CAN identifier << 1 | 1 for 29-bit IDs, with
+ *                           tag PACK_TAG_NEW; otherwise the number of the
+ *                           CAN-ID in the block)
+ *    time         varint   (deviation from the predicted time-stamp [usec],
+ *                           zig-zag encoded)
+ *    flags, dlc, len       (3 bytes, only with tag PACK_TAG_SHAPE)
+ *    mask[(len+7)/8]       (changed bytes, not with tag PACK_TAG_SAME)
+ *    delta[n]              (changed bytes XOR the last data of the CAN-ID)
+ *
+ *  The time-stamp of a frame is predicted from the last frame and the last
+ *  cycle time of its CAN-ID (a new CAN-ID from the previous frame), so a
+ *  cyclic message takes only its jitter.  Every block starts with an empty
+ *  table of CAN-IDs, so each block can be decoded on its own.  The LZ
+ *  format is byte-oriented (sequences of a token, literals and a 16-bit
+ *  offset, as known from LZ4).  A block is closed when it is full or one
+ *  second after its first frame, so the file can be read back (with
+ *  pack_read_message) while it is written.
+ */
+/** @file        canpack.h
+ *
+ *  @brief       Compressed Capture of CAN Messages (Delta Encoding, LZ)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    can_pack Compressed Capture of CAN Messages (Delta Encoding, LZ)
+ *  @{
+ */
+#ifndef CANPACK_H_INCLUDED
+#define CANPACK_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "canrec.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define PACK_MAGIC      "CANPAK\r\n" /**< magic number (8 bytes) */
+#define PACK_VERSION    (1)         /**< version of the file layout */
+
+#define PACK_MODE_CC    (0)         /**< CAN CC messages (8 data bytes) */
+#define PACK_MODE_FD    (1)         /**< CAN FD messages (64 data bytes) */
+
+#define PACK_HEADER_SIZE (16)       /**< size of the file header */
+#define PACK_BLOCK_HEADER (24)      /**< size of a block header */
+#define PACK_BLOCK_SIZE (65536)     /**< max. size of the encoded frames of a block */
+#define PACK_BLOCK_TIME (1000000)   /**< max. time span of a block [usec] */
+#define PACK_FRAME_MAX  (96)        /**< max. size of an encoded frame */
+#define PACK_IDS        (4096)      /**< size of the table of CAN-IDs (power of 2) */
+
+#define PACK_TAG_SHAPE  (0x01)      /**< flags, DLC and length follow */
+#define PACK_TAG_SAME   (0x02)      /**< data unchanged (no mask, no delta) */
+#define PACK_TAG_NEW    (0x04)      /**< first frame of a CAN-ID in the block */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+/** last frame of a CAN-ID (in the current block)
+ */
+struct pack_entry {
+    uint32_t key;                   /**< CAN-ID key (identifier and XTD bit) */
+    uint32_t block;                 /**< block number (entry valid in this block) */
+    uint32_t number;                /**< number of the CAN-ID in the block */
+    uint64_t time;                  /**< time-stamp of the last frame [usec] */
+    uint64_t cycle;                 /**< last cycle time [usec] */
+    uint8_t flags;                  /**< message flags (MSG_FLAG_xyz) */
+    uint8_t dlc;                    /**< data length code */
+    uint8_t len;                    /**< number of data bytes */
+    unsigned char data[64];         /**< last data bytes (padded with zeros) */
+};
+
+/** table of CAN-IDs (delta state of a block)
+ */
+struct pack_table {
+    struct pack_entry *entries;     /**< open-addressing hash table */
+    uint32_t *numbers;              /**< entry of a CAN-ID by its number */
+    uint32_t block;                 /**< current block number */
+    size_t used;                    /**< number of CAN-IDs in the block */
+};
+
+/** writer of a compressed capture file
+ */
+struct pack_writer {
+    FILE *stream;                   /**< output stream */
+    int canfd;                      /**< CAN FD messages */
+    struct pack_table table;        /**< last frame per CAN-ID */
+    unsigned char *raw;             /**< encoded frames of the current block */
+    size_t used;                    /**< size of the encoded frames */
+    unsigned char *packed;          /**< block header and compressed payload */
+    uint32_t *hash;                 /**< LZ compressor: hash table of positions */
+    uint32_t count;                 /**< number of frames in the block */
+    uint64_t first;                 /**< time-stamp of the first frame [usec] */
+    uint64_t last;                  /**< time-stamp of the last frame [usec] */
+    uint64_t deadline;              /**< block closes at the latest [usec] */
+    uint64_t frames;                /**< number of written frames */
+    uint64_t bytes;                 /**< number of written bytes */
+};
+
+/** reader of a compressed capture file (streaming)
+ */
+struct pack_reader {
+    FILE *stream;                   /**< input stream */
+    int canfd;                      /**< CAN FD messages */
+    int header;                     /**< file header has been read */
+    struct pack_table table;        /**< last frame per CAN-ID */
+    unsigned char *raw;             /**< encoded frames of the current block */
+    size_t size;                    /**< size of the encoded frames */
+    size_t pos;                     /**< position of the next frame */
+    unsigned char *packed;          /**< block header and payload (as read) */
+    size_t have;                    /**< number of bytes read of the block */
+    uint32_t count;                 /**< frames left in the block */
+    uint64_t last;                  /**< time-stamp of the last frame [usec] */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       initializes a writer and writes the header of a compressed
+ *               capture file.
+ *
+ *  @param[out]  writer  pointer to a writer
+ *  @param[in]   stream  output stream (binary)
+ *  @param[in]   canfd   non-zero for CAN FD messages (64 data bytes)
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int pack_writer_init(struct pack_writer *writer, FILE *stream, int canfd);
+
+/** @brief       encodes a CAN message into the current block (the block is
+ *               compressed and written when it is full or its time is over).
+ *
+ *  @param[in]   writer     pointer to a writer
+ *  @param[in]   timestamp  time-stamp of the CAN message [usec]
+ *  @param[in]   id         CAN identifier
+ *  @param[in]   flags      message flags (MSG_FLAG_xyz)
+ *  @param[in]   dlc        data length code
+ *  @param[in]   len        number of data bytes (0..8 or 0..64)
+ *  @param[in]   data       data bytes
+ *
+ *  @returns     non-zero value on success, or zero on a write error
+ */
+int pack_write_message(struct pack_writer *writer,
+                       uint64_t timestamp, unsigned long id, int flags, int dlc, int len, const unsigned char *data);
+
+/** @brief       writes the current block, when its time is over (or when
+ *               forced).  To be called when the bus is idle.
+ *
+ *  @returns     non-zero value on success, or zero on a write error
+ */
+int pack_flush(struct pack_writer *writer, int force);
+
+/** @brief       writes the current block and continues with a new file
+ *               (e.g. the next segment), starting with its header.
+ *
+ *  @returns     non-zero value on success, or zero on a write error
+ */
+int pack_writer_switch(struct pack_writer *writer, FILE *stream);
+
+/** @brief       writes the current block and releases the writer (the
+ *               counters remain valid).
+ */
+void pack_writer_exit(struct pack_writer *writer);
+
+/** @brief       initializes a reader of a compressed capture file.
+ *
+ *  @param[out]  reader  pointer to a reader
+ *  @param[in]   stream  input stream (binary)
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int pack_reader_init(struct pack_reader *reader, FILE *stream);
+
+/** @brief       decodes the next CAN message of a compressed capture file.
+ *
+ *  @remarks     An incomplete block (at the end of a file that is still
+ *               written) is kept, and the call can be repeated later.
+ *
+ *  @returns     1 on success, 0 if no complete block is available (yet),
+ *               or -1 if the stream is not a compressed capture file (or
+ *               corrupted)
+ */
+int pack_read_message(struct pack_reader *reader, struct rec_message *message);
+
+/** @brief       releases a reader.
+ */
+void pack_reader_exit(struct pack_reader *reader);
+
+/** @brief       renders a compressed capture file as text (in the layout
+ *               of printmsg).
+ *
+ *  @param[in]   input       compressed capture file
+ *  @param[in]   output      output stream for the text
+ *  @param[in]   mode_time   time-stamp: ZERO, ABS or REL
+ *  @param[in]   mode_id     identifier: HEX, DEC or OCT
+ *  @param[in]   mode_data   data bytes: HEX, DEC or OCT
+ *  @param[in]   mode_ascii  data bytes as ASCII: ON or OFF
+ *  @param[in]   follow      non-zero to wait for new blocks at the end of
+ *                           the file (like 'tail -f')
+ *
+ *  @returns     number of rendered CAN messages
+ */
+uint64_t pack_render(FILE *input, FILE *output, int mode_time, int mode_id, int mode_data, int mode_ascii, int follow);
+
+
+#endif /* CANPACK_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,232 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/canrec.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Binary Record Stream of CAN Messages (Capture)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Microsoft Visual C/C++ Compiler
+ *               Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  (see header file)
+ *
+ *  includes  :  canrec.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ */
+/** @file        canrec.c
+ *
+ *  @brief       Binary Record Stream of CAN Messages (Capture)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @addtogroup  can_rec
+ *  @{
+ */
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "canrec.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define REC_DATA_OFFSET  (16)
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static void put_le16(unsigned char *ptr, uint16_t value);
+static void put_le32(unsigned char *ptr, uint32_t value);
+static void put_le64(unsigned char *ptr, uint64_t value);
+static uint16_t get_le16(const unsigned char *ptr);
+static uint32_t get_le32(const unsigned char *ptr);
+static uint64_t get_le64(const unsigned char *ptr);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+void rec_header_init(struct rec_header *header, int canfd)
+{
+    if (!header)
+        return;
+    header->version = REC_VERSION;
+    header->mode = canfd ? REC_MODE_FD : REC_MODE_CC;
+    header->size = canfd ? REC_RECORD_FD : REC_RECORD_CC;
+}
+
+int rec_write_header(struct msg_buffer *buffer, const struct rec_header *header)
+{
+    unsigned char record[REC_HEADER_SIZE];
+
+    if (!header)
+        return 0;
+    memset(record, 0, sizeof(record));
+    memcpy(&record[0], REC_MAGIC, 8);
+    put_le16(&record[8], header->version);
+    put_le16(&record[10], header->size);
+    record[12] = header->mode;
+    return msg_buffer_write(buffer, record, REC_HEADER_SIZE);
+}
+
+int rec_write_message(struct msg_buffer *buffer, const struct rec_header *header,
+                      uint64_t timestamp, unsigned long id, int flags, int dlc, int len, const unsigned char *data)
+{
+    unsigned char record[REC_RECORD_FD];
+    int max = (header && (header->mode == REC_MODE_FD)) ? 64 : 8;
+
+    if (!header || (len < 0))
+        return 0;
+    if (len > max)
+        len = max;
+    put_le64(&record[0], timestamp);
+    put_le32(&record[8], (uint32_t)id);
+    record[12] = (unsigned char)flags;
+    record[13] = (unsigned char)dlc;
+    record[14] = (unsigned char)len;
+    record[15] = 0x00;
+    if (len > 0)
+        memcpy(&record[REC_DATA_OFFSET], data, (size_t)len);
+    memset(&record[REC_DATA_OFFSET + len], 0, (size_t)(max - len));
+    return msg_buffer_write(buffer, record, (size_t)header->size);
+}
+
+int rec_read_header(FILE *stream, struct rec_header *header)
+{
+    unsigned char record[REC_HEADER_SIZE];
+
+    if (!stream || !header)
+        return 0;
+    if (fread(record, 1, REC_HEADER_SIZE, stream) != REC_HEADER_SIZE)
+        return 0;
+    if (memcmp(&record[0], REC_MAGIC, 8) != 0)
+        return 0;
+    header->version = get_le16(&record[8]);
+    header->size = get_le16(&record[10]);
+    header->mode = record[12];
+    if (header->version != REC_VERSION)
+        return 0;
+    if (!((header->mode == REC_MODE_CC) && (header->size == REC_RECORD_CC)) &&
+        !((header->mode == REC_MODE_FD) && (header->size == REC_RECORD_FD)))
+        return 0;
+    return 1;
+}
+
+int rec_read_message(FILE *stream, const struct rec_header *header, struct rec_message *message)
+{
+    unsigned char record[REC_RECORD_FD];
+    int max;
+
+    if (!stream || !header || !message || (header->size > REC_RECORD_FD))
+        return 0;
+    if (fread(record, 1, (size_t)header->size, stream) != (size_t)header->size)
+        return 0;
+    max = (int)header->size - REC_DATA_OFFSET;
+    message->timestamp = get_le64(&record[0]);
+    message->id = (unsigned long)get_le32(&record[8]);
+    message->flags = (int)record[12];
+    message->dlc = (int)record[13];
+    message->len = ((int)record[14] <= max) ? (int)record[14] : max;
+    memcpy(message->data, &record[REC_DATA_OFFSET], (size_t)message->len);
+    return 1;
+}
+
+uint64_t rec_render(FILE *input, FILE *output, int mode_time, int mode_id, int mode_data, int mode_ascii)
+{
+    struct rec_header header;
+    struct rec_message message;
+    struct msg_timestamp ts;
+    struct msg_format format;
+    struct msg_buffer buffer;
+    uint64_t frames = 0;
+
+    if (!rec_read_header(input, &header))
+        return 0;
+    msg_format_init(&format, mode_time, mode_id, mode_data, mode_ascii, (header.mode == REC_MODE_FD) ? 1 : 0);
+    if (!msg_buffer_init(&buffer, output, MSG_BUFFER_SIZE, MSG_FLUSH_FULL, 0UL))
+        return 0;
+    while (rec_read_message(input, &header, &message)) {
+        ts.tv_sec = (long)(message.timestamp / 1000000ull);
+        ts.tv_usec = (long)(message.timestamp % 1000000ull);
+        if (!msg_buffer_message(&buffer, &format, frames++, &ts, message.id, message.flags, message.len, message.data))
+            break;
+    }
+    msg_buffer_exit(&buffer);
+    return frames;
+}
+
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static void put_le16(unsigned char *ptr, uint16_t value)
+{
+    ptr[0] = (unsigned char)(value);
+    ptr[1] = (unsigned char)(value >> 8);
+}
+
+static void put_le32(unsigned char *ptr, uint32_t value)
+{
+    ptr[0] = (unsigned char)(value);
+    ptr[1] = (unsigned char)(value >> 8);
+    ptr[2] = (unsigned char)(value >> 16);
+    ptr[3] = (unsigned char)(value >> 24);
+}
+
+static void put_le64(unsigned char *ptr, uint64_t value)
+{
+    put_le32(&ptr[0], (uint32_t)value);
+    put_le32(&ptr[4], (uint32_t)(value >> 32));
+}
+
+static uint16_t get_le16(const unsigned char *ptr)
+{
+    return (uint16_t)ptr[0] | ((uint16_t)ptr[1] << 8);
+}
+
+static uint32_t get_le32(const unsigned char *ptr)
+{
+    return (uint32_t)ptr[0] | ((uint32_t)ptr[1] << 8) | ((uint32_t)ptr[2] << 16) | ((uint32_t)ptr[3] << 24);
+}
+
+static uint64_t get_le64(const unsigned char *ptr)
+{
+    return (uint64_t)get_le32(&ptr[0]) | ((uint64_t)get_le32(&ptr[4]) << 32);
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,177 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/canrec.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Binary Record Stream of CAN Messages (Capture)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Microsoft Visual C/C++ Compiler
+ *               Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  void rec_header_init(struct rec_header *header, int canfd);
+ *               int rec_write_header(struct msg_buffer *buffer, const struct rec_header *header);
+ *               int rec_write_message(struct msg_buffer *buffer, const struct rec_header *header, uint64_t timestamp, unsigned long id, int flags, int dlc, int len, const unsigned char *data);
+ *               int rec_read_header(FILE *stream, struct rec_header *header);
+ *               int rec_read_message(FILE *stream, const struct rec_header *header, struct rec_message *message);
+ *               uint64_t rec_render(FILE *input, FILE *output, int mode_time, int mode_id, int mode_data, int mode_ascii);
+ *
+ *  includes  :  printmsg.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  A binary record stream consists of a header followed by records of
+ *  fixed size.  All fields are stored in little-endian byte order.
+ *
+ *  Header (16 bytes):
+ *    0  magic[8]     "CANREC\r\n"
+ *    8  version      uint16_t (REC_VERSION)
+ *   10  size         uint16_t (size of one record: 24 or 80)
+ *   12  mode         uint8_t  (0 = CAN CC, 1 = CAN FD)
+ *   13  reserved[3]  (zero)
+ *
+ *  Record (24 bytes for CAN CC, 80 bytes for CAN FD):
+ *    0  timestamp    uint64_t (microseconds)
+ *    8  id           uint32_t (11-bit or 29-bit identifier)
+ *   12  flags        uint8_t  (MSG_FLAG_xyz)
+ *   13  dlc          uint8_t  (data length code)
+ *   14  len          uint8_t  (number of data bytes)
+ *   15  reserved     (zero)
+ *   16  data[8|64]   (padded with zeros)
+ */
+/** @file        canrec.h
+ *
+ *  @brief       Binary Record Stream of CAN Messages (Capture)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    can_rec Binary Record Stream of CAN Messages (Capture)
+ *  @{
+ */
+#ifndef CANREC_H_INCLUDED
+#define CANREC_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "printmsg.h"
+
+#include <stdio.h>
+#include <stdint.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define REC_MAGIC       "CANREC\r\n" /**< magic number (8 bytes) */
+#define REC_VERSION     (1)         /**< version of the record layout */
+
+#define REC_MODE_CC     (0)         /**< CAN CC records (8 data bytes) */
+#define REC_MODE_FD     (1)         /**< CAN FD records (64 data bytes) */
+
+#define REC_HEADER_SIZE (16)        /**< size of the stream header */
+#define REC_RECORD_CC   (24)        /**< size of a CAN CC record */
+#define REC_RECORD_FD   (80)        /**< size of a CAN FD record */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+/** header of a binary record stream
+ */
+struct rec_header {
+    uint16_t version;               /**< version of the record layout */
+    uint16_t size;                  /**< size of one record */
+    uint8_t mode;                   /**< CAN CC or CAN FD records */
+};
+
+/** CAN message decoded from a binary record
+ */
+struct rec_message {
+    uint64_t timestamp;             /**< time-stamp [usec] */
+    unsigned long id;               /**< CAN identifier */
+    int flags;                      /**< message flags (MSG_FLAG_xyz) */
+    int dlc;                        /**< data length code */
+    int len;                        /**< number of data bytes */
+    unsigned char data[64];         /**< data bytes */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       initializes the header of a binary record stream.
+ *
+ *  @param[out]  header  pointer to a stream header
+ *  @param[in]   canfd   non-zero for CAN FD records (64 data bytes)
+ */
+void rec_header_init(struct rec_header *header, int canfd);
+
+/** @brief       writes the header of a binary record stream into an output
+ *               buffer.
+ *
+ *  @returns     non-zero value on success, or zero on a write error
+ */
+int rec_write_header(struct msg_buffer *buffer, const struct rec_header *header);
+
+/** @brief       encodes a CAN message as binary record into an output buffer
+ *               (no text formatting at all).
+ *
+ *  @param[in]   buffer     pointer to an output buffer
+ *  @param[in]   header     header of the record stream
+ *  @param[in]   timestamp  time-stamp of the CAN message [usec]
+ *  @param[in]   id         CAN identifier
+ *  @param[in]   flags      message flags (MSG_FLAG_xyz)
+ *  @param[in]   dlc        data length code
+ *  @param[in]   len        number of data bytes (0..8 or 0..64)
+ *  @param[in]   data       data bytes
+ *
+ *  @returns     non-zero value on success, or zero on a write error
+ */
+int rec_write_message(struct msg_buffer *buffer, const struct rec_header *header,
+                      uint64_t timestamp, unsigned long id, int flags, int dlc, int len, const unsigned char *data);
+
+/** @brief       reads and checks the header of a binary record stream.
+ *
+ *  @returns     non-zero value on success, or zero if the stream is not a
+ *               binary record stream (or of an unsupported version)
+ */
+int rec_read_header(FILE *stream, struct rec_header *header);
+
+/** @brief       reads the next record of a binary record stream.
+ *
+ *  @returns     non-zero value on success, or zero at the end of the stream
+ */
+int rec_read_message(FILE *stream, const struct rec_header *header, struct rec_message *message);
+
+/** @brief       renders a binary record stream as text (in the layout of
+ *               printmsg).
+ *
+ *  @param[in]   input       binary record stream
+ *  @param[in]   output      output stream for the text
+ *  @param[in]   mode_time   time-stamp: ZERO, ABS or REL
+ *  @param[in]   mode_id     identifier: HEX, DEC or OCT
+ *  @param[in]   mode_data   data bytes: HEX, DEC or OCT
+ *  @param[in]   mode_ascii  data bytes as ASCII: ON or OFF
+ *
+ *  @returns     number of rendered CAN messages
+ */
+uint64_t rec_render(FILE *input, FILE *output, int mode_time, int mode_id, int mode_data, int mode_ascii);
+
+
+#endif /* CANREC_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,383 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/evloop.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Event Loop (Receive Events, Timers and Signals)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  (see header file)
+ *
+ *  includes  :  evloop.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ */
+/** @file        evloop.c
+ *
+ *  @brief       Event Loop (Receive Events, Timers and Signals)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @addtogroup  ev_loop
+ *  @{
+ */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE  /* timerfd, signalfd */
+#endif
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "evloop.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
+#elif defined(__APPLE__)
+#include <sys/types.h>
+#include <sys/event.h>
+#include <sys/time.h>
+#else
+#error Platform not supported
+#endif
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define EV_EVENTS       (16)        /* events per wait */
+#define EV_WAKEUP       (-1)        /* index of the wake-up pipe */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static int add_source(struct ev_loop *loop, int kind, int fd, int signo, ev_handler_t handler, void *context);
+static int set_nonblock(int fd);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int ev_init(struct ev_loop *loop)
+{
+#if defined(__linux__)
+    struct epoll_event event;
+#else
+    struct kevent event;
+#endif
+    if (!loop)
+        return 0;
+    memset(loop, 0, sizeof(struct ev_loop));
+    sigemptyset(&loop->sigset);
+    sigemptyset(&loop->oldset);
+    loop->wakeup[0] = loop->wakeup[1] = -1;
+#if defined(__linux__)
+    if ((loop->fd = epoll_create1(EPOLL_CLOEXEC)) < 0)
+        return 0;
+#else
+    if ((loop->fd = kqueue()) < 0)
+        return 0;
+#endif
+    /* the wake-up pipe (written by ev_stop, also from a signal handler) */
+    if ((pipe(loop->wakeup) != 0) || !set_nonblock(loop->wakeup[0]) || !set_nonblock(loop->wakeup[1])) {
+        ev_exit(loop);
+        return 0;
+    }
+#if defined(__linux__)
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u32 = (uint32_t)EV_WAKEUP;
+    if (epoll_ctl(loop->fd, EPOLL_CTL_ADD, loop->wakeup[0], &event) != 0) {
+#else
+    EV_SET(&event, loop->wakeup[0], EVFILT_READ, EV_ADD, 0, 0, (void*)(intptr_t)EV_WAKEUP);
+    if (kevent(loop->fd, &event, 1, NULL, 0, NULL) != 0) {
+#endif
+        ev_exit(loop);
+        return 0;
+    }
+    loop->running = 1;
+    return 1;
+}
+
+int ev_add_fd(struct ev_loop *loop, int fd, ev_handler_t handler, void *context)
+{
+    int index;
+#if defined(__linux__)
+    struct epoll_event event;
+#else
+    struct kevent event;
+#endif
+    if (!loop || (fd < 0))
+        return -1;
+    if ((index = add_source(loop, EV_FD, fd, 0, handler, context)) < 0)
+        return -1;
+#if defined(__linux__)
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | EPOLLET;
+    event.data.u32 = (uint32_t)index;
+    if (epoll_ctl(loop->fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+#else
+    EV_SET(&event, fd, EVFILT_READ, EV_ADD | EV_CLEAR, 0, 0, (void*)(intptr_t)index);
+    if (kevent(loop->fd, &event, 1, NULL, 0, NULL) != 0) {
+#endif
+        loop->count--;
+        return -1;
+    }
+    return index;
+}
+
+int ev_add_timer(struct ev_loop *loop, unsigned long milliseconds, ev_handler_t handler, void *context)
+{
+    int index, fd = -1;
+#if defined(__linux__)
+    struct epoll_event event;
+    struct itimerspec period;
+#else
+    struct kevent event;
+#endif
+    if (!loop || (milliseconds == 0UL))
+        return -1;
+#if defined(__linux__)
+    if ((fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) < 0)
+        return -1;
+    period.it_interval.tv_sec = (time_t)(milliseconds / 1000UL);
+    period.it_interval.tv_nsec = (long)(milliseconds % 1000UL) * 1000000L;
+    period.it_value = period.it_interval;
+    if ((timerfd_settime(fd, 0, &period, NULL) != 0) ||
+        ((index = add_source(loop, EV_TIMER, fd, 0, handler, context)) < 0)) {
+        (void)close(fd);
+        return -1;
+    }
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u32 = (uint32_t)index;
+    if (epoll_ctl(loop->fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        (void)close(fd);
+#else
+    /* note: a kqueue timer is identified by the index of the source */
+    if ((index = add_source(loop, EV_TIMER, fd, 0, handler, context)) < 0)
+        return -1;
+    EV_SET(&event, (uintptr_t)index, EVFILT_TIMER, EV_ADD, 0, (intptr_t)milliseconds, (void*)(intptr_t)index);
+    if (kevent(loop->fd, &event, 1, NULL, 0, NULL) != 0) {
+#endif
+        loop->count--;
+        return -1;
+    }
+    return index;
+}
+
+int ev_add_signal(struct ev_loop *loop, int signo, ev_handler_t handler, void *context)
+{
+    sigset_t sigset, oldset;
+    int index, fd = -1;
+#if defined(__linux__)
+    struct epoll_event event;
+#else
+    struct kevent event;
+#endif
+    if (!loop || (signo <= 0))
+        return -1;
+    /* note: the signal is blocked, so it is received by the loop only */
+    sigemptyset(&sigset);
+    sigaddset(&sigset, signo);
+    if (pthread_sigmask(SIG_BLOCK, &sigset, &oldset) != 0)
+        return -1;
+    if (!loop->blocked++)
+        loop->oldset = oldset;
+    sigaddset(&loop->sigset, signo);
+#if defined(__linux__)
+    if ((fd = signalfd(-1, &sigset, SFD_NONBLOCK | SFD_CLOEXEC)) < 0)
+        return -1;
+    if ((index = add_source(loop, EV_SIGNAL, fd, signo, handler, context)) < 0) {
+        (void)close(fd);
+        return -1;
+    }
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u32 = (uint32_t)index;
+    if (epoll_ctl(loop->fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        (void)close(fd);
+#else
+    if ((index = add_source(loop, EV_SIGNAL, fd, signo, handler, context)) < 0)
+        return -1;
+    EV_SET(&event, (uintptr_t)signo, EVFILT_SIGNAL, EV_ADD, 0, 0, (void*)(intptr_t)index);
+    if (kevent(loop->fd, &event, 1, NULL, 0, NULL) != 0) {
+#endif
+        loop->count--;
+        return -1;
+    }
+    return index;
+}
+
+int ev_poll(struct ev_loop *loop, int milliseconds)
+{
+    struct ev_source *source;
+    uint64_t value;
+    int n, i, index;
+    char byte;
+#if defined(__linux__)
+    struct epoll_event events[EV_EVENTS];
+    struct signalfd_siginfo info;
+#else
+    struct kevent events[EV_EVENTS];
+    struct timespec timeout;
+#endif
+    if (!loop)
+        return -1;
+#if defined(__linux__)
+    n = epoll_wait(loop->fd, events, EV_EVENTS, milliseconds);
+#else
+    timeout.tv_sec = (time_t)(milliseconds / 1000);
+    timeout.tv_nsec = (long)(milliseconds % 1000) * 1000000L;
+    n = kevent(loop->fd, NULL, 0, events, EV_EVENTS, (milliseconds >= 0) ? &timeout : NULL);
+#endif
+    if (n < 0)
+        return (errno == EINTR) ? 0 : -1;
+    loop->wakeups++;
+    for (i = 0; i < n; i++) {
+#if defined(__linux__)
+        index = (int)(int32_t)events[i].data.u32;
+#else
+        index = (int)(intptr_t)events[i].udata;
+#endif
+        if (index == EV_WAKEUP) {
+            while (read(loop->wakeup[0], &byte, 1) == 1);
+            continue;
+        }
+        if ((index < 0) || (index >= loop->count))
+            continue;
+        source = &loop->sources[index];
+        value = 0;
+        switch (source->kind) {
+#if defined(__linux__)
+        case EV_TIMER:
+            if (read(source->fd, &value, sizeof(value)) != (ssize_t)sizeof(value))
+                continue;
+            break;
+        case EV_SIGNAL:
+            if (read(source->fd, &info, sizeof(info)) != (ssize_t)sizeof(info))
+                continue;
+            value = (uint64_t)info.ssi_signo;
+            break;
+#else
+        case EV_TIMER:
+            value = (uint64_t)events[i].data;
+            break;
+        case EV_SIGNAL:
+            value = (uint64_t)source->signo;
+            break;
+#endif
+        default:
+            break;
+        }
+        if (source->handler)
+            source->handler(loop, source->context, value);
+    }
+    return n;
+}
+
+int ev_run(struct ev_loop *loop)
+{
+    if (!loop)
+        return -1;
+    while (loop->running) {
+        if (ev_poll(loop, -1) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+void ev_stop(struct ev_loop *loop)
+{
+    char byte = 0;
+
+    /* note: only a flag and a write (async-signal-safe) */
+    loop->running = 0;
+    (void)write(loop->wakeup[1], &byte, 1);
+}
+
+void ev_exit(struct ev_loop *loop)
+{
+    int i;
+
+    if (!loop || (loop->fd < 0))
+        return;
+    for (i = 0; i < loop->count; i++) {
+        /* note: the file descriptors of the caller are not closed */
+        if ((loop->sources[i].kind != EV_FD) && (loop->sources[i].fd >= 0))
+            (void)close(loop->sources[i].fd);
+    }
+    if (loop->wakeup[0] >= 0)
+        (void)close(loop->wakeup[0]);
+    if (loop->wakeup[1] >= 0)
+        (void)close(loop->wakeup[1]);
+    (void)close(loop->fd);
+    loop->fd = -1;
+    loop->count = 0;
+    /* the signals of the loop are delivered again (a pending one now) */
+    if (loop->blocked)
+        (void)pthread_sigmask(SIG_SETMASK, &loop->oldset, NULL);
+}
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static int add_source(struct ev_loop *loop, int kind, int fd, int signo, ev_handler_t handler, void *context)
+{
+    struct ev_source *source;
+
+    if (loop->count >= EV_SOURCES)
+        return -1;
+    source = &loop->sources[loop->count];
+    source->kind = kind;
+    source->fd = fd;
+    source->signo = signo;
+    source->handler = handler;
+    source->context = context;
+    return loop->count++;
+}
+
+static int set_nonblock(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+
+    return (flags >= 0) && (fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0) && (fcntl(fd, F_SETFD, FD_CLOEXEC) == 0);
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
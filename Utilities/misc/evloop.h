@@ -0,0 +1,170 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/evloop.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Event Loop (Receive Events, Timers and Signals)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  int ev_init(struct ev_loop *loop);
+ *               int ev_add_fd(struct ev_loop *loop, int fd, ev_handler_t handler, void *context);
+ *               int ev_add_timer(struct ev_loop *loop, unsigned long milliseconds, ev_handler_t handler, void *context);
+ *               int ev_add_signal(struct ev_loop *loop, int signo, ev_handler_t handler, void *context);
+ *               int ev_poll(struct ev_loop *loop, int milliseconds);
+ *               int ev_run(struct ev_loop *loop);
+ *               void ev_stop(struct ev_loop *loop);
+ *               void ev_exit(struct ev_loop *loop);
+ *
+ *  includes  :  <stdint.h>, <signal.h>
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  The event loop waits for any number of event sources with one system
+ *  call and calls the handler of each source that became ready:
+ *  - file descriptors, e.g. the PCAN_RECEIVE_EVENT of several channels;
+ *    they are edge-triggered, so the handler has to read until the queue
+ *    is empty (PCAN_ERROR_QRCVEMPTY), otherwise it is not called again;
+ *  - periodic timers (the handler gets the number of expirations);
+ *  - signals (the handler gets the signal number); the signals are
+ *    blocked in the calling thread while the loop exists, so they are
+ *    received by the loop instead of a signal handler.
+ *
+ *  It is built on epoll (with timerfd and signalfd) on Linux, and on
+ *  kqueue (EVFILT_READ with EV_CLEAR, EVFILT_TIMER, EVFILT_SIGNAL) on
+ *  macOS.  There is no busy waiting and no time-out needed: the loop
+ *  sleeps until an event occurs, and ev_stop wakes it up (it can be
+ *  called from another thread or from a signal handler).
+ */
+/** @file        evloop.h
+ *
+ *  @brief       Event Loop (Receive Events, Timers and Signals)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    ev_loop Event Loop (Receive Events, Timers and Signals)
+ *  @{
+ */
+#ifndef EVLOOP_H_INCLUDED
+#define EVLOOP_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include <stdint.h>
+#include <signal.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define EV_SOURCES      (64)        /**< max. number of event sources */
+
+#define EV_FD           (0)         /**< file descriptor (edge-triggered) */
+#define EV_TIMER        (1)         /**< periodic timer */
+#define EV_SIGNAL       (2)         /**< signal */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+struct ev_loop;
+
+/** handler of an event source (value: 0, number of expirations, resp.
+ *  signal number)
+ */
+typedef void (*ev_handler_t)(struct ev_loop *loop, void *context, uint64_t value);
+
+/** event source
+ */
+struct ev_source {
+    int kind;                       /**< EV_FD, EV_TIMER or EV_SIGNAL */
+    int fd;                         /**< file descriptor (or -1) */
+    int signo;                      /**< signal number (EV_SIGNAL) */
+    ev_handler_t handler;           /**< handler (or NULL, only wake up) */
+    void *context;                  /**< context of the handler */
+};
+
+/** event loop
+ */
+struct ev_loop {
+    int fd;                         /**< epoll resp. kqueue descriptor */
+    int wakeup[2];                  /**< pipe to wake up the loop (ev_stop) */
+    volatile sig_atomic_t running;  /**< cleared by ev_stop */
+    struct ev_source sources[EV_SOURCES]; /**< event sources */
+    int count;                      /**< number of event sources */
+    sigset_t sigset;                /**< signals received by the loop */
+    sigset_t oldset;                /**< signal mask before the loop */
+    int blocked;                    /**< signals have been blocked */
+    uint64_t wakeups;               /**< number of returns from the wait */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       initializes an event loop (w/o event sources).
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int ev_init(struct ev_loop *loop);
+
+/** @brief       adds a file descriptor (readable, edge-triggered).
+ *
+ *  @returns     index of the event source, or a negative value on error
+ */
+int ev_add_fd(struct ev_loop *loop, int fd, ev_handler_t handler, void *context);
+
+/** @brief       adds a periodic timer (first expiration after one period).
+ *
+ *  @returns     index of the event source, or a negative value on error
+ */
+int ev_add_timer(struct ev_loop *loop, unsigned long milliseconds, ev_handler_t handler, void *context);
+
+/** @brief       adds a signal (blocked in the calling thread until ev_exit).
+ *
+ *  @returns     index of the event source, or a negative value on error
+ */
+int ev_add_signal(struct ev_loop *loop, int signo, ev_handler_t handler, void *context);
+
+/** @brief       waits for events (once) and calls the handlers.
+ *
+ *  @param[in]   loop          pointer to the event loop
+ *  @param[in]   milliseconds  time-out (or -1 to wait infinitely)
+ *
+ *  @returns     number of events handled, or a negative value on error
+ */
+int ev_poll(struct ev_loop *loop, int milliseconds);
+
+/** @brief       waits for events and calls the handlers until ev_stop.
+ *
+ *  @returns     zero when stopped, or a negative value on error
+ */
+int ev_run(struct ev_loop *loop);
+
+/** @brief       stops the event loop (async-signal-safe, thread-safe).
+ */
+void ev_stop(struct ev_loop *loop);
+
+/** @brief       releases the event loop (and restores the signal mask).
+ */
+void ev_exit(struct ev_loop *loop);
+
+
+#endif /* EVLOOP_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,343 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/flightrec.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Flight Recorder of CAN Messages (Ring in RAM, Dump on Demand)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  (see header file)
+ *
+ *  includes  :  flightrec.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ */
+/** @file        flightrec.c
+ *
+ *  @brief       Flight Recorder of CAN Messages (Ring in RAM, Dump on Demand)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @addtogroup  flight_rec
+ *  @{
+ */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE  /* MAP_HUGETLB, MADV_HUGEPAGE */
+#endif
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "flightrec.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define FR_TRIES        (100)       /* max. number of suffixes "-1", "-2", ... */
+#define FR_HUGE_PAGE    (2097152)   /* 2MB (size of a huge page on x86_64 and arm64) */
+
+#define LOAD(ptr, order)        __atomic_load_n(ptr, order)
+#define STORE(ptr, val, order)  __atomic_store_n(ptr, val, order)
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static void *worker(void *arg);
+static int write_snapshot(struct flight_rec *rec, FILE *stream, uint64_t end);
+static FILE *create_file(struct flight_rec *rec);
+static int map_ring(struct flight_rec *rec, size_t length, int huge);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int fr_init(struct flight_rec *rec, size_t size, size_t depth, int huge, const char *path, const struct fr_writer *writer)
+{
+    sigset_t sigset, oldset;
+    int rc;
+
+    if (!rec || !size || !depth || !path || !writer || !writer->write || (depth > fr_max_depth(size)))
+        return 0;
+    memset(rec, 0, sizeof(struct flight_rec));
+    rec->size = size;
+    rec->depth = depth;
+    rec->path = path;
+    rec->writer = *writer;
+    if (!map_ring(rec, depth * size, huge))
+        return 0;
+    if ((rec->chunk = (unsigned char*)malloc(FR_CHUNK * size)) == NULL) {
+        (void)munmap(rec->items, rec->length);
+        return 0;
+    }
+    pthread_mutex_init(&rec->mutex, NULL);
+    pthread_cond_init(&rec->cond, NULL);
+    rec->running = 1;
+    /* note: signals are handled by the recording thread */
+    sigfillset(&sigset);
+    pthread_sigmask(SIG_BLOCK, &sigset, &oldset);
+    rc = pthread_create(&rec->thread, NULL, worker, (void*)rec);
+    pthread_sigmask(SIG_SETMASK, &oldset, NULL);
+    if (rc != 0) {
+        pthread_cond_destroy(&rec->cond);
+        pthread_mutex_destroy(&rec->mutex);
+        free(rec->chunk);
+        (void)munmap(rec->items, rec->length);
+        rec->items = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+void fr_record(struct flight_rec *rec, const void *frame)
+{
+    /* note: the frame counter is published after the copy (for the dump), and
+     *       the fence keeps the copy of the next frame after this counter */
+    memcpy(&rec->items[rec->index * rec->size], frame, rec->size);
+    if (++rec->index >= rec->depth)
+        rec->index = 0;
+    STORE(&rec->recorded, rec->recorded + 1, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+int fr_dump(struct flight_rec *rec)
+{
+    int started = 0;
+
+    if (!rec || !rec->items)
+        return 0;
+    pthread_mutex_lock(&rec->mutex);
+    if (!rec->requested && !rec->busy) {
+        rec->snapshot = LOAD(&rec->recorded, __ATOMIC_ACQUIRE);
+        rec->requested = 1;
+        pthread_cond_signal(&rec->cond);
+        started = 1;
+    }
+    else
+        rec->rejected++;
+    pthread_mutex_unlock(&rec->mutex);
+    return started;
+}
+
+size_t fr_max_depth(size_t size)
+{
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long length = sysconf(_SC_PAGESIZE);
+    uint64_t memory;
+
+    if (!size)
+        return 0;
+    /* note: the ring is mapped and touched at once, it must not exhaust the memory */
+    if ((pages <= 0) || (length <= 0))
+        return SIZE_MAX / size;
+    memory = ((uint64_t)pages * (uint64_t)length) / FR_MEMORY_SHARE;
+    if (memory > (uint64_t)SIZE_MAX)
+        memory = (uint64_t)SIZE_MAX;
+    return (size_t)(memory / (uint64_t)size);
+}
+
+void fr_exit(struct flight_rec *rec)
+{
+    if (!rec || !rec->items)
+        return;
+    pthread_mutex_lock(&rec->mutex);
+    rec->running = 0;
+    pthread_cond_signal(&rec->cond);
+    pthread_mutex_unlock(&rec->mutex);
+    pthread_join(rec->thread, NULL);
+    pthread_cond_destroy(&rec->cond);
+    pthread_mutex_destroy(&rec->mutex);
+    free(rec->chunk);
+    (void)munmap(rec->items, rec->length);
+    rec->chunk = NULL;
+    rec->items = NULL;
+}
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static void *worker(void *arg)
+{
+    struct flight_rec *rec = (struct flight_rec*)arg;
+    uint64_t end;
+    FILE *stream;
+    int ok;
+
+    pthread_mutex_lock(&rec->mutex);
+    for (;;) {
+        /* note: a pending request is served before the thread ends */
+        while (!rec->requested && rec->running)
+            pthread_cond_wait(&rec->cond, &rec->mutex);
+        if (!rec->requested)
+            break;
+        end = rec->snapshot;
+        rec->requested = 0;
+        rec->busy = 1;
+        pthread_mutex_unlock(&rec->mutex);
+        /* the dump is written while the recording goes on */
+        if ((stream = create_file(rec)) != NULL) {
+            ok = write_snapshot(rec, stream, end);
+            if (fclose(stream) != 0)
+                ok = 0;
+        }
+        else
+            ok = 0;
+        pthread_mutex_lock(&rec->mutex);
+        if (ok)
+            rec->dumps++;
+        else
+            rec->errors++;
+        rec->busy = 0;
+    }
+    pthread_mutex_unlock(&rec->mutex);
+    return NULL;
+}
+
+static int write_snapshot(struct flight_rec *rec, FILE *stream, uint64_t end)
+{
+    uint64_t first, valid, seq, recorded;
+    size_t slot, n, i;
+    int ok = 1;
+
+    /* the snapshot: the last (up to) depth frames before the request */
+    first = (end > rec->depth) ? end - rec->depth : 0;
+    if (rec->writer.begin) {
+        const void *last = NULL;
+
+        if (end > 0) {
+            memcpy(rec->chunk, &rec->items[(size_t)((end - 1) % rec->depth) * rec->size], rec->size);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            recorded = LOAD(&rec->recorded, __ATOMIC_RELAXED);
+            if (recorded + 2 < end + rec->depth)
+                last = rec->chunk;
+        }
+        if (!rec->writer.begin(rec->writer.context, stream, last))
+            return 0;
+    }
+    for (seq = first; ok && (seq < end); seq += n) {
+        n = (end - seq < FR_CHUNK) ? (size_t)(end - seq) : FR_CHUNK;
+        slot = (size_t)(seq % rec->depth);
+        if (slot + n > rec->depth)
+            n = rec->depth - slot;
+        memcpy(rec->chunk, &rec->items[slot * rec->size], n * rec->size);
+        /* the frames of the chunk are intact, unless the recording has lapped them meanwhile
+         * (note: the frame after the last recorded one might be written just now, and one
+         *  more slot is kept as margin) */
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        recorded = LOAD(&rec->recorded, __ATOMIC_RELAXED);
+        valid = (recorded + 2 > rec->depth) ? recorded + 2 - rec->depth : 0;
+        for (i = 0; ok && (i < n); i++) {
+            if (seq + i < valid) {
+                rec->lost++;
+                continue;
+            }
+            ok = rec->writer.write(rec->writer.context, &rec->chunk[i * rec->size]);
+            rec->dumped++;
+        }
+    }
+    if (rec->writer.end && !rec->writer.end(rec->writer.context))
+        ok = 0;
+    return ok;
+}
+
+static FILE *create_file(struct flight_rec *rec)
+{
+    const char *slash = strrchr(rec->path, '/');
+    const char *ext = strrchr(rec->path, '.');
+    time_t now = time(NULL);
+    char stamp[32];
+    struct tm tm;
+    FILE *stream;
+    int fd, n, i;
+
+    /* the extension starts at the last dot of the file name (if not the first character) */
+    if (!ext || (slash && (ext < slash)) || (ext == (slash ? slash + 1 : rec->path)))
+        ext = rec->path + strlen(rec->path);
+    (void)localtime_r(&now, &tm);
+    (void)strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+    for (i = 0; i < FR_TRIES; i++) {
+        if (i == 0)
+            n = snprintf(rec->name, sizeof(rec->name), "%.*s-%s%s", (int)(ext - rec->path), rec->path, stamp, ext);
+        else
+            n = snprintf(rec->name, sizeof(rec->name), "%.*s-%s-%i%s", (int)(ext - rec->path), rec->path, stamp, i, ext);
+        if ((n < 0) || ((size_t)n >= sizeof(rec->name)))
+            return NULL;
+        /* note: an existing file is never overwritten */
+        if ((fd = open(rec->name, O_WRONLY | O_CREAT | O_EXCL, 0644)) >= 0) {
+            if ((stream = fdopen(fd, "wb")) == NULL)
+                (void)close(fd);
+            return stream;
+        }
+    }
+    return NULL;
+}
+
+static int map_ring(struct flight_rec *rec, size_t length, int huge)
+{
+    void *items = MAP_FAILED;
+
+#if defined(MAP_HUGETLB)
+    /* huge pages from the pool (/proc/sys/vm/nr_hugepages), if any */
+    if (huge) {
+        rec->length = (length + FR_HUGE_PAGE - 1) & ~((size_t)FR_HUGE_PAGE - 1);
+        items = mmap(NULL, rec->length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        rec->pages = FR_PAGES_HUGE;
+    }
+#endif
+    if (items == MAP_FAILED) {
+        rec->length = length;
+        items = mmap(NULL, rec->length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        rec->pages = FR_PAGES_NORMAL;
+#if defined(MADV_HUGEPAGE)
+        /* otherwise transparent huge pages (where enabled) */
+        if (huge && (items != MAP_FAILED) && (madvise(items, rec->length, MADV_HUGEPAGE) == 0))
+            rec->pages = FR_PAGES_THP;
+#endif
+    }
+    if (items == MAP_FAILED)
+        return 0;
+    /* note: all pages are touched now, not while recording */
+    memset(items, 0, rec->length);
+    rec->items = (unsigned char*)items;
+    return 1;
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
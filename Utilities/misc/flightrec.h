@@ -0,0 +1,174 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/flightrec.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Flight Recorder of CAN Messages (Ring in RAM, Dump on Demand)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  int fr_init(struct flight_rec *rec, size_t size, size_t depth, int huge, const char *path, const struct fr_writer *writer);
+ *               void fr_record(struct flight_rec *rec, const void *frame);
+ *               int fr_dump(struct flight_rec *rec);
+ *               void fr_exit(struct flight_rec *rec);
+ *
+ *  includes  :  <stdio.h>, <stdint.h>, <stddef.h>, <pthread.h>
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  The flight recorder keeps the last n frames (items of a fixed size) in
+ *  a ring, which is mapped and touched once at start-up (optionally backed
+ *  by huge pages).  So the memory use is fixed, and recording a frame is a
+ *  copy into the ring and a store of the frame counter, without a lock and
+ *  without an allocation.
+ *
+ *  A dump is requested by the recording thread (e.g. on a signal), which
+ *  takes the current frame counter as end of the snapshot.  A background
+ *  thread writes the frames of the snapshot (oldest first) into a new file
+ *  while the recording goes on.  The frames are copied in chunks; a chunk
+ *  is checked against the frame counter afterwards, and frames which have
+ *  been overwritten meanwhile are dropped (counted as lost).  So the dump
+ *  is a consecutive sequence of intact frames up to the request.
+ *
+ *  Each dump is named with its time, e.g. "flight.rec" becomes
+ *  "flight-20250317-141502.rec" (with a suffix "-1", "-2", ... if the
+ *  name is already taken).  The file format is up to the caller (writer),
+ *  who gets the newest frame of the snapshot first, e.g. to cut the dump
+ *  to a time window.
+ */
+/** @file        flightrec.h
+ *
+ *  @brief       Flight Recorder of CAN Messages (Ring in RAM, Dump on Demand)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    flight_rec Flight Recorder of CAN Messages (Ring in RAM, Dump on Demand)
+ *  @{
+ */
+#ifndef FLIGHTREC_H_INCLUDED
+#define FLIGHTREC_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define FR_CHUNK        (256)       /**< frames copied at once by a dump */
+#define FR_MEMORY_SHARE (2)         /**< ring of at most 1/2 of the physical memory */
+
+#define FR_PAGES_NORMAL (0)         /**< ring in normal pages */
+#define FR_PAGES_HUGE   (1)         /**< ring in huge pages (hugetlb) */
+#define FR_PAGES_THP    (2)         /**< ring in transparent huge pages */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+/** writer of a dump (called by the background thread)
+ */
+struct fr_writer {
+    int (*begin)(void *context, FILE *stream, const void *last); /**< start of a dump, with the newest frame (or NULL) */
+    int (*write)(void *context, const void *frame); /**< frame of the snapshot (oldest first) */
+    int (*end)(void *context);   /**< end of a dump (e.g. flush), before the file is closed */
+    void *context;                  /**< context of the writer */
+};
+
+/** flight recorder
+ */
+struct flight_rec {
+    unsigned char *items;           /**< ring of the frames (mapped) */
+    size_t size;                    /**< size of a frame (in byte) */
+    size_t depth;                   /**< number of frames in the ring */
+    size_t length;                  /**< length of the mapping (in byte) */
+    int pages;                      /**< FR_PAGES_NORMAL, FR_PAGES_HUGE or FR_PAGES_THP */
+    size_t index;                   /**< next slot to be written (recording thread) */
+    uint64_t recorded;              /**< number of frames recorded (atomic) */
+    const char *path;               /**< name of the dump file (w/o time) */
+    struct fr_writer writer;        /**< writer of a dump */
+    unsigned char *chunk;           /**< copy of the frames of a dump (preallocated) */
+    uint64_t snapshot;              /**< end of the requested snapshot */
+    int requested;                  /**< a dump is requested */
+    int busy;                       /**< a dump is in progress */
+    int running;                    /**< the background thread is running */
+    pthread_t thread;               /**< background thread */
+    pthread_mutex_t mutex;          /**< protects the request */
+    pthread_cond_t cond;            /**< signals a request */
+    uint64_t dumps;                 /**< number of dump files written */
+    uint64_t dumped;                /**< number of frames written */
+    uint64_t lost;                  /**< number of frames overwritten during a dump */
+    uint64_t rejected;              /**< number of requests while busy */
+    uint64_t errors;                /**< number of failed dumps */
+    char name[4096];                /**< name of the last dump file */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       initializes a flight recorder and starts its background
+ *               thread (with all signals blocked).
+ *
+ *  @param[out]  rec     pointer to the flight recorder
+ *  @param[in]   size    size of a frame (in byte)
+ *  @param[in]   depth   number of frames in the ring
+ *  @param[in]   huge    try to map the ring in huge pages (non-zero)
+ *  @param[in]   path    name of the dump file (w/o time, kept by the caller)
+ *  @param[in]   writer  writer of a dump (copied)
+ *
+ *  @returns     non-zero value on success, or zero otherwise (e.g. more
+ *               frames than fr_max_depth)
+ */
+int fr_init(struct flight_rec *rec, size_t size, size_t depth, int huge, const char *path, const struct fr_writer *writer);
+
+/** @brief       returns the max. number of frames in the ring, so that the
+ *               ring takes at most 1/FR_MEMORY_SHARE of the physical memory.
+ *
+ *  @param[in]   size    size of a frame (in byte)
+ *
+ *  @returns     max. number of frames (or zero if size is zero)
+ */
+size_t fr_max_depth(size_t size);
+
+/** @brief       records a frame (overwrites the oldest one when the ring is
+ *               full); only to be called by one thread.
+ */
+void fr_record(struct flight_rec *rec, const void *frame);
+
+/** @brief       requests a dump of the frames recorded so far; only to be
+ *               called by the recording thread.
+ *
+ *  @returns     non-zero value if the dump is started, or zero if a dump is
+ *               still in progress
+ */
+int fr_dump(struct flight_rec *rec);
+
+/** @brief       stops the background thread (after a pending dump) and
+ *               releases the flight recorder.
+ */
+void fr_exit(struct flight_rec *rec);
+
+
+#endif /* FLIGHTREC_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
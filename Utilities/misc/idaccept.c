@@ -0,0 +1,144 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/idaccept.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Acceptance Filter from Sets of CAN Identifiers (PCAN-Basic)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  (see header file)
+ *
+ *  includes  :  idaccept.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ */
+/** @file        idaccept.c
+ *
+ *  @brief       Acceptance Filter from Sets of CAN Identifiers (PCAN-Basic)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @addtogroup  id_accept
+ *  @{
+ */
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "idaccept.h"
+
+#include <stdio.h>
+#include <stdint.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define MAX_11BIT       (IDSET_STD_IDS - 1ul)  /* largest 11-bit ID */
+#define MAX_29BIT       (IDSET_MAX_ID)         /* largest 29-bit ID */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+TPCANStatus idset_acceptance(TPCANHandle channel, const struct id_cover *std_cover, const struct id_cover *xtd_cover)
+{
+    const struct id_cover *cover[2] = { std_cover, xtd_cover };
+    const DWORD max_id[2] = { MAX_11BIT, MAX_29BIT };
+    TPCANStatus status;
+    UINT64 filter;
+    int range[2] = { 0, 0 };
+    int xtd;
+
+    /* per frame format the code and mask, or the range if it is smaller */
+    for (xtd = 0; xtd < 2; xtd++) {
+        if (!cover[xtd])
+            continue;
+        (void)idset_cover_ids(cover[xtd], &range[xtd]);
+        if (!cover[xtd]->empty && range[xtd])
+            continue;
+        range[xtd] = 0;
+        /* note: no ID at all is not possible, a single one is dropped in software */
+        if (cover[xtd]->empty)
+            filter = ((UINT64)max_id[xtd] << 32);
+        else
+            filter = ((UINT64)cover[xtd]->code << 32) | (UINT64)cover[xtd]->mask;
+        if ((status = CAN_SetValue(channel, xtd ? PCAN_ACCEPTANCE_FILTER_29BIT : PCAN_ACCEPTANCE_FILTER_11BIT,
+                                   (void*)&filter, sizeof(filter))) != PCAN_ERROR_OK)
+            return status;
+    }
+    /* the message filter (one for both frame formats) */
+    if (!range[0] && !range[1])
+        return PCAN_ERROR_OK;
+    for (xtd = 0; xtd < 2; xtd++) {
+        if ((status = CAN_FilterMessages(channel, range[xtd] ? cover[xtd]->first : 0U, range[xtd] ? cover[xtd]->last : max_id[xtd],
+                                         xtd ? PCAN_MODE_EXTENDED : PCAN_MODE_STANDARD)) != PCAN_ERROR_OK)
+            return status;
+    }
+    return PCAN_ERROR_OK;
+}
+
+void idset_print_acceptance(FILE *stream, const struct id_cover *cover, unsigned long max_id)
+{
+    int width = (max_id > MAX_11BIT) ? 8 : 3;
+    unsigned long ids;
+    int range;
+
+    ids = idset_cover_ids(cover, &range);
+    fprintf(stream, "Acceptance filter for %s IDs: ", (max_id > MAX_11BIT) ? "29-bit" : "11-bit");
+    if (cover->empty)
+        fprintf(stream, "code=0x%0*lX mask=0x%0*lX", width, max_id, width, 0UL);
+    else if (range)
+        fprintf(stream, "range 0x%0*lX-0x%0*lX", width, (unsigned long)cover->first, width, (unsigned long)cover->last);
+    else
+        fprintf(stream, "code=0x%0*lX mask=0x%0*lX", width, (unsigned long)cover->code, width, (unsigned long)cover->mask);
+    fprintf(stream, " (%lu of %lu IDs passed, %.1f%% removed)\n", ids, max_id + 1UL,
+            100.0 - ((double)ids * 100.0 / (double)(max_id + 1UL)));
+}
+
+unsigned long idset_cover_ids(const struct id_cover *cover, int *range)
+{
+    unsigned long by_mask = 1UL, by_range;
+    uint32_t mask;
+
+    /* number of IDs passed by the code and mask resp. by the range */
+    for (mask = cover->mask; mask; mask &= mask - 1u)
+        by_mask <<= 1;
+    by_range = (unsigned long)(cover->last - cover->first) + 1UL;
+    *range = (by_range < by_mask) ? 1 : 0;
+    return cover->empty ? 1UL : (*range ? by_range : by_mask);
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,109 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/idaccept.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Acceptance Filter from Sets of CAN Identifiers (PCAN-Basic)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  TPCANStatus idset_acceptance(TPCANHandle channel, const struct id_cover *std_cover, const struct id_cover *xtd_cover);
+ *               void idset_print_acceptance(FILE *stream, const struct id_cover *cover, unsigned long max_id);
+ *               unsigned long idset_cover_ids(const struct id_cover *cover, int *range);
+ *
+ *  includes  :  idset.h, PCBUSB.h resp. PCANBasic.h (or pcan_api.h)
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  The cover of a set of CAN-IDs (see idset_cover) is programmed into a
+ *  channel per frame format: as acceptance code and mask (mask bits set
+ *  to 1 are don't care), or as range of the message filter if the range
+ *  passes fewer CAN-IDs.
+ *
+ *  The message filter of the library is one for both frame formats: once
+ *  it is custom, only the registered CAN-IDs are received.  So a format
+ *  w/o a range of its own is registered with all of its CAN-IDs (its code
+ *  and mask still apply).
+ */
+/** @file        idaccept.h
+ *
+ *  @brief       Acceptance Filter from Sets of CAN Identifiers (PCAN-Basic)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    id_accept Acceptance Filter from Sets of CAN Identifiers (PCAN-Basic)
+ *  @{
+ */
+#ifndef IDACCEPT_H_INCLUDED
+#define IDACCEPT_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "idset.h"
+
+#if (OPTION_PCBUSB_STANDALONE != 0)
+#include "pcan_api.h"
+#else
+#if defined(__APPLE__)
+#include "PCBUSB.h"
+#else
+#include "PCANBasic.h"
+#endif
+#endif
+
+#include <stdio.h>
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       programs the acceptance filter of a channel from the covers
+ *               of the 11-bit and 29-bit CAN-IDs.
+ *
+ *  @param[in]   channel    channel handle (initialized)
+ *  @param[in]   std_cover  cover of the 11-bit CAN-IDs, or NULL (unchanged)
+ *  @param[in]   xtd_cover  cover of the 29-bit CAN-IDs, or NULL (unchanged)
+ *
+ *  @returns     PCAN_ERROR_OK on success, or the error code of the library
+ */
+TPCANStatus idset_acceptance(TPCANHandle channel, const struct id_cover *std_cover, const struct id_cover *xtd_cover);
+
+/** @brief       prints the acceptance filter of a cover and the share of
+ *               the CAN-IDs it removes (one line).
+ *
+ *  @param[in]   stream  output stream
+ *  @param[in]   cover   code and mask, first and last CAN-ID
+ *  @param[in]   max_id  largest CAN-ID (0x7FF or 0x1FFFFFFF)
+ */
+void idset_print_acceptance(FILE *stream, const struct id_cover *cover, unsigned long max_id);
+
+/** @brief       counts the CAN-IDs passed by a cover.
+ *
+ *  @param[in]   cover  code and mask, first and last CAN-ID
+ *  @param[out]  range  non-zero if the range passes fewer CAN-IDs than
+ *                      the code and mask
+ *
+ *  @returns     number of CAN-IDs passed by the code and mask resp. by the
+ *               range, whichever is smaller (1 if the cover is empty)
+ */
+unsigned long idset_cover_ids(const struct id_cover *cover, int *range);
+
+
+#endif /* IDACCEPT_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,197 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/idmap.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Map of CAN Identifiers to Entries (Direct Index and Hash Table)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  (see header file)
+ *
+ *  includes  :  idmap.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ */
+/** @file        idmap.c
+ *
+ *  @brief       Map of CAN Identifiers to Entries (Direct Index and Hash Table)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @addtogroup  id_map
+ *  @{
+ */
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "idmap.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static size_t find_slot(const uint32_t *keys, size_t size, uint32_t key);
+static int grow_hash(struct id_map *map);
+static uint32_t hash_key(uint32_t key);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int idmap_init(struct id_map *map, size_t xtd_ids)
+{
+    int i;
+
+    if (!map)
+        return 0;
+    memset(map, 0, sizeof(struct id_map));
+    for (i = 0; i < IDMAP_STD_IDS; i++)
+        map->std_index[i] = -1;
+    map->xtd_size = IDMAP_XTD_IDS;
+    while (map->xtd_size < (xtd_ids * 2))
+        map->xtd_size *= 2;
+    map->xtd_keys = (uint32_t*)calloc(map->xtd_size, sizeof(uint32_t));
+    map->xtd_index = (int32_t*)calloc(map->xtd_size, sizeof(int32_t));
+    if (!map->xtd_keys || !map->xtd_index) {
+        idmap_exit(map);
+        return 0;
+    }
+    return 1;
+}
+
+int idmap_find(const struct id_map *map, unsigned long id, int xtd)
+{
+    uint32_t key = ((uint32_t)id << 1) | (xtd ? 1u : 0u);
+    size_t pos;
+
+    if (!xtd && (id < IDMAP_STD_IDS))
+        return (int)map->std_index[id];
+    pos = find_slot(map->xtd_keys, map->xtd_size, key);
+    return map->xtd_keys[pos] ? (int)map->xtd_index[pos] : -1;
+}
+
+int idmap_set(struct id_map *map, unsigned long id, int xtd, int entry)
+{
+    uint32_t key = ((uint32_t)id << 1) | (xtd ? 1u : 0u);
+    size_t pos;
+
+    if (!xtd && (id < IDMAP_STD_IDS)) {
+        map->std_index[id] = (int32_t)entry;
+        return 1;
+    }
+    pos = find_slot(map->xtd_keys, map->xtd_size, key);
+    if (!map->xtd_keys[pos]) {
+        /* note: the table is kept at most half full */
+        if ((map->xtd_used + 1) * 2 > map->xtd_size) {
+            if (!grow_hash(map))
+                return 0;
+            pos = find_slot(map->xtd_keys, map->xtd_size, key);
+        }
+        map->xtd_keys[pos] = key + 1;
+        map->xtd_used++;
+    }
+    map->xtd_index[pos] = (int32_t)entry;
+    return 1;
+}
+
+void idmap_exit(struct id_map *map)
+{
+    if (!map)
+        return;
+    free(map->xtd_keys);
+    free(map->xtd_index);
+    map->xtd_keys = NULL;
+    map->xtd_index = NULL;
+    map->xtd_size = map->xtd_used = 0;
+}
+
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static size_t find_slot(const uint32_t *keys, size_t size, uint32_t key)
+{
+    size_t mask = size - 1;
+    size_t pos = hash_key(key) & mask;
+
+    /* linear probing: the slot of the key, or the empty slot to take it */
+    while (keys[pos] && (keys[pos] != key + 1))
+        pos = (pos + 1) & mask;
+    return pos;
+}
+
+static int grow_hash(struct id_map *map)
+{
+    size_t size = map->xtd_size * 2;
+    uint32_t *keys;
+    int32_t *index;
+    size_t i, pos;
+
+    keys = (uint32_t*)calloc(size, sizeof(uint32_t));
+    index = (int32_t*)calloc(size, sizeof(int32_t));
+    if (!keys || !index) {
+        free(keys);
+        free(index);
+        return 0;
+    }
+    for (i = 0; i < map->xtd_size; i++) {
+        if (map->xtd_keys[i]) {
+            pos = find_slot(keys, size, map->xtd_keys[i] - 1);
+            keys[pos] = map->xtd_keys[i];
+            index[pos] = map->xtd_index[i];
+        }
+    }
+    free(map->xtd_keys);
+    free(map->xtd_index);
+    map->xtd_keys = keys;
+    map->xtd_index = index;
+    map->xtd_size = size;
+    return 1;
+}
+
+static uint32_t hash_key(uint32_t key)
+{
+    /* note: J1939 IDs differ in a few bits only (multiplicative hash) */
+    key ^= key >> 16;
+    key *= 0x45D9F3Bu;
+    key ^= key >> 16;
+    return key;
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,123 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/idmap.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Map of CAN Identifiers to Entries (Direct Index and Hash Table)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  int idmap_init(struct id_map *map, size_t xtd_ids);
+ *               int idmap_find(const struct id_map *map, unsigned long id, int xtd);
+ *               int idmap_set(struct id_map *map, unsigned long id, int xtd, int entry);
+ *               void idmap_exit(struct id_map *map);
+ *
+ *  includes  :  (none)
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  The number of an entry (e.g. of a table of statistics) per CAN-ID.
+ *  11-bit IDs are a direct index into an array, 29-bit IDs are kept in an
+ *  open-addressing hash table (linear probing over an array of keys, so
+ *  a lookup usually touches one cache line).  The hash table is kept at
+ *  most half full; it grows by doubling.
+ *
+ *  The entries themselves are up to the caller, who adds an entry when a
+ *  CAN-ID is not found and then sets its number.
+ */
+/** @file        idmap.h
+ *
+ *  @brief       Map of CAN Identifiers to Entries (Direct Index and Hash Table)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    id_map Map of CAN Identifiers to Entries (Direct Index and Hash Table)
+ *  @{
+ */
+#ifndef IDMAP_H_INCLUDED
+#define IDMAP_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define IDMAP_STD_IDS   (2048)      /**< number of 11-bit identifiers */
+#define IDMAP_XTD_IDS   (1024)      /**< initial size of the hash table (power of 2) */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+/** map of CAN identifiers to entries
+ */
+struct id_map {
+    int32_t std_index[IDMAP_STD_IDS]; /**< entry of an 11-bit ID (or -1) */
+    uint32_t *xtd_keys;             /**< hash table: key + 1 (or 0) */
+    int32_t *xtd_index;             /**< hash table: entry of a key */
+    size_t xtd_size;                /**< size of the hash table (power of 2) */
+    size_t xtd_used;                /**< number of keys in the hash table */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       initializes an empty map.
+ *
+ *  @param[out]  map      pointer to the map
+ *  @param[in]   xtd_ids  number of 29-bit IDs to be added without growing
+ *                        the hash table (or zero for a default size)
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int idmap_init(struct id_map *map, size_t xtd_ids);
+
+/** @brief       looks up the entry of a CAN-ID.
+ *
+ *  @param[in]   map  pointer to the map
+ *  @param[in]   id   CAN identifier
+ *  @param[in]   xtd  non-zero for a 29-bit identifier
+ *
+ *  @returns     number of the entry, or a negative value if not found
+ */
+int idmap_find(const struct id_map *map, unsigned long id, int xtd);
+
+/** @brief       sets the entry of a CAN-ID (adds the CAN-ID if not found).
+ *
+ *  @param[in]   map    pointer to the map
+ *  @param[in]   id     CAN identifier
+ *  @param[in]   xtd    non-zero for a 29-bit identifier
+ *  @param[in]   entry  number of the entry (not negative)
+ *
+ *  @returns     non-zero value on success, or zero otherwise (out of memory)
+ */
+int idmap_set(struct id_map *map, unsigned long id, int xtd, int entry);
+
+/** @brief       releases the map.
+ */
+void idmap_exit(struct id_map *map);
+
+
+#endif /* IDMAP_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,342 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/idset.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Sets of CAN Identifiers (Bitset and Interval Set)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  (see header file)
+ *
+ *  includes  :  idset.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ */
+/** @file        idset.c
+ *
+ *  @brief       Sets of CAN Identifiers (Bitset and Interval Set)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @addtogroup  id_set
+ *  @{
+ */
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "idset.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define TOKEN_LENGTH    (32)        /* longest item in a file: <id>-<id> */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static int parse_item(struct id_set *set, const char *item);
+static int compare_ranges(const void *a, const void *b);
+static void cover_range(struct id_cover *cover, unsigned long first, unsigned long last);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int idset_init(struct id_set *set)
+{
+    if (!set)
+        return 0;
+    memset(set, 0, sizeof(struct id_set));
+    set->sorted = 1;
+    return 1;
+}
+
+int idset_add(struct id_set *set, unsigned long first, unsigned long last)
+{
+    uint32_t *array;
+    size_t size;
+
+    if (!set || (first > last) || (last > IDSET_MAX_ID))
+        return 0;
+    /* the IDs below 2048 into the bitset */
+    for (; (first <= last) && (first < IDSET_STD_IDS); first++)
+        set->bits[first >> 6] |= (uint64_t)1 << (first & 63u);
+    if (first > last)
+        return 1;
+    /* the others as an interval (sorted later) */
+    if (set->count >= set->size) {
+        size = set->size ? set->size * 2 : 64;
+        if ((array = (uint32_t*)realloc(set->first, size * sizeof(uint32_t))) == NULL)
+            return 0;
+        set->first = array;
+        if ((array = (uint32_t*)realloc(set->last, size * sizeof(uint32_t))) == NULL)
+            return 0;
+        set->last = array;
+        set->size = size;
+    }
+    set->first[set->count] = (uint32_t)first;
+    set->last[set->count] = (uint32_t)last;
+    set->count++;
+    set->sorted = 0;
+    return 1;
+}
+
+int idset_load(struct id_set *set, const char *filename, unsigned long *line)
+{
+    FILE *fp;
+    char item[TOKEN_LENGTH + 1];
+    size_t length = 0;
+    unsigned long number = 1;
+    int c, comment = 0, rc = 1;
+
+    if (line)
+        *line = 0;
+    if (!set || !filename)
+        return 0;
+    if ((fp = fopen(filename, "r")) == NULL)
+        return 0;
+    /* items are separated by commas, blanks or new lines (`#' comments) */
+    while (rc && ((c = fgetc(fp)) != EOF)) {
+        if (comment || (c == '#')) {
+            comment = (c != '\n') ? 1 : 0;
+        }
+        else if ((c != ',') && (c != ' ') && (c != '\t') && (c != '\r') && (c != '\n')) {
+            if (length < TOKEN_LENGTH)
+                item[length++] = (char)c;
+            else
+                rc = 0;
+            continue;
+        }
+        if (length) {
+            item[length] = '\0';
+            rc = parse_item(set, item);
+            length = 0;
+        }
+        if (rc && (c == '\n'))
+            number++;
+    }
+    if (rc && length) {
+        item[length] = '\0';
+        rc = parse_item(set, item);
+    }
+    if (ferror(fp))
+        number = 0;
+    (void)fclose(fp);
+    if (!rc && line)
+        *line = number;
+    return (rc && number) ? 1 : 0;
+}
+
+int idset_build(struct id_set *set)
+{
+    uint64_t *ranges;
+    size_t i, n;
+
+    if (!set)
+        return 0;
+    if (set->sorted || (set->count < 2)) {
+        set->sorted = 1;
+        return (int)set->count;
+    }
+    /* sort the intervals by their first ID, then merge adjacent ones */
+    if ((ranges = (uint64_t*)malloc(set->count * sizeof(uint64_t))) == NULL)
+        return -1;
+    for (i = 0; i < set->count; i++)
+        ranges[i] = ((uint64_t)set->first[i] << 32) | (uint64_t)set->last[i];
+    qsort(ranges, set->count, sizeof(uint64_t), compare_ranges);
+    for (i = 0, n = 0; i < set->count; i++) {
+        uint32_t first = (uint32_t)(ranges[i] >> 32);
+        uint32_t last = (uint32_t)ranges[i];
+
+        if (n && ((uint64_t)first <= (uint64_t)set->last[n - 1] + 1u)) {
+            if (last > set->last[n - 1])
+                set->last[n - 1] = last;
+        }
+        else {
+            set->first[n] = first;
+            set->last[n] = last;
+            n++;
+        }
+    }
+    free(ranges);
+    set->count = n;
+    set->sorted = 1;
+    return (int)set->count;
+}
+
+void idset_invert(struct id_set *set)
+{
+    if (set)
+        set->inverted = !set->inverted;
+}
+
+int idset_contains(const struct id_set *set, unsigned long id)
+{
+    const uint32_t *base;
+    size_t n, half;
+    int found;
+
+    if (id < IDSET_STD_IDS) {
+        found = (int)((set->bits[id >> 6] >> (id & 63u)) & 1u);
+    }
+    else if ((n = set->count) != 0) {
+        /* the last interval starting at or below the ID (binary search) */
+        base = set->first;
+        while (n > 1) {
+            half = n >> 1;
+            base = (base[half] <= id) ? &base[half] : base;
+            n -= half;
+        }
+        found = (*base <= id) & (id <= set->last[base - set->first]);
+    }
+    else {
+        found = 0;
+    }
+    return found ^ set->inverted;
+}
+
+int idset_cover(const struct id_set *set, unsigned long max_id, struct id_cover *cover)
+{
+    unsigned long id, next;
+    size_t i;
+    int bit;
+
+    if (!set || !cover || !set->sorted || (max_id > IDSET_MAX_ID))
+        return 0;
+    memset(cover, 0, sizeof(struct id_cover));
+    cover->empty = 1;
+    /* runs of IDs in (resp. not in) the bitset */
+    for (id = 0; (id < IDSET_STD_IDS) && (id <= max_id); id = next) {
+        bit = (int)((set->bits[id >> 6] >> (id & 63u)) & 1u);
+        for (next = id + 1; (next < IDSET_STD_IDS) && (next <= max_id); next++) {
+            if ((int)((set->bits[next >> 6] >> (next & 63u)) & 1u) != bit)
+                break;
+        }
+        if (bit ^ set->inverted)
+            cover_range(cover, id, next - 1);
+    }
+    /* the intervals (resp. the gaps between them) */
+    for (i = 0, next = IDSET_STD_IDS; (i < set->count) && (set->first[i] <= max_id); i++) {
+        if (!set->inverted)
+            cover_range(cover, set->first[i], (set->last[i] < max_id) ? set->last[i] : max_id);
+        else if (set->first[i] > next)
+            cover_range(cover, next, set->first[i] - 1);
+        next = (unsigned long)set->last[i] + 1;
+    }
+    if (set->inverted && (next <= max_id))
+        cover_range(cover, next, max_id);
+    cover->mask &= (uint32_t)max_id;
+    cover->code &= ~cover->mask & (uint32_t)max_id;
+    return 1;
+}
+
+void idset_exit(struct id_set *set)
+{
+    if (!set)
+        return;
+    free(set->first);
+    free(set->last);
+    set->first = NULL;
+    set->last = NULL;
+    set->count = set->size = 0;
+}
+
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static int parse_item(struct id_set *set, const char *item)
+{
+    char *end;
+    unsigned long first, last;
+
+    /* <id>[-<id>] (decimal, octal or hexadecimal) */
+    if ((*item < '0') || (*item > '9'))
+        return 0;
+    errno = 0;
+    first = last = strtoul(item, &end, 0);
+    if ((errno != 0) || (end == item))
+        return 0;
+    if (*end == '-') {
+        item = end + 1;
+        if ((*item < '0') || (*item > '9'))
+            return 0;
+        last = strtoul(item, &end, 0);
+        if ((errno != 0) || (end == item))
+            return 0;
+    }
+    if (*end != '\0')
+        return 0;
+    return (first <= last) ? idset_add(set, first, last) : idset_add(set, last, first);
+}
+
+static int compare_ranges(const void *a, const void *b)
+{
+    uint64_t ra = *(const uint64_t*)a;
+    uint64_t rb = *(const uint64_t*)b;
+
+    return (ra < rb) ? -1 : (ra > rb) ? 1 : 0;
+}
+
+static void cover_range(struct id_cover *cover, unsigned long first, unsigned long last)
+{
+    uint32_t diff;
+
+    if (cover->empty) {
+        cover->code = (uint32_t)first;
+        cover->first = (uint32_t)first;
+        cover->last = (uint32_t)last;
+        cover->empty = 0;
+    }
+    if (first < cover->first)
+        cover->first = (uint32_t)first;
+    if (last > cover->last)
+        cover->last = (uint32_t)last;
+    /* the bits that differ from the code, and all bits below the highest
+     * bit that differs within the range, are don't care */
+    diff = (uint32_t)first ^ (uint32_t)last;
+    diff |= diff >> 1;
+    diff |= diff >> 2;
+    diff |= diff >> 4;
+    diff |= diff >> 8;
+    diff |= diff >> 16;
+    cover->mask |= diff | ((uint32_t)first ^ cover->code);
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,175 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/idset.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Sets of CAN Identifiers (Bitset and Interval Set)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  int idset_init(struct id_set *set);
+ *               int idset_add(struct id_set *set, unsigned long first, unsigned long last);
+ *               int idset_load(struct id_set *set, const char *filename, unsigned long *line);
+ *               int idset_build(struct id_set *set);
+ *               void idset_invert(struct id_set *set);
+ *               int idset_contains(const struct id_set *set, unsigned long id);
+ *               int idset_cover(const struct id_set *set, unsigned long max_id, struct id_cover *cover);
+ *               void idset_exit(struct id_set *set);
+ *
+ *  includes  :  (none)
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  A set of CAN identifiers, e.g. the CAN-IDs to be excluded.  IDs below
+ *  2048 are kept in a bitset (256 bytes), the others (29-bit IDs) as a
+ *  sorted array of disjoint intervals, so thousands of single IDs and
+ *  ranges take 8 bytes each.  The intervals are added in any order and
+ *  then sorted and merged by idset_build.
+ *
+ *  A lookup is a bit test, resp. a binary search over the first IDs of
+ *  the intervals (an array of its own, 16 IDs per cache line).  The set
+ *  can be inverted, i.e. it contains all IDs that have not been added.
+ *
+ *  A list of CAN-IDs can be loaded from a text file: <id>[-<id>] items,
+ *  separated by commas, blanks or new lines; a `#' starts a comment.
+ *
+ *  For the acceptance filter of the CAN controller the tightest code and
+ *  mask (mask bits set to 1 are don't care) and the smallest range that
+ *  cover the set (IDs up to 0x7FF resp. 0x1FFFFFFF) can be computed.
+ */
+/** @file        idset.h
+ *
+ *  @brief       Sets of CAN Identifiers (Bitset and Interval Set)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    id_set Sets of CAN Identifiers (Bitset and Interval Set)
+ *  @{
+ */
+#ifndef IDSET_H_INCLUDED
+#define IDSET_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define IDSET_STD_IDS   (2048)      /**< IDs in the bitset (11-bit) */
+#define IDSET_MAX_ID    (0x1FFFFFFFul)  /**< largest 29-bit ID */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+/** set of CAN identifiers
+ */
+struct id_set {
+    uint64_t bits[IDSET_STD_IDS / 64]; /**< bitset of the IDs below 2048 */
+    uint32_t *first;                /**< first ID of the intervals (sorted) */
+    uint32_t *last;                 /**< last ID of the intervals */
+    size_t count;                   /**< number of intervals */
+    size_t size;                    /**< number of allocated intervals */
+    int sorted;                     /**< intervals sorted and merged */
+    int inverted;                   /**< set of the IDs not added */
+};
+
+/** acceptance filter covering a set of CAN identifiers
+ */
+struct id_cover {
+    uint32_t code;                  /**< acceptance code */
+    uint32_t mask;                  /**< acceptance mask (1 = don't care) */
+    uint32_t first;                 /**< first ID of the covering range */
+    uint32_t last;                  /**< last ID of the covering range */
+    int empty;                      /**< no ID of the set in the range */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       initializes an empty set.
+ *
+ *  @param[out]  set  pointer to the set
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int idset_init(struct id_set *set);
+
+/** @brief       adds a range of CAN-IDs to the set.
+ *
+ *  @param[in]   set    pointer to the set
+ *  @param[in]   first  first CAN-ID of the range
+ *  @param[in]   last   last CAN-ID of the range (at least first)
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int idset_add(struct id_set *set, unsigned long first, unsigned long last);
+
+/** @brief       adds the CAN-IDs of a text file to the set.
+ *
+ *  @param[in]   set       pointer to the set
+ *  @param[in]   filename  name of the file
+ *  @param[out]  line      number of the faulty line (or 0 when the file
+ *                         cannot be read), or NULL
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int idset_load(struct id_set *set, const char *filename, unsigned long *line);
+
+/** @brief       sorts and merges the intervals (before the first lookup).
+ *
+ *  @returns     number of intervals, or a negative value on error
+ */
+int idset_build(struct id_set *set);
+
+/** @brief       inverts the set.
+ */
+void idset_invert(struct id_set *set);
+
+/** @brief       checks if a CAN-ID is in the set.
+ *
+ *  @param[in]   set  pointer to the set (built)
+ *  @param[in]   id   CAN identifier
+ *
+ *  @returns     non-zero value if the CAN-ID is in the set, or zero otherwise
+ */
+int idset_contains(const struct id_set *set, unsigned long id);
+
+/** @brief       computes the acceptance code and mask and the range that
+ *               cover all CAN-IDs of the set up to a given CAN-ID.
+ *
+ *  @param[in]   set     pointer to the set (built)
+ *  @param[in]   max_id  largest CAN-ID (0x7FF or 0x1FFFFFFF)
+ *  @param[out]  cover   code and mask, first and last CAN-ID
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int idset_cover(const struct id_set *set, unsigned long max_id, struct id_cover *cover);
+
+/** @brief       releases the set.
+ */
+void idset_exit(struct id_set *set);
+
+
+#endif /* IDSET_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
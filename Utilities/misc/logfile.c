@@ -0,0 +1,513 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/logfile.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Log-file Writers (Vector ASC, candump, PEAK TRC, JSON Lines)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  (see header file)
+ *
+ *  includes  :  logfile.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ */
+/** @file        logfile.c
+ *
+ *  @brief       Log-file Writers (Vector ASC, candump, PEAK TRC, JSON Lines)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @addtogroup  log_file
+ *  @{
+ */
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "logfile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define ASC_FLAG_EDL    (0x1000)    /* extended data length (CAN FD) */
+#define ASC_FLAG_BRS    (0x2000)    /* bit-rate switch */
+#define ASC_FLAG_ESI    (0x4000)    /* error state indicator */
+
+#define CANDUMP_BRS     (0x1)       /* CANFD_BRS */
+#define CANDUMP_ESI     (0x2)       /* CANFD_ESI */
+
+#define OLE_DATE_1970   (25569.0)   /* 1970-01-01 as OLE Automation date */
+
+#define JSON_FRAGMENT(str)  { str, sizeof(str) - 1 }
+#define JSON_FLAG(flag, key)  { flag, { JSON_FRAGMENT(",\"" key "\":false"), JSON_FRAGMENT(",\"" key "\":true") } }
+#define JSON_FLAGS      (5)         /* XTD, RTR, FDF, BRS, ESI */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+struct json_fragment {              /* constant part of a JSON object */
+    const char *text;
+    size_t length;
+};
+
+struct json_flag {                  /* member for a message flag */
+    int flag;
+    struct json_fragment member[2]; /* false, true */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static char *format_asc(char *ptr, const struct log_writer *writer, uint64_t usec,
+                        unsigned long id, int flags, int dlc, int len, const unsigned char *data);
+static char *format_candump(char *ptr, const struct log_writer *writer, const struct msg_timestamp *timestamp,
+                            unsigned long id, int flags, int len, const unsigned char *data);
+static char *format_trc(char *ptr, const struct log_writer *writer, uint64_t usec,
+                        unsigned long id, int flags, int dlc, int len, const unsigned char *data);
+static char *format_jsonl(char *ptr, const struct log_writer *writer, const struct msg_timestamp *timestamp,
+                          unsigned long id, int flags, int dlc, int len, const unsigned char *data);
+
+static char *put_string(char *ptr, const char *str);
+static char *put_fragment(char *ptr, const struct json_fragment *fragment);
+static char *put_spaces(char *ptr, int count);
+static char *put_decimal(char *ptr, uint64_t value, int width);
+static char *put_digits(char *ptr, uint64_t value, int count);
+static char *put_hex(char *ptr, unsigned long value, int count);
+static char *put_bytes(char *ptr, const unsigned char *data, int len, int separator);
+
+static int put_line(struct msg_buffer *buffer, const char *line);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+static const char hex_digits[16] = {
+    '0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F'
+};
+
+static const struct json_fragment json_ts = JSON_FRAGMENT(",\"ts\":");
+static const struct json_fragment json_id = JSON_FRAGMENT(",\"id\":");
+static const struct json_fragment json_dlc = JSON_FRAGMENT(",\"dlc\":");
+static const struct json_fragment json_data = JSON_FRAGMENT(",\"data\":\"");
+static const struct json_fragment json_end = JSON_FRAGMENT("\"}\n");
+
+static const struct json_flag json_flags[JSON_FLAGS] = {
+    JSON_FLAG(MSG_FLAG_XTD, "xtd"),
+    JSON_FLAG(MSG_FLAG_RTR, "rtr"),
+    JSON_FLAG(MSG_FLAG_FDF, "fdf"),
+    JSON_FLAG(MSG_FLAG_BRS, "brs"),
+    JSON_FLAG(MSG_FLAG_ESI, "esi")
+};
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int log_writer_init(struct log_writer *writer, int format, int canfd, const char *name, int channel)
+{
+    if (!writer || !name)
+        return 0;
+    if ((format != LOG_FORMAT_ASC) && (format != LOG_FORMAT_CANDUMP) && (format != LOG_FORMAT_TRC) &&
+        (format != LOG_FORMAT_JSONL))
+        return 0;
+    memset(writer, 0, sizeof(struct log_writer));
+    writer->format = format;
+    writer->canfd = canfd;
+    return log_writer_bus(writer, name, channel);
+}
+
+int log_writer_bus(struct log_writer *writer, const char *name, int channel)
+{
+    const char *src;
+    char *ptr;
+
+    if (!writer || !name)
+        return 0;
+    (void)snprintf(writer->name, sizeof(writer->name), "%s", name);
+    writer->channel = channel;
+    /* JSON Lines: '{"bus":"<name>"' is the same for all objects (escaped once) */
+    ptr = put_string(writer->prefix, "{\"bus\":\"");
+    for (src = writer->name; *src; src++) {
+        if ((*src == '"') || (*src == '\\'))
+            *ptr++ = '\\';
+        if ((unsigned char)*src >= 0x20)
+            *ptr++ = *src;
+    }
+    *ptr++ = '"';
+    ptr = put_fragment(ptr, &json_ts);
+    writer->length = (size_t)(ptr - writer->prefix);
+    return 1;
+}
+
+int log_write_header(struct log_writer *writer, struct msg_buffer *buffer)
+{
+    struct timeval now;
+    struct tm tm;
+    char stamp[32], date[80], line[128];
+    int rc = 1;
+
+    if (!writer || !buffer)
+        return 0;
+    gettimeofday(&now, NULL);
+    (void)localtime_r(&now.tv_sec, &tm);
+    switch (writer->format) {
+    case LOG_FORMAT_ASC:
+        /* e.g. "Fri Oct 17 07:20:12.123 pm 2025" */
+        (void)strftime(stamp, sizeof(stamp), "%a %b %d %I:%M:%S", &tm);
+        (void)snprintf(date, sizeof(date), "%s.%03ld %s %d", stamp, (long)now.tv_usec / 1000L,
+                       (tm.tm_hour < 12) ? "am" : "pm", tm.tm_year + 1900);
+        (void)snprintf(line, sizeof(line), "date %s\n", date);
+        rc &= put_line(buffer, line);
+        rc &= put_line(buffer, "base hex  timestamps absolute\n");
+        rc &= put_line(buffer, "internal events logged\n");
+        rc &= put_line(buffer, "// version 9.0.0\n");
+        (void)snprintf(line, sizeof(line), "Begin Triggerblock %s\n", date);
+        rc &= put_line(buffer, line);
+        rc &= put_line(buffer, "   0.000000 Start of measurement\n");
+        break;
+    case LOG_FORMAT_TRC:
+        /* start time as OLE Automation date (days since 1899-12-30, local time) */
+        (void)snprintf(line, sizeof(line), ";$FILEVERSION=2.1\n;$STARTTIME=%.10f\n;$COLUMNS=N,O,T,B,I,d,R,L,D\n;\n",
+                       OLE_DATE_1970 + (((double)now.tv_sec + (double)tm.tm_gmtoff + ((double)now.tv_usec / 1000000.0)) / 86400.0));
+        rc &= put_line(buffer, line);
+        (void)strftime(date, sizeof(date), "%d.%m.%Y %H:%M:%S", &tm);
+        (void)snprintf(line, sizeof(line), ";   Start time: %s.%03ld.0\n", date, (long)now.tv_usec / 1000L);
+        rc &= put_line(buffer, line);
+        rc &= put_line(buffer, ";   Generated by can_moni\n");
+        rc &= put_line(buffer, ";-------------------------------------------------------------------------------\n");
+        rc &= put_line(buffer, ";   Message   Time    Type    ID     Rx/Tx\n");
+        rc &= put_line(buffer, ";   Number    Offset  |  Bus  [hex]  |  Reserved\n");
+        rc &= put_line(buffer, ";   |         [ms]    |  |    |      |  |  Data Length Code\n");
+        rc &= put_line(buffer, ";   |         |       |  |    |      |  |  |    Data [hex] ...\n");
+        rc &= put_line(buffer, ";   |         |       |  |    |      |  |  |    |\n");
+        rc &= put_line(buffer, ";---+-- ------+------ +- +- --+----- +- +- +--- +- -- -- -- -- -- -- --\n");
+        break;
+    case LOG_FORMAT_CANDUMP:
+    default:
+        break;
+    }
+    return rc;
+}
+
+int log_write_message(struct log_writer *writer, struct msg_buffer *buffer, const struct msg_timestamp *timestamp,
+                      unsigned long id, int flags, int dlc, int len, const unsigned char *data)
+{
+    char *line, *ptr;
+    uint64_t usec;
+
+    if (!writer || !buffer || !timestamp || (len < 0) || (len > 64))
+        return 0;
+    /* note: the line is formatted straight into the output buffer */
+    if ((line = msg_buffer_reserve(buffer, MSG_LINE_MAX)) == NULL)
+        return 0;
+    ptr = line;
+    usec = ((uint64_t)timestamp->tv_sec * 1000000ull) + (uint64_t)timestamp->tv_usec;
+    if (writer->counter++ == 0)
+        writer->start = usec;
+    usec = (usec >= writer->start) ? (usec - writer->start) : 0;
+    switch (writer->format) {
+    case LOG_FORMAT_ASC:
+        ptr = format_asc(ptr, writer, usec, id, flags, dlc, len, data);
+        break;
+    case LOG_FORMAT_CANDUMP:
+        ptr = format_candump(ptr, writer, timestamp, id, flags, len, data);
+        break;
+    case LOG_FORMAT_TRC:
+        ptr = format_trc(ptr, writer, usec, id, flags, dlc, len, data);
+        break;
+    case LOG_FORMAT_JSONL:
+        ptr = format_jsonl(ptr, writer, timestamp, id, flags, dlc, len, data);
+        break;
+    default:
+        return 0;
+    }
+    return msg_buffer_commit(buffer, (size_t)(ptr - line));
+}
+
+int log_write_footer(struct log_writer *writer, struct msg_buffer *buffer)
+{
+    if (!writer || !buffer)
+        return 0;
+    if (writer->format == LOG_FORMAT_ASC)
+        return put_line(buffer, "End TriggerBlock\n");
+    return 1;
+}
+
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static char *format_asc(char *ptr, const struct log_writer *writer, uint64_t usec,
+                        unsigned long id, int flags, int dlc, int len, const unsigned char *data)
+{
+    char *start;
+    int asc = ASC_FLAG_EDL;
+
+    /* time relative to the start of measurement: "%11.6f " */
+    ptr = put_decimal(ptr, usec / 1000000ull, 4);
+    *ptr++ = '.';
+    ptr = put_digits(ptr, usec % 1000000ull, 6);
+    *ptr++ = ' ';
+    if (!(flags & MSG_FLAG_FDF)) {
+        /* "<ch>  <id>[x]  Rx   d <dlc> <data>" */
+        ptr = put_decimal(ptr, (uint64_t)writer->channel, 0);
+        ptr = put_spaces(ptr, 2);
+        start = ptr;
+        ptr = put_hex(ptr, id, 0);
+        if (flags & MSG_FLAG_XTD)
+            *ptr++ = 'x';
+        ptr = put_spaces(ptr, 15 - (int)(ptr - start));
+        ptr = put_string(ptr, " Rx   ");
+        *ptr++ = (flags & MSG_FLAG_RTR) ? 'r' : 'd';
+        *ptr++ = ' ';
+        *ptr++ = hex_digits[dlc & 0xF];
+        *ptr++ = ' ';
+        if (!(flags & MSG_FLAG_RTR))
+            ptr = put_bytes(ptr, data, len, ' ');
+    }
+    else {
+        /* "CANFD <ch> Rx <id>[x] <name> <brs> <esi> <dlc> <len> <data> <duration> <length> <flags> <crc> <timing>..." */
+        ptr = put_string(ptr, "CANFD ");
+        ptr = put_decimal(ptr, (uint64_t)writer->channel, 3);
+        ptr = put_string(ptr, " Rx   ");
+        start = ptr;
+        ptr = put_hex(ptr, id, 0);
+        if (flags & MSG_FLAG_XTD)
+            *ptr++ = 'x';
+        if ((ptr - start) < 8) {
+            /* right-aligned in 8 characters */
+            memmove(start + (8 - (ptr - start)), start, (size_t)(ptr - start));
+            memset(start, ' ', (size_t)(8 - (ptr - start)));
+            ptr = start + 8;
+        }
+        ptr = put_spaces(ptr, 2 + 32);
+        *ptr++ = ' ';
+        *ptr++ = (flags & MSG_FLAG_BRS) ? '1' : '0';
+        *ptr++ = ' ';
+        *ptr++ = (flags & MSG_FLAG_ESI) ? '1' : '0';
+        *ptr++ = ' ';
+        *ptr++ = hex_digits[dlc & 0xF];
+        *ptr++ = ' ';
+        ptr = put_decimal(ptr, (uint64_t)len, 2);
+        *ptr++ = ' ';
+        ptr = put_bytes(ptr, data, len, ' ');
+        asc |= (flags & MSG_FLAG_BRS) ? ASC_FLAG_BRS : 0;
+        asc |= (flags & MSG_FLAG_ESI) ? ASC_FLAG_ESI : 0;
+        *ptr++ = ' ';
+        ptr = put_decimal(ptr, 0, 8);
+        *ptr++ = ' ';
+        ptr = put_decimal(ptr, 0, 4);
+        *ptr++ = ' ';
+        ptr = put_spaces(ptr, 4);
+        ptr = put_hex(ptr, (unsigned long)asc, 4);
+        ptr = put_string(ptr, "        0        0        0        0        0");
+    }
+    *ptr++ = '\n';
+    return ptr;
+}
+
+static char *format_candump(char *ptr, const struct log_writer *writer, const struct msg_timestamp *timestamp,
+                            unsigned long id, int flags, int len, const unsigned char *data)
+{
+    /* "(<sec>.<usec>) <ifname> <id>#<data>" resp. "<id>##<flags><data>" */
+    *ptr++ = '(';
+    ptr = put_digits(ptr, (uint64_t)timestamp->tv_sec, 10);
+    *ptr++ = '.';
+    ptr = put_digits(ptr, (uint64_t)timestamp->tv_usec, 6);
+    *ptr++ = ')';
+    *ptr++ = ' ';
+    ptr = put_string(ptr, writer->name);
+    *ptr++ = ' ';
+    ptr = put_hex(ptr, id, (flags & MSG_FLAG_XTD) ? 8 : 3);
+    *ptr++ = '#';
+    if (flags & MSG_FLAG_FDF) {
+        *ptr++ = '#';
+        *ptr++ = hex_digits[((flags & MSG_FLAG_BRS) ? CANDUMP_BRS : 0) | ((flags & MSG_FLAG_ESI) ? CANDUMP_ESI : 0)];
+        ptr = put_bytes(ptr, data, len, 0);
+    }
+    else if (flags & MSG_FLAG_RTR) {
+        *ptr++ = 'R';
+        if ((len > 0) && (len <= 8))
+            *ptr++ = hex_digits[len];
+    }
+    else
+        ptr = put_bytes(ptr, data, len, 0);
+    *ptr++ = '\n';
+    return ptr;
+}
+
+static char *format_trc(char *ptr, const struct log_writer *writer, uint64_t usec,
+                        unsigned long id, int flags, int dlc, int len, const unsigned char *data)
+{
+    const char *type;
+
+    if (flags & MSG_FLAG_FDF) {
+        if ((flags & MSG_FLAG_BRS) && (flags & MSG_FLAG_ESI))
+            type = "BI";
+        else if (flags & MSG_FLAG_BRS)
+            type = "FB";
+        else if (flags & MSG_FLAG_ESI)
+            type = "FE";
+        else
+            type = "FD";
+    }
+    else
+        type = (flags & MSG_FLAG_RTR) ? "RR" : "DT";
+    /* "<number> <offset> <type> <bus> <id> Rx - <dlc>  <data>" */
+    ptr = put_decimal(ptr, writer->counter, 7);
+    *ptr++ = ' ';
+    ptr = put_decimal(ptr, usec / 1000ull, 9);
+    *ptr++ = '.';
+    ptr = put_digits(ptr, usec % 1000ull, 3);
+    *ptr++ = ' ';
+    ptr = put_string(ptr, type);
+    *ptr++ = ' ';
+    ptr = put_decimal(ptr, (uint64_t)writer->channel, 0);
+    *ptr++ = ' ';
+    if (!(flags & MSG_FLAG_XTD))
+        ptr = put_spaces(ptr, 4);
+    ptr = put_hex(ptr, id, (flags & MSG_FLAG_XTD) ? 8 : 4);
+    ptr = put_string(ptr, " Rx - ");
+    ptr = put_decimal(ptr, (uint64_t)(dlc & 0xF), 2);
+    if (!(flags & MSG_FLAG_RTR) && (len > 0)) {
+        ptr = put_spaces(ptr, 4);
+        ptr = put_bytes(ptr, data, len, ' ');
+    }
+    *ptr++ = '\n';
+    return ptr;
+}
+
+static char *format_jsonl(char *ptr, const struct log_writer *writer, const struct msg_timestamp *timestamp,
+                          unsigned long id, int flags, int dlc, int len, const unsigned char *data)
+{
+    int i;
+
+    /* '{"bus":"<name>","ts":<sec>.<usec>,"id":<id>,"xtd":<bool>,...,"dlc":<dlc>,"data":"<hex>"}' */
+    memcpy(ptr, writer->prefix, writer->length);
+    ptr += writer->length;
+    ptr = put_decimal(ptr, (uint64_t)timestamp->tv_sec, 0);
+    *ptr++ = '.';
+    ptr = put_digits(ptr, (uint64_t)timestamp->tv_usec, 6);
+    ptr = put_fragment(ptr, &json_id);
+    ptr = put_decimal(ptr, (uint64_t)id, 0);
+    for (i = 0; i < JSON_FLAGS; i++)
+        ptr = put_fragment(ptr, &json_flags[i].member[(flags & json_flags[i].flag) ? 1 : 0]);
+    ptr = put_fragment(ptr, &json_dlc);
+    ptr = put_decimal(ptr, (uint64_t)(dlc & 0xF), 0);
+    ptr = put_fragment(ptr, &json_data);
+    if (!(flags & MSG_FLAG_RTR))
+        ptr = put_bytes(ptr, data, len, 0);
+    return put_fragment(ptr, &json_end);
+}
+
+static char *put_string(char *ptr, const char *str)
+{
+    while (*str)
+        *ptr++ = *str++;
+    return ptr;
+}
+
+static char *put_fragment(char *ptr, const struct json_fragment *fragment)
+{
+    memcpy(ptr, fragment->text, fragment->length);
+    return ptr + fragment->length;
+}
+
+static char *put_spaces(char *ptr, int count)
+{
+    while (count-- > 0)
+        *ptr++ = ' ';
+    return ptr;
+}
+
+static char *put_decimal(char *ptr, uint64_t value, int width)
+{
+    char digits[24];
+    int n = 0;
+
+    /* right-aligned (padded with spaces) */
+    do {
+        digits[n++] = (char)('0' + (value % 10U));
+        value /= 10U;
+    } while (value);
+    ptr = put_spaces(ptr, width - n);
+    while (n > 0)
+        *ptr++ = digits[--n];
+    return ptr;
+}
+
+static char *put_digits(char *ptr, uint64_t value, int count)
+{
+    int i;
+
+    /* exactly count digits (padded with zeros) */
+    for (i = count - 1; i >= 0; i--) {
+        ptr[i] = (char)('0' + (value % 10U));
+        value /= 10U;
+    }
+    return ptr + count;
+}
+
+static char *put_hex(char *ptr, unsigned long value, int count)
+{
+    int n = 1;
+
+    /* count digits (padded with zeros), or as many as needed */
+    while ((n < 8) && (value >> (4 * n)))
+        n++;
+    if (n < count)
+        n = count;
+    while (n-- > 0)
+        *ptr++ = hex_digits[(value >> (4 * n)) & 0xF];
+    return ptr;
+}
+
+static char *put_bytes(char *ptr, const unsigned char *data, int len, int separator)
+{
+    int i;
+
+    for (i = 0; i < len; i++) {
+        if (separator && i)
+            *ptr++ = (char)separator;
+        *ptr++ = hex_digits[data[i] >> 4];
+        *ptr++ = hex_digits[data[i] & 0xF];
+    }
+    return ptr;
+}
+
+static int put_line(struct msg_buffer *buffer, const char *line)
+{
+    return msg_buffer_write(buffer, line, strlen(line));
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,150 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/logfile.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Log-file Writers (Vector ASC, candump, PEAK TRC, JSON Lines)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  int log_writer_init(struct log_writer *writer, int format, int canfd, const char *name, int channel);
+ *               int log_writer_bus(struct log_writer *writer, const char *name, int channel);
+ *               int log_write_header(struct log_writer *writer, struct msg_buffer *buffer);
+ *               int log_write_message(struct log_writer *writer, struct msg_buffer *buffer, const struct msg_timestamp *timestamp, unsigned long id, int flags, int dlc, int len, const unsigned char *data);
+ *               int log_write_footer(struct log_writer *writer, struct msg_buffer *buffer);
+ *
+ *  includes  :  printmsg.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  Streaming writers for log-files of other tools (no allocation per
+ *  frame):
+ *  - Vector ASC (CAN CC and CAN FD lines, time relative to the first frame)
+ *  - candump log-file format of can-utils ("(sec.usec) ifname id#data",
+ *    "id##<flags>data" for CAN FD frames)
+ *  - PEAK-System TRC version 2.1 (message types DT, RR, FD, FB, FE, BI)
+ *  - JSON Lines (one object per frame), e.g.
+ *    {"bus":"PCAN-USB1","ts":1742220902.123456,"id":291,"xtd":false,
+ *     "rtr":false,"fdf":false,"brs":false,"esi":false,"dlc":2,"data":"0102"}
+ *    (in one line), rendered from constant key fragments and a prefix that
+ *    is made once per writer (w/o a JSON library)
+ *
+ *  The line is formatted in place, straight into the output buffer.  The
+ *  bus of the following frames can be changed (several interfaces in one
+ *  log-file), the counter and the start time are kept.
+ */
+/** @file        logfile.h
+ *
+ *  @brief       Log-file Writers (Vector ASC, candump, PEAK TRC, JSON Lines)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    log_file Log-file Writers (Vector ASC, candump, PEAK TRC, JSON Lines)
+ *  @{
+ */
+#ifndef LOGFILE_H_INCLUDED
+#define LOGFILE_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "printmsg.h"
+
+#include <stdio.h>
+#include <stdint.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define LOG_FORMAT_ASC      (1)     /**< Vector ASC */
+#define LOG_FORMAT_CANDUMP  (2)     /**< candump log-file (can-utils) */
+#define LOG_FORMAT_TRC      (3)     /**< PEAK-System TRC (version 2.1) */
+#define LOG_FORMAT_JSONL    (4)     /**< JSON Lines (one object per frame) */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+/** log-file writer
+ */
+struct log_writer {
+    int format;                     /**< log-file format (LOG_FORMAT_xyz) */
+    int canfd;                      /**< CAN FD channel */
+    char name[32];                  /**< interface name (candump, JSON Lines) */
+    char prefix[96];                /**< start of a JSON object (JSON Lines) */
+    size_t length;                  /**< length of the prefix */
+    int channel;                    /**< channel number (ASC, TRC) */
+    uint64_t counter;               /**< number of written frames */
+    uint64_t start;                 /**< time-stamp of the first frame [usec] */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       initializes a log-file writer.
+ *
+ *  @param[out]  writer   pointer to a log-file writer
+ *  @param[in]   format   log-file format (LOG_FORMAT_xyz)
+ *  @param[in]   canfd    non-zero for a CAN FD channel
+ *  @param[in]   name     interface name (for candump and JSON Lines)
+ *  @param[in]   channel  channel number (for ASC and TRC, 1..n)
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int log_writer_init(struct log_writer *writer, int format, int canfd, const char *name, int channel);
+
+/** @brief       changes the bus of the following frames (interface name
+ *               and channel number, see log_writer_init).
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int log_writer_bus(struct log_writer *writer, const char *name, int channel);
+
+/** @brief       writes the header of the log-file (with the current date).
+ *
+ *  @returns     non-zero value on success, or zero on a write error
+ */
+int log_write_header(struct log_writer *writer, struct msg_buffer *buffer);
+
+/** @brief       writes one CAN message into the log-file.
+ *
+ *  @param[in]   writer     pointer to a log-file writer
+ *  @param[in]   buffer     pointer to an output buffer
+ *  @param[in]   timestamp  time-stamp of the CAN message
+ *  @param[in]   id         CAN identifier
+ *  @param[in]   flags      message flags (MSG_FLAG_xyz)
+ *  @param[in]   dlc        data length code
+ *  @param[in]   len        number of data bytes (0..64)
+ *  @param[in]   data       data bytes
+ *
+ *  @returns     non-zero value on success, or zero on a write error
+ */
+int log_write_message(struct log_writer *writer, struct msg_buffer *buffer, const struct msg_timestamp *timestamp,
+                      unsigned long id, int flags, int dlc, int len, const unsigned char *data);
+
+/** @brief       writes the footer of the log-file (if any).
+ *
+ *  @returns     non-zero value on success, or zero on a write error
+ */
+int log_write_footer(struct log_writer *writer, struct msg_buffer *buffer);
+
+
+#endif /* LOGFILE_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
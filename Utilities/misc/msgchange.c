@@ -0,0 +1,199 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/msgchange.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Detection of Changed CAN Messages (Last Payload per CAN-ID)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  (see header file)
+ *
+ *  includes  :  msgchange.h, printmsg.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ */
+/** @file        msgchange.c
+ *
+ *  @brief       Detection of Changed CAN Messages (Last Payload per CAN-ID)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @addtogroup  msg_changes
+ *  @{
+ */
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "msgchange.h"
+#include "printmsg.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static int lookup(struct msg_changes *chg, unsigned long id, int flags, int *added);
+static int add_entry(struct msg_changes *chg, uint32_t key);
+static uint64_t compare_data(const uint64_t *last, const unsigned char *data, int len);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int chg_init(struct msg_changes *chg)
+{
+    if (!chg)
+        return 0;
+    memset(chg, 0, sizeof(struct msg_changes));
+    return idmap_init(&chg->map, 0);
+}
+
+int chg_check(struct msg_changes *chg, unsigned long id, int flags, int dlc, int len, const unsigned char *data, uint64_t *repeats)
+{
+    struct chg_entry *entry;
+    int index, added = 0;
+
+    if (repeats)
+        *repeats = 0;
+    if (!chg || !chg->map.xtd_keys || !data)
+        return 1;
+    if ((len < 0) || (flags & MSG_FLAG_RTR))
+        len = 0;
+    if (len > 64)
+        len = 64;
+    chg->frames++;
+    /* look up the entry of the CAN-ID (or add one) */
+    if ((index = lookup(chg, id, flags, &added)) < 0)
+        return 1;   /* note: out of memory, the frame is shown */
+    entry = &chg->entries[index];
+    /* compare flags, DLC and data bytes (a word at a time) */
+    if (!added && (entry->flags == (uint8_t)flags) && (entry->dlc == (uint8_t)dlc) &&
+        (entry->len == (uint8_t)len) && !compare_data(entry->data, data, len)) {
+        entry->repeats++;
+        chg->suppressed++;
+        return 0;
+    }
+    /* keep the new payload (zero-padded) */
+    memset(entry->data, 0, sizeof(entry->data));
+    memcpy(entry->data, data, (size_t)len);
+    entry->flags = (uint8_t)flags;
+    entry->dlc = (uint8_t)dlc;
+    entry->len = (uint8_t)len;
+    if (repeats)
+        *repeats = entry->repeats;
+    entry->repeats = 0;
+    return 1;
+}
+
+void chg_exit(struct msg_changes *chg)
+{
+    if (!chg)
+        return;
+    free(chg->entries);
+    idmap_exit(&chg->map);
+    chg->entries = NULL;
+    chg->used = chg->size = 0;
+}
+
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static int lookup(struct msg_changes *chg, unsigned long id, int flags, int *added)
+{
+    uint32_t key = ((uint32_t)id << 1) | ((flags & MSG_FLAG_XTD) ? 1u : 0u);
+    int index;
+
+    if ((index = idmap_find(&chg->map, id, flags & MSG_FLAG_XTD)) >= 0)
+        return index;
+    if ((index = add_entry(chg, key)) < 0)
+        return -1;
+    if (!idmap_set(&chg->map, id, flags & MSG_FLAG_XTD, index)) {
+        chg->used--;    /* note: the entry is dropped again */
+        return -1;
+    }
+    *added = 1;
+    return index;
+}
+
+static int add_entry(struct msg_changes *chg, uint32_t key)
+{
+    struct chg_entry *entries;
+    size_t size;
+
+    if (chg->used >= chg->size) {
+        /* note: the entries are referenced by their number, so they can move */
+        size = chg->size ? chg->size * 2 : 256;
+        if ((entries = (struct chg_entry*)realloc(chg->entries, size * sizeof(struct chg_entry))) == NULL)
+            return -1;
+        chg->entries = entries;
+        chg->size = size;
+    }
+    memset(&chg->entries[chg->used], 0, sizeof(struct chg_entry));
+    chg->entries[chg->used].key = key;
+    return (int)chg->used++;
+}
+
+static uint64_t compare_data(const uint64_t *last, const unsigned char *data, int len)
+{
+    uint64_t diff = 0, word;
+    int i, words = len >> 3;
+
+    /* note: memcpy is a plain (unaligned) load here */
+    if (words == CHG_WORDS) {
+        /* CAN FD with 64 bytes: fixed length, so it is vectorized */
+        for (i = 0; i < CHG_WORDS; i++) {
+            memcpy(&word, &data[i << 3], sizeof(word));
+            diff |= word ^ last[i];
+        }
+        return diff;
+    }
+    for (i = 0; i < words; i++) {
+        memcpy(&word, &data[i << 3], sizeof(word));
+        diff |= word ^ last[i];
+    }
+    if (len & 7) {
+        /* the last word: bytes beyond the length are zero in the stored payload */
+        word = 0;
+        memcpy(&word, &data[i << 3], (size_t)(len & 7));
+        diff |= word ^ last[i];
+    }
+    return diff;
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,130 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/msgchange.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Detection of Changed CAN Messages (Last Payload per CAN-ID)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  int chg_init(struct msg_changes *chg);
+ *               int chg_check(struct msg_changes *chg, unsigned long id, int flags, int dlc, int len, const unsigned char *data, uint64_t *repeats);
+ *               void chg_exit(struct msg_changes *chg);
+ *
+ *  includes  :  idmap.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  The last payload of each CAN-ID (11-bit and 29-bit) is kept, so that
+ *  cyclic frames with an unchanged payload can be suppressed.  A frame is
+ *  a change when it is the first one of its CAN-ID, or when its flags, its
+ *  DLC or its data bytes differ from the last frame of the CAN-ID.
+ *
+ *  The payload is stored zero-padded in 64-bit words and compared a word
+ *  at a time (a CAN CC frame is one word, a CAN FD frame up to eight; the
+ *  full-length loop is vectorized by the compiler).  The entries are kept
+ *  in a dense array and found by their CAN-ID (see idmap.h).
+ */
+/** @file        msgchange.h
+ *
+ *  @brief       Detection of Changed CAN Messages (Last Payload per CAN-ID)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    msg_changes Detection of Changed CAN Messages (Last Payload per CAN-ID)
+ *  @{
+ */
+#ifndef MSGCHANGE_H_INCLUDED
+#define MSGCHANGE_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "idmap.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define CHG_WORDS       (8)         /**< 64 data bytes in 64-bit words */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+/** last payload of a CAN-ID
+ */
+struct chg_entry {
+    uint64_t data[CHG_WORDS];       /**< data bytes (zero-padded) */
+    uint32_t key;                   /**< CAN identifier << 1 | XTD */
+    uint8_t flags;                  /**< message flags (MSG_FLAG_xyz) */
+    uint8_t dlc;                    /**< data length code */
+    uint8_t len;                    /**< number of data bytes */
+    uint8_t reserved;               /**< (alignment) */
+    uint64_t repeats;               /**< suppressed frames since the last change */
+};
+
+/** last payloads of all CAN-IDs
+ */
+struct msg_changes {
+    struct chg_entry *entries;      /**< entries in order of appearance */
+    size_t used;                    /**< number of entries */
+    size_t size;                    /**< number of allocated entries */
+    struct id_map map;              /**< entry of a CAN-ID */
+    uint64_t frames;                /**< number of frames */
+    uint64_t suppressed;            /**< number of suppressed frames */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       initializes the payload table.
+ *
+ *  @param[out]  chg  pointer to the payload table
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int chg_init(struct msg_changes *chg);
+
+/** @brief       compares a CAN message with the last one of its CAN-ID and
+ *               keeps it as the last one.
+ *
+ *  @param[in]   chg      pointer to the payload table
+ *  @param[in]   id       CAN identifier
+ *  @param[in]   flags    message flags (MSG_FLAG_xyz)
+ *  @param[in]   dlc      data length code
+ *  @param[in]   len      number of data bytes (0..64)
+ *  @param[in]   data     data bytes
+ *  @param[out]  repeats  suppressed frames of the CAN-ID before this change (or NULL)
+ *
+ *  @returns     non-zero value when the message is a change (to be shown),
+ *               or zero when it is a repeat (to be suppressed)
+ */
+int chg_check(struct msg_changes *chg, unsigned long id, int flags, int dlc, int len, const unsigned char *data, uint64_t *repeats);
+
+/** @brief       releases the payload table.
+ */
+void chg_exit(struct msg_changes *chg);
+
+
+#endif /* MSGCHANGE_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
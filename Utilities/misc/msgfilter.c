@@ -0,0 +1,662 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/msgfilter.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Filter Expressions for CAN Messages (compiled to Bytecode)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  (see header file)
+ *
+ *  includes  :  msgfilter.h, idset.h, printmsg.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ */
+/** @file        msgfilter.c
+ *
+ *  @brief       Filter Expressions for CAN Messages (compiled to Bytecode)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @addtogroup  msg_filter
+ *  @{
+ */
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "msgfilter.h"
+#include "printmsg.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <errno.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define OP_AND          (1)         /* a && b */
+#define OP_OR           (2)         /* a || b */
+#define OP_NOT          (3)         /* !a */
+#define OP_ID_RANGE     (4)         /* operand <= id <= mask */
+#define OP_ID           (5)         /* (id & mask) <op> value */
+#define OP_FLAGS        (6)         /* (flags & mask) == value */
+#define OP_DLC          (7)         /* dlc <op> value */
+#define OP_LEN          (8)         /* len <op> value */
+#define OP_DATA         (9)         /* (data[first..last] & mask) <op> value */
+#define OP_PATTERN      (10)        /* masked compare of the payload (==, !=) */
+
+#define CMP_EQ          (0)
+#define CMP_NE          (1)
+#define CMP_LT          (2)
+#define CMP_LE          (3)
+#define CMP_GT          (4)
+#define CMP_GE          (5)
+
+#define MAX_BYTES       (64)
+#define MAX_RANGES      (FLT_PROGRAM * 2)   /* ranges of IDs per subexpression */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+/* CAN-IDs of a subexpression (sorted, disjoint ranges) */
+struct id_ranges {
+    uint32_t first[MAX_RANGES];
+    uint32_t last[MAX_RANGES];
+    int count;
+};
+
+/* state of the compiler (recursive descent) */
+struct parser {
+    struct msg_filter *filter;      /* program */
+    const char *text;               /* begin of the expression */
+    const char *ptr;                /* current position */
+    int depth;                      /* stack depth at the current position */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static int parse_expr(struct parser *p);
+static int parse_term(struct parser *p);
+static int parse_factor(struct parser *p);
+static int parse_test(struct parser *p);
+static int parse_compare(struct parser *p, uint8_t *compare);
+static int parse_number(struct parser *p, uint64_t *value);
+static int parse_bytes(struct parser *p, unsigned char *bytes, int width);
+static int accept(struct parser *p, const char *token);
+static int keyword(struct parser *p, const char *word);
+static int emit(struct parser *p, uint8_t opcode, uint8_t compare, uint32_t operand, uint64_t mask, uint64_t value);
+static int compare(uint8_t compare, uint64_t a, uint64_t b);
+static int match_pattern(const struct flt_pattern *pattern, const unsigned char *data);
+static void id_compare(struct id_ranges *ranges, const struct flt_instr *instr);
+static void add_range(struct id_ranges *ranges, uint32_t first, uint32_t last);
+static void join_ranges(struct id_ranges *result, const struct id_ranges *a, const struct id_ranges *b);
+static void meet_ranges(struct id_ranges *result, const struct id_ranges *a, const struct id_ranges *b);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int flt_compile(struct msg_filter *filter, const char *text, size_t *position)
+{
+    struct parser p;
+
+    if (position)
+        *position = 0;
+    if (!filter || !text)
+        return 0;
+    memset(filter, 0, sizeof(struct msg_filter));
+    p.filter = filter;
+    p.text = p.ptr = text;
+    p.depth = 0;
+    /* the expression, then the end of the text */
+    if (!parse_expr(&p) || !accept(&p, "") || (p.depth != 1)) {
+        if (position)
+            *position = (size_t)(p.ptr - p.text);
+        filter->length = 0;
+        return 0;
+    }
+    return 1;
+}
+
+int flt_match(const struct msg_filter *filter, unsigned long id, int flags, int dlc, int len, const unsigned char *data)
+{
+    const struct flt_instr *instr, *end;
+    uint64_t stack = 0, value;
+    int bit, i;
+
+    if (!filter || !filter->length)
+        return 1;
+    if (flags & MSG_FLAG_RTR)
+        len = 0;    /* note: remote frames have no data bytes */
+    /* note: the stack is a word of bits, the top is bit 0 */
+    for (instr = filter->program, end = &filter->program[filter->length]; instr < end; instr++) {
+        switch (instr->opcode) {
+        case OP_AND:
+            bit = (int)(stack & (stack >> 1) & 1u);
+            stack >>= 2;
+            break;
+        case OP_OR:
+            bit = (int)((stack | (stack >> 1)) & 1u);
+            stack >>= 2;
+            break;
+        case OP_NOT:
+            bit = (int)(~stack & 1u);
+            stack >>= 1;
+            break;
+        case OP_ID_RANGE:
+            bit = ((id >= instr->operand) && (id <= instr->mask)) ? 1 : 0;
+            break;
+        case OP_ID:
+            bit = compare(instr->compare, (uint64_t)id & instr->mask, instr->value);
+            break;
+        case OP_FLAGS:
+            bit = (((uint64_t)flags & instr->mask) == instr->value) ? 1 : 0;
+            break;
+        case OP_DLC:
+            bit = compare(instr->compare, (uint64_t)dlc, instr->value);
+            break;
+        case OP_LEN:
+            bit = compare(instr->compare, (uint64_t)len, instr->value);
+            break;
+        case OP_DATA:
+            if (len <= (int)instr->last) {
+                bit = 0;
+                break;
+            }
+            for (value = 0, i = instr->first; i <= instr->last; i++)
+                value = (value << 8) | (uint64_t)data[i];
+            bit = compare(instr->compare, value & instr->mask, instr->value);
+            break;
+        case OP_PATTERN:
+            if (len <= (int)instr->last) {
+                bit = 0;
+                break;
+            }
+            bit = match_pattern(&filter->patterns[instr->operand], data) ^ (instr->compare == CMP_NE);
+            break;
+        default:
+            bit = 0;
+            break;
+        }
+        stack = (stack << 1) | (uint64_t)bit;
+    }
+    return (int)(stack & 1u);
+}
+
+int flt_id_set(const struct msg_filter *filter, struct id_set *set)
+{
+    const struct flt_instr *instr;
+    struct id_ranges *stack, *top;
+    int i, n = 0, rc = 1;
+
+    if (!filter || !set)
+        return 0;
+    if (!filter->length)
+        return idset_add(set, 0ul, IDSET_MAX_ID);
+    /* note: the last entry is a scratch area for AND and OR */
+    if ((stack = (struct id_ranges*)malloc((FLT_STACK + 1) * sizeof(struct id_ranges))) == NULL)
+        return 0;
+    /* the same stack machine, with sets of IDs instead of bits */
+    for (instr = filter->program; instr < &filter->program[filter->length]; instr++) {
+        switch (instr->opcode) {
+        case OP_AND:
+        case OP_OR:
+            n--;
+            if (instr->opcode == OP_AND)
+                meet_ranges(&stack[FLT_STACK], &stack[n - 1], &stack[n]);
+            else
+                join_ranges(&stack[FLT_STACK], &stack[n - 1], &stack[n]);
+            memcpy(&stack[n - 1], &stack[FLT_STACK], sizeof(struct id_ranges));
+            continue;
+        case OP_NOT:
+            /* note: the complement of a superset is not a superset */
+            top = &stack[n - 1];
+            top->count = 0;
+            add_range(top, 0u, (uint32_t)IDSET_MAX_ID);
+            continue;
+        default:
+            top = &stack[n++];
+            top->count = 0;
+            if (instr->opcode == OP_ID_RANGE)
+                add_range(top, instr->operand, (uint32_t)instr->mask);
+            else if (instr->opcode == OP_ID)
+                id_compare(top, instr);
+            else
+                add_range(top, 0u, (uint32_t)IDSET_MAX_ID);
+            continue;
+        }
+    }
+    for (i = 0; rc && (n == 1) && (i < stack[0].count); i++)
+        rc = idset_add(set, stack[0].first[i], stack[0].last[i]);
+    free(stack);
+    return (rc && (n == 1)) ? 1 : 0;
+}
+
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static int parse_expr(struct parser *p)
+{
+    if (!parse_term(p))
+        return 0;
+    while (accept(p, "||") || keyword(p, "OR")) {
+        if (!parse_term(p) || !emit(p, OP_OR, 0, 0, 0, 0))
+            return 0;
+    }
+    return 1;
+}
+
+static int parse_term(struct parser *p)
+{
+    if (!parse_factor(p))
+        return 0;
+    while (accept(p, "&&") || keyword(p, "AND")) {
+        if (!parse_factor(p) || !emit(p, OP_AND, 0, 0, 0, 0))
+            return 0;
+    }
+    return 1;
+}
+
+static int parse_factor(struct parser *p)
+{
+    if (accept(p, "!") || keyword(p, "NOT"))
+        return parse_factor(p) && emit(p, OP_NOT, 0, 0, 0, 0);
+    if (accept(p, "(")) {
+        if (!parse_expr(p))
+            return 0;
+        return accept(p, ")");
+    }
+    return parse_test(p);
+}
+
+static int parse_test(struct parser *p)
+{
+    struct flt_pattern *pattern;
+    unsigned char mask[MAX_BYTES], value[MAX_BYTES];
+    uint64_t first, last, word_mask, word_value;
+    uint8_t cmp = CMP_EQ;
+    int i, n, width;
+
+    if (keyword(p, "ID")) {
+        if (keyword(p, "IN")) {
+            /* ID IN <id>[-<id>]{,<id>[-<id>]} */
+            n = 0;
+            do {
+                if (!parse_number(p, &first))
+                    return 0;
+                last = first;
+                if (accept(p, "-") && !parse_number(p, &last))
+                    return 0;
+                if ((first > last) || (last > 0x1FFFFFFFull))
+                    return 0;
+                if (!emit(p, OP_ID_RANGE, 0, (uint32_t)first, last, 0))
+                    return 0;
+                if (n++ && !emit(p, OP_OR, 0, 0, 0, 0))
+                    return 0;
+            } while (accept(p, ","));
+            return 1;
+        }
+        /* ID [& <mask>] <op> <value> */
+        word_mask = 0x1FFFFFFFull;
+        if (!accept(p, "&&") && accept(p, "&") && !parse_number(p, &word_mask))
+            return 0;
+        if (!parse_compare(p, &cmp) || !parse_number(p, &word_value))
+            return 0;
+        return emit(p, OP_ID, cmp, 0, word_mask, word_value);
+    }
+    if (keyword(p, "DATA")) {
+        /* DATA[<i>[..<j>]] [& <mask>] <op> <value> */
+        if (!accept(p, "[") || !parse_number(p, &first))
+            return 0;
+        last = first;
+        if (accept(p, "..") && !parse_number(p, &last))
+            return 0;
+        if (!accept(p, "]") || (first > last) || (last >= MAX_BYTES))
+            return 0;
+        width = (int)(last - first) + 1;
+        memset(mask, 0xFF, sizeof(mask));
+        if (!accept(p, "&&") && accept(p, "&") && !parse_bytes(p, mask, width))
+            return 0;
+        if (!parse_compare(p, &cmp) || !parse_bytes(p, value, width))
+            return 0;
+        if ((cmp == CMP_EQ) || (cmp == CMP_NE)) {
+            /* masked compare of the payload (16-byte chunks) */
+            if (p->filter->used_patterns >= FLT_PATTERNS)
+                return 0;
+            pattern = &p->filter->patterns[p->filter->used_patterns];
+            memset(pattern, 0, sizeof(struct flt_pattern));
+            for (i = 0; i < width; i++) {
+                ((unsigned char*)pattern->mask)[first + i] = mask[i];
+                ((unsigned char*)pattern->value)[first + i] = value[i] & mask[i];
+            }
+            pattern->chunk = (uint8_t)(first / 16u);
+            pattern->chunks = (uint8_t)((last / 16u) - (first / 16u) + 1u);
+            if (!emit(p, OP_PATTERN, cmp, (uint32_t)p->filter->used_patterns, 0, 0))
+                return 0;
+            p->filter->used_patterns++;
+        }
+        else {
+            /* numeric compare (at most 8 bytes) */
+            if (width > 8)
+                return 0;
+            for (word_mask = word_value = 0, i = 0; i < width; i++) {
+                word_mask = (word_mask << 8) | (uint64_t)mask[i];
+                word_value = (word_value << 8) | (uint64_t)value[i];
+            }
+            if (!emit(p, OP_DATA, cmp, 0, word_mask, word_value))
+                return 0;
+        }
+        p->filter->program[p->filter->length - 1].first = (uint8_t)first;
+        p->filter->program[p->filter->length - 1].last = (uint8_t)last;
+        return 1;
+    }
+    if (keyword(p, "DLC")) {
+        /* DLC <op> <value> */
+        if (!parse_compare(p, &cmp) || !parse_number(p, &word_value))
+            return 0;
+        return emit(p, OP_DLC, cmp, 0, 0, word_value);
+    }
+    if (keyword(p, "LEN")) {
+        /* LEN <op> <value> */
+        if (!parse_compare(p, &cmp) || !parse_number(p, &word_value))
+            return 0;
+        return emit(p, OP_LEN, cmp, 0, 0, word_value);
+    }
+    if (keyword(p, "XTD"))
+        return emit(p, OP_FLAGS, 0, 0, MSG_FLAG_XTD, MSG_FLAG_XTD);
+    if (keyword(p, "STD"))
+        return emit(p, OP_FLAGS, 0, 0, MSG_FLAG_XTD, 0);
+    if (keyword(p, "RTR"))
+        return emit(p, OP_FLAGS, 0, 0, MSG_FLAG_RTR, MSG_FLAG_RTR);
+    if (keyword(p, "FDF"))
+        return emit(p, OP_FLAGS, 0, 0, MSG_FLAG_FDF, MSG_FLAG_FDF);
+    if (keyword(p, "BRS"))
+        return emit(p, OP_FLAGS, 0, 0, MSG_FLAG_BRS, MSG_FLAG_BRS);
+    if (keyword(p, "ESI"))
+        return emit(p, OP_FLAGS, 0, 0, MSG_FLAG_ESI, MSG_FLAG_ESI);
+    return 0;
+}
+
+static int parse_compare(struct parser *p, uint8_t *cmp)
+{
+    /* note: two-character operators first */
+    if (accept(p, "=="))
+        *cmp = CMP_EQ;
+    else if (accept(p, "!="))
+        *cmp = CMP_NE;
+    else if (accept(p, "<="))
+        *cmp = CMP_LE;
+    else if (accept(p, ">="))
+        *cmp = CMP_GE;
+    else if (accept(p, "<"))
+        *cmp = CMP_LT;
+    else if (accept(p, ">"))
+        *cmp = CMP_GT;
+    else
+        return 0;
+    return 1;
+}
+
+static int parse_number(struct parser *p, uint64_t *value)
+{
+    char *end;
+
+    while (isspace((unsigned char)*p->ptr))
+        p->ptr++;
+    if (!isdigit((unsigned char)*p->ptr))
+        return 0;
+    errno = 0;
+    *value = (uint64_t)strtoull(p->ptr, &end, 0);
+    if ((errno != 0) || (end == p->ptr) || isalnum((unsigned char)*end))
+        return 0;
+    p->ptr = end;
+    return 1;
+}
+
+static int parse_bytes(struct parser *p, unsigned char *bytes, int width)
+{
+    const char *digits, *end;
+    uint64_t value;
+    int n, i, nibble;
+
+    while (isspace((unsigned char)*p->ptr))
+        p->ptr++;
+    memset(bytes, 0, (size_t)width);
+    if ((p->ptr[0] == '0') && ((p->ptr[1] == 'x') || (p->ptr[1] == 'X'))) {
+        /* hexadecimal: any number of digits (right-aligned, big-endian) */
+        for (digits = end = &p->ptr[2]; isxdigit((unsigned char)*end); end++);
+        if ((end == digits) || isalnum((unsigned char)*end))
+            return 0;
+        for (n = 0, i = (int)(end - digits) - 1; i >= 0; i--, n++) {
+            nibble = isdigit((unsigned char)digits[i]) ? (digits[i] - '0') : (toupper((unsigned char)digits[i]) - 'A' + 10);
+            if ((n / 2) >= width) {
+                if (nibble)
+                    return 0;   /* the value does not fit into the bytes */
+                continue;
+            }
+            bytes[width - 1 - (n / 2)] |= (unsigned char)(nibble << ((n % 2) * 4));
+        }
+        p->ptr = end;
+        return 1;
+    }
+    /* decimal or octal: at most 64 bits */
+    if (!parse_number(p, &value))
+        return 0;
+    for (i = width - 1; (i >= 0) && value; i--, value >>= 8)
+        bytes[i] = (unsigned char)value;
+    return (value == 0) ? 1 : 0;
+}
+
+static int accept(struct parser *p, const char *token)
+{
+    size_t n = strlen(token);
+
+    while (isspace((unsigned char)*p->ptr))
+        p->ptr++;
+    /* note: the empty token is the end of the text */
+    if (n == 0)
+        return (*p->ptr == '\0') ? 1 : 0;
+    if (strncmp(p->ptr, token, n) != 0)
+        return 0;
+    p->ptr += n;
+    return 1;
+}
+
+static int keyword(struct parser *p, const char *word)
+{
+    size_t n = strlen(word);
+
+    while (isspace((unsigned char)*p->ptr))
+        p->ptr++;
+    if (strncasecmp(p->ptr, word, n) != 0)
+        return 0;
+    if (isalnum((unsigned char)p->ptr[n]) || (p->ptr[n] == '_'))
+        return 0;
+    p->ptr += n;
+    return 1;
+}
+
+static int emit(struct parser *p, uint8_t opcode, uint8_t cmp, uint32_t operand, uint64_t mask, uint64_t value)
+{
+    struct flt_instr *instr;
+
+    if (p->filter->length >= FLT_PROGRAM)
+        return 0;
+    /* a test pushes a bit, AND and OR pop one (NOT replaces it) */
+    if ((opcode == OP_AND) || (opcode == OP_OR))
+        p->depth--;
+    else if (opcode != OP_NOT)
+        p->depth++;
+    if ((p->depth < 1) || (p->depth > FLT_STACK))
+        return 0;
+    instr = &p->filter->program[p->filter->length++];
+    memset(instr, 0, sizeof(struct flt_instr));
+    instr->opcode = opcode;
+    instr->compare = cmp;
+    instr->operand = operand;
+    instr->mask = mask;
+    instr->value = value;
+    return 1;
+}
+
+static int compare(uint8_t cmp, uint64_t a, uint64_t b)
+{
+    switch (cmp) {
+    case CMP_EQ: return (a == b) ? 1 : 0;
+    case CMP_NE: return (a != b) ? 1 : 0;
+    case CMP_LT: return (a < b) ? 1 : 0;
+    case CMP_LE: return (a <= b) ? 1 : 0;
+    case CMP_GT: return (a > b) ? 1 : 0;
+    case CMP_GE: return (a >= b) ? 1 : 0;
+    default: return 0;
+    }
+}
+
+static int match_pattern(const struct flt_pattern *pattern, const unsigned char *data)
+{
+    int w, end = (pattern->chunk + pattern->chunks) * 2;
+    uint64_t diff = 0, word;
+
+    /* (data ^ value) & mask, a word at a time */
+    for (w = pattern->chunk * 2; w < end; w++) {
+        memcpy(&word, &data[w * 8], sizeof(word));
+        diff |= (word ^ pattern->value[w]) & pattern->mask[w];
+    }
+    return (diff == 0) ? 1 : 0;
+}
+
+static void id_compare(struct id_ranges *ranges, const struct flt_instr *instr)
+{
+    const uint64_t max_id = (uint64_t)IDSET_MAX_ID;
+    uint64_t value = instr->value;
+
+    /* note: only a comparison of the whole ID restricts the IDs */
+    if ((instr->mask & max_id) != max_id) {
+        add_range(ranges, 0u, (uint32_t)max_id);
+        return;
+    }
+    switch (instr->compare) {
+    case CMP_EQ:
+        if (value <= max_id)
+            add_range(ranges, (uint32_t)value, (uint32_t)value);
+        break;
+    case CMP_NE:
+        if (value > max_id) {
+            add_range(ranges, 0u, (uint32_t)max_id);
+            break;
+        }
+        if (value > 0u)
+            add_range(ranges, 0u, (uint32_t)value - 1u);
+        if (value < max_id)
+            add_range(ranges, (uint32_t)value + 1u, (uint32_t)max_id);
+        break;
+    case CMP_LT:
+        if (value > 0u)
+            add_range(ranges, 0u, (value <= max_id) ? (uint32_t)value - 1u : (uint32_t)max_id);
+        break;
+    case CMP_LE:
+        add_range(ranges, 0u, (value <= max_id) ? (uint32_t)value : (uint32_t)max_id);
+        break;
+    case CMP_GT:
+        if (value < max_id)
+            add_range(ranges, (uint32_t)value + 1u, (uint32_t)max_id);
+        break;
+    case CMP_GE:
+        if (value <= max_id)
+            add_range(ranges, (uint32_t)value, (uint32_t)max_id);
+        break;
+    default:
+        add_range(ranges, 0u, (uint32_t)max_id);
+        break;
+    }
+}
+
+static void add_range(struct id_ranges *ranges, uint32_t first, uint32_t last)
+{
+    /* note: the ranges are added in ascending order */
+    if (ranges->count && ((uint64_t)first <= (uint64_t)ranges->last[ranges->count - 1] + 1u)) {
+        if (last > ranges->last[ranges->count - 1])
+            ranges->last[ranges->count - 1] = last;
+    }
+    else if (ranges->count < MAX_RANGES) {
+        ranges->first[ranges->count] = first;
+        ranges->last[ranges->count] = last;
+        ranges->count++;
+    }
+    else {
+        /* note: out of space, the superset gets bigger */
+        if (last > ranges->last[ranges->count - 1])
+            ranges->last[ranges->count - 1] = last;
+    }
+}
+
+static void join_ranges(struct id_ranges *result, const struct id_ranges *a, const struct id_ranges *b)
+{
+    int i = 0, j = 0;
+
+    /* union (merged by the first ID) */
+    result->count = 0;
+    while ((i < a->count) || (j < b->count)) {
+        if ((j >= b->count) || ((i < a->count) && (a->first[i] <= b->first[j]))) {
+            add_range(result, a->first[i], a->last[i]);
+            i++;
+        }
+        else {
+            add_range(result, b->first[j], b->last[j]);
+            j++;
+        }
+    }
+}
+
+static void meet_ranges(struct id_ranges *result, const struct id_ranges *a, const struct id_ranges *b)
+{
+    uint32_t first, last;
+    int i = 0, j = 0;
+
+    /* intersection (the range that ends first is done) */
+    result->count = 0;
+    while ((i < a->count) && (j < b->count)) {
+        first = (a->first[i] > b->first[j]) ? a->first[i] : b->first[j];
+        last = (a->last[i] < b->last[j]) ? a->last[i] : b->last[j];
+        if (first <= last)
+            add_range(result, first, last);
+        if (a->last[i] < b->last[j])
+            i++;
+        else
+            j++;
+    }
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
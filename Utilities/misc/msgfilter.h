@@ -0,0 +1,165 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/msgfilter.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Filter Expressions for CAN Messages (compiled to Bytecode)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  int flt_compile(struct msg_filter *filter, const char *text, size_t *position);
+ *               int flt_match(const struct msg_filter *filter, unsigned long id, int flags, int dlc, int len, const unsigned char *data);
+ *               int flt_id_set(const struct msg_filter *filter, struct id_set *set);
+ *
+ *  includes  :  idset.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  A filter expression is compiled into a short program for a stack
+ *  machine of bits (postfix order), which is run once per frame:
+ *
+ *    <expr>   := <term> { (OR | ||) <term> }
+ *    <term>   := <factor> { (AND | &&) <factor> }
+ *    <factor> := (NOT | !) <factor> | '(' <expr> ')' | <test>
+ *    <test>   := ID IN <id>[-<id>]{,<id>[-<id>]}
+ *              | ID [& <mask>] <op> <value>
+ *              | DATA[<i>[..<j>]] [& <mask>] <op> <value>
+ *              | DLC <op> <value> | LEN <op> <value>
+ *              | XTD | STD | RTR | FDF | BRS | ESI
+ *    <op>     := == | != | < | <= | > | >=
+ *
+ *  Keywords are not case sensitive, numbers are decimal, octal (0) or
+ *  hexadecimal (0x).  DATA[i..j] is the value of the data bytes i to j
+ *  (0..63, the first one is the most significant byte).  A comparison
+ *  with == or != is a masked compare of the payload (any number of
+ *  bytes, a hexadecimal value can be longer than 64 bits), which is run
+ *  over 8 bytes at a time.  Other comparisons are
+ *  limited to 8 bytes.  A test of data bytes is false for frames that
+ *  are too short (and for remote frames).
+ *
+ *  Example: ID IN 0x18FF0000-0x18FFFFFF && DATA[2..3] & 0xF0F0 == 0x1020 && FDF
+ *
+ *  The CAN-IDs a frame can have to pass the filter (ID IN and comparisons
+ *  of the whole ID, combined by AND and OR) can be put into a set of IDs,
+ *  e.g. to derive the acceptance filter of the CAN controller.
+ */
+/** @file        msgfilter.h
+ *
+ *  @brief       Filter Expressions for CAN Messages (compiled to Bytecode)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    msg_filter Filter Expressions for CAN Messages (compiled to Bytecode)
+ *  @{
+ */
+#ifndef MSGFILTER_H_INCLUDED
+#define MSGFILTER_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "idset.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define FLT_PROGRAM     (128)       /**< max. number of instructions */
+#define FLT_PATTERNS    (16)        /**< max. number of payload patterns */
+#define FLT_STACK       (64)        /**< depth of the stack (bits) */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+/** instruction of a filter program
+ */
+struct flt_instr {
+    uint8_t opcode;                 /**< operation (test or AND, OR, NOT) */
+    uint8_t compare;                /**< comparison (==, !=, <, <=, >, >=) */
+    uint8_t first;                  /**< first data byte */
+    uint8_t last;                   /**< last data byte */
+    uint32_t operand;               /**< first ID of a range, resp. number of a pattern */
+    uint64_t mask;                  /**< mask (or last ID of a range) */
+    uint64_t value;                 /**< value to be compared */
+};
+
+/** payload pattern for a masked compare (64 bytes)
+ */
+struct flt_pattern {
+    uint64_t mask[8];               /**< mask of the data bytes */
+    uint64_t value[8];              /**< value of the data bytes (masked) */
+    uint8_t chunk;                  /**< first 16-byte chunk */
+    uint8_t chunks;                 /**< number of 16-byte chunks */
+};
+
+/** compiled filter expression
+ */
+struct msg_filter {
+    struct flt_instr program[FLT_PROGRAM]; /**< instructions in postfix order */
+    int length;                     /**< number of instructions */
+    struct flt_pattern patterns[FLT_PATTERNS]; /**< payload patterns */
+    int used_patterns;              /**< number of payload patterns */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       compiles a filter expression.
+ *
+ *  @param[out]  filter    pointer to the compiled filter
+ *  @param[in]   text      filter expression
+ *  @param[out]  position  position of a syntax error in the text (or NULL)
+ *
+ *  @returns     non-zero value on success, or zero on a syntax error
+ */
+int flt_compile(struct msg_filter *filter, const char *text, size_t *position);
+
+/** @brief       runs a filter on a CAN message.
+ *
+ *  @param[in]   filter  pointer to the compiled filter
+ *  @param[in]   id      CAN identifier
+ *  @param[in]   flags   message flags (MSG_FLAG_xyz)
+ *  @param[in]   dlc     data length code
+ *  @param[in]   len     number of data bytes (0..64)
+ *  @param[in]   data    data bytes (a buffer of 64 bytes, also for CAN CC)
+ *
+ *  @returns     non-zero value if the message passes the filter, or zero
+ *               otherwise
+ */
+int flt_match(const struct msg_filter *filter, unsigned long id, int flags, int dlc, int len, const unsigned char *data);
+
+/** @brief       adds the CAN-IDs that can pass a filter to a set.
+ *
+ *  @remarks     The set is a superset of the IDs that pass the filter, since
+ *               tests other than of the ID are assumed to be true.
+ *
+ *  @param[in]   filter  pointer to the compiled filter
+ *  @param[in]   set     pointer to the set (to be built afterwards)
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int flt_id_set(const struct msg_filter *filter, struct id_set *set);
+
+
+#endif /* MSGFILTER_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
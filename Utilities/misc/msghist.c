@@ -0,0 +1,328 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/msghist.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Histograms of Inter-Arrival Times (HDR, per CAN-ID and Bus)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Microsoft Visual C/C++ Compiler
+ *               Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  (see header file)
+ *
+ *  includes  :  msghist.h, printmsg.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ */
+/** @file        msghist.c
+ *
+ *  @brief       Histograms of Inter-Arrival Times (HDR, per CAN-ID and Bus)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @addtogroup  msg_hist
+ *  @{
+ */
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "msghist.h"
+#include "printmsg.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define SUB_BUCKETS     (1u << HDR_SUB_BITS)        /* 32 */
+#define LINEAR_MAX      (2u * SUB_BUCKETS)          /* values below have a bucket each */
+#define VALUE_MAX       (0xFFFFFFFFull)             /* values are clamped to 71 minutes */
+
+#define PERCENTILES     (4)
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static int bucket_of(uint32_t value);
+static uint64_t upper_bound(int bucket);
+static int lookup(struct msg_hist *hist, unsigned long id, int flags);
+static void sort_histograms(struct msg_hist *hist);
+static int compare_keys(const void *a, const void *b);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+static const double percentiles[PERCENTILES] = {
+    50.0, 90.0, 99.0, 99.9
+};
+
+static const struct hist_entry *sort_entries;  /* note: for qsort (the report is not re-entrant) */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int hist_init(struct msg_hist *hist)
+{
+    if (!hist)
+        return 0;
+    memset(hist, 0, sizeof(struct msg_hist));
+    hist->bus.min = (uint32_t)VALUE_MAX;
+    /* note: the pages of the pool are mapped on first use */
+    hist->entries = (struct hist_entry*)calloc(HDR_IDS, sizeof(struct hist_entry));
+    hist->order = (size_t*)calloc(HDR_IDS, sizeof(size_t));
+    if (!hist->entries || !hist->order || !idmap_init(&hist->map, HDR_IDS)) {
+        hist_exit(hist);
+        return 0;
+    }
+    return 1;
+}
+
+void hist_update(struct msg_hist *hist, uint64_t timestamp, unsigned long id, int flags)
+{
+    struct hist_entry *entry;
+    int index;
+
+    if (!hist || !hist->entries)
+        return;
+    /* the bus: time since the last frame */
+    if (hist->frames++)
+        hdr_record(&hist->bus, (timestamp > hist->last) ? (timestamp - hist->last) : 0u);
+    hist->last = timestamp;
+    /* the CAN-ID: time since its last frame */
+    if ((index = lookup(hist, id, flags)) < 0) {
+        hist->dropped++;
+        return;
+    }
+    entry = &hist->entries[index];
+    if (entry->seen)
+        hdr_record(&entry->histogram, (timestamp > entry->last) ? (timestamp - entry->last) : 0u);
+    entry->last = timestamp;
+    entry->seen = 1u;
+}
+
+void hdr_record(struct hdr_histogram *histogram, uint64_t value)
+{
+    uint32_t clamped = (value < VALUE_MAX) ? (uint32_t)value : (uint32_t)VALUE_MAX;
+
+    if (!histogram)
+        return;
+    histogram->counts[bucket_of(clamped)]++;
+    if (!histogram->count++ || (clamped < histogram->min))
+        histogram->min = clamped;
+    if (clamped > histogram->max)
+        histogram->max = clamped;
+}
+
+uint64_t hdr_percentile(const struct hdr_histogram *histogram, double percentile)
+{
+    uint64_t target, total = 0;
+    uint64_t value;
+    int i;
+
+    if (!histogram || !histogram->count)
+        return 0;
+    if (percentile >= 100.0)
+        return histogram->max;
+    target = (uint64_t)((percentile / 100.0) * (double)histogram->count + 0.5);
+    if (target < 1)
+        target = 1;
+    for (i = 0; i < HDR_BUCKETS; i++) {
+        total += histogram->counts[i];
+        if (total >= target)
+            break;
+    }
+    value = upper_bound(i);
+    return (value < histogram->max) ? value : histogram->max;
+}
+
+int hist_report(struct msg_hist *hist, FILE *stream, int mode_id)
+{
+    const struct hist_entry *entry;
+    size_t i;
+    int p;
+
+    if (!hist || !stream || !hist->entries)
+        return 0;
+    fprintf(stream, "Inter-arrival times: %" PRIu64 " frame(s), %zu CAN-ID(s)", hist->frames, hist->used);
+    if (hist->dropped)
+        fprintf(stream, ", %" PRIu64 " frame(s) of further CAN-IDs on the bus only", hist->dropped);
+    fprintf(stream, "\n");
+    fprintf(stream, "  CAN-ID        Count    p50 [ms]   p90 [ms]   p99 [ms]  p99.9 [ms]   Max [ms]\n");
+    fprintf(stream, "  %-9s%10" PRIu64, "(bus)", hist->bus.count);
+    for (p = 0; p < PERCENTILES; p++)
+        fprintf(stream, "  %9.3f", (double)hdr_percentile(&hist->bus, percentiles[p]) / 1000.0);
+    fprintf(stream, "  %9.3f\n", (double)hist->bus.max / 1000.0);
+    sort_histograms(hist);
+    for (i = 0; i < hist->used; i++) {
+        entry = &hist->entries[hist->order[i]];
+        switch (mode_id) {
+        case MSG_MODE_DEC:
+            fprintf(stream, "  %-9lu", (unsigned long)(entry->key >> 1));
+            break;
+        case MSG_MODE_OCT:
+            fprintf(stream, "  \\%-8lo", (unsigned long)(entry->key >> 1));
+            break;
+        case MSG_MODE_HEX:
+        default:
+            fprintf(stream, (entry->key & 1u) ? "  %08lXx" : "  %03lX      ", (unsigned long)(entry->key >> 1));
+            break;
+        }
+        fprintf(stream, "%10" PRIu64, entry->histogram.count);
+        if (entry->histogram.count) {
+            for (p = 0; p < PERCENTILES; p++)
+                fprintf(stream, "  %9.3f", (double)hdr_percentile(&entry->histogram, percentiles[p]) / 1000.0);
+            fprintf(stream, "  %9.3f\n", (double)entry->histogram.max / 1000.0);
+        }
+        else
+            fprintf(stream, "  %9s  %9s  %9s  %9s  %9s\n", "-", "-", "-", "-", "-");
+    }
+    return (fflush(stream) == 0) ? 1 : 0;
+}
+
+int hist_export(struct msg_hist *hist, FILE *stream)
+{
+    const struct hdr_histogram *histogram;
+    const struct hist_entry *entry;
+    size_t i;
+    int p;
+
+    if (!hist || !stream || !hist->entries)
+        return 0;
+    fprintf(stream, "id,xtd,count,min_us,p50_us,p90_us,p99_us,p99.9_us,max_us\n");
+    sort_histograms(hist);
+    for (i = 0; i <= hist->used; i++) {
+        /* note: the first line is the bus */
+        if (i == 0) {
+            histogram = &hist->bus;
+            fprintf(stream, "bus,,%" PRIu64, histogram->count);
+        }
+        else {
+            entry = &hist->entries[hist->order[i - 1]];
+            histogram = &entry->histogram;
+            fprintf(stream, "0x%0*lX,%u,%" PRIu64, (entry->key & 1u) ? 8 : 3,
+                    (unsigned long)(entry->key >> 1), (unsigned)(entry->key & 1u), histogram->count);
+        }
+        if (histogram->count) {
+            fprintf(stream, ",%" PRIu32, histogram->min);
+            for (p = 0; p < PERCENTILES; p++)
+                fprintf(stream, ",%" PRIu64, hdr_percentile(histogram, percentiles[p]));
+            fprintf(stream, ",%" PRIu32 "\n", histogram->max);
+        }
+        else
+            fprintf(stream, ",,,,,,\n");
+    }
+    return (fflush(stream) == 0) ? 1 : 0;
+}
+
+void hist_exit(struct msg_hist *hist)
+{
+    if (!hist)
+        return;
+    free(hist->entries);
+    free(hist->order);
+    idmap_exit(&hist->map);
+    hist->entries = NULL;
+    hist->order = NULL;
+    hist->used = 0;
+}
+
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static int bucket_of(uint32_t value)
+{
+    int magnitude;
+
+    if (value < LINEAR_MAX)
+        return (int)value;
+    /* position of the highest bit (6..31), then the next 5 bits */
+#if defined(__GNUC__) || defined(__clang__)
+    magnitude = 31 - __builtin_clz(value);
+#else
+    for (magnitude = 31; !(value & (1u << magnitude)); magnitude--);
+#endif
+    return (int)LINEAR_MAX + ((magnitude - (HDR_SUB_BITS + 1)) * (int)SUB_BUCKETS) +
+           (int)((value >> (magnitude - HDR_SUB_BITS)) - SUB_BUCKETS);
+}
+
+static uint64_t upper_bound(int bucket)
+{
+    int magnitude, sub;
+
+    if (bucket < (int)LINEAR_MAX)
+        return (uint64_t)bucket;
+    magnitude = ((bucket - (int)LINEAR_MAX) / (int)SUB_BUCKETS) + (HDR_SUB_BITS + 1);
+    sub = ((bucket - (int)LINEAR_MAX) % (int)SUB_BUCKETS) + (int)SUB_BUCKETS;
+    return ((uint64_t)(sub + 1) << (magnitude - HDR_SUB_BITS)) - 1u;
+}
+
+static int lookup(struct msg_hist *hist, unsigned long id, int flags)
+{
+    uint32_t key = ((uint32_t)id << 1) | ((flags & MSG_FLAG_XTD) ? 1u : 0u);
+    int index;
+
+    if ((index = idmap_find(&hist->map, id, flags & MSG_FLAG_XTD)) >= 0)
+        return index;
+    if (hist->used >= HDR_IDS)
+        return -1;
+    index = (int)hist->used++;
+    hist->entries[index].key = key;
+    /* note: the map is sized for the pool, so it does not grow here */
+    (void)idmap_set(&hist->map, id, flags & MSG_FLAG_XTD, index);
+    return index;
+}
+
+static void sort_histograms(struct msg_hist *hist)
+{
+    size_t i;
+
+    for (i = 0; i < hist->used; i++)
+        hist->order[i] = i;
+    sort_entries = hist->entries;
+    qsort(hist->order, hist->used, sizeof(size_t), compare_keys);
+}
+
+static int compare_keys(const void *a, const void *b)
+{
+    uint32_t ka = sort_entries[*(const size_t*)a].key;
+    uint32_t kb = sort_entries[*(const size_t*)b].key;
+
+    /* 11-bit IDs first, then 29-bit IDs */
+    if ((ka & 1u) != (kb & 1u))
+        return (ka & 1u) ? 1 : -1;
+    return (ka < kb) ? -1 : (ka > kb) ? 1 : 0;
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,176 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/msghist.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Histograms of Inter-Arrival Times (HDR, per CAN-ID and Bus)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Microsoft Visual C/C++ Compiler
+ *               Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  int hist_init(struct msg_hist *hist);
+ *               void hist_update(struct msg_hist *hist, uint64_t timestamp, unsigned long id, int flags);
+ *               void hdr_record(struct hdr_histogram *histogram, uint64_t value);
+ *               uint64_t hdr_percentile(const struct hdr_histogram *histogram, double percentile);
+ *               int hist_report(struct msg_hist *hist, FILE *stream, int mode_id);
+ *               int hist_export(struct msg_hist *hist, FILE *stream);
+ *               void hist_exit(struct msg_hist *hist);
+ *
+ *  includes  :  idmap.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  Histograms of the time between two frames of the same CAN-ID, and
+ *  between two frames on the bus, taken from the time-stamps of the
+ *  frames.  The histograms have a fixed number of buckets in the layout
+ *  of a HDR histogram: values below 64 usec have a bucket each, above
+ *  each power of two is divided into 32 buckets, so the relative error
+ *  is at most 1/32 from 1 usec to 71 minutes (3.5 kB per histogram).
+ *
+ *  All memory is allocated by hist_init: a pool of HDR_IDS histograms
+ *  and the map of the CAN-IDs, which is sized for the pool (see idmap.h).
+ *  So recording a frame is a lookup and an increment, and
+ *  never allocates.  Frames of CAN-IDs beyond the pool are counted in
+ *  the bus histogram only.
+ */
+/** @file        msghist.h
+ *
+ *  @brief       Histograms of Inter-Arrival Times (HDR, per CAN-ID and Bus)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    msg_hist Histograms of Inter-Arrival Times (HDR, per CAN-ID and Bus)
+ *  @{
+ */
+#ifndef MSGHIST_H_INCLUDED
+#define MSGHIST_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "idmap.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define HDR_SUB_BITS    (5)         /**< 32 buckets per power of two */
+#define HDR_BUCKETS     (64 + (26 * 32)) /**< buckets for 0..2^32-1 usec */
+
+#define HDR_IDS         (2048)      /**< size of the pool of histograms (CAN-IDs) */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+/** HDR histogram (constant memory)
+ */
+struct hdr_histogram {
+    uint64_t count;                 /**< number of values */
+    uint32_t min;                   /**< smallest value */
+    uint32_t max;                   /**< largest value */
+    uint32_t counts[HDR_BUCKETS];   /**< number of values per bucket */
+};
+
+/** histogram of a CAN-ID
+ */
+struct hist_entry {
+    uint32_t key;                   /**< CAN identifier << 1 | XTD */
+    uint32_t seen;                  /**< a frame has been received */
+    uint64_t last;                  /**< time-stamp of the last frame [usec] */
+    struct hdr_histogram histogram; /**< inter-arrival times [usec] */
+};
+
+/** histograms of inter-arrival times (per CAN-ID and for the bus)
+ */
+struct msg_hist {
+    struct hdr_histogram bus;       /**< inter-arrival times on the bus [usec] */
+    uint64_t last;                  /**< time-stamp of the last frame [usec] */
+    uint64_t frames;                /**< number of frames */
+    uint64_t dropped;               /**< frames of CAN-IDs beyond the pool */
+    struct hist_entry *entries;     /**< pool of histograms (HDR_IDS) */
+    size_t used;                    /**< number of used histograms */
+    struct id_map map;              /**< histogram of a CAN-ID */
+    size_t *order;                  /**< histograms sorted by CAN-ID (report) */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       initializes the histograms (allocates the pool).
+ *
+ *  @param[out]  hist  pointer to the histograms
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int hist_init(struct msg_hist *hist);
+
+/** @brief       records the inter-arrival times of a CAN message (no
+ *               allocation).
+ *
+ *  @param[in]   hist       pointer to the histograms
+ *  @param[in]   timestamp  time-stamp of the CAN message [usec]
+ *  @param[in]   id         CAN identifier
+ *  @param[in]   flags      message flags (MSG_FLAG_xyz)
+ */
+void hist_update(struct msg_hist *hist, uint64_t timestamp, unsigned long id, int flags);
+
+/** @brief       records a value in a histogram.
+ */
+void hdr_record(struct hdr_histogram *histogram, uint64_t value);
+
+/** @brief       returns the value at a percentile (the upper bound of its
+ *               bucket, at most the largest value).
+ *
+ *  @param[in]   histogram   pointer to a histogram
+ *  @param[in]   percentile  percentile (0.0..100.0)
+ *
+ *  @returns     value at the percentile, or 0 if the histogram is empty
+ */
+uint64_t hdr_percentile(const struct hdr_histogram *histogram, double percentile);
+
+/** @brief       writes the percentiles p50, p90, p99, p99.9 and the maximum
+ *               of the bus and of all CAN-IDs (sorted by CAN-ID).
+ *
+ *  @param[in]   hist     pointer to the histograms
+ *  @param[in]   stream   output stream
+ *  @param[in]   mode_id  identifier: HEX, DEC or OCT
+ *
+ *  @returns     non-zero value on success, or zero on a write error
+ */
+int hist_report(struct msg_hist *hist, FILE *stream, int mode_id);
+
+/** @brief       writes the percentiles as CSV (one line for the bus and one
+ *               per CAN-ID, times in usec).
+ *
+ *  @returns     non-zero value on success, or zero on a write error
+ */
+int hist_export(struct msg_hist *hist, FILE *stream);
+
+/** @brief       releases the histograms.
+ */
+void hist_exit(struct msg_hist *hist);
+
+
+#endif /* MSGHIST_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,221 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/msgmerge.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Merge of CAN Message Streams (Ordered by Time-stamp)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  (see header file)
+ *
+ *  includes  :  msgmerge.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ */
+/** @file        msgmerge.c
+ *
+ *  @brief       Merge of CAN Message Streams (Ordered by Time-stamp)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @addtogroup  msg_merge
+ *  @{
+ */
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "msgmerge.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define OLDER(a, b)  (((a)->key < (b)->key) || (((a)->key == (b)->key) && ((a)->seq < (b)->seq)))
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static void sift_up(struct mrg_entry *heap, size_t index);
+static void sift_down(struct mrg_entry *heap, size_t count, size_t index);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int mrg_init(struct msg_merge *mrg, int ways, size_t size, size_t depth, uint64_t window)
+{
+    size_t i;
+
+    if (!mrg || (ways < 1) || (ways > MRG_WAYS_MAX) || !size || !depth || (depth > UINT32_MAX) ||
+        (depth > (SIZE_MAX / size)))
+        return 0;
+    memset(mrg, 0, sizeof(struct msg_merge));
+    mrg->items = (unsigned char*)malloc(depth * size);
+    mrg->heap = (struct mrg_entry*)malloc(depth * sizeof(struct mrg_entry));
+    mrg->slots = (uint32_t*)malloc(depth * sizeof(uint32_t));
+    if (!mrg->items || !mrg->heap || !mrg->slots) {
+        mrg_exit(mrg);
+        return 0;
+    }
+    for (i = 0; i < depth; i++)
+        mrg->slots[i] = (uint32_t)(depth - 1 - i);
+    mrg->avail = depth;
+    mrg->size = size;
+    mrg->depth = depth;
+    mrg->ways = ways;
+    mrg->window = window;
+    return 1;
+}
+
+int mrg_push(struct msg_merge *mrg, int way, const void *frame, uint64_t key, uint64_t now)
+{
+    struct mrg_entry *entry;
+
+    if (!mrg || !mrg->items || !mrg->avail || (way < 0) || (way >= mrg->ways))
+        return 0;
+    entry = &mrg->heap[mrg->count];
+    entry->key = key;
+    entry->seq = mrg->seq++;
+    entry->since = now;
+    entry->slot = mrg->slots[--mrg->avail];
+    entry->way = (uint32_t)way;
+    memcpy(&mrg->items[(size_t)entry->slot * mrg->size], frame, mrg->size);
+    sift_up(mrg->heap, mrg->count++);
+    if (key > mrg->newest[way])
+        mrg->newest[way] = key;
+    return 1;
+}
+
+void mrg_close(struct msg_merge *mrg, int way)
+{
+    if (!mrg || (way < 0) || (way >= mrg->ways))
+        return;
+    mrg->closed[way] = 1;
+}
+
+int mrg_pop(struct msg_merge *mrg, void *frame, uint64_t now)
+{
+    struct mrg_entry *oldest;
+    int way;
+
+    if (!mrg || !mrg->count)
+        return 0;
+    oldest = &mrg->heap[0];
+    /* note: after the reorder window the frame is handed out in any case */
+    if ((now - oldest->since) < mrg->window) {
+        for (way = 0; way < mrg->ways; way++) {
+            if ((way != (int)oldest->way) && !mrg->closed[way] && (mrg->newest[way] < oldest->key))
+                break;
+        }
+        if (way < mrg->ways) {
+            /* an older frame might come, but there is no room to wait for it */
+            if (mrg->count < mrg->depth)
+                return 0;
+            mrg->forced++;
+        }
+    }
+    memcpy(frame, &mrg->items[(size_t)oldest->slot * mrg->size], mrg->size);
+    if (oldest->key < mrg->last)
+        mrg->late++;
+    else
+        mrg->last = oldest->key;
+    mrg->merged++;
+    /* the slot is free again, the last entry replaces the oldest one */
+    mrg->slots[mrg->avail++] = oldest->slot;
+    if (--mrg->count > 0) {
+        mrg->heap[0] = mrg->heap[mrg->count];
+        sift_down(mrg->heap, mrg->count, 0);
+    }
+    return 1;
+}
+
+uint64_t mrg_due(const struct msg_merge *mrg)
+{
+    if (!mrg || !mrg->count)
+        return 0;
+    /* note: the oldest frame is the first to be handed out */
+    return mrg->heap[0].since + mrg->window;
+}
+
+void mrg_exit(struct msg_merge *mrg)
+{
+    if (!mrg)
+        return;
+    free(mrg->items);
+    free(mrg->heap);
+    free(mrg->slots);
+    mrg->items = NULL;
+    mrg->heap = NULL;
+    mrg->slots = NULL;
+    mrg->count = 0;
+    mrg->avail = 0;
+}
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static void sift_up(struct mrg_entry *heap, size_t index)
+{
+    struct mrg_entry entry = heap[index];
+    size_t parent;
+
+    while (index > 0) {
+        parent = (index - 1) / 2;
+        if (!OLDER(&entry, &heap[parent]))
+            break;
+        heap[index] = heap[parent];
+        index = parent;
+    }
+    heap[index] = entry;
+}
+
+static void sift_down(struct mrg_entry *heap, size_t count, size_t index)
+{
+    struct mrg_entry entry = heap[index];
+    size_t child;
+
+    while ((child = (2 * index) + 1) < count) {
+        if ((child + 1 < count) && OLDER(&heap[child + 1], &heap[child]))
+            child++;
+        if (!OLDER(&heap[child], &entry))
+            break;
+        heap[index] = heap[child];
+        index = child;
+    }
+    heap[index] = entry;
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
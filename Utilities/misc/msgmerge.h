@@ -0,0 +1,167 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/msgmerge.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Merge of CAN Message Streams (Ordered by Time-stamp)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  int mrg_init(struct msg_merge *mrg, int ways, size_t size, size_t depth, uint64_t window);
+ *               int mrg_push(struct msg_merge *mrg, int way, const void *frame, uint64_t key, uint64_t now);
+ *               void mrg_close(struct msg_merge *mrg, int way);
+ *               int mrg_pop(struct msg_merge *mrg, void *frame, uint64_t now);
+ *               uint64_t mrg_due(const struct msg_merge *mrg);
+ *               void mrg_exit(struct msg_merge *mrg);
+ *
+ *  includes  :  <stdint.h>, <stddef.h>
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  The frames of several streams (ways, e.g. CAN channels) are merged into
+ *  one stream, ordered by their time-stamps (keys).  The frames of each way
+ *  are pushed in the order of their arrival into a preallocated reorder
+ *  buffer, which is a binary heap (k-way merge).  The oldest frame of the
+ *  buffer is handed out when no way can deliver an older one anymore:
+ *  - each other way has already delivered a frame with a time-stamp not
+ *    older than this frame (the frames of a way are in order), or it is
+ *    closed; or
+ *  - the frame has been in the buffer for the reorder window (a way is
+ *    idle or its frames are late); or
+ *  - the reorder buffer is full.
+ *
+ *  So the output is ordered as long as the latency of the streams does not
+ *  exceed the reorder window.  A frame which is older than the frame handed
+ *  out before is handed out at once (counted as late).  The arrival time
+ *  (now) is given by the caller, e.g. once per round over all ways.
+ */
+/** @file        msgmerge.h
+ *
+ *  @brief       Merge of CAN Message Streams (Ordered by Time-stamp)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    msg_merge Merge of CAN Message Streams (Ordered by Time-stamp)
+ *  @{
+ */
+#ifndef MSGMERGE_H_INCLUDED
+#define MSGMERGE_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define MRG_WAYS_MAX    (64)        /**< max. number of streams */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+/** frame in the reorder buffer (heap entry)
+ */
+struct mrg_entry {
+    uint64_t key;                   /**< time-stamp of the frame */
+    uint64_t seq;                   /**< arrival order (equal time-stamps) */
+    uint64_t since;                 /**< arrival time */
+    uint32_t slot;                  /**< slot of the frame */
+    uint32_t way;                   /**< stream of the frame */
+};
+
+/** merge of several streams
+ */
+struct msg_merge {
+    unsigned char *items;           /**< slots of the frames (preallocated) */
+    size_t size;                    /**< size of a frame (in byte) */
+    size_t depth;                   /**< number of slots (reorder buffer) */
+    struct mrg_entry *heap;         /**< heap of the frames (oldest first) */
+    size_t count;                   /**< number of frames in the heap */
+    uint32_t *slots;                /**< stack of the free slots */
+    size_t avail;                   /**< number of free slots */
+    int ways;                       /**< number of streams */
+    uint64_t newest[MRG_WAYS_MAX];  /**< newest time-stamp per stream */
+    int closed[MRG_WAYS_MAX];       /**< stream is closed */
+    uint64_t window;                /**< reorder window (unit of now) */
+    uint64_t seq;                   /**< number of frames pushed */
+    uint64_t last;                  /**< time-stamp of the last frame handed out */
+    uint64_t merged;                /**< number of frames handed out */
+    uint64_t late;                  /**< number of frames handed out out of order */
+    uint64_t forced;                /**< number of frames handed out when full */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       initializes a merge of several streams.
+ *
+ *  @param[out]  mrg     pointer to the merge
+ *  @param[in]   ways    number of streams (1..MRG_WAYS_MAX)
+ *  @param[in]   size    size of a frame (in byte)
+ *  @param[in]   depth   number of frames in the reorder buffer
+ *  @param[in]   window  reorder window (in the unit of the arrival time)
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int mrg_init(struct msg_merge *mrg, int ways, size_t size, size_t depth, uint64_t window);
+
+/** @brief       pushes a frame of a stream into the reorder buffer.
+ *
+ *  @param[in]   mrg    pointer to the merge
+ *  @param[in]   way    stream of the frame (0..ways-1)
+ *  @param[in]   frame  pointer to the frame (copied)
+ *  @param[in]   key    time-stamp of the frame
+ *  @param[in]   now    arrival time (monotonic)
+ *
+ *  @returns     non-zero value on success, or zero if the buffer is full
+ */
+int mrg_push(struct msg_merge *mrg, int way, const void *frame, uint64_t key, uint64_t now);
+
+/** @brief       closes a stream (no more frames will be pushed).
+ */
+void mrg_close(struct msg_merge *mrg, int way);
+
+/** @brief       hands out the oldest frame, if no older one can come.
+ *
+ *  @param[in]   mrg    pointer to the merge
+ *  @param[out]  frame  buffer for the frame
+ *  @param[in]   now    current time (monotonic)
+ *
+ *  @returns     non-zero value if a frame is handed out, or zero otherwise
+ */
+int mrg_pop(struct msg_merge *mrg, void *frame, uint64_t now);
+
+/** @brief       returns the time when the oldest frame is handed out at the
+ *               latest (end of its reorder window), e.g. for a time-out.
+ *
+ *  @returns     arrival time plus reorder window, or zero when empty
+ */
+uint64_t mrg_due(const struct msg_merge *mrg);
+
+/** @brief       releases the merge.
+ */
+void mrg_exit(struct msg_merge *mrg);
+
+
+#endif /* MSGMERGE_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
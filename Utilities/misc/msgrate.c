@@ -0,0 +1,256 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/msgrate.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Rate Limiting of CAN Messages per CAN-ID (Token Bucket, 1 of N)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  (see header file)
+ *
+ *  includes  :  msgrate.h, printmsg.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ */
+/** @file        msgrate.c
+ *
+ *  @brief       Rate Limiting of CAN Messages per CAN-ID (Token Bucket, 1 of N)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @addtogroup  msg_rate
+ *  @{
+ */
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "msgrate.h"
+#include "printmsg.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define TOKEN           (1000000ull)    /* one token (refilled per usec and frame/s) */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static int lookup(struct msg_rate *rate, unsigned long id, int flags);
+static int find_rule(const struct msg_rate *rate, unsigned long id);
+static int add_entry(struct msg_rate *rate, uint32_t key, unsigned long id);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int rate_init(struct msg_rate *rate)
+{
+    if (!rate)
+        return 0;
+    memset(rate, 0, sizeof(struct msg_rate));
+    return idmap_init(&rate->map, 0);
+}
+
+int rate_rule(struct msg_rate *rate, int policy, unsigned long value)
+{
+    struct rate_rule *rule;
+
+    if (!rate || (rate->used_rules >= RATE_RULES) || !value)
+        return -1;
+    if ((policy != RATE_TOKEN_BUCKET) && (policy != RATE_ONE_OF_N))
+        return -1;
+    /* note: rules can only be added before the first frame */
+    if (rate->used)
+        return -1;
+    rule = &rate->rules[rate->used_rules];
+    memset(rule, 0, sizeof(struct rate_rule));
+    rule->policy = policy;
+    rule->value = value;
+    return rate->used_rules++;
+}
+
+int rate_range(struct msg_rate *rate, int rule, unsigned long first, unsigned long last)
+{
+    struct rate_rule *entry;
+
+    if (!rate || (rule < 0) || (rule >= rate->used_rules) || (first > last))
+        return 0;
+    entry = &rate->rules[rule];
+    if (entry->ranges >= RATE_RANGES)
+        return 0;
+    entry->first[entry->ranges] = (uint32_t)first;
+    entry->last[entry->ranges] = (uint32_t)last;
+    entry->ranges++;
+    return 1;
+}
+
+int rate_check(struct msg_rate *rate, uint64_t timestamp, unsigned long id, int flags)
+{
+    struct rate_entry *entry;
+    struct rate_rule *rule;
+    uint64_t elapsed, depth;
+    int index, passed;
+
+    if (!rate || !rate->map.xtd_keys)
+        return 1;
+    rate->frames++;
+    /* look up the entry of the CAN-ID (or add one) */
+    if ((index = lookup(rate, id, flags)) < 0)
+        return 1;   /* note: out of memory, the frame is passed */
+    entry = &rate->entries[index];
+    if (entry->rule < 0)
+        return 1;
+    rule = &rate->rules[entry->rule];
+    if (rule->policy == RATE_TOKEN_BUCKET) {
+        /* refill the bucket (at most one second, so no overflow) */
+        depth = (uint64_t)rule->value * TOKEN;
+        if (entry->count) {
+            elapsed = (timestamp > entry->last) ? (timestamp - entry->last) : 0u;
+            if (elapsed > TOKEN)
+                elapsed = TOKEN;
+            entry->credit += elapsed * (uint64_t)rule->value;
+            if (entry->credit > depth)
+                entry->credit = depth;
+        }
+        else
+            entry->credit = depth;
+        entry->last = timestamp;
+        entry->count++;
+        if ((passed = (entry->credit >= TOKEN)) != 0)
+            entry->credit -= TOKEN;
+    }
+    else {
+        /* keep the first of each n frames */
+        passed = ((entry->count % rule->value) == 0) ? 1 : 0;
+        entry->count++;
+    }
+    if (passed) {
+        rule->passed++;
+        return 1;
+    }
+    rule->dropped++;
+    rate->dropped++;
+    return 0;
+}
+
+int rate_report(const struct msg_rate *rate, FILE *stream)
+{
+    const struct rate_rule *rule;
+    int i;
+
+    if (!rate || !stream)
+        return 0;
+    fprintf(stream, "Rate limit: %" PRIu64 " of %" PRIu64 " frame(s) dropped\n", rate->dropped, rate->frames);
+    for (i = 0; i < rate->used_rules; i++) {
+        rule = &rate->rules[i];
+        if (rule->policy == RATE_TOKEN_BUCKET)
+            fprintf(stream, "  rule %d (%lu frame(s)/s)", i + 1, rule->value);
+        else
+            fprintf(stream, "  rule %d (1 of %lu frame(s))", i + 1, rule->value);
+        fprintf(stream, ": %" PRIu64 " frame(s) passed, %" PRIu64 " frame(s) dropped\n", rule->passed, rule->dropped);
+    }
+    return (fflush(stream) == 0) ? 1 : 0;
+}
+
+void rate_exit(struct msg_rate *rate)
+{
+    if (!rate)
+        return;
+    free(rate->entries);
+    idmap_exit(&rate->map);
+    rate->entries = NULL;
+    rate->used = rate->size = 0;
+}
+
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static int lookup(struct msg_rate *rate, unsigned long id, int flags)
+{
+    uint32_t key = ((uint32_t)id << 1) | ((flags & MSG_FLAG_XTD) ? 1u : 0u);
+    int index;
+
+    if ((index = idmap_find(&rate->map, id, flags & MSG_FLAG_XTD)) >= 0)
+        return index;
+    if ((index = add_entry(rate, key, id)) < 0)
+        return -1;
+    if (!idmap_set(&rate->map, id, flags & MSG_FLAG_XTD, index)) {
+        rate->used--;   /* note: the entry is dropped again */
+        return -1;
+    }
+    return index;
+}
+
+static int find_rule(const struct msg_rate *rate, unsigned long id)
+{
+    const struct rate_rule *rule;
+    int i, r;
+
+    /* the rule added last wins */
+    for (r = rate->used_rules - 1; r >= 0; r--) {
+        rule = &rate->rules[r];
+        for (i = 0; i < rule->ranges; i++) {
+            if ((id >= rule->first[i]) && (id <= rule->last[i]))
+                return r;
+        }
+    }
+    return -1;
+}
+
+static int add_entry(struct msg_rate *rate, uint32_t key, unsigned long id)
+{
+    struct rate_entry *entries;
+    size_t size;
+
+    if (rate->used >= rate->size) {
+        /* note: the entries are referenced by their number, so they can move */
+        size = rate->size ? rate->size * 2 : 256;
+        if ((entries = (struct rate_entry*)realloc(rate->entries, size * sizeof(struct rate_entry))) == NULL)
+            return -1;
+        rate->entries = entries;
+        rate->size = size;
+    }
+    memset(&rate->entries[rate->used], 0, sizeof(struct rate_entry));
+    rate->entries[rate->used].key = key;
+    rate->entries[rate->used].rule = (int32_t)find_rule(rate, id);
+    return (int)rate->used++;
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
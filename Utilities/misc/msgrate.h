@@ -0,0 +1,177 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/msgrate.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Rate Limiting of CAN Messages per CAN-ID (Token Bucket, 1 of N)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  int rate_init(struct msg_rate *rate);
+ *               int rate_rule(struct msg_rate *rate, int policy, unsigned long value);
+ *               int rate_range(struct msg_rate *rate, int rule, unsigned long first, unsigned long last);
+ *               int rate_check(struct msg_rate *rate, uint64_t timestamp, unsigned long id, int flags);
+ *               int rate_report(const struct msg_rate *rate, FILE *stream);
+ *               void rate_exit(struct msg_rate *rate);
+ *
+ *  includes  :  idmap.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  Decimation of cyclic CAN messages per CAN-ID, by rules for ranges of
+ *  CAN-IDs (11-bit and 29-bit).  A rule has one of two policies:
+ *
+ *  - RATE_TOKEN_BUCKET: at most n frames per second per CAN-ID.  Each
+ *    CAN-ID has a bucket of n tokens (one second), which is refilled
+ *    with n tokens per second by the time-stamps of the frames; a frame
+ *    takes one token, or it is dropped.
+ *  - RATE_ONE_OF_N: every n-th frame of a CAN-ID is kept (the first one
+ *    of the CAN-ID included).
+ *
+ *  When the ranges of several rules overlap, the rule added last applies.
+ *  The rule of a CAN-ID is looked up once, on its first frame; then it is
+ *  kept with the state of the CAN-ID (see idmap.h).
+ */
+/** @file        msgrate.h
+ *
+ *  @brief       Rate Limiting of CAN Messages per CAN-ID (Token Bucket, 1 of N)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    msg_rate Rate Limiting of CAN Messages per CAN-ID (Token Bucket, 1 of N)
+ *  @{
+ */
+#ifndef MSGRATE_H_INCLUDED
+#define MSGRATE_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "idmap.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define RATE_TOKEN_BUCKET   (1)     /**< at most n frames per second */
+#define RATE_ONE_OF_N       (2)     /**< every n-th frame */
+
+#define RATE_RULES          (16)    /**< max. number of rules */
+#define RATE_RANGES         (32)    /**< max. number of ID ranges per rule */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+/** rule for a set of CAN-IDs
+ */
+struct rate_rule {
+    int policy;                     /**< RATE_TOKEN_BUCKET or RATE_ONE_OF_N */
+    unsigned long value;            /**< frames per second, resp. n */
+    int ranges;                     /**< number of ID ranges */
+    uint32_t first[RATE_RANGES];    /**< first CAN-ID of a range */
+    uint32_t last[RATE_RANGES];     /**< last CAN-ID of a range */
+    uint64_t passed;                /**< number of passed frames */
+    uint64_t dropped;               /**< number of dropped frames */
+};
+
+/** state of a CAN-ID
+ */
+struct rate_entry {
+    uint32_t key;                   /**< CAN identifier << 1 | XTD */
+    int32_t rule;                   /**< rule of the CAN-ID (or -1) */
+    uint64_t last;                  /**< time-stamp of the last frame [usec] */
+    uint64_t credit;                /**< tokens * 1'000'000 (token bucket) */
+    uint64_t count;                 /**< number of frames (1 of n) */
+};
+
+/** rate limiting of CAN messages per CAN-ID
+ */
+struct msg_rate {
+    struct rate_rule rules[RATE_RULES]; /**< rules (the last one wins) */
+    int used_rules;                 /**< number of rules */
+    struct rate_entry *entries;     /**< entries in order of appearance */
+    size_t used;                    /**< number of entries */
+    size_t size;                    /**< number of allocated entries */
+    struct id_map map;              /**< entry of a CAN-ID */
+    uint64_t frames;                /**< number of frames */
+    uint64_t dropped;               /**< number of dropped frames */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       initializes the rate limiting (w/o rules).
+ *
+ *  @param[out]  rate  pointer to the rate limiting
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int rate_init(struct msg_rate *rate);
+
+/** @brief       adds a rule (w/o ID ranges, see rate_range).
+ *
+ *  @param[in]   rate    pointer to the rate limiting
+ *  @param[in]   policy  RATE_TOKEN_BUCKET or RATE_ONE_OF_N
+ *  @param[in]   value   frames per second, resp. n (at least 1)
+ *
+ *  @returns     number of the rule, or a negative value on error
+ */
+int rate_rule(struct msg_rate *rate, int policy, unsigned long value);
+
+/** @brief       adds a range of CAN-IDs to a rule.
+ *
+ *  @param[in]   rate   pointer to the rate limiting
+ *  @param[in]   rule   number of the rule
+ *  @param[in]   first  first CAN-ID of the range
+ *  @param[in]   last   last CAN-ID of the range
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int rate_range(struct msg_rate *rate, int rule, unsigned long first, unsigned long last);
+
+/** @brief       counts a CAN message by the rule of its CAN-ID.
+ *
+ *  @param[in]   rate       pointer to the rate limiting
+ *  @param[in]   timestamp  time-stamp of the CAN message [usec]
+ *  @param[in]   id         CAN identifier
+ *  @param[in]   flags      message flags (MSG_FLAG_xyz)
+ *
+ *  @returns     non-zero value when the message is passed, or zero when
+ *               it is dropped
+ */
+int rate_check(struct msg_rate *rate, uint64_t timestamp, unsigned long id, int flags);
+
+/** @brief       writes the number of passed and dropped frames per rule.
+ *
+ *  @returns     non-zero value on success, or zero on a write error
+ */
+int rate_report(const struct msg_rate *rate, FILE *stream);
+
+/** @brief       releases the rate limiting.
+ */
+void rate_exit(struct msg_rate *rate);
+
+
+#endif /* MSGRATE_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
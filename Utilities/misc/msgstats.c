@@ -0,0 +1,334 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/msgstats.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Statistics of CAN Messages per CAN-ID (Rolling Windows)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  (see header file)
+ *
+ *  includes  :  msgstats.h, printmsg.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ */
+/** @file        msgstats.c
+ *
+ *  @brief       Statistics of CAN Messages per CAN-ID (Rolling Windows)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @addtogroup  msg_stats
+ *  @{
+ */
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "msgstats.h"
+#include "printmsg.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <math.h>
+#include <sys/time.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define SLOTS_PER_ENTRY (STATS_WINDOWS * STATS_SLOTS)
+#define CYCLE_MAX       (0xFFFFFFFFu)   /* cycle times are clamped to 71 minutes */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static int add_entry(struct msg_stats *stats, uint32_t key, uint64_t timestamp);
+static int compare_keys(const void *a, const void *b);
+static uint64_t get_time_usec(void);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+static const uint64_t slot_length[STATS_WINDOWS] = {
+    250000ull, 2500000ull, 15000000ull    /* a quarter of 1s, 10s and 60s */
+};
+
+static const struct stats_entry *sort_entries;  /* note: for qsort (the report is not re-entrant) */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int stats_init(struct msg_stats *stats)
+{
+    if (!stats)
+        return 0;
+    memset(stats, 0, sizeof(struct msg_stats));
+    return idmap_init(&stats->map, 0);
+}
+
+int stats_update(struct msg_stats *stats, uint64_t timestamp, unsigned long id, int flags, int dlc)
+{
+    struct stats_entry *entry;
+    struct stats_slot *slots, *slot;
+    uint32_t key = ((uint32_t)id << 1) | ((flags & MSG_FLAG_XTD) ? 1u : 0u);
+    uint32_t epoch, cycle = 0;
+    int index, changed, w;
+
+    if (!stats || !stats->map.xtd_keys)
+        return 0;
+    /* look up the entry of the CAN-ID (or add one) */
+    if ((index = idmap_find(&stats->map, id, flags & MSG_FLAG_XTD)) < 0) {
+        if ((index = add_entry(stats, key, timestamp)) < 0)
+            return 0;
+        if (!idmap_set(&stats->map, id, flags & MSG_FLAG_XTD, index)) {
+            stats->used--;  /* note: the entry is dropped again */
+            return 0;
+        }
+    }
+    entry = &stats->entries[index];
+    /* totals */
+    if (stats->frames++ == 0) {
+        stats->start = timestamp;
+        stats->offset = get_time_usec() - timestamp;
+    }
+    if (timestamp > stats->latest)
+        stats->latest = timestamp;
+    changed = (entry->count && (entry->dlc != (uint8_t)dlc)) ? 1 : 0;
+    if (entry->count)
+        cycle = ((timestamp - entry->last) < CYCLE_MAX) ? (uint32_t)(timestamp - entry->last) : CYCLE_MAX;
+    entry->changes += (uint64_t)changed;
+    /* current slot of each window (cleared when reused) */
+    slots = &stats->slots[(size_t)index * SLOTS_PER_ENTRY];
+    for (w = 0; w < STATS_WINDOWS; w++, slots += STATS_SLOTS) {
+        epoch = (uint32_t)(timestamp / slot_length[w]);
+        slot = &slots[epoch % STATS_SLOTS];
+        if (slot->epoch != epoch) {
+            memset(slot, 0, sizeof(struct stats_slot));
+            slot->epoch = epoch;
+            slot->min = CYCLE_MAX;
+        }
+        slot->count++;
+        slot->changes += (uint32_t)changed;
+        if (entry->count) {
+            slot->cycles++;
+            if (cycle < slot->min)
+                slot->min = cycle;
+            if (cycle > slot->max)
+                slot->max = cycle;
+            slot->sum += (uint64_t)cycle;
+            slot->squares += (uint64_t)cycle * (uint64_t)cycle;
+        }
+    }
+    entry->count++;
+    entry->last = timestamp;
+    entry->dlc = (uint8_t)dlc;
+    entry->flags = (uint8_t)flags;
+    return 1;
+}
+
+int stats_window(const struct msg_stats *stats, size_t entry, int window, uint64_t now, struct stats_summary *summary)
+{
+    const struct stats_slot *slots, *slot;
+    uint64_t length, current, elapsed, covered, min = CYCLE_MAX, max = 0, sum = 0, squares = 0;
+    double count = 0.0, weight, variance;
+    uint32_t epoch;
+    int i;
+
+    if (!stats || (entry >= stats->used) || (window < 0) || (window >= STATS_WINDOWS) || !summary)
+        return 0;
+    memset(summary, 0, sizeof(struct stats_summary));
+    length = slot_length[window];
+    current = now / length;
+    elapsed = now % length;
+    slots = &stats->slots[(entry * SLOTS_PER_ENTRY) + ((size_t)window * STATS_SLOTS)];
+    for (i = 0; (i < STATS_SLOTS) && ((uint64_t)i <= current); i++) {
+        /* the current slot, three full slots, and a part of the oldest one */
+        epoch = (uint32_t)(current - (uint64_t)i);
+        slot = &slots[epoch % STATS_SLOTS];
+        if ((slot->epoch != epoch) || !slot->count)
+            continue;
+        weight = (i < (STATS_SLOTS - 1)) ? 1.0 : (double)(length - elapsed) / (double)length;
+        count += weight * (double)slot->count;
+        summary->count += slot->count;
+        summary->changes += slot->changes;
+        summary->cycles += slot->cycles;
+        if (slot->cycles) {
+            if (slot->min < min)
+                min = slot->min;
+            if (slot->max > max)
+                max = slot->max;
+            sum += slot->sum;
+            squares += slot->squares;
+        }
+    }
+    /* rate over the window (or over the time since the first frame) */
+    covered = length * (STATS_SLOTS - 1);
+    if ((now - stats->start) < covered)
+        covered = now - stats->start;
+    summary->rate = covered ? (count * 1000000.0) / (double)covered : 0.0;
+    if (summary->cycles) {
+        summary->min = (double)min;
+        summary->max = (double)max;
+        summary->avg = (double)sum / (double)summary->cycles;
+        variance = ((double)squares / (double)summary->cycles) - (summary->avg * summary->avg);
+        summary->jitter = (variance > 0.0) ? sqrt(variance) : 0.0;
+    }
+    return 1;
+}
+
+uint64_t stats_now(const struct msg_stats *stats)
+{
+    uint64_t now;
+
+    if (!stats || !stats->frames)
+        return 0;
+    /* note: the wall clock continues when there are no frames */
+    now = get_time_usec() - stats->offset;
+    return (now > stats->latest) ? now : stats->latest;
+}
+
+int stats_report(struct msg_stats *stats, FILE *stream, int mode_id)
+{
+    struct stats_summary rate[STATS_WINDOWS];
+    const struct stats_entry *entry;
+    uint64_t now;
+    size_t i;
+    int w;
+
+    if (!stats || !stream || (stats->used && !stats->order))
+        return 0;
+    now = stats_now(stats);
+    fprintf(stream, "Statistics: %" PRIu64 " frame(s), %zu CAN-ID(s), %.3fs\n", stats->frames, stats->used,
+            stats->frames ? (double)(now - stats->start) / 1000000.0 : 0.0);
+    fprintf(stream, "  CAN-ID      Frames    1s [fps]   10s [fps]   60s [fps]    Min [ms]   Avg [ms]   Max [ms]   Jit [ms]  DLC  Changes     Last\n");
+    for (i = 0; i < stats->used; i++)
+        stats->order[i] = i;
+    sort_entries = stats->entries;
+    qsort(stats->order, stats->used, sizeof(size_t), compare_keys);
+    for (i = 0; i < stats->used; i++) {
+        entry = &stats->entries[stats->order[i]];
+        for (w = 0; w < STATS_WINDOWS; w++)
+            (void)stats_window(stats, stats->order[i], w, now, &rate[w]);
+        switch (mode_id) {
+        case MSG_MODE_DEC:
+            fprintf(stream, "  %-9lu", (unsigned long)(entry->key >> 1));
+            break;
+        case MSG_MODE_OCT:
+            fprintf(stream, "  \\%-8lo", (unsigned long)(entry->key >> 1));
+            break;
+        case MSG_MODE_HEX:
+        default:
+            fprintf(stream, (entry->key & 1u) ? "  %08lXx" : "  %03lX      ", (unsigned long)(entry->key >> 1));
+            break;
+        }
+        fprintf(stream, "%9" PRIu64 "  %10.1f  %10.1f  %10.1f", entry->count,
+                rate[STATS_WINDOW_1S].rate, rate[STATS_WINDOW_10S].rate, rate[STATS_WINDOW_60S].rate);
+        /* cycle time and jitter over the 10s window [ms] */
+        if (rate[STATS_WINDOW_10S].cycles)
+            fprintf(stream, "  %10.3f %10.3f %10.3f %10.3f",
+                    rate[STATS_WINDOW_10S].min / 1000.0, rate[STATS_WINDOW_10S].avg / 1000.0,
+                    rate[STATS_WINDOW_10S].max / 1000.0, rate[STATS_WINDOW_10S].jitter / 1000.0);
+        else
+            fprintf(stream, "  %10s %10s %10s %10s", "-", "-", "-", "-");
+        fprintf(stream, "  %3u  %7" PRIu64 "  %6.1fs\n", (unsigned)entry->dlc, entry->changes,
+                (double)(now - entry->last) / 1000000.0);
+    }
+    return (fflush(stream) == 0) ? 1 : 0;
+}
+
+void stats_exit(struct msg_stats *stats)
+{
+    if (!stats)
+        return;
+    free(stats->entries);
+    free(stats->slots);
+    free(stats->order);
+    idmap_exit(&stats->map);
+    stats->entries = NULL;
+    stats->slots = NULL;
+    stats->order = NULL;
+    stats->used = stats->size = 0;
+}
+
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static int add_entry(struct msg_stats *stats, uint32_t key, uint64_t timestamp)
+{
+    struct stats_entry *entries;
+    struct stats_slot *slots;
+    size_t *order;
+    size_t size;
+
+    if (stats->used >= stats->size) {
+        /* note: the entries are referenced by their number, so they can move */
+        size = stats->size ? stats->size * 2 : 256;
+        if ((entries = (struct stats_entry*)realloc(stats->entries, size * sizeof(struct stats_entry))) == NULL)
+            return -1;
+        stats->entries = entries;
+        if ((slots = (struct stats_slot*)realloc(stats->slots, size * SLOTS_PER_ENTRY * sizeof(struct stats_slot))) == NULL)
+            return -1;
+        stats->slots = slots;
+        if ((order = (size_t*)realloc(stats->order, size * sizeof(size_t))) == NULL)
+            return -1;
+        stats->order = order;
+        stats->size = size;
+    }
+    memset(&stats->entries[stats->used], 0, sizeof(struct stats_entry));
+    memset(&stats->slots[stats->used * SLOTS_PER_ENTRY], 0, SLOTS_PER_ENTRY * sizeof(struct stats_slot));
+    stats->entries[stats->used].key = key;
+    stats->entries[stats->used].first = timestamp;
+    return (int)stats->used++;
+}
+
+static int compare_keys(const void *a, const void *b)
+{
+    uint32_t ka = sort_entries[*(const size_t*)a].key;
+    uint32_t kb = sort_entries[*(const size_t*)b].key;
+
+    /* 11-bit IDs first, then 29-bit IDs */
+    if ((ka & 1u) != (kb & 1u))
+        return (ka & 1u) ? 1 : -1;
+    return (ka < kb) ? -1 : (ka > kb) ? 1 : 0;
+}
+
+static uint64_t get_time_usec(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return ((uint64_t)tv.tv_sec * 1000000ull) + (uint64_t)tv.tv_usec;
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,198 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/msgstats.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Statistics of CAN Messages per CAN-ID (Rolling Windows)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  int stats_init(struct msg_stats *stats);
+ *               int stats_update(struct msg_stats *stats, uint64_t timestamp, unsigned long id, int flags, int dlc);
+ *               int stats_window(const struct msg_stats *stats, size_t entry, int window, uint64_t now, struct stats_summary *summary);
+ *               uint64_t stats_now(const struct msg_stats *stats);
+ *               int stats_report(struct msg_stats *stats, FILE *stream, int mode_id);
+ *               void stats_exit(struct msg_stats *stats);
+ *
+ *  includes  :  idmap.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  Live statistics per CAN-ID: number of frames, rate, min./avg./max.
+ *  cycle time, jitter (standard deviation of the cycle time), DLC changes
+ *  and last-seen time, over rolling windows of 1s, 10s and 60s.
+ *
+ *  The entries are kept in a dense array in order of appearance and found
+ *  by their CAN-ID (see idmap.h).  Each window is a ring of a few
+ *  time slots (a quarter of the window each); a frame only updates the
+ *  current slot of each window, a slot is cleared when it is reused.  So
+ *  the work per frame is constant, and the windows are summed up only
+ *  when they are read.  The oldest slot is weighted by the part of it that
+ *  is still in the window.
+ *
+ *  All times are taken from the time-stamps of the frames (the reference
+ *  time "now" of a report is derived from the wall clock, so the windows
+ *  age on an idle bus as well).
+ */
+/** @file        msgstats.h
+ *
+ *  @brief       Statistics of CAN Messages per CAN-ID (Rolling Windows)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    msg_stats Statistics of CAN Messages per CAN-ID (Rolling Windows)
+ *  @{
+ */
+#ifndef MSGSTATS_H_INCLUDED
+#define MSGSTATS_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "idmap.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define STATS_WINDOW_1S     (0)     /**< rolling window of 1 second */
+#define STATS_WINDOW_10S    (1)     /**< rolling window of 10 seconds */
+#define STATS_WINDOW_60S    (2)     /**< rolling window of 60 seconds */
+#define STATS_WINDOWS       (3)     /**< number of rolling windows */
+
+#define STATS_SLOTS         (5)     /**< time slots per window (4 + current) */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+/** one time slot of a rolling window
+ */
+struct stats_slot {
+    uint32_t epoch;                 /**< number of the slot (time / slot length) */
+    uint32_t count;                 /**< number of frames */
+    uint32_t changes;               /**< number of DLC changes */
+    uint32_t cycles;                /**< number of cycle times */
+    uint32_t min;                   /**< min. cycle time [usec] */
+    uint32_t max;                   /**< max. cycle time [usec] */
+    uint64_t sum;                   /**< sum of the cycle times [usec] */
+    uint64_t squares;               /**< sum of the squared cycle times [usec^2] */
+};
+
+/** statistics of one CAN-ID (totals)
+ */
+struct stats_entry {
+    uint32_t key;                   /**< CAN identifier << 1 | XTD */
+    uint8_t dlc;                    /**< last data length code */
+    uint8_t flags;                  /**< last message flags (MSG_FLAG_xyz) */
+    uint16_t reserved;              /**< (alignment) */
+    uint64_t count;                 /**< number of frames */
+    uint64_t changes;               /**< number of DLC changes */
+    uint64_t first;                 /**< time-stamp of the first frame [usec] */
+    uint64_t last;                  /**< time-stamp of the last frame [usec] */
+};
+
+/** summary of a CAN-ID over a rolling window
+ */
+struct stats_summary {
+    uint64_t count;                 /**< number of frames */
+    double rate;                    /**< frames per second */
+    uint64_t changes;               /**< number of DLC changes */
+    uint64_t cycles;                /**< number of cycle times */
+    double min;                     /**< min. cycle time [usec] */
+    double avg;                     /**< avg. cycle time [usec] */
+    double max;                     /**< max. cycle time [usec] */
+    double jitter;                  /**< standard deviation of the cycle time [usec] */
+};
+
+/** statistics of CAN messages per CAN-ID
+ */
+struct msg_stats {
+    struct stats_entry *entries;    /**< entries in order of appearance */
+    struct stats_slot *slots;       /**< STATS_WINDOWS * STATS_SLOTS slots per entry */
+    size_t used;                    /**< number of entries */
+    size_t size;                    /**< number of allocated entries */
+    struct id_map map;              /**< entry of a CAN-ID */
+    uint64_t frames;                /**< number of frames */
+    uint64_t start;                 /**< time-stamp of the first frame [usec] */
+    uint64_t latest;                /**< latest time-stamp [usec] */
+    uint64_t offset;                /**< wall clock - time-stamp [usec] */
+    size_t *order;                  /**< entries sorted by CAN-ID (report) */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       initializes the statistics.
+ *
+ *  @param[out]  stats  pointer to the statistics
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int stats_init(struct msg_stats *stats);
+
+/** @brief       counts a CAN message.
+ *
+ *  @param[in]   stats      pointer to the statistics
+ *  @param[in]   timestamp  time-stamp of the CAN message [usec]
+ *  @param[in]   id         CAN identifier
+ *  @param[in]   flags      message flags (MSG_FLAG_xyz)
+ *  @param[in]   dlc        data length code
+ *
+ *  @returns     non-zero value on success, or zero if no entry could be added
+ */
+int stats_update(struct msg_stats *stats, uint64_t timestamp, unsigned long id, int flags, int dlc);
+
+/** @brief       sums up a rolling window of an entry.
+ *
+ *  @param[in]   stats    pointer to the statistics
+ *  @param[in]   entry    number of the entry (0..used-1)
+ *  @param[in]   window   STATS_WINDOW_1S, STATS_WINDOW_10S or STATS_WINDOW_60S
+ *  @param[in]   now      reference time [usec] (see stats_now)
+ *  @param[out]  summary  summary of the window
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int stats_window(const struct msg_stats *stats, size_t entry, int window, uint64_t now, struct stats_summary *summary);
+
+/** @brief       returns the current time in the time base of the frames.
+ */
+uint64_t stats_now(const struct msg_stats *stats);
+
+/** @brief       writes a summary of all CAN-IDs (sorted by CAN-ID).
+ *
+ *  @param[in]   stats    pointer to the statistics
+ *  @param[in]   stream   output stream
+ *  @param[in]   mode_id  identifier: HEX, DEC or OCT
+ *
+ *  @returns     non-zero value on success, or zero on a write error
+ */
+int stats_report(struct msg_stats *stats, FILE *stream, int mode_id);
+
+/** @brief       releases the statistics.
+ */
+void stats_exit(struct msg_stats *stats);
+
+
+#endif /* MSGSTATS_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,371 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/msgtable.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Table of CAN Messages per CAN-ID (Top View)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  (see header file)
+ *
+ *  includes  :  msgtable.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ */
+/** @file        msgtable.c
+ *
+ *  @brief       Table of CAN Messages per CAN-ID (Top View)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @addtogroup  msg_table
+ *  @{
+ */
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "msgtable.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/ioctl.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define ROWS_INITIAL    (64)
+#define KEY_XTD         (0x80000000UL)
+
+#define DEFAULT_LINES   (24)
+#define DEFAULT_COLUMNS (80)
+#define HEADER_LINES    (2)
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static int find_row(const struct msg_table *table, unsigned long id, int flags);
+static int insert_row(struct msg_table *table, unsigned long id, int flags);
+static void index_row(struct msg_table *table, int row);
+
+static int get_geometry(struct msg_table *table);
+static size_t compose_row(const struct msg_table *table, const struct tbl_row *row, char *line);
+static void draw_line(struct msg_table *table, int line, const char *text, size_t length);
+static void put_string(struct msg_table *table, const char *text, size_t length);
+
+static uint64_t get_time_usec(void);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int tbl_init(struct msg_table *table, FILE *stream, int mode_id, int mode_data, int canfd, unsigned int refresh)
+{
+    if (!table || !stream)
+        return 0;
+    memset(table, 0, sizeof(struct msg_table));
+    table->rows = (struct tbl_row*)malloc(ROWS_INITIAL * sizeof(struct tbl_row));
+    if (!table->rows || !idmap_init(&table->map, 0) ||
+        !msg_buffer_init(&table->output, stream, MSG_BUFFER_SIZE, MSG_FLUSH_FULL, 0UL)) {
+        free(table->rows);
+        idmap_exit(&table->map);
+        table->rows = NULL;
+        return 0;
+    }
+    table->size = ROWS_INITIAL;
+    table->mode_id = mode_id;
+    table->mode_data = mode_data;
+    table->canfd = canfd;
+    table->refresh = (uint64_t)refresh * 1000ull;
+    table->deadline = get_time_usec();
+    /* hide the cursor (the screen is cleared with the first refresh) */
+    put_string(table, "\033[?25l", 6);
+    return 1;
+}
+
+int tbl_update(struct msg_table *table, const struct msg_timestamp *timestamp,
+               unsigned long id, int flags, int dlc, int len, const unsigned char *data)
+{
+    struct tbl_row *row;
+    uint64_t usec;
+    int r;
+
+    if (!table || !table->rows)
+        return 0;
+    if ((r = find_row(table, id, flags)) < 0) {
+        if ((r = insert_row(table, id, flags)) < 0)
+            return 0;
+    }
+    row = &table->rows[r];
+    usec = ((uint64_t)timestamp->tv_sec * 1000000ull) + (uint64_t)timestamp->tv_usec;
+    if (row->count)
+        row->cycle = usec - row->last;
+    row->last = usec;
+    row->count++;
+    row->flags = flags;
+    row->dlc = dlc;
+    row->len = (len < 0) ? 0 : (len > 64) ? 64 : len;
+    memcpy(row->data, data, (size_t)row->len);
+    row->dirty = 1;
+    table->frames++;
+    return 1;
+}
+
+int tbl_refresh(struct msg_table *table, int force)
+{
+    char line[TBL_LINE_MAX];
+    uint64_t now;
+    size_t length;
+    int i, visible;
+
+    if (!table || !table->rows)
+        return 0;
+    now = get_time_usec();
+    if (!force && (now < table->deadline))
+        return 1;
+    table->deadline = now + table->refresh;
+    /* (re-)draw everything when the terminal size has changed */
+    if (!get_geometry(table))
+        return 0;
+    /* header: number of frames and CAN-IDs, column titles */
+    length = (size_t)snprintf(line, sizeof(line), "Frames: %llu  CAN-IDs: %lu",
+                              (unsigned long long)table->frames, (unsigned long)table->used);
+    draw_line(table, 0, line, length);
+    length = (size_t)snprintf(line, sizeof(line), "%-10s %-5s %3s %12s %12s  %s",
+                              "CAN-ID", "Flags", "DLC", "Count", "Cycle[ms]", "Data");
+    draw_line(table, 1, line, length);
+    /* rows: only the changed ones (and only what fits on the screen) */
+    visible = table->lines - HEADER_LINES - 1;
+    for (i = 0; (i < (int)table->used) && (i < visible); i++) {
+        if (table->rows[i].dirty) {
+            length = compose_row(table, &table->rows[i], line);
+            draw_line(table, HEADER_LINES + i, line, length);
+            table->rows[i].dirty = 0;
+        }
+    }
+    if ((int)table->used > visible)
+        length = (size_t)snprintf(line, sizeof(line), "(%lu more CAN-IDs)", (unsigned long)(table->used - (size_t)visible));
+    else
+        length = 0;
+    if (visible >= 0)
+        draw_line(table, HEADER_LINES + visible, line, length);
+    return msg_buffer_flush(&table->output);
+}
+
+void tbl_exit(struct msg_table *table)
+{
+    char text[32];
+    int line, visible;
+
+    if (!table || !table->rows)
+        return;
+    (void)tbl_refresh(table, 1);
+    /* put the cursor below the table and show it again */
+    visible = table->lines - HEADER_LINES - 1;
+    line = HEADER_LINES + (((int)table->used <= visible) ? (int)table->used : visible + 1) + 1;
+    put_string(table, text, (size_t)snprintf(text, sizeof(text), "\033[%d;1H\033[?25h", line));
+    msg_buffer_exit(&table->output);
+    free(table->rows);
+    idmap_exit(&table->map);
+    free(table->screen);
+    free(table->length);
+    table->rows = NULL;
+}
+
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static int find_row(const struct msg_table *table, unsigned long id, int flags)
+{
+    return idmap_find(&table->map, id, flags & MSG_FLAG_XTD);
+}
+
+static int insert_row(struct msg_table *table, unsigned long id, int flags)
+{
+    struct tbl_row *rows;
+    uint32_t key;
+    size_t lo = 0, hi = table->used, mid;
+    int i;
+
+    if (table->used >= table->size) {
+        if ((rows = (struct tbl_row*)realloc(table->rows, table->size * 2 * sizeof(struct tbl_row))) == NULL)
+            return -1;
+        table->rows = rows;
+        table->size *= 2;
+    }
+    /* rows are sorted by CAN-ID (11-bit IDs first) */
+    key = (flags & MSG_FLAG_XTD) ? (uint32_t)(KEY_XTD | id) : (uint32_t)id;
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (table->rows[mid].key < key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    /* note: only a new CAN-ID can fail (the map may have to grow) */
+    if (!idmap_set(&table->map, id, flags & MSG_FLAG_XTD, (int)lo))
+        return -1;
+    memmove(&table->rows[lo + 1], &table->rows[lo], (table->used - lo) * sizeof(struct tbl_row));
+    memset(&table->rows[lo], 0, sizeof(struct tbl_row));
+    table->rows[lo].key = key;
+    table->rows[lo].id = id;
+    table->rows[lo].flags = flags;
+    table->used++;
+    /* the following rows have moved one line down */
+    for (i = (int)lo; i < (int)table->used; i++) {
+        index_row(table, i);
+        table->rows[i].dirty = 1;
+    }
+    return (int)lo;
+}
+
+static void index_row(struct msg_table *table, int row)
+{
+    const struct tbl_row *ptr = &table->rows[row];
+
+    /* note: the CAN-ID is in the map already, so this does not fail */
+    (void)idmap_set(&table->map, ptr->id, (ptr->key & KEY_XTD) ? 1 : 0, row);
+}
+
+static int get_geometry(struct msg_table *table)
+{
+    struct winsize ws;
+    int lines = DEFAULT_LINES, columns = DEFAULT_COLUMNS;
+    size_t i;
+
+    if ((ioctl(fileno(table->output.stream), TIOCGWINSZ, &ws) == 0) && (ws.ws_row > 0) && (ws.ws_col > 0)) {
+        lines = (int)ws.ws_row;
+        columns = (int)ws.ws_col;
+    }
+    if (lines < HEADER_LINES + 1)
+        lines = HEADER_LINES + 1;
+    if (columns > TBL_LINE_MAX - 1)
+        columns = TBL_LINE_MAX - 1;
+    if (table->screen && (lines == table->lines) && (columns == table->columns))
+        return 1;
+    /* new screen size: clear the screen and draw everything */
+    free(table->screen);
+    free(table->length);
+    table->screen = (char*)malloc((size_t)lines * TBL_LINE_MAX);
+    table->length = (int*)calloc((size_t)lines, sizeof(int));
+    if (!table->screen || !table->length) {
+        free(table->screen);
+        free(table->length);
+        table->screen = NULL;
+        table->length = NULL;
+        return 0;
+    }
+    table->lines = lines;
+    table->columns = columns;
+    for (i = 0; i < table->used; i++)
+        table->rows[i].dirty = 1;
+    put_string(table, "\033[H\033[2J", 7);
+    return 1;
+}
+
+static size_t compose_row(const struct msg_table *table, const struct tbl_row *row, char *line)
+{
+    char id[16], flags[8], data[64*5+1];
+    int n, i = 0;
+
+    switch (table->mode_id) {
+    case MSG_MODE_DEC: (void)snprintf(id, sizeof(id), "%lu", row->id); break;
+    case MSG_MODE_OCT: (void)snprintf(id, sizeof(id), "\\%lo", row->id); break;
+    default: (void)snprintf(id, sizeof(id), (row->flags & MSG_FLAG_XTD) ? "%08lX" : "%03lX", row->id); break;
+    }
+    flags[i++] = (row->flags & MSG_FLAG_XTD) ? 'X' : ' ';
+    flags[i++] = (row->flags & MSG_FLAG_RTR) ? 'R' : ' ';
+    if (table->canfd) {
+        flags[i++] = (row->flags & MSG_FLAG_FDF) ? 'F' : ' ';
+        flags[i++] = (row->flags & MSG_FLAG_BRS) ? 'B' : ' ';
+        flags[i++] = (row->flags & MSG_FLAG_ESI) ? 'E' : ' ';
+    }
+    flags[i] = '\0';
+    if (!(row->flags & MSG_FLAG_RTR))
+        data[msg_encode_data(data, row->data, row->len, table->mode_data)] = '\0';
+    else
+        (void)strcpy(data, "Remote Transmit Request");
+    n = snprintf(line, (size_t)table->columns + 1, "%-10s %-5s %3d %12llu %8lu.%03lu  %s",
+                 id, flags, row->dlc, (unsigned long long)row->count,
+                 (unsigned long)(row->cycle / 1000ull), (unsigned long)(row->cycle % 1000ull), data);
+    if (n < 0)
+        return 0;
+    return ((size_t)n < (size_t)table->columns) ? (size_t)n : (size_t)table->columns;
+}
+
+static void draw_line(struct msg_table *table, int line, const char *text, size_t length)
+{
+    char *screen;
+    size_t old, first = 0, last = length;
+    char cursor[32];
+
+    if (line >= table->lines)
+        return;
+    screen = &table->screen[(size_t)line * TBL_LINE_MAX];
+    old = (size_t)table->length[line];
+    /* only the characters that differ from the screen are written */
+    while ((first < length) && (first < old) && (text[first] == screen[first]))
+        first++;
+    if ((first == length) && (length == old))
+        return;
+    if (length == old) {
+        while ((last > first) && (text[last - 1] == screen[last - 1]))
+            last--;
+    }
+    put_string(table, cursor, (size_t)snprintf(cursor, sizeof(cursor), "\033[%d;%luH", line + 1, (unsigned long)first + 1));
+    put_string(table, &text[first], last - first);
+    if (length < old)
+        put_string(table, "\033[K", 3);
+    memcpy(screen, text, length);
+    table->length[line] = (int)length;
+}
+
+static void put_string(struct msg_table *table, const char *text, size_t length)
+{
+    if (length > 0)
+        (void)msg_buffer_write(&table->output, text, length);
+}
+
+static uint64_t get_time_usec(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return ((uint64_t)tv.tv_sec * 1000000ull) + (uint64_t)tv.tv_usec;
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
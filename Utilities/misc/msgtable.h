@@ -0,0 +1,148 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/msgtable.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Table of CAN Messages per CAN-ID (Top View)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  int tbl_init(struct msg_table *table, FILE *stream, int mode_id, int mode_data, int canfd, unsigned int refresh);
+ *               int tbl_update(struct msg_table *table, const struct msg_timestamp *timestamp, unsigned long id, int flags, int dlc, int len, const unsigned char *data);
+ *               int tbl_refresh(struct msg_table *table, int force);
+ *               void tbl_exit(struct msg_table *table);
+ *
+ *  includes  :  printmsg.h, idmap.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  The table keeps one row per CAN-ID (last data bytes, DLC, number of
+ *  frames and cycle time), sorted by CAN-ID and found by their CAN-ID
+ *  (see idmap.h).  Updating a row
+ *  does not write anything.  The screen is redrawn at a capped refresh
+ *  rate, and only the characters that differ from the screen contents
+ *  are written (with ANSI cursor moves), so terminal I/O scales with the
+ *  number of CAN-IDs and not with the frame rate.
+ */
+/** @file        msgtable.h
+ *
+ *  @brief       Table of CAN Messages per CAN-ID (Top View)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    msg_table Table of CAN Messages per CAN-ID (Top View)
+ *  @{
+ */
+#ifndef MSGTABLE_H_INCLUDED
+#define MSGTABLE_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "printmsg.h"
+#include "idmap.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define TBL_REFRESH     (100)       /**< default refresh interval [msec] */
+#define TBL_LINE_MAX    (256)       /**< max. length of one table row */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+/** one row of the table (one CAN-ID)
+ */
+struct tbl_row {
+    uint32_t key;                   /**< sort key (29-bit IDs after 11-bit IDs) */
+    unsigned long id;               /**< CAN identifier */
+    int flags;                      /**< message flags (MSG_FLAG_xyz) */
+    int dlc;                        /**< data length code */
+    int len;                        /**< number of data bytes */
+    unsigned char data[64];         /**< last data bytes */
+    uint64_t count;                 /**< number of frames */
+    uint64_t last;                  /**< time-stamp of the last frame [usec] */
+    uint64_t cycle;                 /**< cycle time [usec] */
+    int dirty;                      /**< row has to be redrawn */
+};
+
+/** table of CAN messages per CAN-ID
+ */
+struct msg_table {
+    struct tbl_row *rows;           /**< rows sorted by CAN-ID */
+    size_t used;                    /**< number of rows */
+    size_t size;                    /**< number of allocated rows */
+    struct id_map map;              /**< row of a CAN-ID */
+    uint64_t frames;                /**< number of frames */
+    int mode_id;                    /**< identifier: HEX, DEC or OCT */
+    int mode_data;                  /**< data bytes: HEX, DEC or OCT */
+    int canfd;                      /**< CAN FD layout (flags XRFBE) */
+    uint64_t refresh;               /**< refresh interval [usec] */
+    uint64_t deadline;              /**< next refresh [usec] */
+    int lines;                      /**< terminal height */
+    int columns;                    /**< terminal width */
+    char *screen;                   /**< contents of the screen (per line) */
+    int *length;                    /**< length of each screen line */
+    struct msg_buffer output;       /**< output buffer (one write per refresh) */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       initializes a table of CAN messages and clears the screen.
+ *
+ *  @param[out]  table      pointer to a table
+ *  @param[in]   stream     output stream (a terminal)
+ *  @param[in]   mode_id    identifier: HEX, DEC or OCT
+ *  @param[in]   mode_data  data bytes: HEX, DEC or OCT
+ *  @param[in]   canfd      non-zero for CAN FD layout (flags XRFBE)
+ *  @param[in]   refresh    refresh interval [msec]
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int tbl_init(struct msg_table *table, FILE *stream, int mode_id, int mode_data, int canfd, unsigned int refresh);
+
+/** @brief       updates the row of a CAN-ID (nothing is written).
+ *
+ *  @returns     non-zero value on success, or zero if no row could be added
+ */
+int tbl_update(struct msg_table *table, const struct msg_timestamp *timestamp,
+               unsigned long id, int flags, int dlc, int len, const unsigned char *data);
+
+/** @brief       redraws the changed characters of the table, when the refresh
+ *               interval has expired (or when forced).
+ *
+ *  @returns     non-zero value on success, or zero on a write error
+ */
+int tbl_refresh(struct msg_table *table, int force);
+
+/** @brief       redraws the table, puts the cursor below it and releases
+ *               the table.
+ */
+void tbl_exit(struct msg_table *table);
+
+
+#endif /* MSGTABLE_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
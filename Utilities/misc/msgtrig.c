@@ -0,0 +1,152 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/msgtrig.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Trigger Capture of CAN Messages (Pre- and Post-Trigger Window)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  (see header file)
+ *
+ *  includes  :  msgtrig.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ */
+/** @file        msgtrig.c
+ *
+ *  @brief       Trigger Capture of CAN Messages (Pre- and Post-Trigger Window)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @addtogroup  msg_trigger
+ *  @{
+ */
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "msgtrig.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int trig_init(struct msg_trigger *trig, size_t size, size_t pre, uint64_t post, int rearm)
+{
+    if (!trig || !size || (pre > TRIG_PRE_MAX) || (post > TRIG_POST_MAX))
+        return 0;
+    memset(trig, 0, sizeof(struct msg_trigger));
+    /* note: one more for the trigger frame */
+    if ((trig->items = (unsigned char*)malloc((pre + 1) * size)) == NULL)
+        return 0;
+    trig->size = size;
+    trig->depth = pre + 1;
+    trig->post = post;
+    trig->rearm = rearm;
+    trig->state = TRIG_ARMED;
+    return 1;
+}
+
+size_t trig_update(struct msg_trigger *trig, const void *frame, int match)
+{
+    size_t tail;
+
+    if (!trig || !trig->items || (trig->state == TRIG_DONE))
+        return 0;
+    trig->frames++;
+    /* store the frame (the oldest one is overwritten when the ring is full) */
+    tail = trig->head + trig->count;
+    if (tail >= trig->depth)
+        tail -= trig->depth;
+    memcpy(&trig->items[tail * trig->size], frame, trig->size);
+    if (trig->count < trig->depth)
+        trig->count++;
+    else if (++trig->head >= trig->depth)
+        trig->head = 0;
+    if (trig->state == TRIG_ARMED) {
+        if (!match) {
+            /* note: the ring keeps the trigger frame's slot free */
+            if (trig->count == trig->depth) {
+                trig->count--;
+                if (++trig->head >= trig->depth)
+                    trig->head = 0;
+            }
+            return 0;
+        }
+        /* trigger: the pre-trigger window and the trigger frame */
+        trig->triggers++;
+        trig->remaining = trig->post;
+        trig->state = TRIG_CAPTURING;
+    }
+    else if (trig->remaining) {
+        /* post-trigger window: the frame itself */
+        trig->remaining--;
+    }
+    if (!trig->remaining)
+        trig->state = trig->rearm ? TRIG_ARMED : TRIG_DONE;
+    trig->written += trig->count;
+    return trig->count;
+}
+
+const void *trig_next(struct msg_trigger *trig)
+{
+    const void *frame;
+
+    if (!trig || !trig->count)
+        return NULL;
+    frame = &trig->items[trig->head * trig->size];
+    if (++trig->head >= trig->depth)
+        trig->head = 0;
+    trig->count--;
+    return frame;
+}
+
+void trig_exit(struct msg_trigger *trig)
+{
+    if (!trig)
+        return;
+    free(trig->items);
+    trig->items = NULL;
+    trig->count = 0;
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
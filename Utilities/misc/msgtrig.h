@@ -0,0 +1,134 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/msgtrig.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Trigger Capture of CAN Messages (Pre- and Post-Trigger Window)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  int trig_init(struct msg_trigger *trig, size_t size, size_t pre, uint64_t post, int rearm);
+ *               size_t trig_update(struct msg_trigger *trig, const void *frame, int match);
+ *               const void *trig_next(struct msg_trigger *trig);
+ *               void trig_exit(struct msg_trigger *trig);
+ *
+ *  includes  :  (none)
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  While armed, the raw frames are stored in a preallocated ring of the
+ *  last n frames (the pre-trigger window), which is overwritten and never
+ *  written out.  When a frame matches the trigger condition, the frames
+ *  of the ring and the trigger frame are handed out, followed by the next
+ *  m frames (the post-trigger window).  Then the capture is re-armed with
+ *  an empty ring, or it is done (single shot).
+ *
+ *  The frames are copied as they are (items of a fixed size), the trigger
+ *  condition is evaluated by the caller, only while armed.
+ */
+/** @file        msgtrig.h
+ *
+ *  @brief       Trigger Capture of CAN Messages (Pre- and Post-Trigger Window)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    msg_trigger Trigger Capture of CAN Messages (Pre- and Post-Trigger Window)
+ *  @{
+ */
+#ifndef MSGTRIG_H_INCLUDED
+#define MSGTRIG_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define TRIG_ARMED      (0)         /**< waiting for the trigger */
+#define TRIG_CAPTURING  (1)         /**< post-trigger window */
+#define TRIG_DONE       (2)         /**< captured (single shot) */
+
+#define TRIG_PRE_MAX    (1048576)   /**< max. frames before the trigger */
+#define TRIG_POST_MAX   (1048576)   /**< max. frames after the trigger */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+/** trigger capture
+ */
+struct msg_trigger {
+    unsigned char *items;           /**< ring of the pre-trigger frames (preallocated) */
+    size_t size;                    /**< size of a frame (in byte) */
+    size_t depth;                   /**< number of frames in the ring (pre + 1) */
+    size_t head;                    /**< next frame to be handed out */
+    size_t count;                   /**< number of frames in the ring */
+    uint64_t post;                  /**< number of frames after the trigger */
+    uint64_t remaining;             /**< frames left in the post-trigger window */
+    int rearm;                      /**< re-arm after the post-trigger window */
+    int state;                      /**< TRIG_ARMED, TRIG_CAPTURING or TRIG_DONE */
+    uint64_t frames;                /**< number of frames seen */
+    uint64_t triggers;              /**< number of triggers */
+    uint64_t written;               /**< number of frames handed out */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       initializes a trigger capture (armed).
+ *
+ *  @param[out]  trig   pointer to the trigger capture
+ *  @param[in]   size   size of a frame (in byte)
+ *  @param[in]   pre    number of frames before the trigger (0..TRIG_PRE_MAX)
+ *  @param[in]   post   number of frames after the trigger (0..TRIG_POST_MAX)
+ *  @param[in]   rearm  re-arm after the post-trigger window (non-zero)
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int trig_init(struct msg_trigger *trig, size_t size, size_t pre, uint64_t post, int rearm);
+
+/** @brief       passes a frame to the trigger capture.
+ *
+ *  @param[in]   trig   pointer to the trigger capture
+ *  @param[in]   frame  pointer to the frame (copied)
+ *  @param[in]   match  the frame matches the trigger condition (non-zero)
+ *
+ *  @returns     number of frames to be handed out by trig_next (zero while
+ *               armed or when done)
+ */
+size_t trig_update(struct msg_trigger *trig, const void *frame, int match);
+
+/** @brief       hands out the next frame to be written (oldest first).
+ *
+ *  @returns     pointer to the frame (valid until the next call of
+ *               trig_update), or NULL when there are no more frames
+ */
+const void *trig_next(struct msg_trigger *trig);
+
+/** @brief       releases the trigger capture.
+ */
+void trig_exit(struct msg_trigger *trig);
+
+
+#endif /* MSGTRIG_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
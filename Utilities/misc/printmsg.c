@@ -39,10 +39,13 @@
 #include "printmsg.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <errno.h>
 #include <time.h>
 #ifndef _WIN32
+#include <unistd.h>
 #include <sys/time.h>
 #else
 #include <windows.h>
@@ -54,6 +57,18 @@
 #ifndef MSG_PRINT_USEC
 #define MSG_PRINT_USEC  0
 #endif
+#ifndef MSG_ENCODE_SIMD
+#define MSG_ENCODE_SIMD 1
+#endif
+#if (MSG_ENCODE_SIMD != 0)
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MSG_ENCODE_X86              /* SSE2 (baseline) and AVX2 (runtime check) */
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define MSG_ENCODE_NEON             /* NEON (baseline) */
+#include <arm_neon.h>
+#endif
+#endif
 
 /*  -----------  defines  ------------------------------------------------
  */
@@ -66,10 +81,44 @@
 /*  -----------  prototypes  ---------------------------------------------
  */
 
+static char *put_string(char *ptr, const char *str);
+static char *put_number(char *ptr, uint64_t value, unsigned int base, int width, int left);
+static char *put_time(char *ptr, int mode, struct msg_timestamp *laststamp, struct msg_timecache *timecache,
+                      const struct msg_timestamp *timestamp);
+static char *put_time_of_day(char *ptr, struct msg_timecache *timecache, long seconds, int local);
+static char *put_fraction(char *ptr, long value, int width);
+static char *put_id(char *ptr, unsigned long id, int flags, int len, const struct msg_format *format);
+static char *put_indent(char *ptr, const char *prefix, int mode, int canfd);
+
+static uint64_t get_time_usec(void);
+static int check_policy(const struct msg_buffer *buffer);
+
+static void init_encoder(void);
+static void encode_hex_scalar(char *text, const unsigned char *data, int len);
+static void encode_ascii_scalar(char *text, const unsigned char *data, int len);
+#if defined(MSG_ENCODE_X86)
+static void encode_hex_sse2(char *text, const unsigned char *data, int len);
+static void encode_ascii_sse2(char *text, const unsigned char *data, int len);
+static void encode_hex_avx2(char *text, const unsigned char *data, int len);
+static void encode_ascii_avx2(char *text, const unsigned char *data, int len);
+#elif defined(MSG_ENCODE_NEON)
+static void encode_hex_neon(char *text, const unsigned char *data, int len);
+static void encode_ascii_neon(char *text, const unsigned char *data, int len);
+#endif
+
 
 /*  -----------  variables  ----------------------------------------------
  */
 
+static char hex_table[256][3];      /* "%02X " */
+static char dec_table[256][4];      /* "%-3u " */
+static char oct_table[256][5];      /* "\\%03o " */
+static char ascii_table[256];       /* printable or '.' */
+static int encoder_ready = 0;
+
+static void (*encode_hex)(char *text, const unsigned char *data, int len) = encode_hex_scalar;
+static void (*encode_ascii)(char *text, const unsigned char *data, int len) = encode_ascii_scalar;
+
 
 /*  -----------  functions  ----------------------------------------------
  */
@@ -215,16 +264,328 @@ void msg_print_ascii(FILE *stream, unsigned char data, int mode)
 void msg_print_time(FILE *stream, struct msg_timestamp *timestamp, int mode)
 {
     static struct msg_timestamp laststamp = { 0, 0 };
-    struct timeval difftime;
-    struct tm tm; time_t t;  char timestring[25];
+    static struct msg_timecache timecache = { 0, 0, 0, 0, "" };
+    char timestring[48];
+    char *ptr;
+
+    ptr = put_time(timestring, mode, &laststamp, &timecache, timestamp);
+    (void)fwrite(timestring, 1, (size_t)(ptr - timestring), stream);
+}
+
+int msg_encode_data(char *text, const unsigned char *data, int len, int mode)
+{
+    int i;
+
+    if (!text || !data || (len <= 0))
+        return 0;
+    if (!encoder_ready)
+        init_encoder();
+
+    switch (mode) {
+    case MSG_MODE_DEC:
+        for (i = 0; i < len; i++)
+            memcpy(&text[i * 4], dec_table[data[i]], 4);
+        return len * 4;
+    case MSG_MODE_OCT:
+        for (i = 0; i < len; i++)
+            memcpy(&text[i * 5], oct_table[data[i]], 5);
+        return len * 5;
+    case MSG_MODE_HEX:
+    default:
+        encode_hex(text, data, len);
+        return len * 3;
+    }
+}
+
+int msg_encode_ascii(char *text, const unsigned char *data, int len)
+{
+    if (!text || !data || (len <= 0))
+        return 0;
+    if (!encoder_ready)
+        init_encoder();
+
+    encode_ascii(text, data, len);
+    return len;
+}
+
+void msg_format_init(struct msg_format *format, int mode_time, int mode_id, int mode_data, int mode_ascii, int canfd)
+{
+    if (!encoder_ready)
+        init_encoder();
+    if (!format)
+        return;
+    memset(format, 0, sizeof(struct msg_format));
+    format->mode_time = mode_time;
+    format->mode_id = mode_id;
+    format->mode_data = mode_data;
+    format->mode_ascii = mode_ascii;
+    format->canfd = canfd;
+}
+
+size_t msg_format_message(char *buffer, size_t size, struct msg_format *format,
+                          uint64_t counter, struct msg_timestamp *timestamp,
+                          unsigned long id, int flags, int len, const unsigned char *data)
+{
+    char text[64 * 5], ascii[64];
+    char *ptr = buffer;
+    int row, end, cell, n;
+
+    if (!buffer || !format || !timestamp || !data || (size < MSG_LINE_MAX))
+        return 0;
+    if (len < 0)
+        len = 0;
+    if (len > 64)
+        len = 64;
+
+    /* counter, time-stamp, identifier and flags */
+    ptr = put_number(ptr, counter, 10, 7, 1);
+    *ptr++ = ' ';
+    ptr = put_time(ptr, format->mode_time, &format->laststamp, &format->timecache, timestamp);
+    ptr = put_id(ptr, id, flags, len, format);
+
+    /* data bytes (and ASCII characters) in rows of 8 bytes */
+    if (!(flags & MSG_FLAG_RTR)) {
+        n = msg_encode_data(text, data, len, format->mode_data);
+        cell = (len > 0) ? (n / len) : 0;
+        if (format->mode_ascii) {
+            (void)msg_encode_ascii(ascii, data, len);
+            row = 0;
+            while ((row * 8) < len) {
+                end = len - (row * 8);
+                if (end >= 8)
+                    end = 8;
+                /* note: each cell ends with a space, so the row is always 8 cells wide */
+                memcpy(ptr, &text[row * 8 * cell], (size_t)(end * cell));
+                ptr += end * cell;
+                memset(ptr, ' ', (size_t)((8 - end) * cell));
+                ptr += (8 - end) * cell;
+                *ptr++ = ' ';
+                if (format->mode_ascii == MSG_ASCII_ON) {
+                    memcpy(ptr, &ascii[row * 8], (size_t)end);
+                    ptr += end;
+                }
+                row += 1;
+                if ((row * 8) < len)
+                    ptr = put_indent(ptr, "\n\t", format->mode_id, format->canfd);
+            }
+        }
+        else if (n > 0) {
+            memcpy(ptr, text, (size_t)n);
+            ptr += n - 1;   /* w/o trailing space */
+        }
+    }
+    else {
+        ptr = put_string(ptr, "Remote Transmit Request");
+    }
+    *ptr++ = '\n';
+    return (size_t)(ptr - buffer);
+}
+
+int msg_buffer_init(struct msg_buffer *buffer, FILE *stream, size_t size, int policy, unsigned long value)
+{
+    if (!buffer || !stream || (size < MSG_LINE_MAX))
+        return 0;
+    memset(buffer, 0, sizeof(struct msg_buffer));
+    if ((buffer->data = (char*)malloc(size)) == NULL)
+        return 0;
+    buffer->stream = stream;
+    buffer->size = size;
+    buffer->policy = policy;
+    buffer->value = value;
+    if (policy == MSG_FLUSH_TIME)
+        buffer->deadline = get_time_usec() + ((uint64_t)value * 1000ull);
+    return 1;
+}
+
+int msg_buffer_message(struct msg_buffer *buffer, struct msg_format *format,
+                       uint64_t counter, struct msg_timestamp *timestamp,
+                       unsigned long id, int flags, int len, const unsigned char *data)
+{
+    int rc = 1;
+
+    if (!buffer || !buffer->data)
+        return 0;
+    /* make room for the longest possible frame */
+    if ((buffer->size - buffer->used) < MSG_LINE_MAX)
+        rc = msg_buffer_flush(buffer);
+    buffer->used += msg_format_message(&buffer->data[buffer->used], buffer->size - buffer->used,
+                                       format, counter, timestamp, id, flags, len, data);
+    buffer->frames++;
+    /* flush policy: bytes, frames or time (or when full) */
+    if (check_policy(buffer))
+        rc = msg_buffer_flush(buffer);
+    return rc;
+}
+
+int msg_buffer_write(struct msg_buffer *buffer, const void *data, size_t length)
+{
+    int rc = 1;
+
+    if (!buffer || !buffer->data || !data || (length > MSG_LINE_MAX))
+        return 0;
+    /* make room for the record */
+    if ((buffer->size - buffer->used) < length)
+        rc = msg_buffer_flush(buffer);
+    memcpy(&buffer->data[buffer->used], data, length);
+    buffer->used += length;
+    buffer->frames++;
+    /* flush policy: bytes, frames or time (or when full) */
+    if (check_policy(buffer))
+        rc = msg_buffer_flush(buffer);
+    return rc;
+}
+
+char *msg_buffer_reserve(struct msg_buffer *buffer, size_t length)
+{
+    if (!buffer || !buffer->data || (length > MSG_LINE_MAX))
+        return NULL;
+    /* make room for the record */
+    if (((buffer->size - buffer->used) < length) && !msg_buffer_flush(buffer))
+        return NULL;
+    return &buffer->data[buffer->used];
+}
+
+int msg_buffer_commit(struct msg_buffer *buffer, size_t length)
+{
+    if (!buffer || !buffer->data || (length > (buffer->size - buffer->used)))
+        return 0;
+    buffer->used += length;
+    buffer->frames++;
+    /* flush policy: bytes, frames or time (or when full) */
+    if (check_policy(buffer))
+        return msg_buffer_flush(buffer);
+    return 1;
+}
+
+int msg_buffer_flush(struct msg_buffer *buffer)
+{
+    int rc = 1;
+
+    if (!buffer || !buffer->data)
+        return 0;
+    if ((buffer->used > 0) && buffer->sink) {
+        /* hand the buffer over and continue with an empty one */
+        char *data = buffer->sink(buffer->context, buffer->data, buffer->used);
+
+        if (data) {
+            buffer->written += (uint64_t)buffer->used;
+            buffer->data = data;
+        }
+        else
+            rc = 0;
+    }
+    else if (buffer->used > 0) {
+        /* note: anything printed by stdio must go out first */
+        (void)fflush(buffer->stream);
+#ifndef _WIN32
+        const char *ptr = buffer->data;
+        size_t left = buffer->used;
+        ssize_t n;
+
+        while (left > 0) {
+            if ((n = write(fileno(buffer->stream), ptr, left)) < 0) {
+                if (errno == EINTR)
+                    continue;
+                rc = 0;
+                break;
+            }
+            ptr += n;
+            left -= (size_t)n;
+        }
+        buffer->written += (uint64_t)(buffer->used - left);
+#else
+        if (fwrite(buffer->data, 1, buffer->used, buffer->stream) != buffer->used)
+            rc = 0;
+        else
+            buffer->written += (uint64_t)buffer->used;
+        (void)fflush(buffer->stream);
+#endif
+    }
+    buffer->used = 0;
+    buffer->frames = 0;
+    if (buffer->policy == MSG_FLUSH_TIME)
+        buffer->deadline = get_time_usec() + ((uint64_t)buffer->value * 1000ull);
+    return rc;
+}
+
+int msg_buffer_sink(struct msg_buffer *buffer, msg_sink_t sink, void *context)
+{
+    char *data;
+
+    if (!buffer || !buffer->data || !sink || buffer->sink)
+        return 0;
+    (void)msg_buffer_flush(buffer);
+    /* note: the buffers are provided by the sink from now on */
+    if ((data = sink(context, NULL, 0)) == NULL)
+        return 0;
+    free(buffer->data);
+    buffer->data = data;
+    buffer->sink = sink;
+    buffer->context = context;
+    return 1;
+}
+
+void msg_buffer_exit(struct msg_buffer *buffer)
+{
+    if (!buffer || !buffer->data)
+        return;
+    (void)msg_buffer_flush(buffer);
+    if (buffer->sink)
+        (void)buffer->sink(buffer->context, buffer->data, 0);
+    else
+        free(buffer->data);
+    buffer->data = NULL;
+    buffer->size = 0;
+}
+
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static char *put_string(char *ptr, const char *str)
+{
+    while (*str)
+        *ptr++ = *str++;
+    return ptr;
+}
+
+static char *put_number(char *ptr, uint64_t value, unsigned int base, int width, int left)
+{
+    static const char digits[] = "0123456789ABCDEF";
+    char tmp[24];
+    int n = 0;
+
+    /* note: zero-padded when right-aligned, space-padded when left-aligned */
+    do {
+        tmp[n++] = digits[value % base];
+        value /= base;
+    } while (value);
+    if (!left) {
+        for (; width > n; width--)
+            *ptr++ = '0';
+    }
+    for (width -= n; n > 0; n--)
+        *ptr++ = tmp[n - 1];
+    if (left) {
+        for (; width > 0; width--)
+            *ptr++ = ' ';
+    }
+    return ptr;
+}
+
+static char *put_time(char *ptr, int mode, struct msg_timestamp *laststamp, struct msg_timecache *timecache,
+                      const struct msg_timestamp *timestamp)
+{
+    struct msg_timestamp stamp = *timestamp;
+    struct msg_timestamp difftime;
 
     switch (mode) {
     case MSG_TIME_REL:
     case MSG_TIME_ZERO:
-        if (laststamp.tv_sec == 0)  /* first init */
-            laststamp = *timestamp;
-        difftime.tv_sec = timestamp->tv_sec - laststamp.tv_sec;
-        difftime.tv_usec = timestamp->tv_usec - laststamp.tv_usec;
+        if (laststamp->tv_sec == 0)  /* first init */
+            *laststamp = stamp;
+        difftime.tv_sec = stamp.tv_sec - laststamp->tv_sec;
+        difftime.tv_usec = stamp.tv_usec - laststamp->tv_usec;
         if (difftime.tv_usec < 0) {
             difftime.tv_sec -= 1;
             difftime.tv_usec += 1000000;
@@ -233,40 +594,370 @@ void msg_print_time(FILE *stream, struct msg_timestamp *timestamp, int mode)
             difftime.tv_sec = 0;
             difftime.tv_usec = 0;
         }
-        t = (time_t)difftime.tv_sec;
-        tm = *gmtime(&t);
-        strftime(timestring, 24, "%H:%M:%S", &tm);
+        ptr = put_time_of_day(ptr, timecache, difftime.tv_sec, 0);
+        *ptr++ = '.';
 #if (MSG_PRINT_USEC == 0)
-        fprintf(stream, "%s.%04li  ", timestring, difftime.tv_usec / 100L);
+        ptr = put_fraction(ptr, difftime.tv_usec / 100L, 4);
 #else
-        fprintf(stream, "%s.%06li  ", timestring, difftime.tv_usec);
+        ptr = put_fraction(ptr, difftime.tv_usec, 6);
 #endif
         if (mode == MSG_TIME_REL)
-            laststamp = *timestamp; /* update for delta calculation */
+            *laststamp = stamp; /* update for delta calculation */
         break;
     case MSG_TIME_ABS:
     default:
-        if (timestamp->tv_sec < 0)
-            timestamp->tv_sec = 0;
-        if (timestamp->tv_usec < 0)
-            timestamp->tv_usec = 0;
-
-        t = (time_t)timestamp->tv_sec;
-        tm = *localtime(&t);
-        strftime(timestring, 24, "%H:%M:%S", &tm);
+        if (stamp.tv_sec < 0)
+            stamp.tv_sec = 0;
+        if (stamp.tv_usec < 0)
+            stamp.tv_usec = 0;
+
+        ptr = put_time_of_day(ptr, timecache, stamp.tv_sec, 1);
+        *ptr++ = '.';
 #if (MSG_PRINT_USEC == 0)
-        fprintf(stream, "%s.%04li  ", timestring, timestamp->tv_usec / 100L);
+        ptr = put_fraction(ptr, stamp.tv_usec / 100L, 4);
 #else
-        fprintf(stream, "%s.%04li  ", timestring, timestamp->tv_usec);
+        ptr = put_fraction(ptr, stamp.tv_usec, 4);
 #endif
         break;
     }
+    *ptr++ = ' ';
+    *ptr++ = ' ';
+    return ptr;
 }
 
+static char *put_time_of_day(char *ptr, struct msg_timecache *timecache, long seconds, int local)
+{
+    struct tm tm; time_t t;
 
-/*  -----------  local functions  ----------------------------------------
- */
+    /* note: "HH:MM:SS" changes only once per second, so gmtime/localtime
+     *       and strftime are called only when the second has changed.
+     */
+    if (!timecache->valid || (timecache->tv_sec != seconds) || (timecache->local != local)) {
+        t = (time_t)seconds;
+#ifndef _WIN32
+        if (local)
+            (void)localtime_r(&t, &tm);
+        else
+            (void)gmtime_r(&t, &tm);
+#else
+        tm = local ? *localtime(&t) : *gmtime(&t);
+#endif
+        timecache->length = (int)strftime(timecache->string, sizeof(timecache->string), "%H:%M:%S", &tm);
+        timecache->tv_sec = seconds;
+        timecache->local = local;
+        timecache->valid = 1;
+    }
+    memcpy(ptr, timecache->string, (size_t)timecache->length);
+    return ptr + timecache->length;
+}
+
+static char *put_fraction(char *ptr, long value, int width)
+{
+    static const long limit[7] = { 1L, 10L, 100L, 1000L, 10000L, 100000L, 1000000L };
+    int i;
 
+    /* fixed number of digits (like "%0<width>li"), otherwise as is */
+    if ((value < 0) || (width > 6) || (value >= limit[width]))
+        return put_number(ptr, (uint64_t)((value < 0) ? 0 : value), 10, width, 0);
+    for (i = width - 1; i >= 0; i--) {
+        ptr[i] = (char)('0' + (value % 10));
+        value /= 10;
+    }
+    return ptr + width;
+}
+
+static char *put_id(char *ptr, unsigned long id, int flags, int len, const struct msg_format *format)
+{
+    switch (format->mode_id) {
+    case MSG_MODE_DEC:
+        ptr = put_number(ptr, (uint64_t)id, 10, 4, 1);
+        break;
+    case MSG_MODE_OCT:
+        *ptr++ = '\\';
+        ptr = put_number(ptr, (uint64_t)id, 8, 4, 0);
+        break;
+    case MSG_MODE_HEX:
+    default:
+        ptr = put_number(ptr, (uint64_t)id, 16, 3, 0);
+        break;
+    }
+    *ptr++ = ' ';
+    *ptr++ = (flags & MSG_FLAG_XTD) ? 'X' : ' ';
+    *ptr++ = (flags & MSG_FLAG_RTR) ? 'R' : ' ';
+    if (format->canfd) {
+        *ptr++ = (flags & MSG_FLAG_FDF) ? 'F' : ' ';
+        *ptr++ = (flags & MSG_FLAG_BRS) ? 'B' : ' ';
+        *ptr++ = (flags & MSG_FLAG_ESI) ? 'E' : ' ';
+    }
+    *ptr++ = ' ';
+    *ptr++ = '[';
+    ptr = put_number(ptr, (uint64_t)len, 10, 0, 0);
+    *ptr++ = ']';
+    *ptr++ = ' ';
+    *ptr++ = ' ';
+    return ptr;
+}
+
+static char *put_indent(char *ptr, const char *prefix, int mode, int canfd)
+{
+    int n;
+
+    /* note: same width as msg_print_indent and msg_print_indent_fd */
+    switch (mode) {
+    case MSG_MODE_DEC: n = 29; break;   /* "  HH:MM:SS.xxxx  DDDD XR [DD]  " */
+    case MSG_MODE_OCT: n = 30; break;   /* "  HH:MM:SS.xxxx  \OOOO XR [DD]  " */
+    case MSG_MODE_HEX: n = 28; break;   /* "  HH:MM:SS.xxxx  XXX XR [DD]  " */
+    default: return ptr;
+    }
+    if (canfd)
+        n += 3;                         /* flags FBE */
+    ptr = put_string(ptr, prefix);
+    for (; n > 0; n--)
+        *ptr++ = ' ';
+    return ptr;
+}
+
+static uint64_t get_time_usec(void)
+{
+#ifndef _WIN32
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return ((uint64_t)tv.tv_sec * 1000000ull) + (uint64_t)tv.tv_usec;
+#else
+    return (uint64_t)GetTickCount64() * 1000ull;
+#endif
+}
+
+static int check_policy(const struct msg_buffer *buffer)
+{
+    switch (buffer->policy) {
+    case MSG_FLUSH_BYTES:
+        return (buffer->used >= buffer->value) ? 1 : 0;
+    case MSG_FLUSH_FRAMES:
+        return (buffer->frames >= buffer->value) ? 1 : 0;
+    case MSG_FLUSH_TIME:
+        return (get_time_usec() >= buffer->deadline) ? 1 : 0;
+    case MSG_FLUSH_FULL:
+    default:
+        return 0;
+    }
+}
+
+
+static void init_encoder(void)
+{
+    int i;
+    char tmp[8];
+
+    /* 256-entry tables (same conversion as msg_print_data) */
+    for (i = 0; i < 256; i++) {
+        (void)snprintf(tmp, sizeof(tmp), "%02X ", i);
+        memcpy(hex_table[i], tmp, 3);
+        (void)snprintf(tmp, sizeof(tmp), "%-3u ", i);
+        memcpy(dec_table[i], tmp, 4);
+        (void)snprintf(tmp, sizeof(tmp), "\\%03o ", i);
+        memcpy(oct_table[i], tmp, 5);
+        ascii_table[i] = isprint(i) ? (char)i : '.';
+    }
+    /* kernels for HEX and ASCII (best one of this CPU) */
+#if defined(MSG_ENCODE_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        encode_hex = encode_hex_avx2;
+        encode_ascii = encode_ascii_avx2;
+    }
+    else {
+        encode_hex = encode_hex_sse2;
+        encode_ascii = encode_ascii_sse2;
+    }
+#elif defined(MSG_ENCODE_NEON)
+    encode_hex = encode_hex_neon;
+    encode_ascii = encode_ascii_neon;
+#else
+    encode_hex = encode_hex_scalar;
+    encode_ascii = encode_ascii_scalar;
+#endif
+    encoder_ready = 1;
+}
+
+static void encode_hex_scalar(char *text, const unsigned char *data, int len)
+{
+    int i;
+
+    for (i = 0; i < len; i++)
+        memcpy(&text[i * 3], hex_table[data[i]], 3);
+}
+
+static void encode_ascii_scalar(char *text, const unsigned char *data, int len)
+{
+    int i;
+
+    for (i = 0; i < len; i++)
+        text[i] = ascii_table[data[i]];
+}
+
+#if defined(MSG_ENCODE_X86) || defined(MSG_ENCODE_NEON)
+/* shuffle pattern: 8 digit pairs "HL" into 8 cells "HL " (0xFF = space) */
+static const unsigned char cell_lo[16] = {
+    0,1,0xFF, 2,3,0xFF, 4,5,0xFF, 6,7,0xFF, 8,9,0xFF, 10
+};
+static const unsigned char cell_hi[16] = {
+    11,0xFF, 12,13,0xFF, 14,15,0xFF, 0xFF,0xFF,0xFF,0xFF, 0xFF,0xFF,0xFF,0xFF
+};
+#endif
+
+#if defined(MSG_ENCODE_X86)
+static inline __m128i hex_digits_sse2(__m128i nibbles)
+{
+    /* '0'..'9' or 'A'..'F' (w/o table look-up) */
+    __m128i above9 = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')),
+                        _mm_and_si128(above9, _mm_set1_epi8('A' - '0' - 10)));
+}
+
+static void encode_hex_sse2(char *text, const unsigned char *data, int len)
+{
+    char pairs[32];
+    __m128i x, hi, lo;
+    int i, n;
+
+    /* note: SSE2 has no byte shuffle, the digit pairs are spread by copy */
+    for (; len >= 8; len -= n, data += n, text += n * 3) {
+        if (len >= 16) {
+            n = 16;
+            x = _mm_loadu_si128((const __m128i*)data);
+        }
+        else {
+            n = 8;
+            x = _mm_loadl_epi64((const __m128i*)data);
+        }
+        hi = hex_digits_sse2(_mm_and_si128(_mm_srli_epi16(x, 4), _mm_set1_epi8(0x0F)));
+        lo = hex_digits_sse2(_mm_and_si128(x, _mm_set1_epi8(0x0F)));
+        _mm_storeu_si128((__m128i*)&pairs[0], _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i*)&pairs[16], _mm_unpackhi_epi8(hi, lo));
+        for (i = 0; i < n; i++) {
+            text[i * 3 + 0] = pairs[i * 2 + 0];
+            text[i * 3 + 1] = pairs[i * 2 + 1];
+            text[i * 3 + 2] = ' ';
+        }
+    }
+    encode_hex_scalar(text, data, len);
+}
+
+static void encode_ascii_sse2(char *text, const unsigned char *data, int len)
+{
+    __m128i x, mask;
+
+    /* printable: 0x20..0x7E, i.e. (x - 0x20) <= 0x5E unsigned */
+    for (; len >= 16; len -= 16, data += 16, text += 16) {
+        x = _mm_loadu_si128((const __m128i*)data);
+        mask = _mm_sub_epi8(x, _mm_set1_epi8(0x20));
+        mask = _mm_cmpeq_epi8(_mm_min_epu8(mask, _mm_set1_epi8(0x5E)), mask);
+        _mm_storeu_si128((__m128i*)text, _mm_or_si128(_mm_and_si128(mask, x),
+                                                      _mm_andnot_si128(mask, _mm_set1_epi8('.'))));
+    }
+    if (len >= 8) {
+        x = _mm_loadl_epi64((const __m128i*)data);
+        mask = _mm_sub_epi8(x, _mm_set1_epi8(0x20));
+        mask = _mm_cmpeq_epi8(_mm_min_epu8(mask, _mm_set1_epi8(0x5E)), mask);
+        _mm_storel_epi64((__m128i*)text, _mm_or_si128(_mm_and_si128(mask, x),
+                                                      _mm_andnot_si128(mask, _mm_set1_epi8('.'))));
+        len -= 8, data += 8, text += 8;
+    }
+    encode_ascii_scalar(text, data, len);
+}
+
+__attribute__((target("avx2")))
+static void encode_hex_avx2(char *text, const unsigned char *data, int len)
+{
+    const __m256i digits = _mm256_setr_epi8('0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F',
+                                            '0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F');
+    const __m256i shuffle_lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)cell_lo));
+    const __m256i shuffle_hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)cell_hi));
+    const __m256i spaces_lo = _mm256_and_si256(_mm256_cmpeq_epi8(shuffle_lo, _mm256_set1_epi8((char)0xFF)), _mm256_set1_epi8(' '));
+    const __m256i spaces_hi = _mm256_and_si256(_mm256_cmpeq_epi8(shuffle_hi, _mm256_set1_epi8((char)0xFF)), _mm256_set1_epi8(' '));
+    __m128i x, hi, lo;
+    __m256i pairs, a, b;
+
+    /* 16 bytes: digit pairs of byte 0..7 in lane 0 and of byte 8..15 in lane 1 */
+    for (; len >= 16; len -= 16, data += 16, text += 48) {
+        x = _mm_loadu_si128((const __m128i*)data);
+        hi = _mm_shuffle_epi8(_mm256_castsi256_si128(digits), _mm_and_si128(_mm_srli_epi16(x, 4), _mm_set1_epi8(0x0F)));
+        lo = _mm_shuffle_epi8(_mm256_castsi256_si128(digits), _mm_and_si128(x, _mm_set1_epi8(0x0F)));
+        pairs = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi8(hi, lo)), _mm_unpackhi_epi8(hi, lo), 1);
+        a = _mm256_or_si256(_mm256_shuffle_epi8(pairs, shuffle_lo), spaces_lo);
+        b = _mm256_or_si256(_mm256_shuffle_epi8(pairs, shuffle_hi), spaces_hi);
+        _mm_storeu_si128((__m128i*)&text[0], _mm256_castsi256_si128(a));
+        _mm_storel_epi64((__m128i*)&text[16], _mm256_castsi256_si128(b));
+        _mm_storeu_si128((__m128i*)&text[24], _mm256_extracti128_si256(a, 1));
+        _mm_storel_epi64((__m128i*)&text[40], _mm256_extracti128_si256(b, 1));
+    }
+    if (len >= 8) {
+        x = _mm_loadl_epi64((const __m128i*)data);
+        hi = _mm_shuffle_epi8(_mm256_castsi256_si128(digits), _mm_and_si128(_mm_srli_epi16(x, 4), _mm_set1_epi8(0x0F)));
+        lo = _mm_shuffle_epi8(_mm256_castsi256_si128(digits), _mm_and_si128(x, _mm_set1_epi8(0x0F)));
+        x = _mm_unpacklo_epi8(hi, lo);
+        _mm_storeu_si128((__m128i*)&text[0], _mm_or_si128(_mm_shuffle_epi8(x, _mm256_castsi256_si128(shuffle_lo)),
+                                                          _mm256_castsi256_si128(spaces_lo)));
+        _mm_storel_epi64((__m128i*)&text[16], _mm_or_si128(_mm_shuffle_epi8(x, _mm256_castsi256_si128(shuffle_hi)),
+                                                           _mm256_castsi256_si128(spaces_hi)));
+        len -= 8, data += 8, text += 24;
+    }
+    encode_hex_scalar(text, data, len);
+}
+
+__attribute__((target("avx2")))
+static void encode_ascii_avx2(char *text, const unsigned char *data, int len)
+{
+    __m256i x, mask;
+
+    for (; len >= 32; len -= 32, data += 32, text += 32) {
+        x = _mm256_loadu_si256((const __m256i*)data);
+        mask = _mm256_sub_epi8(x, _mm256_set1_epi8(0x20));
+        mask = _mm256_cmpeq_epi8(_mm256_min_epu8(mask, _mm256_set1_epi8(0x5E)), mask);
+        _mm256_storeu_si256((__m256i*)text, _mm256_blendv_epi8(_mm256_set1_epi8('.'), x, mask));
+    }
+    encode_ascii_sse2(text, data, len);
+}
+#elif defined(MSG_ENCODE_NEON)
+static void encode_hex_neon(char *text, const unsigned char *data, int len)
+{
+    static const unsigned char hex_digits[16] = {
+        '0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F'
+    };
+    const uint8x16_t digits = vld1q_u8(hex_digits);
+    const uint8x16_t shuffle_lo = vld1q_u8(cell_lo);
+    const uint8x16_t shuffle_hi = vld1q_u8(cell_hi);
+    const uint8x16_t spaces_lo = vandq_u8(vceqq_u8(shuffle_lo, vdupq_n_u8(0xFF)), vdupq_n_u8(' '));
+    const uint8x16_t spaces_hi = vandq_u8(vceqq_u8(shuffle_hi, vdupq_n_u8(0xFF)), vdupq_n_u8(' '));
+    uint8x16_t hi, lo, pairs;
+    uint8x8_t x;
+
+    /* note: out-of-range indices (0xFF) yield zero with TBL */
+    for (; len >= 8; len -= 8, data += 8, text += 24) {
+        x = vld1_u8(data);
+        hi = vqtbl1q_u8(digits, vcombine_u8(vshr_n_u8(x, 4), vdup_n_u8(0)));
+        lo = vqtbl1q_u8(digits, vcombine_u8(vand_u8(x, vdup_n_u8(0x0F)), vdup_n_u8(0)));
+        pairs = vzip1q_u8(hi, lo);
+        vst1q_u8((uint8_t*)&text[0], vorrq_u8(vqtbl1q_u8(pairs, shuffle_lo), spaces_lo));
+        vst1_u8((uint8_t*)&text[16], vget_low_u8(vorrq_u8(vqtbl1q_u8(pairs, shuffle_hi), spaces_hi)));
+    }
+    encode_hex_scalar(text, data, len);
+}
+
+static void encode_ascii_neon(char *text, const unsigned char *data, int len)
+{
+    uint8x16_t x, mask;
+
+    for (; len >= 16; len -= 16, data += 16, text += 16) {
+        x = vld1q_u8(data);
+        mask = vcleq_u8(vsubq_u8(x, vdupq_n_u8(0x20)), vdupq_n_u8(0x5E));
+        vst1q_u8((uint8_t*)text, vbslq_u8(mask, x, vdupq_n_u8('.')));
+    }
+    encode_ascii_scalar(text, data, len);
+}
+#endif
 
 /** @}
  */
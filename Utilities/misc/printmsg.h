@@ -18,6 +18,18 @@
  *               void msg_print_indent(FILE *stream, const char *prefix, int mode);
  *               void msg_print_indent_fd(FILE *stream, const char *prefix, int mode);
  *               void msg_print_time(FILE *stream, struct msg_timestamp *timestamp, int mode);
+ *               int msg_encode_data(char *text, const unsigned char *data, int len, int mode);
+ *               int msg_encode_ascii(char *text, const unsigned char *data, int len);
+ *               void msg_format_init(struct msg_format *format, int mode_time, int mode_id, int mode_data, int mode_ascii, int canfd);
+ *               size_t msg_format_message(char *buffer, size_t size, struct msg_format *format, uint64_t counter, struct msg_timestamp *timestamp, unsigned long id, int flags, int len, const unsigned char *data);
+ *               int msg_buffer_init(struct msg_buffer *buffer, FILE *stream, size_t size, int policy, unsigned long value);
+ *               int msg_buffer_message(struct msg_buffer *buffer, struct msg_format *format, uint64_t counter, struct msg_timestamp *timestamp, unsigned long id, int flags, int len, const unsigned char *data);
+ *               int msg_buffer_write(struct msg_buffer *buffer, const void *data, size_t length);
+ *               char *msg_buffer_reserve(struct msg_buffer *buffer, size_t length);
+ *               int msg_buffer_commit(struct msg_buffer *buffer, size_t length);
+ *               int msg_buffer_flush(struct msg_buffer *buffer);
+ *               int msg_buffer_sink(struct msg_buffer *buffer, msg_sink_t sink, void *context);
+ *               void msg_buffer_exit(struct msg_buffer *buffer);
  *
  *  includes  :  (none)
  *
@@ -46,6 +58,8 @@
  */
 
 #include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
 
 
 /*  -----------  defines  ------------------------------------------------
@@ -62,6 +76,20 @@
 #define MSG_ASCII_OFF   (0)
 #define MSG_ASCII_ON    (1)
 
+#define MSG_FLAG_XTD    (0x01)
+#define MSG_FLAG_RTR    (0x02)
+#define MSG_FLAG_FDF    (0x04)
+#define MSG_FLAG_BRS    (0x08)
+#define MSG_FLAG_ESI    (0x10)
+
+#define MSG_FLUSH_FULL    (0)       /**< flush when the buffer is full */
+#define MSG_FLUSH_BYTES   (1)       /**< flush after n bytes */
+#define MSG_FLUSH_FRAMES  (2)       /**< flush after n frames */
+#define MSG_FLUSH_TIME    (3)       /**< flush after n milliseconds */
+
+#define MSG_LINE_MAX    (1024)      /**< max. length of one formatted frame */
+#define MSG_BUFFER_SIZE (65536)     /**< default size of the output buffer */
+
 
 /*  -----------  types  --------------------------------------------------
  */
@@ -73,6 +101,51 @@ struct msg_timestamp {
     long tv_usec;                   /**< microseconds */
 };
 
+/** time-of-day string (cached for one second)
+ */
+struct msg_timecache {
+    long tv_sec;                    /**< seconds of the cached string */
+    int local;                      /**< local time (or UTC) */
+    int valid;                      /**< cache is valid */
+    int length;                     /**< length of the string */
+    char string[24];                /**< "HH:MM:SS" */
+};
+
+/** output format of a CAN message (incl. state for relative time)
+ */
+struct msg_format {
+    int mode_time;                  /**< time-stamp: ZERO, ABS or REL */
+    int mode_id;                    /**< identifier: HEX, DEC or OCT */
+    int mode_data;                  /**< data bytes: HEX, DEC or OCT */
+    int mode_ascii;                 /**< data bytes as ASCII: ON or OFF */
+    int canfd;                      /**< CAN FD layout (flags XRFBE) */
+    struct msg_timestamp laststamp; /**< (for delta calculation) */
+    struct msg_timecache timecache; /**< (for time-of-day rendering) */
+};
+
+/** sink for filled output buffers: takes a buffer (length > 0) and returns
+ *  an empty buffer of the same size (or NULL on error, then the buffer is
+ *  not taken); with data = NULL it returns the first buffer, with length = 0
+ *  it takes back the buffer and returns NULL
+ */
+typedef char *(*msg_sink_t)(void *context, char *data, size_t length);
+
+/** output buffer for formatted CAN messages
+ */
+struct msg_buffer {
+    FILE *stream;                   /**< output stream */
+    char *data;                     /**< buffer for formatted frames */
+    size_t size;                    /**< size of the buffer */
+    size_t used;                    /**< bytes pending in the buffer */
+    int policy;                     /**< flush policy (MSG_FLUSH_xyz) */
+    unsigned long value;            /**< bytes, frames or milliseconds */
+    unsigned long frames;           /**< frames pending in the buffer */
+    uint64_t deadline;              /**< next flush time [usec] */
+    uint64_t written;               /**< bytes written to the stream */
+    msg_sink_t sink;                /**< sink for filled buffers (or NULL) */
+    void *context;                  /**< context of the sink */
+};
+
 /*  -----------  variables  ----------------------------------------------
  */
 
@@ -92,6 +165,143 @@ void msg_print_indent_fd(FILE *stream, const char *prefix, int mode);
 void msg_print_time(FILE *stream, struct msg_timestamp *timestamp, int mode);
 
 
+/** @brief       converts data bytes into text (HEX, DEC or OCT), each byte
+ *               followed by a space ("%02X ", "%-3u " or "\\%03o ").
+ *
+ *               HEX conversion uses SIMD instructions when available (SSE2,
+ *               AVX2 or NEON, selected at runtime), DEC and OCT use tables.
+ *
+ *  @param[out]  text  buffer for the text (5 characters per data byte)
+ *  @param[in]   data  data bytes
+ *  @param[in]   len   number of data bytes (0..64)
+ *  @param[in]   mode  conversion: HEX, DEC or OCT
+ *
+ *  @returns     number of characters written (w/o zero terminator)
+ */
+int msg_encode_data(char *text, const unsigned char *data, int len, int mode);
+
+/** @brief       converts data bytes into ASCII characters (non-printable
+ *               characters are replaced by '.').
+ *
+ *  @param[out]  text  buffer for the text (1 character per data byte)
+ *  @param[in]   data  data bytes
+ *  @param[in]   len   number of data bytes (0..64)
+ *
+ *  @returns     number of characters written (w/o zero terminator)
+ */
+int msg_encode_ascii(char *text, const unsigned char *data, int len);
+
+
+/** @brief       initializes the output format of CAN messages.
+ *
+ *  @param[out]  format      pointer to an output format
+ *  @param[in]   mode_time   time-stamp: ZERO, ABS or REL
+ *  @param[in]   mode_id     identifier: HEX, DEC or OCT
+ *  @param[in]   mode_data   data bytes: HEX, DEC or OCT
+ *  @param[in]   mode_ascii  data bytes as ASCII: ON or OFF
+ *  @param[in]   canfd       non-zero for CAN FD layout (flags XRFBE)
+ */
+void msg_format_init(struct msg_format *format, int mode_time, int mode_id, int mode_data, int mode_ascii, int canfd);
+
+/** @brief       formats a CAN message (counter, time-stamp, identifier, flags,
+ *               data bytes and ASCII characters) into a caller buffer.
+ *
+ *               The result is identical to the output of msg_print_xyz.
+ *
+ *  @param[out]  buffer     buffer for the formatted CAN message
+ *  @param[in]   size       size of the buffer (at least MSG_LINE_MAX)
+ *  @param[in]   format     pointer to an output format
+ *  @param[in]   counter    message counter
+ *  @param[in]   timestamp  time-stamp of the CAN message
+ *  @param[in]   id         CAN identifier
+ *  @param[in]   flags      message flags (MSG_FLAG_xyz)
+ *  @param[in]   len        data length (0..64)
+ *  @param[in]   data       data bytes
+ *
+ *  @returns     number of characters written, or zero if the buffer is too small
+ */
+size_t msg_format_message(char *buffer, size_t size, struct msg_format *format,
+                          uint64_t counter, struct msg_timestamp *timestamp,
+                          unsigned long id, int flags, int len, const unsigned char *data);
+
+
+/** @brief       initializes an output buffer for formatted CAN messages.
+ *
+ *  @param[out]  buffer  pointer to an output buffer
+ *  @param[in]   stream  output stream
+ *  @param[in]   size    size of the buffer (at least MSG_LINE_MAX)
+ *  @param[in]   policy  flush policy (MSG_FLUSH_xyz)
+ *  @param[in]   value   bytes, frames or milliseconds (depending on the policy)
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int msg_buffer_init(struct msg_buffer *buffer, FILE *stream, size_t size, int policy, unsigned long value);
+
+/** @brief       formats a CAN message into the output buffer and flushes the
+ *               buffer according to its flush policy.
+ *
+ *  @returns     non-zero value on success, or zero on a write error
+ */
+int msg_buffer_message(struct msg_buffer *buffer, struct msg_format *format,
+                       uint64_t counter, struct msg_timestamp *timestamp,
+                       unsigned long id, int flags, int len, const unsigned char *data);
+
+/** @brief       copies a pre-encoded record (e.g. a binary record) into the
+ *               output buffer and flushes the buffer according to its flush
+ *               policy.
+ *
+ *  @param[in]   buffer  pointer to an output buffer
+ *  @param[in]   data    record to be written
+ *  @param[in]   length  length of the record (at most MSG_LINE_MAX)
+ *
+ *  @returns     non-zero value on success, or zero on a write error
+ */
+int msg_buffer_write(struct msg_buffer *buffer, const void *data, size_t length);
+
+/** @brief       makes room for a record that is formatted in place (the
+ *               buffer is flushed if there is not enough room left).
+ *
+ *  @param[in]   buffer  pointer to an output buffer
+ *  @param[in]   length  max. length of the record (at most MSG_LINE_MAX)
+ *
+ *  @returns     pointer to the free space of the buffer, or NULL on a write
+ *               error
+ */
+char *msg_buffer_reserve(struct msg_buffer *buffer, size_t length);
+
+/** @brief       takes over a record formatted in place (after a call of
+ *               msg_buffer_reserve) and flushes the buffer according to its
+ *               flush policy.
+ *
+ *  @param[in]   buffer  pointer to an output buffer
+ *  @param[in]   length  length of the record (at most the reserved length)
+ *
+ *  @returns     non-zero value on success, or zero on a write error
+ */
+int msg_buffer_commit(struct msg_buffer *buffer, size_t length);
+
+/** @brief       writes all pending frames to the output stream (with one write).
+ *
+ *  @returns     non-zero value on success, or zero on a write error
+ */
+int msg_buffer_flush(struct msg_buffer *buffer);
+
+/** @brief       hands the filled buffers to a sink (e.g. an asynchronous
+ *               writer) instead of writing them to the output stream.
+ *
+ *  @param[in]   buffer   pointer to an output buffer
+ *  @param[in]   sink     sink for filled buffers (buffers of the same size)
+ *  @param[in]   context  context of the sink
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int msg_buffer_sink(struct msg_buffer *buffer, msg_sink_t sink, void *context);
+
+/** @brief       flushes and releases an output buffer.
+ */
+void msg_buffer_exit(struct msg_buffer *buffer);
+
+
 #endif /* PRINTMSG_H_INCLUDED */
 /** @}
  */
@@ -0,0 +1,261 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/ringbuf.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Lock-free Ring Buffer (Single Producer, Single Consumer)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  (see header file)
+ *
+ *  includes  :  ringbuf.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ */
+/** @file        ringbuf.c
+ *
+ *  @brief       Lock-free Ring Buffer (Single Producer, Single Consumer)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @addtogroup  ring_buf
+ *  @{
+ */
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "ringbuf.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define LOAD(ptr, order)        __atomic_load_n(ptr, order)
+#define STORE(ptr, val, order)  __atomic_store_n(ptr, val, order)
+#define CAS(ptr, exp, val)      __atomic_compare_exchange_n(ptr, exp, val, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+#define RING_BLOCK_DELAY        (100000L)  /* 100us [nsec] */
+
+#define ITEM(ring, index)       (&(ring)->items[((index) & (ring)->mask) * (ring)->size])
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static void deadline(struct timespec *abstime, unsigned int milliseconds);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int ring_init(struct ring_buffer *ring, size_t depth, size_t size, int policy)
+{
+    uint64_t n = RING_DEPTH_MIN;
+
+    if (!ring || (size == 0) || (depth > RING_DEPTH_MAX))
+        return 0;
+    if ((policy != RING_DROP_NEWEST) && (policy != RING_DROP_OLDEST) && (policy != RING_BLOCK))
+        return 0;
+    while (n < (uint64_t)depth)
+        n <<= 1;
+    memset(ring, 0, sizeof(struct ring_buffer));
+    if ((ring->items = (unsigned char*)calloc((size_t)n, size)) == NULL)
+        return 0;
+    ring->size = size;
+    ring->depth = n;
+    ring->mask = n - 1;
+    ring->policy = policy;
+    ring->wakeup = ring;
+    if (pthread_mutex_init(&ring->mutex, NULL) != 0) {
+        free(ring->items);
+        ring->items = NULL;
+        return 0;
+    }
+    if (pthread_cond_init(&ring->cond, NULL) != 0) {
+        pthread_mutex_destroy(&ring->mutex);
+        free(ring->items);
+        ring->items = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+int ring_push(struct ring_buffer *ring, const void *item)
+{
+    uint64_t head = ring->head;     /* (written by the producer only) */
+    struct timespec delay = { 0, RING_BLOCK_DELAY };
+    int waited = 0;
+
+    while ((head - ring->tail_cache) >= ring->depth) {
+        /* looks full: fetch the consumer index again */
+        ring->tail_cache = LOAD(&ring->tail, __ATOMIC_ACQUIRE);
+        if ((head - ring->tail_cache) < ring->depth)
+            break;
+        switch (ring->policy) {
+        case RING_DROP_OLDEST:
+            /* note: the consumer may take the same item at the same time */
+            if (CAS(&ring->tail, &ring->tail_cache, ring->tail_cache + 1)) {
+                ring->tail_cache += 1;
+                ring->dropped_oldest++;
+            }
+            break;
+        case RING_BLOCK:
+            if (!waited++)
+                ring->blocked++;
+            (void)nanosleep(&delay, NULL);
+            break;
+        case RING_DROP_NEWEST:
+        default:
+            ring->dropped_newest++;
+            return 0;
+        }
+    }
+    memcpy(ITEM(ring, head), item, ring->size);
+    STORE(&ring->head, head + 1, __ATOMIC_SEQ_CST);
+    /* wake up the consumer (only when it is sleeping) */
+    if (LOAD(&ring->wakeup->waiting, __ATOMIC_SEQ_CST)) {
+        pthread_mutex_lock(&ring->wakeup->mutex);
+        pthread_cond_signal(&ring->wakeup->cond);
+        pthread_mutex_unlock(&ring->wakeup->mutex);
+    }
+    return 1;
+}
+
+int ring_pop(struct ring_buffer *ring, void *item)
+{
+    uint64_t tail;
+
+    for (;;) {
+        tail = LOAD(&ring->tail, __ATOMIC_ACQUIRE);
+        if (tail == LOAD(&ring->head, __ATOMIC_ACQUIRE))
+            return 0;
+        memcpy(item, ITEM(ring, tail), ring->size);
+        if (ring->policy != RING_DROP_OLDEST) {
+            STORE(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+            return 1;
+        }
+        /* the item is only valid if it was not dropped meanwhile */
+        if (CAS(&ring->tail, &tail, tail + 1))
+            return 1;
+    }
+}
+
+void ring_wait(struct ring_buffer *ring, unsigned int milliseconds)
+{
+    struct timespec abstime;
+
+    deadline(&abstime, milliseconds);
+    pthread_mutex_lock(&ring->mutex);
+    STORE(&ring->waiting, 1, __ATOMIC_SEQ_CST);
+    if ((LOAD(&ring->head, __ATOMIC_SEQ_CST) == LOAD(&ring->tail, __ATOMIC_SEQ_CST)) &&
+        !LOAD(&ring->closed, __ATOMIC_SEQ_CST))
+        (void)pthread_cond_timedwait(&ring->cond, &ring->mutex, &abstime);
+    STORE(&ring->waiting, 0, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&ring->mutex);
+}
+
+int ring_group(struct ring_buffer *rings, int count)
+{
+    int i;
+
+    if (!rings || (count < 1))
+        return 0;
+    for (i = 0; i < count; i++)
+        rings[i].wakeup = &rings[0];
+    return 1;
+}
+
+void ring_wait_group(struct ring_buffer *rings, int count, unsigned int milliseconds)
+{
+    struct timespec abstime;
+    int i, closed = 0;
+
+    deadline(&abstime, milliseconds);
+    /* note: the producers of the group wake up the consumer by the first ring buffer */
+    pthread_mutex_lock(&rings[0].mutex);
+    STORE(&rings[0].waiting, 1, __ATOMIC_SEQ_CST);
+    for (i = 0; i < count; i++) {
+        if (LOAD(&rings[i].head, __ATOMIC_SEQ_CST) != LOAD(&rings[i].tail, __ATOMIC_SEQ_CST))
+            break;
+        closed += LOAD(&rings[i].closed, __ATOMIC_SEQ_CST) ? 1 : 0;
+    }
+    if ((i == count) && (closed < count))
+        (void)pthread_cond_timedwait(&rings[0].cond, &rings[0].mutex, &abstime);
+    STORE(&rings[0].waiting, 0, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&rings[0].mutex);
+}
+
+void ring_close(struct ring_buffer *ring)
+{
+    pthread_mutex_lock(&ring->wakeup->mutex);
+    STORE(&ring->closed, 1, __ATOMIC_SEQ_CST);
+    pthread_cond_signal(&ring->wakeup->cond);
+    pthread_mutex_unlock(&ring->wakeup->mutex);
+}
+
+int ring_closed(struct ring_buffer *ring)
+{
+    return LOAD(&ring->closed, __ATOMIC_ACQUIRE);
+}
+
+void ring_exit(struct ring_buffer *ring)
+{
+    if (!ring || !ring->items)
+        return;
+    pthread_cond_destroy(&ring->cond);
+    pthread_mutex_destroy(&ring->mutex);
+    free(ring->items);
+    ring->items = NULL;
+}
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static void deadline(struct timespec *abstime, unsigned int milliseconds)
+{
+    struct timeval now;
+
+    gettimeofday(&now, NULL);
+    abstime->tv_sec = now.tv_sec + (time_t)(milliseconds / 1000U);
+    abstime->tv_nsec = ((long)now.tv_usec * 1000L) + ((long)(milliseconds % 1000U) * 1000000L);
+    if (abstime->tv_nsec >= 1000000000L) {
+        abstime->tv_sec += 1;
+        abstime->tv_nsec -= 1000000000L;
+    }
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,178 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/ringbuf.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Lock-free Ring Buffer (Single Producer, Single Consumer)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  int ring_init(struct ring_buffer *ring, size_t depth, size_t size, int policy);
+ *               int ring_push(struct ring_buffer *ring, const void *item);
+ *               int ring_pop(struct ring_buffer *ring, void *item);
+ *               void ring_wait(struct ring_buffer *ring, unsigned int milliseconds);
+ *               int ring_group(struct ring_buffer *rings, int count);
+ *               void ring_wait_group(struct ring_buffer *rings, int count, unsigned int milliseconds);
+ *               void ring_close(struct ring_buffer *ring);
+ *               int ring_closed(struct ring_buffer *ring);
+ *               void ring_exit(struct ring_buffer *ring);
+ *
+ *  includes  :  <stdint.h>, <stddef.h>, <pthread.h>
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  The ring buffer passes items of fixed size from one producer thread to
+ *  one consumer thread.  Both indexes are on their own cache line and the
+ *  items are preallocated, so push and pop do not lock nor allocate.  The
+ *  consumer may sleep while the ring buffer is empty (ring_wait); it gets
+ *  woken up by the producer only when it is actually sleeping.  A consumer
+ *  of several ring buffers (one producer each) may sleep until any of them
+ *  is not empty (ring_group and ring_wait_group).
+ *
+ *  When the ring buffer is full, the overflow policy decides:
+ *  - RING_DROP_NEWEST: the new item is discarded;
+ *  - RING_DROP_OLDEST: the oldest item is discarded to make room;
+ *  - RING_BLOCK: the producer waits until the consumer made room.
+ */
+/** @file        ringbuf.h
+ *
+ *  @brief       Lock-free Ring Buffer (Single Producer, Single Consumer)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    ring_buf Lock-free Ring Buffer (SPSC)
+ *  @{
+ */
+#ifndef RINGBUF_H_INCLUDED
+#define RINGBUF_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define RING_DROP_NEWEST  (0)       /**< discard the new item when full */
+#define RING_DROP_OLDEST  (1)       /**< discard the oldest item when full */
+#define RING_BLOCK        (2)       /**< wait for room when full */
+
+#define RING_DEPTH_MIN    (2)       /**< min. number of items */
+#define RING_DEPTH_MAX    (1 << 24) /**< max. number of items */
+
+#define RING_CACHE_LINE   (64)      /**< (to avoid false sharing) */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+/** lock-free ring buffer (single producer, single consumer)
+ */
+struct ring_buffer {
+    /* producer side */
+    uint64_t head __attribute__((aligned(RING_CACHE_LINE)));  /**< next item to be written */
+    uint64_t tail_cache;            /**< (last seen consumer index) */
+    uint64_t dropped_newest;        /**< items discarded (new ones) */
+    uint64_t dropped_oldest;        /**< items discarded (old ones) */
+    uint64_t blocked;               /**< pushes that had to wait */
+    /* consumer side */
+    uint64_t tail __attribute__((aligned(RING_CACHE_LINE)));  /**< next item to be read */
+    int waiting;                    /**< consumer is sleeping */
+    int closed;                     /**< producer has finished */
+    struct ring_buffer *wakeup;     /**< ring buffer whose consumer is woken up (itself or the first of a group) */
+    /* read-only after initialization */
+    unsigned char *items __attribute__((aligned(RING_CACHE_LINE)));  /**< preallocated items */
+    size_t size;                    /**< size of one item */
+    uint64_t depth;                 /**< number of items (power of 2) */
+    uint64_t mask;                  /**< depth - 1 */
+    int policy;                     /**< overflow policy (RING_xyz) */
+    pthread_mutex_t mutex;          /**< (for waking up the consumer) */
+    pthread_cond_t cond;            /**< (for waking up the consumer) */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       initializes a ring buffer.
+ *
+ *  @param[out]  ring    pointer to a ring buffer
+ *  @param[in]   depth   number of items (rounded up to a power of 2)
+ *  @param[in]   size    size of one item
+ *  @param[in]   policy  overflow policy (RING_xyz)
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int ring_init(struct ring_buffer *ring, size_t depth, size_t size, int policy);
+
+/** @brief       puts an item into the ring buffer (producer only).
+ *
+ *  @returns     non-zero value if the item was queued, or zero if it was
+ *               discarded (overflow policy RING_DROP_NEWEST)
+ */
+int ring_push(struct ring_buffer *ring, const void *item);
+
+/** @brief       takes the oldest item from the ring buffer (consumer only).
+ *
+ *  @returns     non-zero value if an item was taken, or zero if the ring
+ *               buffer is empty
+ */
+int ring_pop(struct ring_buffer *ring, void *item);
+
+/** @brief       waits until the ring buffer is not empty, the producer has
+ *               finished or the time-out has expired (consumer only).
+ */
+void ring_wait(struct ring_buffer *ring, unsigned int milliseconds);
+
+/** @brief       groups several ring buffers of one consumer, so that their
+ *               producers wake up the consumer in ring_wait_group (to be
+ *               called before the producers are started).
+ *
+ *  @param[in]   rings   array of ring buffers (initialized)
+ *  @param[in]   count   number of ring buffers
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int ring_group(struct ring_buffer *rings, int count);
+
+/** @brief       waits until any ring buffer of a group is not empty, all
+ *               producers have finished or the time-out has expired
+ *               (consumer only).
+ */
+void ring_wait_group(struct ring_buffer *rings, int count, unsigned int milliseconds);
+
+/** @brief       signals that the producer has finished (producer only).
+ */
+void ring_close(struct ring_buffer *ring);
+
+/** @brief       returns non-zero if the producer has finished.  When this is
+ *               checked before ring_pop fails, the ring buffer is drained.
+ */
+int ring_closed(struct ring_buffer *ring);
+
+/** @brief       releases a ring buffer (counters are kept).
+ */
+void ring_exit(struct ring_buffer *ring);
+
+
+#endif /* RINGBUF_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,328 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/segment.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Segmented Output Files (Size- and Time-based Rotation)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  (see header file)
+ *
+ *  includes  :  segment.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ */
+/** @file        segment.c
+ *
+ *  @brief       Segmented Output Files (Size- and Time-based Rotation)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @addtogroup  seg_output
+ *  @{
+ */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE  /* fallocate */
+#endif
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "segment.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define SEG_SUFFIX      ".next"     /* file name of a prepared segment */
+#define SEG_TRIES       (100)       /* max. number of suffixes "-1", "-2", ... */
+#define SEG_RETRY       (1000000)   /* 1s [usec] */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static void *worker(void *arg);
+static int make_name(const struct seg_output *segment, time_t start, char *name, size_t size);
+static void preallocate(FILE *stream, uint64_t size);
+static void close_segment(FILE *stream);
+static uint64_t get_time_usec(void);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int seg_init(struct seg_output *segment, const char *path, const char *mode, uint64_t size, uint64_t period)
+{
+    char name[SEG_PATH_MAX];
+
+    if (!segment || !path || !mode || ((strlen(path) + sizeof(SEG_SUFFIX)) > SEG_PATH_MAX) || (strlen(mode) > 3))
+        return 0;
+    memset(segment, 0, sizeof(struct seg_output));
+    strcpy(segment->path, path);
+    strcpy(segment->mode, mode);
+    strcpy(segment->temp, path);
+    strcat(segment->temp, SEG_SUFFIX);
+    segment->size = size;
+    segment->period = period * 1000000ull;
+    /* first segment (opened now) */
+    segment->start = get_time_usec();
+    if (!make_name(segment, (time_t)(segment->start / 1000000ull), name, sizeof(name)) ||
+        ((segment->stream = fopen(name, segment->mode)) == NULL))
+        return 0;
+    segment->segments = 1;
+    /* background thread (without it segments are opened and closed in time) */
+    if ((pthread_mutex_init(&segment->mutex, NULL) == 0) &&
+        (pthread_cond_init(&segment->cond, NULL) == 0)) {
+        segment->running = 1;
+        if (pthread_create(&segment->thread, NULL, worker, (void*)segment) != 0)
+            segment->running = 0;
+    }
+    return 1;
+}
+
+int seg_due(const struct seg_output *segment, uint64_t bytes)
+{
+    if (segment->size && ((bytes - segment->offset) >= segment->size))
+        return 1;
+    if (segment->period && ((get_time_usec() - segment->start) >= segment->period))
+        return 1;
+    return 0;
+}
+
+FILE *seg_open(struct seg_output *segment)
+{
+    char name[SEG_PATH_MAX];
+    uint64_t now = get_time_usec();
+
+    if (segment->upcoming)
+        return segment->upcoming;
+    if (now < segment->retry)
+        return NULL;
+    if (segment->running) {
+        pthread_mutex_lock(&segment->mutex);
+        if (segment->retired || segment->pending) {
+            /* note: the background thread is still busy with the former segment */
+            pthread_mutex_unlock(&segment->mutex);
+            return NULL;
+        }
+        if ((segment->upcoming = segment->next) != NULL) {
+            /* prepared segment: renamed by the background thread */
+            segment->next = NULL;
+            segment->target = (time_t)(now / 1000000ull);
+            segment->pending = 1;
+            pthread_cond_signal(&segment->cond);
+        }
+        segment->failed = 0;
+        pthread_mutex_unlock(&segment->mutex);
+    }
+    if (!segment->upcoming) {
+        /* no prepared segment: open it now */
+        if (make_name(segment, (time_t)(now / 1000000ull), name, sizeof(name)))
+            segment->upcoming = fopen(name, segment->mode);
+    }
+    if (segment->upcoming)
+        segment->start = now;
+    else
+        segment->retry = now + SEG_RETRY;
+    return segment->upcoming;
+}
+
+void seg_switch(struct seg_output *segment, uint64_t bytes)
+{
+    FILE *former = segment->stream;
+
+    if (!segment->upcoming)
+        return;
+    segment->stream = segment->upcoming;
+    segment->upcoming = NULL;
+    if (segment->running) {
+        pthread_mutex_lock(&segment->mutex);
+        segment->retired = former;
+        segment->length = bytes - segment->offset;
+        pthread_cond_signal(&segment->cond);
+        pthread_mutex_unlock(&segment->mutex);
+    }
+    else
+        close_segment(former);
+    segment->offset = bytes;
+    segment->segments++;
+}
+
+void seg_exit(struct seg_output *segment)
+{
+    if (!segment || !segment->stream)
+        return;
+    if (segment->running) {
+        pthread_mutex_lock(&segment->mutex);
+        segment->running = 0;
+        pthread_cond_signal(&segment->cond);
+        pthread_mutex_unlock(&segment->mutex);
+        /* note: pending jobs are done before the thread terminates */
+        pthread_join(segment->thread, NULL);
+        pthread_cond_destroy(&segment->cond);
+        pthread_mutex_destroy(&segment->mutex);
+    }
+    if (segment->next) {
+        (void)fclose(segment->next);
+        (void)remove(segment->temp);
+        segment->next = NULL;
+    }
+    if (segment->upcoming) {
+        close_segment(segment->upcoming);
+        segment->upcoming = NULL;
+    }
+    close_segment(segment->stream);
+    segment->stream = NULL;
+}
+
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static void *worker(void *arg)
+{
+    struct seg_output *segment = (struct seg_output*)arg;
+    char name[SEG_PATH_MAX];
+    FILE *stream;
+    time_t target;
+    uint64_t size;
+    int pending;
+
+    pthread_mutex_lock(&segment->mutex);
+    for (;;) {
+        if (segment->retired || segment->pending) {
+            /* rename the taken segment and close the former one */
+            stream = segment->retired;
+            pending = segment->pending;
+            target = segment->target;
+            segment->retired = NULL;
+            segment->pending = 0;
+            pthread_mutex_unlock(&segment->mutex);
+            if (pending && make_name(segment, target, name, sizeof(name)))
+                (void)rename(segment->temp, name);
+            if (stream)
+                close_segment(stream);
+            pthread_mutex_lock(&segment->mutex);
+        }
+        else if (segment->running && !segment->next && !segment->failed) {
+            /* prepare the next segment (size of the last one, if unlimited) */
+            size = segment->size ? segment->size : segment->length;
+            pthread_mutex_unlock(&segment->mutex);
+            if ((stream = fopen(segment->temp, segment->mode)) != NULL)
+                preallocate(stream, size);
+            pthread_mutex_lock(&segment->mutex);
+            segment->next = stream;
+            segment->failed = stream ? 0 : 1;
+        }
+        else if (segment->running)
+            pthread_cond_wait(&segment->cond, &segment->mutex);
+        else
+            break;
+    }
+    pthread_mutex_unlock(&segment->mutex);
+    return NULL;
+}
+
+static int make_name(const struct seg_output *segment, time_t start, char *name, size_t size)
+{
+    const char *slash = strrchr(segment->path, '/');
+    const char *ext = strrchr(segment->path, '.');
+    char stamp[32];
+    struct tm tm;
+    struct stat st;
+    int n, i;
+
+    /* the extension starts at the last dot of the file name (if not the first character) */
+    if (!ext || (slash && (ext < slash)) || (ext == (slash ? slash + 1 : segment->path)))
+        ext = segment->path + strlen(segment->path);
+    (void)localtime_r(&start, &tm);
+    (void)strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+    for (i = 0; i < SEG_TRIES; i++) {
+        if (i == 0)
+            n = snprintf(name, size, "%.*s-%s%s", (int)(ext - segment->path), segment->path, stamp, ext);
+        else
+            n = snprintf(name, size, "%.*s-%s-%i%s", (int)(ext - segment->path), segment->path, stamp, i, ext);
+        if ((n < 0) || ((size_t)n >= size))
+            return 0;
+        if (stat(name, &st) != 0)
+            return 1;
+    }
+    return 0;
+}
+
+static void preallocate(FILE *stream, uint64_t size)
+{
+    if (size == 0)
+        return;
+#if defined(__linux__)
+    /* note: the file size is not changed (no zeros at the end of the file) */
+    (void)fallocate(fileno(stream), FALLOC_FL_KEEP_SIZE, 0, (off_t)size);
+#elif defined(__APPLE__)
+    fstore_t store = { F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, (off_t)size, 0 };
+
+    if (fcntl(fileno(stream), F_PREALLOCATE, &store) == -1) {
+        store.fst_flags = F_ALLOCATEALL;
+        (void)fcntl(fileno(stream), F_PREALLOCATE, &store);
+    }
+#else
+    (void)stream;
+#endif
+}
+
+static void close_segment(FILE *stream)
+{
+    struct stat st;
+
+    /* note: release preallocated blocks beyond the end of the file */
+    (void)fflush(stream);
+    if (fstat(fileno(stream), &st) == 0)
+        (void)ftruncate(fileno(stream), st.st_size);
+    (void)fclose(stream);
+}
+
+static uint64_t get_time_usec(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return ((uint64_t)tv.tv_sec * 1000000ull) + (uint64_t)tv.tv_usec;
+}
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
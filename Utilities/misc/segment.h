@@ -0,0 +1,153 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/segment.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Segmented Output Files (Size- and Time-based Rotation)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  int seg_init(struct seg_output *segment, const char *path, const char *mode, uint64_t size, uint64_t period);
+ *               int seg_due(const struct seg_output *segment, uint64_t bytes);
+ *               FILE *seg_open(struct seg_output *segment);
+ *               void seg_switch(struct seg_output *segment, uint64_t bytes);
+ *               void seg_exit(struct seg_output *segment);
+ *
+ *  includes  :  (none)
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  The output is written into a sequence of files (segments); a new
+ *  segment is started after a number of bytes or seconds.  Each segment
+ *  is named with its start time, e.g. "trace.txt" becomes
+ *  "trace-20250317-141502.txt" (with a suffix "-1", "-2", ... if the name
+ *  is already taken).
+ *
+ *  A background thread opens the next segment in advance and allocates
+ *  its disk space (fallocate resp. F_PREALLOCATE, without changing the
+ *  file size), and it closes, trims and renames the segments.  So the
+ *  switch to the next segment only swaps the stream on the caller side.
+ *  The caller has to finish the current segment (footer, pending data)
+ *  between seg_open and seg_switch, so each segment is a complete file.
+ */
+/** @file        segment.h
+ *
+ *  @brief       Segmented Output Files (Size- and Time-based Rotation)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    seg_output Segmented Output Files (Size- and Time-based Rotation)
+ *  @{
+ */
+#ifndef SEGMENT_H_INCLUDED
+#define SEGMENT_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define SEG_PATH_MAX    (1024)      /**< max. length of a file name */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+/** segmented output file
+ */
+struct seg_output {
+    char path[SEG_PATH_MAX];        /**< file name (w/o time-stamp) */
+    char mode[4];                   /**< open mode ("w" or "wb") */
+    uint64_t size;                  /**< max. size of a segment [byte] (or 0) */
+    uint64_t period;                /**< max. duration of a segment [usec] (or 0) */
+    FILE *stream;                   /**< current segment */
+    uint64_t start;                 /**< start time of the segment [usec] */
+    uint64_t offset;                /**< byte count at the start of the segment */
+    uint64_t length;                /**< size of the last segment [byte] */
+    uint64_t segments;              /**< number of segments */
+    FILE *upcoming;                 /**< next segment (between seg_open and seg_switch) */
+    char temp[SEG_PATH_MAX];        /**< file name of a prepared segment */
+    FILE *next;                     /**< prepared segment (or NULL) */
+    FILE *retired;                  /**< segment to be closed (or NULL) */
+    time_t target;                  /**< start time of a taken prepared segment */
+    int pending;                    /**< taken prepared segment has to be renamed */
+    int failed;                     /**< next segment could not be prepared */
+    uint64_t retry;                 /**< no new attempt to open a segment before [usec] */
+    int running;                    /**< background thread is running */
+    pthread_t thread;               /**< background thread */
+    pthread_mutex_t mutex;          /**< mutex for the jobs */
+    pthread_cond_t cond;            /**< condition for the jobs */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       opens the first segment and starts the background thread.
+ *
+ *  @param[out]  segment  pointer to a segmented output file
+ *  @param[in]   path     file name (the start time is inserted before the
+ *                        file extension)
+ *  @param[in]   mode     open mode ("w" or "wb")
+ *  @param[in]   size     max. size of a segment [byte] (0 = unlimited)
+ *  @param[in]   period   max. duration of a segment [sec] (0 = unlimited)
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int seg_init(struct seg_output *segment, const char *path, const char *mode, uint64_t size, uint64_t period);
+
+/** @brief       checks if the current segment is full or its time is over.
+ *
+ *  @param[in]   segment  pointer to a segmented output file
+ *  @param[in]   bytes    number of bytes written so far (in total)
+ *
+ *  @returns     non-zero value if a new segment is due, or zero otherwise
+ */
+int seg_due(const struct seg_output *segment, uint64_t bytes);
+
+/** @brief       takes the next segment (prepared in the background, or
+ *               opened now if there is none).
+ *
+ *  @returns     stream of the next segment, or NULL if it cannot be opened
+ *               (the current segment should be kept then)
+ */
+FILE *seg_open(struct seg_output *segment);
+
+/** @brief       makes the next segment the current one; the former segment
+ *               is closed in the background (it must have been flushed).
+ *
+ *  @param[in]   segment  pointer to a segmented output file
+ *  @param[in]   bytes    number of bytes written so far (in total)
+ */
+void seg_switch(struct seg_output *segment, uint64_t bytes);
+
+/** @brief       closes the current segment and stops the background thread
+ *               (a prepared segment is removed).
+ */
+void seg_exit(struct seg_output *segment);
+
+
+#endif /* SEGMENT_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,656 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/writeq.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Asynchronous Write Queue (io_uring resp. Writer Thread)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  (see header file)
+ *
+ *  includes  :  writeq.h
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ */
+/** @file        writeq.c
+ *
+ *  @brief       Asynchronous Write Queue (io_uring resp. Writer Thread)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @addtogroup  write_queue
+ *  @{
+ */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE  /* syscall */
+#endif
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "writeq.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+
+/*  -----------  options  ------------------------------------------------
+ */
+
+#if defined(__linux__) && defined(__NR_io_uring_setup) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define WRQ_HAVE_URING
+#include <linux/io_uring.h>
+#endif
+#endif
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define WRQ_TAG_SYNC    (0x10000)   /* user data of a FSYNC request */
+#define WRQ_TAG_CLOSE   (0x10001)   /* user data of a CLOSE request */
+#define WRQ_SQ_IDLE     (1000)      /* SQPOLL thread sleeps after 1s idle [msec] */
+#define WRQ_RETRY       (10)        /* write attempts on a stuck file */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static int thread_init(struct write_queue *queue);
+static int thread_push(struct write_queue *queue, int fd, int index, size_t length, int64_t offset);
+static void *writer(void *arg);
+static int write_all(int fd, const char *data, size_t length, int64_t offset);
+static void sync_close(int fd);
+#ifdef WRQ_HAVE_URING
+static int uring_init(struct write_queue *queue, int sqpoll);
+static int uring_push(struct write_queue *queue, int opcode, int fd, int index, size_t length, int64_t offset, int flags, uint64_t tag);
+static int uring_enter(struct write_queue *queue, unsigned submit, unsigned wait);
+static void uring_reap(struct write_queue *queue);
+static int uring_resubmit(struct write_queue *queue, int index);
+static void uring_exit(struct write_queue *queue);
+#endif
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+int wrq_init(struct write_queue *queue, int backend, size_t size, int count)
+{
+    long page = sysconf(_SC_PAGESIZE);
+    void *memory = NULL;
+    int i;
+
+    if (!queue || (size == 0) || (count < 2) || (count > WRQ_BUFFERS_MAX))
+        return 0;
+    memset(queue, 0, sizeof(struct write_queue));
+    /* note: page-aligned buffers (registered resp. pinned by the kernel) */
+    if (page <= 0)
+        page = 4096;
+    size = (size + (size_t)page - 1) & ~((size_t)page - 1);
+    if (posix_memalign(&memory, (size_t)page, size * (size_t)count) != 0)
+        return 0;
+    queue->memory = (char*)memory;
+    queue->size = size;
+    queue->count = count;
+    for (i = 0; i < count; i++)
+        queue->free[i] = count - 1 - i;
+    queue->available = count;
+    queue->fd = -1;
+    queue->ring = -1;
+#ifdef WRQ_HAVE_URING
+    /* io_uring: with a polling kernel thread (if allowed and if there is a
+     * spare CPU, a single CPU would be shared with it), otherwise without */
+    if ((backend == WRQ_AUTO) || (backend == WRQ_URING)) {
+        if (((sysconf(_SC_NPROCESSORS_ONLN) > 1) && uring_init(queue, 1)) || uring_init(queue, 0)) {
+            queue->backend = WRQ_URING;
+            return 1;
+        }
+    }
+#endif
+    /* writer thread (io_uring is not available) */
+    if ((backend != WRQ_URING) && thread_init(queue)) {
+        queue->backend = WRQ_THREAD;
+        return 1;
+    }
+    free(queue->memory);
+    queue->memory = NULL;
+    return 0;
+}
+
+int wrq_attach(struct write_queue *queue, int fd)
+{
+    struct stat st;
+    int former, dupl;
+    off_t offset;
+
+    if (!queue || !queue->memory || (fd < 0))
+        return 0;
+    if ((dupl = dup(fd)) < 0)
+        return 0;
+    former = queue->fd;
+    /* note: the former file is complete when its writes are done (a segment
+     *       may be trimmed by its owner then), the sync is not waited for */
+    if (former >= 0)
+        (void)wrq_drain(queue);
+    queue->fd = dupl;
+    /* note: positioned writes into regular files, in order into anything else */
+    offset = lseek(dupl, 0, SEEK_CUR);
+    queue->seekable = ((fstat(dupl, &st) == 0) && S_ISREG(st.st_mode) && (offset >= 0)) ? 1 : 0;
+    queue->offset = queue->seekable ? (int64_t)offset : -1;
+    if (former < 0)
+        return 1;
+    /* sync and close the former file after its pending writes */
+#ifdef WRQ_HAVE_URING
+    if (queue->backend == WRQ_URING) {
+        if (uring_push(queue, IORING_OP_FSYNC, former, -1, 0, 0, IOSQE_IO_HARDLINK, WRQ_TAG_SYNC) &&
+            uring_push(queue, IORING_OP_CLOSE, former, -1, 0, 0, 0, WRQ_TAG_CLOSE)) {
+            (void)uring_enter(queue, 2, 0);
+            return 1;
+        }
+        /* note: no room for the requests (should not happen) */
+        sync_close(former);
+        return 1;
+    }
+#endif
+    if (!thread_push(queue, former, -1, 0, -1))
+        sync_close(former);
+    return 1;
+}
+
+char *wrq_buffer(struct write_queue *queue)
+{
+    char *buffer = NULL;
+    int stalled = 0;
+
+    if (!queue || !queue->memory)
+        return NULL;
+#ifdef WRQ_HAVE_URING
+    if (queue->backend == WRQ_URING) {
+        uring_reap(queue);
+        while (queue->available == 0) {
+            /* all buffers in flight: wait for a completion */
+            stalled = 1;
+            if (uring_enter(queue, 0, 1) < 0)
+                break;
+            uring_reap(queue);
+        }
+        if (queue->available > 0)
+            buffer = queue->memory + ((size_t)queue->free[--queue->available] * queue->size);
+        queue->stalls += (uint64_t)stalled;
+        return buffer;
+    }
+#endif
+    pthread_mutex_lock(&queue->mutex);
+    while ((queue->available == 0) && queue->running) {
+        /* all buffers in flight: wait for the writer thread */
+        stalled = 1;
+        pthread_cond_wait(&queue->done, &queue->mutex);
+    }
+    if (queue->available > 0)
+        buffer = queue->memory + ((size_t)queue->free[--queue->available] * queue->size);
+    queue->stalls += (uint64_t)stalled;
+    pthread_mutex_unlock(&queue->mutex);
+    return buffer;
+}
+
+int wrq_submit(struct write_queue *queue, char *buffer, size_t length)
+{
+    int index, rc = 0;
+    int64_t offset;
+
+    if (!queue || !queue->memory || !buffer || (length == 0) || (queue->fd < 0))
+        return 0;
+    index = (int)((size_t)(buffer - queue->memory) / queue->size);
+    if ((index < 0) || (index >= queue->count) || (length > queue->size))
+        return 0;
+    offset = queue->offset;
+    queue->length[index] = length;
+    queue->written[index] = 0;
+    queue->position[index] = offset;
+    queue->retries[index] = 0;
+#ifdef WRQ_HAVE_URING
+    if (queue->backend == WRQ_URING) {
+        /* note: a pipe (no offset) is written in order of submission */
+        if (queue->fixed)
+            rc = uring_push(queue, IORING_OP_WRITE_FIXED, queue->fd, index, length, offset,
+                            queue->seekable ? 0 : IOSQE_IO_DRAIN, (uint64_t)index);
+        else
+            rc = uring_push(queue, IORING_OP_WRITE, queue->fd, index, length, offset,
+                            queue->seekable ? 0 : IOSQE_IO_DRAIN, (uint64_t)index);
+        if (rc)
+            (void)uring_enter(queue, 1, 0);
+    }
+    else
+#endif
+    rc = thread_push(queue, queue->fd, index, length, offset);
+    if (rc) {
+        if (queue->seekable)
+            queue->offset += (int64_t)length;
+        queue->writes++;
+        queue->bytes += (uint64_t)length;
+    }
+    return rc;
+}
+
+void wrq_release(struct write_queue *queue, char *buffer)
+{
+    int index;
+
+    if (!queue || !queue->memory || !buffer)
+        return;
+    index = (int)((size_t)(buffer - queue->memory) / queue->size);
+    if ((index < 0) || (index >= queue->count))
+        return;
+    if (queue->backend == WRQ_THREAD)
+        pthread_mutex_lock(&queue->mutex);
+    queue->free[queue->available++] = index;
+    if (queue->backend == WRQ_THREAD)
+        pthread_mutex_unlock(&queue->mutex);
+}
+
+int wrq_drain(struct write_queue *queue)
+{
+    uint64_t errors;
+
+    if (!queue || !queue->memory)
+        return 0;
+    errors = queue->errors;
+#ifdef WRQ_HAVE_URING
+    if (queue->backend == WRQ_URING) {
+        uring_reap(queue);
+        while (queue->writing > 0) {
+            if (uring_enter(queue, 0, 1) < 0)
+                break;
+            uring_reap(queue);
+        }
+        return (queue->errors == errors) ? 1 : 0;
+    }
+#endif
+    pthread_mutex_lock(&queue->mutex);
+    while ((queue->writing > 0) && queue->running)
+        pthread_cond_wait(&queue->done, &queue->mutex);
+    pthread_mutex_unlock(&queue->mutex);
+    return (queue->errors == errors) ? 1 : 0;
+}
+
+void wrq_exit(struct write_queue *queue)
+{
+    if (!queue || !queue->memory)
+        return;
+    (void)wrq_drain(queue);
+#ifdef WRQ_HAVE_URING
+    if (queue->backend == WRQ_URING) {
+        /* note: sync and close requests of former files */
+        while (queue->inflight > 0) {
+            if (uring_enter(queue, 0, 1) < 0)
+                break;
+            uring_reap(queue);
+        }
+        uring_exit(queue);
+    }
+#endif
+    if (queue->backend == WRQ_THREAD) {
+        pthread_mutex_lock(&queue->mutex);
+        queue->running = 0;
+        pthread_cond_signal(&queue->cond);
+        pthread_mutex_unlock(&queue->mutex);
+        pthread_join(queue->thread, NULL);
+        pthread_cond_destroy(&queue->done);
+        pthread_cond_destroy(&queue->cond);
+        pthread_mutex_destroy(&queue->mutex);
+    }
+    if (queue->fd >= 0)
+        sync_close(queue->fd);
+    queue->fd = -1;
+    free(queue->memory);
+    queue->memory = NULL;
+}
+
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static int thread_init(struct write_queue *queue)
+{
+    if (pthread_mutex_init(&queue->mutex, NULL) != 0)
+        return 0;
+    if (pthread_cond_init(&queue->cond, NULL) != 0) {
+        pthread_mutex_destroy(&queue->mutex);
+        return 0;
+    }
+    if (pthread_cond_init(&queue->done, NULL) != 0) {
+        pthread_cond_destroy(&queue->cond);
+        pthread_mutex_destroy(&queue->mutex);
+        return 0;
+    }
+    queue->running = 1;
+    if (pthread_create(&queue->thread, NULL, writer, (void*)queue) != 0) {
+        queue->running = 0;
+        pthread_cond_destroy(&queue->done);
+        pthread_cond_destroy(&queue->cond);
+        pthread_mutex_destroy(&queue->mutex);
+        return 0;
+    }
+    return 1;
+}
+
+static int thread_push(struct write_queue *queue, int fd, int index, size_t length, int64_t offset)
+{
+    struct wrq_job *job;
+
+    pthread_mutex_lock(&queue->mutex);
+    /* note: there are more jobs than buffers, so the queue is only full
+     *       with a lot of files attached in a row */
+    while (((queue->tail - queue->head) >= WRQ_JOBS) && queue->running)
+        pthread_cond_wait(&queue->done, &queue->mutex);
+    if (!queue->running) {
+        pthread_mutex_unlock(&queue->mutex);
+        return 0;
+    }
+    job = &queue->jobs[queue->tail % WRQ_JOBS];
+    job->fd = fd;
+    job->index = index;
+    job->length = length;
+    job->offset = offset;
+    if (index >= 0)
+        queue->writing++;
+    queue->tail++;
+    pthread_cond_signal(&queue->cond);
+    pthread_mutex_unlock(&queue->mutex);
+    return 1;
+}
+
+static void *writer(void *arg)
+{
+    struct write_queue *queue = (struct write_queue*)arg;
+    struct wrq_job job;
+    int ok;
+
+    pthread_mutex_lock(&queue->mutex);
+    for (;;) {
+        if (queue->head != queue->tail) {
+            /* note: the job stays in the queue until it is done (drain) */
+            job = queue->jobs[queue->head % WRQ_JOBS];
+            pthread_mutex_unlock(&queue->mutex);
+            if (job.index >= 0)
+                ok = write_all(job.fd, queue->memory + ((size_t)job.index * queue->size), job.length, job.offset);
+            else {
+                ok = ((fsync(job.fd) == 0) || (errno == EINVAL)) ? 1 : 0;
+                (void)close(job.fd);
+            }
+            pthread_mutex_lock(&queue->mutex);
+            if (!ok)
+                queue->errors++;
+            if (job.index >= 0) {
+                queue->free[queue->available++] = job.index;
+                queue->writing--;
+            }
+            queue->head++;
+            pthread_cond_broadcast(&queue->done);
+        }
+        else if (queue->running)
+            pthread_cond_wait(&queue->cond, &queue->mutex);
+        else
+            break;
+    }
+    pthread_mutex_unlock(&queue->mutex);
+    return NULL;
+}
+
+static int write_all(int fd, const char *data, size_t length, int64_t offset)
+{
+    ssize_t n;
+    int tries = 0;
+
+    while (length > 0) {
+        if (offset >= 0)
+            n = pwrite(fd, data, length, (off_t)offset);
+        else
+            n = write(fd, data, length);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return 0;
+        }
+        if ((n == 0) && (++tries >= WRQ_RETRY))
+            return 0;
+        data += n;
+        length -= (size_t)n;
+        if (offset >= 0)
+            offset += (int64_t)n;
+    }
+    return 1;
+}
+
+static void sync_close(int fd)
+{
+    (void)fsync(fd);
+    (void)close(fd);
+}
+
+#ifdef WRQ_HAVE_URING
+static int uring_init(struct write_queue *queue, int sqpoll)
+{
+    struct io_uring_params params;
+    struct iovec iov[WRQ_BUFFERS_MAX];
+    unsigned char *sq, *cq;
+    int fd, i;
+
+    memset(&params, 0, sizeof(params));
+    if (sqpoll) {
+        /* note: requires CAP_SYS_NICE before Linux 5.11 */
+        params.flags = IORING_SETUP_SQPOLL;
+        params.sq_thread_idle = WRQ_SQ_IDLE;
+    }
+    /* note: room for all buffers and the requests of a few attached files */
+    if ((fd = (int)syscall(__NR_io_uring_setup, (unsigned)WRQ_JOBS, &params)) < 0)
+        return 0;
+    queue->sq_size = params.sq_off.array + (params.sq_entries * sizeof(unsigned));
+    queue->cq_size = params.cq_off.cqes + (params.cq_entries * sizeof(struct io_uring_cqe));
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (queue->cq_size > queue->sq_size)
+            queue->sq_size = queue->cq_size;
+        queue->cq_size = queue->sq_size;
+    }
+    queue->sq_ring = mmap(NULL, queue->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (queue->sq_ring == MAP_FAILED) {
+        (void)close(fd);
+        return 0;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        queue->cq_ring = queue->sq_ring;
+    else {
+        queue->cq_ring = mmap(NULL, queue->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (queue->cq_ring == MAP_FAILED) {
+            (void)munmap(queue->sq_ring, queue->sq_size);
+            (void)close(fd);
+            return 0;
+        }
+    }
+    queue->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    queue->sqes = mmap(NULL, queue->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (queue->sqes == MAP_FAILED) {
+        if (queue->cq_ring != queue->sq_ring)
+            (void)munmap(queue->cq_ring, queue->cq_size);
+        (void)munmap(queue->sq_ring, queue->sq_size);
+        (void)close(fd);
+        return 0;
+    }
+    sq = (unsigned char*)queue->sq_ring;
+    cq = (unsigned char*)queue->cq_ring;
+    queue->sq_head = (unsigned*)(sq + params.sq_off.head);
+    queue->sq_tail = (unsigned*)(sq + params.sq_off.tail);
+    queue->sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+    queue->sq_flags = (unsigned*)(sq + params.sq_off.flags);
+    queue->sq_array = (unsigned*)(sq + params.sq_off.array);
+    queue->cq_head = (unsigned*)(cq + params.cq_off.head);
+    queue->cq_tail = (unsigned*)(cq + params.cq_off.tail);
+    queue->cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+    queue->cqes = (void*)(cq + params.cq_off.cqes);
+    queue->ring = fd;
+    queue->sqpoll = sqpoll;
+    /* registered buffers: no page mapping per request (WRITE_FIXED) */
+    for (i = 0; i < queue->count; i++) {
+        iov[i].iov_base = queue->memory + ((size_t)i * queue->size);
+        iov[i].iov_len = queue->size;
+    }
+    queue->fixed = (syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, iov, (unsigned)queue->count) == 0) ? 1 : 0;
+    return 1;
+}
+
+static int uring_push(struct write_queue *queue, int opcode, int fd, int index, size_t length, int64_t offset, int flags, uint64_t tag)
+{
+    struct io_uring_sqe *sqe;
+    unsigned tail = *queue->sq_tail;
+    unsigned head = __atomic_load_n(queue->sq_head, __ATOMIC_ACQUIRE);
+    unsigned slot;
+
+    if ((tail - head) > *queue->sq_mask)
+        return 0;
+    slot = tail & *queue->sq_mask;
+    sqe = &((struct io_uring_sqe*)queue->sqes)[slot];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    sqe->opcode = (uint8_t)opcode;
+    sqe->flags = (uint8_t)flags;
+    sqe->fd = fd;
+    if (index >= 0) {
+        /* note: after a short write the remainder of the buffer is written */
+        sqe->addr = (uint64_t)(uintptr_t)(queue->memory + ((size_t)index * queue->size) + queue->written[index]);
+        sqe->len = (uint32_t)length;
+        sqe->off = (uint64_t)offset;  /* note: -1 = current file position */
+        if (opcode == IORING_OP_WRITE_FIXED)
+            sqe->buf_index = (uint16_t)index;
+    }
+    sqe->user_data = tag;
+    queue->sq_array[slot] = slot;
+    if (index >= 0)
+        queue->writing++;
+    /* note: the entry must be visible before the tail is moved */
+    __atomic_store_n(queue->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    queue->inflight++;
+    return 1;
+}
+
+static int uring_enter(struct write_queue *queue, unsigned submit, unsigned wait)
+{
+    unsigned flags = wait ? IORING_ENTER_GETEVENTS : 0;
+    int rc;
+
+    if (queue->sqpoll) {
+        /* the kernel thread takes the entries, wake it up if it sleeps */
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(queue->sq_flags, __ATOMIC_RELAXED) & IORING_SQ_NEED_WAKEUP)
+            flags |= IORING_ENTER_SQ_WAKEUP;
+        else if (!wait)
+            return 0;
+        submit = 0;
+    }
+    do {
+        rc = (int)syscall(__NR_io_uring_enter, queue->ring, submit, wait, flags, NULL, 0);
+    } while ((rc < 0) && (errno == EINTR));
+    return rc;
+}
+
+static void uring_reap(struct write_queue *queue)
+{
+    struct io_uring_cqe *cqe;
+    unsigned head = *queue->cq_head;
+    unsigned tail = __atomic_load_n(queue->cq_tail, __ATOMIC_ACQUIRE);
+    unsigned submit = 0;
+    int index;
+
+    while (head != tail) {
+        cqe = &((struct io_uring_cqe*)queue->cqes)[head & *queue->cq_mask];
+        if (cqe->user_data < (uint64_t)queue->count) {
+            index = (int)cqe->user_data;
+            queue->writing--;
+            if (cqe->res > 0)
+                queue->written[index] += (size_t)cqe->res;
+            if ((cqe->res >= 0) && (queue->written[index] < queue->length[index]) &&
+                ((cqe->res > 0) || (++queue->retries[index] < WRQ_RETRY)) && uring_resubmit(queue, index)) {
+                /* short write: the remainder is written at the advanced offset (like write_all) */
+                submit++;
+            }
+            else {
+                /* written buffer (or failed, e.g. disk full) */
+                if ((cqe->res < 0) || (queue->written[index] != queue->length[index]))
+                    queue->errors++;
+                queue->free[queue->available++] = index;
+            }
+        }
+        else if ((cqe->user_data == WRQ_TAG_SYNC) && (cqe->res < 0) && (cqe->res != -EINVAL))
+            queue->errors++;
+        else if ((cqe->user_data == WRQ_TAG_CLOSE) && (cqe->res < 0))
+            queue->errors++;
+        queue->inflight--;
+        head++;
+    }
+    __atomic_store_n(queue->cq_head, head, __ATOMIC_RELEASE);
+    if (submit)
+        (void)uring_enter(queue, submit, 0);
+}
+
+static int uring_resubmit(struct write_queue *queue, int index)
+{
+    size_t length = queue->length[index] - queue->written[index];
+    int64_t offset = queue->position[index];
+
+    /* note: a pipe is written in order (a blocking pipe is not written short) */
+    if (offset >= 0)
+        offset += (int64_t)queue->written[index];
+    if (queue->fixed)
+        return uring_push(queue, IORING_OP_WRITE_FIXED, queue->fd, index, length, offset,
+                          (offset >= 0) ? 0 : IOSQE_IO_DRAIN, (uint64_t)index);
+    return uring_push(queue, IORING_OP_WRITE, queue->fd, index, length, offset,
+                      (offset >= 0) ? 0 : IOSQE_IO_DRAIN, (uint64_t)index);
+}
+
+static void uring_exit(struct write_queue *queue)
+{
+    if (queue->fixed)
+        (void)syscall(__NR_io_uring_register, queue->ring, IORING_UNREGISTER_BUFFERS, NULL, 0);
+    (void)munmap(queue->sqes, queue->sqes_size);
+    if (queue->cq_ring != queue->sq_ring)
+        (void)munmap(queue->cq_ring, queue->cq_size);
+    (void)munmap(queue->sq_ring, queue->sq_size);
+    (void)close(queue->ring);
+    queue->ring = -1;
+}
+#endif
+
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
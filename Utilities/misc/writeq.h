@@ -0,0 +1,204 @@
+/*  -- $HeadURL: https://svn.uv-software.net/projects/uv-software/CAN/I386/DRV/trunk/API/misc/writeq.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Asynchronous Write Queue (io_uring resp. Writer Thread)
+ *
+ *  copyright :  (C) 2025, UV Software, Berlin
+ *
+ *  compiler  :  Apple LLVM Compiler (clang)
+ *               GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  int wrq_init(struct write_queue *queue, int backend, size_t size, int count);
+ *               int wrq_attach(struct write_queue *queue, int fd);
+ *               char *wrq_buffer(struct write_queue *queue);
+ *               int wrq_submit(struct write_queue *queue, char *buffer, size_t length);
+ *               void wrq_release(struct write_queue *queue, char *buffer);
+ *               int wrq_drain(struct write_queue *queue);
+ *               void wrq_exit(struct write_queue *queue);
+ *
+ *  includes  :  (none)
+ *
+ *  author    :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  The write queue owns a fixed number of buffers.  The caller fills a
+ *  buffer and submits it; the buffer is written to the file in the
+ *  background and becomes free again afterwards.  The caller only waits
+ *  when all buffers are in flight (counted as stall).
+ *
+ *  On Linux the buffers are written with io_uring (raw system calls, no
+ *  liburing): the buffers are registered with the kernel (WRITE_FIXED),
+ *  and a kernel thread polls the submission queue (SQPOLL), if allowed
+ *  and if there is more than one CPU, so a submission usually is a store
+ *  into shared memory.  When a new file is attached (e.g. the next
+ *  segment), the pending writes of the former file are waited for, and
+ *  the file is synced and closed in the background by linked FSYNC and
+ *  CLOSE requests.
+ *
+ *  Otherwise (or when io_uring is not available) a writer thread writes
+ *  the buffers with pwrite resp. write, in the order of submission.
+ *
+ *  The queue writes to a duplicate of the file descriptor, so the caller
+ *  may close its stream after the last submission.
+ */
+/** @file        writeq.h
+ *
+ *  @brief       Asynchronous Write Queue (io_uring resp. Writer Thread)
+ *
+ *  @author      $Author: neptune $
+ *
+ *  @version     $Rev: 589 $
+ *
+ *  @defgroup    write_queue Asynchronous Write Queue (io_uring resp. Writer Thread)
+ *  @{
+ */
+#ifndef WRITEQ_H_INCLUDED
+#define WRITEQ_H_INCLUDED
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define WRQ_AUTO        (0)         /**< io_uring if available, otherwise a thread */
+#define WRQ_URING       (1)         /**< io_uring (Linux) */
+#define WRQ_THREAD      (2)         /**< writer thread (pwrite) */
+
+#define WRQ_BUFFERS     (8)         /**< default number of buffers */
+#define WRQ_BUFFERS_MAX (64)        /**< max. number of buffers */
+#define WRQ_JOBS        (128)       /**< size of the job queue (power of 2) */
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+/** job of the writer thread (write a buffer, or sync and close a file)
+ */
+struct wrq_job {
+    int fd;                         /**< file descriptor */
+    int index;                      /**< buffer index (or -1 to sync and close) */
+    size_t length;                  /**< number of bytes to be written */
+    int64_t offset;                 /**< file offset (or -1 for the current position) */
+};
+
+/** asynchronous write queue
+ */
+struct write_queue {
+    int backend;                    /**< WRQ_URING or WRQ_THREAD */
+    size_t size;                    /**< size of a buffer */
+    int count;                      /**< number of buffers */
+    char *memory;                   /**< memory of the buffers (page aligned) */
+    size_t length[WRQ_BUFFERS_MAX]; /**< bytes submitted per buffer */
+    size_t written[WRQ_BUFFERS_MAX]; /**< bytes written per buffer (short writes) */
+    int64_t position[WRQ_BUFFERS_MAX]; /**< file offset per buffer (or -1) */
+    int retries[WRQ_BUFFERS_MAX];   /**< writes of zero bytes per buffer */
+    int free[WRQ_BUFFERS_MAX];      /**< stack of free buffers */
+    int available;                  /**< number of free buffers */
+    int fd;                         /**< attached file (a duplicate) */
+    int seekable;                   /**< file supports positioned writes */
+    int64_t offset;                 /**< file offset of the next write */
+    int writing;                    /**< buffers not written yet */
+    uint64_t writes;                /**< number of submitted buffers */
+    uint64_t bytes;                 /**< number of submitted bytes */
+    uint64_t stalls;                /**< caller had to wait for a buffer */
+    uint64_t errors;                /**< number of failed requests */
+    /* io_uring */
+    int ring;                       /**< io_uring file descriptor */
+    int sqpoll;                     /**< submission queue polled by the kernel */
+    int fixed;                      /**< buffers registered with the kernel */
+    int inflight;                   /**< requests not completed */
+    void *sq_ring;                  /**< mapping of the submission queue */
+    void *cq_ring;                  /**< mapping of the completion queue */
+    void *sqes;                     /**< mapping of the submission entries */
+    size_t sq_size;                 /**< size of the submission queue mapping */
+    size_t cq_size;                 /**< size of the completion queue mapping */
+    size_t sqes_size;               /**< size of the submission entries mapping */
+    unsigned *sq_head, *sq_tail, *sq_mask, *sq_flags, *sq_array;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    void *cqes;                     /**< completion entries */
+    /* writer thread */
+    struct wrq_job jobs[WRQ_JOBS];  /**< job queue */
+    unsigned head;                  /**< next job to be done */
+    unsigned tail;                  /**< next free job */
+    int running;                    /**< writer thread is running */
+    pthread_t thread;               /**< writer thread */
+    pthread_mutex_t mutex;          /**< mutex for the jobs and buffers */
+    pthread_cond_t cond;            /**< condition for the writer thread */
+    pthread_cond_t done;            /**< condition for the caller */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+/** @brief       initializes a write queue (allocates the buffers and sets up
+ *               io_uring resp. starts the writer thread).
+ *
+ *  @param[out]  queue    pointer to a write queue
+ *  @param[in]   backend  WRQ_AUTO, WRQ_URING or WRQ_THREAD
+ *  @param[in]   size     size of a buffer
+ *  @param[in]   count    number of buffers (2..WRQ_BUFFERS_MAX)
+ *
+ *  @returns     non-zero value on success, or zero otherwise (e.g. io_uring
+ *               is requested, but not available)
+ */
+int wrq_init(struct write_queue *queue, int backend, size_t size, int count);
+
+/** @brief       attaches a file (the queue writes to a duplicate of the file
+ *               descriptor); the pending writes of the former file are
+ *               waited for, then it is synced and closed in the background.
+ *
+ *  @returns     non-zero value on success, or zero otherwise
+ */
+int wrq_attach(struct write_queue *queue, int fd);
+
+/** @brief       takes a free buffer (waits if all buffers are in flight).
+ *
+ *  @returns     pointer to a buffer of the queue's buffer size, or NULL
+ */
+char *wrq_buffer(struct write_queue *queue);
+
+/** @brief       submits a filled buffer (written to the attached file at the
+ *               next file offset).
+ *
+ *  @returns     non-zero value on success, or zero otherwise (the buffer is
+ *               still owned by the caller then)
+ */
+int wrq_submit(struct write_queue *queue, char *buffer, size_t length);
+
+/** @brief       gives back a buffer that is not submitted.
+ */
+void wrq_release(struct write_queue *queue, char *buffer);
+
+/** @brief       waits until all submitted buffers have been written.
+ *
+ *  @returns     non-zero value on success, or zero if a request failed
+ */
+int wrq_drain(struct write_queue *queue);
+
+/** @brief       syncs and closes the attached file, waits for all requests
+ *               and releases the write queue.
+ */
+void wrq_exit(struct write_queue *queue);
+
+
+#endif /* WRITEQ_H_INCLUDED */
+/** @}
+ */
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
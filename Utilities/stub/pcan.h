@@ -0,0 +1,32 @@
+/*  -- $HeadURL: https://uv-software.net/MacCAN/PCANUSB/Utilities/stub/trunk/pcan.h $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Stand-in for <pcan.h> of the PEAK-System Linux driver
+ *
+ *  copyright :  (c) 2025 by UV Software, Berlin
+ *
+ *  author(s) :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  PCANBasic.h (Linux) takes DWORD, WORD and BYTE from <pcan.h>, which is
+ *  installed with the driver.  W/o the driver this header is used, e.g.
+ *
+ *    make CFLAGS=-idirafter\ ../stub
+ *
+ *  for can_moni and can_test (an installed <pcan.h> is found first).
+ */
+#ifndef PCAN_H_STUB_INCLUDED
+#define PCAN_H_STUB_INCLUDED
+
+#include <stdint.h>
+
+typedef uint32_t DWORD;
+typedef uint16_t WORD;
+typedef uint8_t  BYTE;
+
+#endif /* PCAN_H_STUB_INCLUDED */
@@ -0,0 +1,497 @@
+/*  -- $HeadURL: https://uv-software.net/MacCAN/PCANUSB/Utilities/stub/trunk/pcanbasic.c $ --
+ *
+ *  project   :  CAN - Controller Area Network
+ *
+ *  purpose   :  Stub of the PCAN-Basic library (frame generator w/o hardware)
+ *
+ *  copyright :  (c) 2025 by UV Software, Berlin
+ *
+ *  compiler  :  GNU C/C++ Compiler (gcc)
+ *
+ *  export    :  CAN_Initialize, CAN_InitializeFD, CAN_Uninitialize, CAN_Reset,
+ *               CAN_GetStatus, CAN_Read, CAN_ReadFD, CAN_Write, CAN_WriteFD,
+ *               CAN_FilterMessages, CAN_GetValue, CAN_SetValue, CAN_GetErrorText
+ *
+ *  includes  :  PCANBasic.h
+ *
+ *  author(s) :  Uwe Vogt, UV Software
+ *
+ *  e-mail    :  uwe.vogt@uv-software.de
+ *
+ *
+ *  -----------  description  --------------------------------------------
+ *
+ *  A libpcanbasic.so for Linux that generates CAN frames instead of
+ *  talking to a PCAN interface, so that can_moni and can_test can be run
+ *  and measured w/o hardware (see the benchmarks and tests):
+ *
+ *    LD_LIBRARY_PATH=../stub STUB_FRAMES=1000 ./can_moni PCAN-USB1
+ *
+ *  Each channel generates the same sequence of CAN CC resp. CAN FD frames
+ *  (11-bit and 29-bit IDs, RTR, BRS and ESI, all DLCs), time-stamped with
+ *  1.234ms distance and an offset per channel.  When all initialized
+ *  channels have generated their frames, SIGTERM is sent to the process.
+ *
+ *  The message filter (PCAN_MESSAGE_FILTER and CAN_FilterMessages) and
+ *  the acceptance filters (PCAN_ACCEPTANCE_FILTER_11BIT/29BIT) are taken
+ *  into account like by the hardware: a removed frame is never read.
+ *
+ *  Environment variables:
+ *  - STUB_FRAMES=<n>  number of frames per channel (default 1000)
+ *  - STUB_DELAY=<us>  delay of each read call [usec] (default 0)
+ *  - STUB_REPEAT=1    payloads that repeat per CAN-ID (no RTR, max. DLC)
+ *  - STUB_RANDOM=1    random 29-bit IDs, DLCs, payloads and jitter (incompressible)
+ *  - STUB_LEAN=1      minimal frames w/o filter (cost of the read path)
+ *  - STUB_TRACE=1     print the filter settings to stderr
+ */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE  /* eventfd */
+#endif
+
+/*  -----------  includes  -----------------------------------------------
+ */
+
+#include "PCANBasic.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+
+
+/*  -----------  defines  ------------------------------------------------
+ */
+
+#define CHANNELS_MAX  (16)          /* PCAN-USB1..16 */
+#define RANGES_MAX    (64)          /* registered ID ranges per channel */
+
+#define FRAMES_DEFAULT  (1000UL)
+#define TIME_START  (1000000ULL * 3600ULL * 5ULL)   /* 05:00:00 */
+#define TIME_FRAME  (1234ULL)       /* distance of the frames [usec] */
+#define TIME_CHANNEL  (617ULL)      /* offset per channel [usec] */
+
+#define MASK_11BIT  (0x7FFU)
+#define MASK_29BIT  (0x1FFFFFFFU)
+
+
+/*  -----------  types  --------------------------------------------------
+ */
+
+struct range {
+    DWORD from, to;                 /* first and last CAN-ID */
+    TPCANMode mode;                 /* PCAN_MODE_STANDARD or _EXTENDED */
+};
+
+struct channel {
+    TPCANHandle handle;             /* channel handle (0 = unused) */
+    int initialized;                /* CAN_Initialize[FD] called */
+    int exhausted;                  /* all frames generated */
+    unsigned long index;            /* number of the channel (0..15) */
+    unsigned long count;            /* number of generated frames */
+    int event;                      /* receive event (eventfd) */
+    BYTE filter;                    /* PCAN_FILTER_OPEN/_CLOSE/_CUSTOM */
+    struct range ranges[RANGES_MAX];  /* registered ID ranges */
+    int used;                       /* number of registered ranges */
+    UINT64 acceptance[2];           /* code and mask (11-bit, 29-bit) */
+};
+
+
+/*  -----------  prototypes  ---------------------------------------------
+ */
+
+static void load_settings(void);
+static struct channel *get_channel(TPCANHandle handle);
+static int next_frame(struct channel *channel, DWORD *id, BYTE *type, BYTE *dlc, BYTE *data, int fd, UINT64 *usec);
+static void generate(unsigned long i, DWORD *id, BYTE *type, BYTE *dlc, BYTE *data, int fd);
+static UINT64 scramble(unsigned long i);
+static int accepted(const struct channel *channel, DWORD id, BYTE type);
+static void end_of_frames(struct channel *channel);
+
+
+/*  -----------  variables  ----------------------------------------------
+ */
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t once = PTHREAD_ONCE_INIT;
+static struct channel channels[CHANNELS_MAX];
+static unsigned long frames = FRAMES_DEFAULT;
+static unsigned long delay = 0UL;
+static int repeat = 0;
+static int noise = 0;
+static int lean = 0;
+static int trace = 0;
+
+
+/*  -----------  functions  ----------------------------------------------
+ */
+
+TPCANStatus CAN_Initialize(TPCANHandle Channel, TPCANBaudrate Btr0Btr1, TPCANType HwType, DWORD IOPort, WORD Interrupt)
+{
+    struct channel *channel = get_channel(Channel);
+
+    (void)Btr0Btr1;
+    (void)HwType;
+    (void)IOPort;
+    (void)Interrupt;
+    if (!channel)
+        return PCAN_ERROR_ILLHANDLE;
+    channel->initialized = 1;
+    return PCAN_ERROR_OK;
+}
+
+TPCANStatus CAN_InitializeFD(TPCANHandle Channel, TPCANBitrateFD BitrateFD)
+{
+    (void)BitrateFD;
+    return CAN_Initialize(Channel, 0, 0, 0, 0);
+}
+
+TPCANStatus CAN_Uninitialize(TPCANHandle Channel)
+{
+    struct channel *channel = get_channel(Channel);
+
+    if (!channel)
+        return PCAN_ERROR_ILLHANDLE;
+    channel->initialized = 0;
+    return PCAN_ERROR_OK;
+}
+
+TPCANStatus CAN_Reset(TPCANHandle Channel)
+{
+    return get_channel(Channel) ? PCAN_ERROR_OK : PCAN_ERROR_ILLHANDLE;
+}
+
+TPCANStatus CAN_GetStatus(TPCANHandle Channel)
+{
+    return get_channel(Channel) ? PCAN_ERROR_OK : PCAN_ERROR_ILLHANDLE;
+}
+
+TPCANStatus CAN_Read(TPCANHandle Channel, TPCANMsg* MessageBuffer, TPCANTimestamp* TimestampBuffer)
+{
+    struct channel *channel = get_channel(Channel);
+    BYTE data[64];
+    UINT64 usec;
+
+    if (!channel || !MessageBuffer)
+        return !channel ? PCAN_ERROR_ILLHANDLE : PCAN_ERROR_ILLPARAMVAL;
+    if (lean) {
+        /* note: the cost of the read path w/o a frame generator */
+        MessageBuffer->ID = 0x100U + (DWORD)(channel->count & 0x3FU);
+        MessageBuffer->MSGTYPE = PCAN_MESSAGE_STANDARD;
+        MessageBuffer->LEN = 8U;
+        memset(MessageBuffer->DATA, (int)channel->count, 8);
+        usec = channel->count++;
+    }
+    else if (!next_frame(channel, &MessageBuffer->ID, &MessageBuffer->MSGTYPE, &MessageBuffer->LEN, data, 0, &usec))
+        return PCAN_ERROR_QRCVEMPTY;
+    else
+        memcpy(MessageBuffer->DATA, data, 8);
+    if (TimestampBuffer) {
+        TimestampBuffer->millis = (DWORD)(usec / 1000ULL);
+        TimestampBuffer->millis_overflow = (WORD)((usec / 1000ULL) >> 32);
+        TimestampBuffer->micros = (WORD)(usec % 1000ULL);
+    }
+    return PCAN_ERROR_OK;
+}
+
+TPCANStatus CAN_ReadFD(TPCANHandle Channel, TPCANMsgFD* MessageBuffer, TPCANTimestampFD* TimestampBuffer)
+{
+    struct channel *channel = get_channel(Channel);
+    UINT64 usec;
+
+    if (!channel || !MessageBuffer)
+        return !channel ? PCAN_ERROR_ILLHANDLE : PCAN_ERROR_ILLPARAMVAL;
+    if (lean) {
+        MessageBuffer->ID = 0x100U + (DWORD)(channel->count & 0x3FU);
+        MessageBuffer->MSGTYPE = PCAN_MESSAGE_FD;
+        MessageBuffer->DLC = 8U;
+        memset(MessageBuffer->DATA, (int)channel->count, 8);
+        usec = channel->count++;
+    }
+    else if (!next_frame(channel, &MessageBuffer->ID, &MessageBuffer->MSGTYPE, &MessageBuffer->DLC, MessageBuffer->DATA, 1, &usec))
+        return PCAN_ERROR_QRCVEMPTY;
+    if (TimestampBuffer)
+        *TimestampBuffer = (TPCANTimestampFD)usec;
+    return PCAN_ERROR_OK;
+}
+
+TPCANStatus CAN_Write(TPCANHandle Channel, TPCANMsg* MessageBuffer)
+{
+    (void)MessageBuffer;
+    return get_channel(Channel) ? PCAN_ERROR_OK : PCAN_ERROR_ILLHANDLE;
+}
+
+TPCANStatus CAN_WriteFD(TPCANHandle Channel, TPCANMsgFD* MessageBuffer)
+{
+    (void)MessageBuffer;
+    return get_channel(Channel) ? PCAN_ERROR_OK : PCAN_ERROR_ILLHANDLE;
+}
+
+TPCANStatus CAN_FilterMessages(TPCANHandle Channel, DWORD FromID, DWORD ToID, TPCANMode Mode)
+{
+    struct channel *channel = get_channel(Channel);
+    DWORD max = (Mode == PCAN_MODE_EXTENDED) ? MASK_29BIT : MASK_11BIT;
+    TPCANStatus status = PCAN_ERROR_RESOURCE;
+
+    if (!channel)
+        return PCAN_ERROR_ILLHANDLE;
+    if (((Mode != PCAN_MODE_STANDARD) && (Mode != PCAN_MODE_EXTENDED)) || (FromID > ToID) || (ToID > max))
+        return PCAN_ERROR_ILLPARAMVAL;
+    if (trace)
+        fprintf(stderr, "STUB FilterMessages %X-%X mode %u\n", FromID, ToID, Mode);
+    /* note: a closed or open filter is custom from now on, every call adds a range */
+    pthread_mutex_lock(&mutex);
+    if (channel->filter != PCAN_FILTER_CUSTOM)
+        channel->used = 0;
+    channel->filter = PCAN_FILTER_CUSTOM;
+    if (channel->used < RANGES_MAX) {
+        channel->ranges[channel->used].from = FromID;
+        channel->ranges[channel->used].to = ToID;
+        channel->ranges[channel->used].mode = Mode;
+        channel->used++;
+        status = PCAN_ERROR_OK;
+    }
+    pthread_mutex_unlock(&mutex);
+    return status;
+}
+
+TPCANStatus CAN_GetValue(TPCANHandle Channel, TPCANParameter Parameter, void* Buffer, DWORD BufferLength)
+{
+    struct channel *channel = get_channel(Channel);
+
+    if (!Buffer || !BufferLength)
+        return PCAN_ERROR_ILLPARAMVAL;
+    memset(Buffer, 0, (BufferLength > 4U) ? 4U : BufferLength);
+    switch (Parameter) {
+    case PCAN_API_VERSION:
+        strncpy(Buffer, "stub", BufferLength);
+        return PCAN_ERROR_OK;
+    case PCAN_CHANNEL_CONDITION:
+        *(BYTE*)Buffer = channel ? PCAN_CHANNEL_AVAILABLE : PCAN_CHANNEL_UNAVAILABLE;
+        return PCAN_ERROR_OK;
+    default:
+        break;
+    }
+    if (!channel)
+        return PCAN_ERROR_ILLHANDLE;
+    switch (Parameter) {
+    case PCAN_HARDWARE_NAME:
+    case PCAN_CHANNEL_VERSION:
+        strncpy(Buffer, "stub", BufferLength);
+        break;
+    case PCAN_RECEIVE_EVENT:
+        if (BufferLength < sizeof(int))
+            return PCAN_ERROR_ILLPARAMVAL;
+        *(int*)Buffer = channel->event;
+        break;
+    case PCAN_MESSAGE_FILTER:
+        *(BYTE*)Buffer = channel->filter;
+        break;
+    case PCAN_ACCEPTANCE_FILTER_11BIT:
+    case PCAN_ACCEPTANCE_FILTER_29BIT:
+        if (BufferLength < sizeof(UINT64))
+            return PCAN_ERROR_ILLPARAMVAL;
+        memcpy(Buffer, &channel->acceptance[(Parameter == PCAN_ACCEPTANCE_FILTER_29BIT) ? 1 : 0], sizeof(UINT64));
+        break;
+    default:
+        break;
+    }
+    return PCAN_ERROR_OK;
+}
+
+TPCANStatus CAN_SetValue(TPCANHandle Channel, TPCANParameter Parameter, void* Buffer, DWORD BufferLength)
+{
+    struct channel *channel = get_channel(Channel);
+
+    if (!Buffer || !BufferLength)
+        return PCAN_ERROR_ILLPARAMVAL;
+    if (!channel)
+        return PCAN_ERROR_ILLHANDLE;
+    switch (Parameter) {
+    case PCAN_MESSAGE_FILTER:
+        if (*(BYTE*)Buffer > PCAN_FILTER_OPEN)
+            return PCAN_ERROR_ILLPARAMVAL;
+        pthread_mutex_lock(&mutex);
+        channel->filter = *(BYTE*)Buffer;
+        channel->used = 0;
+        pthread_mutex_unlock(&mutex);
+        if (trace)
+            fprintf(stderr, "STUB SetValue %X %u\n", Parameter, *(BYTE*)Buffer);
+        break;
+    case PCAN_ACCEPTANCE_FILTER_11BIT:
+    case PCAN_ACCEPTANCE_FILTER_29BIT:
+        if (BufferLength < sizeof(UINT64))
+            return PCAN_ERROR_ILLPARAMVAL;
+        memcpy(&channel->acceptance[(Parameter == PCAN_ACCEPTANCE_FILTER_29BIT) ? 1 : 0], Buffer, sizeof(UINT64));
+        if (trace)
+            fprintf(stderr, "STUB SetValue %X %016llX\n", Parameter, (unsigned long long)*(UINT64*)Buffer);
+        break;
+    default:
+        break;
+    }
+    return PCAN_ERROR_OK;
+}
+
+TPCANStatus CAN_GetErrorText(TPCANStatus Error, WORD Language, char* Buffer)
+{
+    (void)Language;
+    if (!Buffer)
+        return PCAN_ERROR_ILLPARAMVAL;
+    sprintf(Buffer, "stub error 0x%X", Error);
+    return PCAN_ERROR_OK;
+}
+
+/*  -----------  local functions  ----------------------------------------
+ */
+
+static void load_settings(void)
+{
+    const char *value;
+    int i;
+
+    if ((value = getenv("STUB_FRAMES")) != NULL)
+        frames = strtoul(value, NULL, 0);
+    if ((value = getenv("STUB_DELAY")) != NULL)
+        delay = strtoul(value, NULL, 0);
+    repeat = (getenv("STUB_REPEAT") != NULL) ? 1 : 0;
+    noise = (getenv("STUB_RANDOM") != NULL) ? 1 : 0;
+    lean = (getenv("STUB_LEAN") != NULL) ? 1 : 0;
+    trace = (getenv("STUB_TRACE") != NULL) ? 1 : 0;
+
+    for (i = 0; i < CHANNELS_MAX; i++) {
+        channels[i].handle = (i < 8) ? (TPCANHandle)(PCAN_USBBUS1 + i) : (TPCANHandle)(PCAN_USBBUS9 + (i - 8));
+        channels[i].index = (unsigned long)i;
+        channels[i].filter = PCAN_FILTER_OPEN;
+        channels[i].acceptance[0] = (UINT64)MASK_11BIT;  /* code 0, all bits don't care */
+        channels[i].acceptance[1] = (UINT64)MASK_29BIT;
+        channels[i].event = eventfd(1, EFD_NONBLOCK);
+    }
+}
+
+static struct channel *get_channel(TPCANHandle handle)
+{
+    int i;
+
+    (void)pthread_once(&once, load_settings);
+    for (i = 0; i < CHANNELS_MAX; i++)
+        if (channels[i].handle == handle)
+            return &channels[i];
+    return NULL;
+}
+
+static int next_frame(struct channel *channel, DWORD *id, BYTE *type, BYTE *dlc, BYTE *data, int fd, UINT64 *usec)
+{
+    unsigned long i;
+
+    if (delay)
+        (void)usleep((useconds_t)delay);
+    /* the frames removed by a filter are generated, but never read */
+    do {
+        if (channel->count >= frames) {
+            end_of_frames(channel);
+            return 0;
+        }
+        i = channel->count++;
+        generate(i, id, type, dlc, data, fd);
+    } while (!accepted(channel, *id, *type));
+    *usec = TIME_START + ((UINT64)i * TIME_FRAME) + (channel->index * TIME_CHANNEL) +
+            (noise ? ((scramble(i) >> 16) % TIME_FRAME) : ((UINT64)(i % 7UL) * 3ULL));
+    return 1;
+}
+
+static void generate(unsigned long i, DWORD *id, BYTE *type, BYTE *dlc, BYTE *data, int fd)
+{
+    int j;
+
+    *id = ((i % 3UL) == 0UL) ? (DWORD)(0x18FF0000UL + (i % 7UL)) : (DWORD)(0x100UL + (i % 11UL));
+    *type = ((i % 3UL) == 0UL) ? PCAN_MESSAGE_EXTENDED : PCAN_MESSAGE_STANDARD;
+    if ((i % 13UL) == 5UL)
+        *type |= PCAN_MESSAGE_RTR;
+    if (fd) {
+        *type |= PCAN_MESSAGE_FD;
+        if (i % 2UL)
+            *type |= PCAN_MESSAGE_BRS;
+        if ((i % 17UL) == 3UL)
+            *type |= PCAN_MESSAGE_ESI;
+        *dlc = (BYTE)(i % 16UL);
+    }
+    else
+        *dlc = (BYTE)((i % 16UL) % 9UL);
+    /* note: every 20th frame has a changed byte 2 (change detection) */
+    for (j = 0; j < 64; j++)
+        data[j] = (BYTE)(((i / 4UL) * 7UL) + ((unsigned long)j * 31UL) + (((j == 2) && ((i % 20UL) == 0UL)) ? 1UL : 0UL));
+    if (repeat) {
+        *type &= (BYTE)~PCAN_MESSAGE_RTR;
+        *dlc = fd ? 15U : 8U;
+        for (j = 0; j < 64; j++)
+            data[j] = (BYTE)(*id + (DWORD)j + (((i % 50UL) == 0UL) ? (DWORD)i : 0U));
+    }
+    if (noise) {
+        /* note: about every 2nd data byte is zero (a random mask of changed bytes) */
+        UINT64 x = scramble(i);
+        *id = (DWORD)(x >> 32) & MASK_29BIT;
+        *type = (*type & (BYTE)~(PCAN_MESSAGE_RTR | PCAN_MESSAGE_STANDARD)) | PCAN_MESSAGE_EXTENDED;
+        *dlc = (BYTE)((x >> 8) % (fd ? 16U : 9U));
+        for (j = 0; j < 64; j++) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            data[j] = (x & 0x80000000ULL) ? (BYTE)(x >> 40) : 0x00U;
+        }
+    }
+}
+
+static UINT64 scramble(unsigned long i)
+{
+    /* note: xorshift seeded by the frame number (same sequence per channel) */
+    UINT64 x = ((UINT64)i + 1ULL) * 0x9E3779B97F4A7C15ULL;
+
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    return x;
+}
+
+static int accepted(const struct channel *channel, DWORD id, BYTE type)
+{
+    int xtd = (type & PCAN_MESSAGE_EXTENDED) ? 1 : 0;
+    DWORD code = (DWORD)(channel->acceptance[xtd] >> 32);
+    DWORD mask = (DWORD)(channel->acceptance[xtd] & 0xFFFFFFFFULL);
+    TPCANMode mode = xtd ? PCAN_MODE_EXTENDED : PCAN_MODE_STANDARD;
+    int i;
+
+    /* acceptance filter: mask bits set to 1 are don't care */
+    if ((id ^ code) & ~mask & (xtd ? MASK_29BIT : MASK_11BIT))
+        return 0;
+    /* message filter: only the registered ranges of the frame format */
+    if (channel->filter == PCAN_FILTER_OPEN)
+        return 1;
+    for (i = 0; i < channel->used; i++)
+        if ((channel->ranges[i].mode == mode) && (channel->ranges[i].from <= id) && (id <= channel->ranges[i].to))
+            return 1;
+    return 0;
+}
+
+static void end_of_frames(struct channel *channel)
+{
+    int i, done = 1;
+
+    /* note: the receive event stays signaled, so that a reader which
+     *       waits w/o time-out gets back to its loop (and the signal) */
+    if (channel->exhausted)
+        return;
+    channel->exhausted = 1;
+    /* the end of the program, when all channels are done */
+    pthread_mutex_lock(&mutex);
+    for (i = 0; i < CHANNELS_MAX; i++)
+        if (channels[i].initialized && !channels[i].exhausted)
+            done = 0;
+    pthread_mutex_unlock(&mutex);
+    if (done)
+        (void)kill(getpid(), SIGTERM);
+}
+
+/*  ----------------------------------------------------------------------
+ *  Uwe Vogt,  UV Software,  Chausseestrasse 33 A,  10115 Berlin,  Germany
+ *  Tel.: +49-30-46799872,  Fax: +49-30-46799873,  Mobile: +49-170-3801903
+ *  E-Mail: uwe.vogt@uv-software.de,  Homepage: http://www.uv-software.de/
+ */
@@ -0,0 +1,52 @@
+#!/bin/sh
+#
+#	Acceptance filter derived from the CAN-IDs (can_moni and can_test)
+#
+#	An exclusion resp. a filter that restricts only the 11-bit IDs must
+#	not drop the extended frames: the message filter of the library is
+#	one for both frame formats (custom mode passes registered IDs only).
+#	The stub applies the filters like the hardware.
+#
+#	Copyright (c) 2025  Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+#
+CAN_MONI=${CAN_MONI:-../can_moni/can_moni}
+CAN_TEST=${CAN_TEST:-../can_test/can_test}
+STUB_DIR=${STUB_DIR:-../stub}
+FRAMES=300
+OUTPUT=${TMPDIR:-/tmp}/test_acceptance.$$
+rc=0
+
+# count the printed frames by format (column 3 is the CAN-ID in HEX)
+count() {
+	awk -v pass="$1" '
+	function hex(s,   i, n) { n = 0; for (i = 1; i <= length(s); i++) n = n * 16 + index("0123456789ABCDEF", substr(s, i, 1)) - 1; return n }
+	/^[0-9]+[ \t]/ { id = hex($3); if (pass == "all" || id <= 261 || id >= 2048) { n++; if (id > 2047) x++ } }
+	END { printf("%d %d\n", n, x) }' $OUTPUT
+}
+
+# reference: all frames of the stub, filtered here (11-bit IDs 0x106-0x7FF removed)
+LD_LIBRARY_PATH=$STUB_DIR STUB_FRAMES=$FRAMES $CAN_MONI PCAN-USB1 >$OUTPUT 2>/dev/null
+set -- $(count some); expected=$1; extended=$2
+
+# can_moni: the acceptance filter from the complement of the exclusion
+LD_LIBRARY_PATH=$STUB_DIR STUB_FRAMES=$FRAMES $CAN_MONI PCAN-USB1 --exclude=0x106-0x7FF >$OUTPUT 2>/dev/null
+set -- $(count all)
+if [ $1 -eq $expected ] && [ $2 -eq $extended ] && [ $extended -gt 0 ]; then
+	echo "PASS: can_moni --exclude=0x106-0x7FF ($1 frames, $2 extended)"
+else
+	echo "FAIL: can_moni --exclude=0x106-0x7FF ($1 of $expected frames, $2 of $extended extended)"
+	rc=1
+fi
+
+# can_test: the acceptance filter from the CAN-IDs of the filter expression
+LD_LIBRARY_PATH=$STUB_DIR STUB_FRAMES=$FRAMES $CAN_TEST PCAN-USB1 --filter="ID IN 0x000-0x105, 0x800-0x1FFFFFFF" \
+	>$OUTPUT 2>/dev/null
+received=$(sed -n "s/^Message(s)=\([0-9]*\)/\1/p" $OUTPUT)
+if [ "$received" = "$expected" ]; then
+	echo "PASS: can_test --filter=\"ID IN 0x000-0x105, 0x800-0x1FFFFFFF\" ($received frames)"
+else
+	echo "FAIL: can_test --filter=\"ID IN 0x000-0x105, 0x800-0x1FFFFFFF\" (${received:-no} of $expected frames)"
+	rc=1
+fi
+rm -f $OUTPUT
+exit $rc
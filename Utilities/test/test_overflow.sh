@@ -0,0 +1,34 @@
+#!/bin/sh
+#
+#	Receive queue of can_moni: a stalled pipe with a queue of 64 frames
+#
+#	- BLOCK: all frames arrive
+#	- DROP-NEWEST, DROP-OLDEST: printed plus dropped frames add up
+#
+#	Copyright (c) 2025  Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+#
+CAN_MONI=${CAN_MONI:-../can_moni/can_moni}
+STUB_DIR=${STUB_DIR:-../stub}
+FRAMES=100000
+OUTPUT=${TMPDIR:-/tmp}/test_overflow.$$
+rc=0
+
+for policy in BLOCK DROP-NEWEST DROP-OLDEST; do
+	LD_LIBRARY_PATH=$STUB_DIR STUB_FRAMES=$FRAMES $CAN_MONI PCAN-USB1 --queue=64 --overflow=$policy \
+		2>/dev/null | (sleep 1; cat) > $OUTPUT
+	printed=$(grep -c "^[0-9][0-9]*[ 	]" $OUTPUT)
+	dropped=$(sed -n "s/^Receive queue: \([0-9]*\) newest frame(s) dropped, \([0-9]*\) oldest.*/\1 \2/p" $OUTPUT)
+	dropped=${dropped:-0 0}
+	dropped=$(( ${dropped% *} + ${dropped#* } ))
+	if [ "$policy" = "BLOCK" ] && [ $dropped -ne 0 ]; then
+		result=FAIL
+	elif [ $(( printed + dropped )) -ne $FRAMES ]; then
+		result=FAIL
+	else
+		result=PASS
+	fi
+	[ $result = PASS ] || rc=1
+	echo "$result: --overflow=$policy ($printed printed, $dropped dropped of $FRAMES)"
+done
+rm -f $OUTPUT
+exit $rc
@@ -0,0 +1,118 @@
+#!/bin/sh
+#
+#	Round trip of the capture files through can_moni --render
+#
+#	The frames captured with --output=BINARY (16-byte header, 24-byte
+#	records for CAN CC, 80-byte records for CAN FD) and --output=COMPRESSED
+#	must render to the same lines as the TEXT output of the same frames
+#	from the stub.  The compressed captures span several blocks; random
+#	CAN FD frames (STUB_RANDOM) give blocks that are stored uncompressed.
+#	With --follow a compressed file is rendered while it is written.
+#
+#	Copyright (c) 2025  Uwe Vogt, UV Software, Berlin (info@uv-software.com)
+#
+CAN_MONI=${CAN_MONI:-../can_moni/can_moni}
+STUB_DIR=${STUB_DIR:-../stub}
+FRAMES=300
+BLOCKS=3000
+OUTPUT=${TMPDIR:-/tmp}/test_render.$$
+rc=0
+
+# the frame lines of the TEXT output (incl. the lines of CAN FD payloads)
+frames() {
+	awk '/^[0-9]+[ \t]/ || /^\t/' $1
+}
+
+# round trip: <mode> <record size> [<option>...]
+binary() {
+	mode=$1; size=$2; shift 2
+	LD_LIBRARY_PATH=$STUB_DIR STUB_FRAMES=$FRAMES $CAN_MONI PCAN-USB1 "$@" >$OUTPUT.txt 2>/dev/null
+	LD_LIBRARY_PATH=$STUB_DIR STUB_FRAMES=$FRAMES $CAN_MONI PCAN-USB1 "$@" --output=BINARY --output-file=$OUTPUT.rec \
+		>/dev/null 2>&1
+	bytes=$(wc -c <$OUTPUT.rec)
+	if [ "$(head -c 8 $OUTPUT.rec | tr -d '\r\n')" != "CANREC" ] || [ $bytes -ne $((16 + FRAMES * size)) ]; then
+		echo "FAIL: --output=BINARY ($mode, $bytes bytes instead of 16 + $FRAMES x $size)"
+		rc=1
+	elif ! $CAN_MONI --render=$OUTPUT.rec >$OUTPUT.out 2>/dev/null; then
+		echo "FAIL: --render of BINARY ($mode, exit code $?)"
+		rc=1
+	elif [ $(frames $OUTPUT.out | wc -l) -lt $FRAMES ] || ! frames $OUTPUT.txt | cmp -s - $OUTPUT.out; then
+		echo "FAIL: --render of BINARY ($mode, rendered frames differ from the TEXT output)"
+		rc=1
+	else
+		echo "PASS: --render of BINARY ($mode, $FRAMES frames of $size bytes)"
+	fi
+}
+
+# the blocks of a compressed file: <number> <stored uncompressed>
+blocks() {
+	od -An -v -tu1 $1 | awk '
+	{ for (i = 1; i <= NF; i++) b[n++] = $i }
+	function le32(o) { return b[o] + b[o+1] * 256 + b[o+2] * 65536 + b[o+3] * 16777216 }
+	END { o = 16; while (o + 24 <= n) { k++; if (le32(o+4) == 0) s++; o += 24 + (le32(o+4) ? le32(o+4) : le32(o)) } printf("%d %d\n", k, s) }'
+}
+
+# round trip: <mode> <stored blocks (yes|no)> [<option>...]
+compressed() {
+	mode=$1; stored=$2; shift 2
+	LD_LIBRARY_PATH=$STUB_DIR STUB_FRAMES=$BLOCKS $CAN_MONI PCAN-USB1 "$@" >$OUTPUT.txt 2>/dev/null
+	LD_LIBRARY_PATH=$STUB_DIR STUB_FRAMES=$BLOCKS $CAN_MONI PCAN-USB1 "$@" --output=COMPRESSED --output-file=$OUTPUT.pak \
+		>/dev/null 2>&1
+	set -- $(blocks $OUTPUT.pak)
+	if [ "$(head -c 8 $OUTPUT.pak | tr -d '\r\n')" != "CANPAK" ] || [ $1 -lt 2 ] ||
+	   { [ $stored = yes ] && [ $2 -ne $1 ]; } || { [ $stored = no ] && [ $2 -ne 0 ]; }; then
+		echo "FAIL: --output=COMPRESSED ($mode, $1 blocks, $2 stored uncompressed)"
+		rc=1
+	elif ! $CAN_MONI --render=$OUTPUT.pak >$OUTPUT.out 2>/dev/null; then
+		echo "FAIL: --render of COMPRESSED ($mode, exit code $?)"
+		rc=1
+	elif [ $(frames $OUTPUT.out | grep -c "^[0-9]") -ne $BLOCKS ] || ! frames $OUTPUT.txt | cmp -s - $OUTPUT.out; then
+		echo "FAIL: --render of COMPRESSED ($mode, rendered frames differ from the TEXT output)"
+		rc=1
+	else
+		echo "PASS: --render of COMPRESSED ($mode, $BLOCKS frames in $1 blocks, $2 stored uncompressed)"
+	fi
+}
+
+binary "CAN CC" 24
+binary "CAN FD" 80 --mode=FDF+BRS
+compressed "CAN CC" no
+compressed "CAN FD" no --mode=FDF+BRS
+STUB_RANDOM=1 compressed "CAN FD, random" yes --mode=FDF+BRS
+
+# follow a compressed file while it is written (1ms per frame), then stop
+rm -f $OUTPUT.pak
+LD_LIBRARY_PATH=$STUB_DIR STUB_FRAMES=$BLOCKS STUB_DELAY=1000 STUB_RANDOM=1 $CAN_MONI PCAN-USB1 --mode=FDF+BRS \
+	--output=COMPRESSED --output-file=$OUTPUT.pak >/dev/null 2>&1 &
+writer=$!
+while [ ! -f $OUTPUT.pak ] && kill -0 $writer 2>/dev/null; do sleep 0.1; done
+$CAN_MONI --render=$OUTPUT.pak --follow >$OUTPUT.out 2>/dev/null &
+follower=$!
+sleep 2
+during=$(grep -c "^[0-9]" $OUTPUT.out)
+wait $writer
+sleep 1
+kill $follower; { wait $follower; } 2>/dev/null
+LD_LIBRARY_PATH=$STUB_DIR STUB_FRAMES=$BLOCKS STUB_RANDOM=1 $CAN_MONI PCAN-USB1 --mode=FDF+BRS >$OUTPUT.txt 2>/dev/null
+if [ $during -eq 0 ] || [ $during -ge $BLOCKS ] || ! frames $OUTPUT.txt | cmp -s - $OUTPUT.out; then
+	echo "FAIL: --render --follow ($during frames after 2s, $(grep -c "^[0-9]" $OUTPUT.out) of $BLOCKS frames at the end)"
+	rc=1
+else
+	echo "PASS: --render --follow ($during frames after 2s, $BLOCKS frames at the end)"
+fi
+
+# not a capture file
+if $CAN_MONI --render=$0 >/dev/null 2>&1; then
+	echo "FAIL: --render of a text file (no error)"
+	rc=1
+else
+	echo "PASS: --render of a text file (error)"
+fi
+if $CAN_MONI --render=$OUTPUT.rec --follow >/dev/null 2>&1; then
+	echo "FAIL: --render --follow of BINARY (no error)"
+	rc=1
+else
+	echo "PASS: --render --follow of BINARY (error)"
+fi
+rm -f $OUTPUT.txt $OUTPUT.rec $OUTPUT.pak $OUTPUT.out
+exit $rc